@@ -0,0 +1,190 @@
+/*
+ * LineScanner.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "basic.hpp"
+#if defined __x86_64__
+#include <immintrin.h>
+#endif
+
+namespace cppknife {
+
+/**
+ * Scans the bytes from <em>start</em> to <em>length</em> byte by byte.
+ * @return The offset of the first '\n' (if <em>lineEnds == nullptr</em>) or <em>length</em>.
+ */
+static size_t scanTail(const char *data, size_t start, size_t length,
+    std::vector<uint32_t> *lineEnds, bool &binary) {
+  size_t rc = length;
+  auto ptr = reinterpret_cast<const unsigned char*>(data);
+  for (size_t ix = start; ix < length; ix++) {
+    unsigned char cc = ptr[ix];
+    if (cc == '\n') {
+      if (lineEnds == nullptr) {
+        rc = ix;
+        break;
+      }
+      lineEnds->push_back(static_cast<uint32_t>(ix));
+    } else if (cc < ' ' && (cc < '\t' || cc > '\r')) {
+      binary = true;
+    }
+  }
+  return rc;
+}
+
+LineScanner::LineScanner(Kernel kernel) :
+    _kernel(kernel) {
+  Kernel best = bestKernel();
+  if (_kernel == K_AUTO || _kernel > best) {
+    _kernel = best;
+  }
+}
+
+LineScanner::Kernel LineScanner::bestKernel() {
+#if defined __x86_64__
+  static Kernel rc = __builtin_cpu_supports("avx2") ? K_AVX2 : K_SSE2;
+  return rc;
+#else
+  return K_SCALAR;
+#endif
+}
+
+size_t LineScanner::findLineEnd(const char *data, size_t length,
+    bool &binary) const {
+  return scan(data, length, nullptr, binary);
+}
+
+bool LineScanner::indexBlock(const char *data, size_t length,
+    std::vector<uint32_t> &lineEnds) const {
+  bool rc = false;
+  lineEnds.clear();
+  scan(data, length, &lineEnds, rc);
+  return rc;
+}
+
+size_t LineScanner::scan(const char *data, size_t length,
+    std::vector<uint32_t> *lineEnds, bool &binary) const {
+  size_t rc;
+  switch (_kernel) {
+#if defined __x86_64__
+  case K_AVX2:
+    rc = scanAvx2(data, length, lineEnds, binary);
+    break;
+  case K_SSE2:
+    rc = scanSse2(data, length, lineEnds, binary);
+    break;
+#endif
+  default:
+    rc = scanScalar(data, length, lineEnds, binary);
+    break;
+  }
+  return rc;
+}
+
+#if defined __x86_64__
+__attribute__((target("avx2")))
+size_t LineScanner::scanAvx2(const char *data, size_t length,
+    std::vector<uint32_t> *lineEnds, bool &binary) const {
+  const __m256i newline = _mm256_set1_epi8('\n');
+  const __m256i lastControl = _mm256_set1_epi8(0x1f);
+  const __m256i tab = _mm256_set1_epi8('\t');
+  // TAB..CR: 5 characters
+  const __m256i whiteRange = _mm256_set1_epi8('\r' - '\t');
+  size_t offset = 0;
+  while (offset + 32 <= length) {
+    __m256i block = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(data + offset));
+    // Unsigned compare: min(x, limit) == x <=> x <= limit
+    __m256i isControl = _mm256_cmpeq_epi8(_mm256_min_epu8(block, lastControl),
+        block);
+    __m256i shifted = _mm256_sub_epi8(block, tab);
+    __m256i isWhite = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, whiteRange),
+        shifted);
+    uint32_t binaries = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_andnot_si256(isWhite, isControl)));
+    uint32_t newlines = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(block, newline)));
+    if (lineEnds == nullptr) {
+      if (newlines != 0) {
+        uint32_t position = __builtin_ctz(newlines);
+        if ((binaries & ((1U << position) - 1)) != 0) {
+          binary = true;
+        }
+        return offset + position;
+      }
+    } else {
+      while (newlines != 0) {
+        lineEnds->push_back(
+            static_cast<uint32_t>(offset + __builtin_ctz(newlines)));
+        newlines &= newlines - 1;
+      }
+    }
+    if (binaries != 0) {
+      binary = true;
+    }
+    offset += 32;
+  }
+  return scanTail(data, offset, length, lineEnds, binary);
+}
+
+size_t LineScanner::scanSse2(const char *data, size_t length,
+    std::vector<uint32_t> *lineEnds, bool &binary) const {
+  const __m128i newline = _mm_set1_epi8('\n');
+  const __m128i lastControl = _mm_set1_epi8(0x1f);
+  const __m128i tab = _mm_set1_epi8('\t');
+  const __m128i whiteRange = _mm_set1_epi8('\r' - '\t');
+  size_t offset = 0;
+  while (offset + 16 <= length) {
+    __m128i block = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(data + offset));
+    __m128i isControl = _mm_cmpeq_epi8(_mm_min_epu8(block, lastControl), block);
+    __m128i shifted = _mm_sub_epi8(block, tab);
+    __m128i isWhite = _mm_cmpeq_epi8(_mm_min_epu8(shifted, whiteRange),
+        shifted);
+    uint32_t binaries = static_cast<uint32_t>(_mm_movemask_epi8(
+        _mm_andnot_si128(isWhite, isControl)));
+    uint32_t newlines = static_cast<uint32_t>(_mm_movemask_epi8(
+        _mm_cmpeq_epi8(block, newline)));
+    if (lineEnds == nullptr) {
+      if (newlines != 0) {
+        uint32_t position = __builtin_ctz(newlines);
+        if ((binaries & ((1U << position) - 1)) != 0) {
+          binary = true;
+        }
+        return offset + position;
+      }
+    } else {
+      while (newlines != 0) {
+        lineEnds->push_back(
+            static_cast<uint32_t>(offset + __builtin_ctz(newlines)));
+        newlines &= newlines - 1;
+      }
+    }
+    if (binaries != 0) {
+      binary = true;
+    }
+    offset += 16;
+  }
+  return scanTail(data, offset, length, lineEnds, binary);
+}
+#else
+size_t LineScanner::scanAvx2(const char *data, size_t length,
+    std::vector<uint32_t> *lineEnds, bool &binary) const {
+  return scanScalar(data, length, lineEnds, binary);
+}
+size_t LineScanner::scanSse2(const char *data, size_t length,
+    std::vector<uint32_t> *lineEnds, bool &binary) const {
+  return scanScalar(data, length, lineEnds, binary);
+}
+#endif
+
+size_t LineScanner::scanScalar(const char *data, size_t length,
+    std::vector<uint32_t> *lineEnds, bool &binary) const {
+  return scanTail(data, 0, length, lineEnds, binary);
+}
+
+} /* cppknife */
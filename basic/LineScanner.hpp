@@ -0,0 +1,82 @@
+/*
+ * LineScanner.hpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef BASIC_LINESCANNER_HPP_
+#define BASIC_LINESCANNER_HPP_
+
+namespace cppknife {
+/**
+ * @brief Finds line ends and binary data of a text block in one pass.
+ *
+ * Binary data are '\0' and the control characters other than TAB..CR.
+ * The scanner is the common line splitting kernel of <em>LineAgent</em>,
+ * <em>LineReader</em> and (via <em>LineReader</em>) <em>CsvFile</em>.
+ *
+ * Available kernels: AVX2, SSE2 (x86_64 only) and a portable scalar kernel.
+ */
+class LineScanner {
+public:
+  enum Kernel {
+    K_AUTO, K_SCALAR, K_SSE2, K_AVX2
+  };
+protected:
+  Kernel _kernel;
+public:
+  /**
+   * Constructor.
+   * @param kernel The algorithm to use. <em>K_AUTO</em>: the fastest available.
+   *  An unavailable kernel is replaced by the fastest available.
+   */
+  LineScanner(Kernel kernel = K_AUTO);
+public:
+  /**
+   * Finds the next line end.
+   * @param data The text to inspect.
+   * @param length The length of <em>data</em>.
+   * @param[in, out] binary Set to <em>true</em> if there is binary data in front of the line end.
+   * @return The offset of the next '\n' or <em>length</em> if there is no '\n'.
+   */
+  size_t findLineEnd(const char *data, size_t length, bool &binary) const;
+  /**
+   * Builds the line index of a block.
+   * @param data The block to inspect.
+   * @param length The length of <em>data</em>. Must be less than 4 GiByte.
+   * @param[out] lineEnds The offsets of all '\n' in <em>data</em>.
+   * @return <em>true</em>: the block contains binary data.
+   */
+  bool indexBlock(const char *data, size_t length,
+      std::vector<uint32_t> &lineEnds) const;
+  /**
+   * Returns the kernel in use.
+   */
+  inline Kernel kernel() const {
+    return _kernel;
+  }
+public:
+  /**
+   * Returns the fastest kernel available on the current CPU.
+   */
+  static Kernel bestKernel();
+protected:
+  /*
+   * The kernels: with <em>lineEnds == nullptr</em> the scan stops at the first '\n'.
+   * All return the offset of the first '\n' or <em>length</em>.
+   */
+  size_t scanAvx2(const char *data, size_t length,
+      std::vector<uint32_t> *lineEnds, bool &binary) const;
+  size_t scanScalar(const char *data, size_t length,
+      std::vector<uint32_t> *lineEnds, bool &binary) const;
+  size_t scanSse2(const char *data, size_t length,
+      std::vector<uint32_t> *lineEnds, bool &binary) const;
+  size_t scan(const char *data, size_t length, std::vector<uint32_t> *lineEnds,
+      bool &binary) const;
+};
+
+} /* cppknife */
+
+#endif /* BASIC_LINESCANNER_HPP_ */
@@ -21,9 +21,16 @@
 #include <string>
 #include <vector>
 #include <deque>
+#include <list>
 #include <cstdlib>
 #include <chrono>
 #include <regex>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <bitset>
 #include "../basic/InternalError.hpp"
 #include "../basic/StringTool.hpp"
 #include "../basic/TimeTool.hpp"
@@ -31,6 +38,7 @@
 #include "../basic/BaseRandom.hpp"
 #include "../basic/CharRandom.hpp"
 #include "../basic/PortableRandom.hpp"
+#include "../basic/LineScanner.hpp"
 
 inline int min(int a, int b) {
   return a <= b ? a : b;
@@ -88,13 +88,24 @@ ByteStorage::allocate(size_t size) {
   char *rc = _last->allocate(size);
   if (rc == nullptr) {
     if (size < _capacity - _last->_neededBytes) {
-      _last = new ByteBuffer(_capacity, _last);
+      // Buffers released by reset() are used first:
+      _last =
+          _last->_successor != nullptr ?
+              _last->_successor : new ByteBuffer(_capacity, _last);
       rc = _last->allocate(size);
     }
   }
   return rc;
 }
 
+void ByteStorage::reset() {
+  for (auto current = _first; current != nullptr;
+      current = current->_successor) {
+    current->_size = 0;
+  }
+  _last = _first;
+}
+
 void ByteStorage::clear() {
   ByteBuffer *next = _first;
   while (next != nullptr) {
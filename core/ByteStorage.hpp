@@ -92,6 +92,11 @@ public:
 	 * Releases all memory.
 	 */
 	void clear();
+	/**
+	 * Marks all byte sequences as free without releasing the memory.
+	 * The buffers are reused by the following <em>allocate()</em> calls.
+	 */
+	void reset();
 	/**
 	 * Checks the structure of the used <em>ByteBuffer</em>.
 	 * @return: "": OK Otherwise: the error message
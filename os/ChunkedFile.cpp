@@ -0,0 +1,139 @@
+/*
+ * ChunkedFile.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "os.hpp"
+
+namespace cppknife {
+
+ChunkedFile::ChunkedFile(const char *filename, Logger *logger,
+    bool checkBinary) :
+    _logger(logger), _filename(filename), _fileSize(0), _chunks(), _mutex(), _finished(), _stop(
+        false), _checkBinary(checkBinary) {
+}
+ChunkedFile::~ChunkedFile() {
+}
+size_t ChunkedFile::chunkSizeFor(size_t fileSize, int threads) {
+  if (threads <= 0) {
+    threads = ThreadPool::defaultThreadCount();
+  }
+  // 4 chunks per thread: a slow chunk does not delay the others.
+  size_t rc = fileSize / (4 * threads);
+  if (rc < MIN_CHUNK_SIZE) {
+    rc = MIN_CHUNK_SIZE;
+  } else if (rc > DEFAULT_CHUNK_SIZE) {
+    rc = DEFAULT_CHUNK_SIZE;
+  }
+  return rc;
+}
+size_t ChunkedFile::findLineStart(int handle, size_t position) {
+  size_t rc = _fileSize;
+  char buffer[0x10000];
+  // The line starts behind the '\n' in front of position:
+  position--;
+  while (position < _fileSize) {
+    auto bytes = pread(handle, buffer, sizeof buffer, position);
+    if (bytes <= 0) {
+      break;
+    }
+    auto found = static_cast<const char*>(memchr(buffer, '\n', bytes));
+    if (found != nullptr) {
+      rc = position + (found - buffer) + 1;
+      break;
+    }
+    position += bytes;
+  }
+  return rc;
+}
+bool ChunkedFile::process(ThreadPool &pool, ProcessChunk_t process,
+    MergeChunk_t merge, size_t maxPending) {
+  bool rc = true;
+  if (maxPending == 0) {
+    maxPending = 2 * pool.countThreads();
+  }
+  _stop = false;
+  size_t submitted = 0;
+  size_t merged = 0;
+  size_t lineNo = 1;
+  // After a stop the submitted tasks must be finished: they use the chunks and the callbacks.
+  while (merged < submitted || (rc && submitted < _chunks.size())) {
+    while (rc && submitted < _chunks.size()
+        && submitted - merged < maxPending) {
+      FileChunk *chunk = &_chunks[submitted++];
+      pool.submit([this, chunk, &process] {
+        if (!_stop) {
+          LineAgent agent(_logger);
+          if (!agent.openRange(_filename.c_str(), chunk->_start, chunk->_end,
+              _checkBinary)) {
+            chunk->_failed = !agent.hasBinaryData();
+          } else {
+            process(*chunk, agent);
+            size_t length = 0;
+            // The unprocessed lines are needed for the line numbers of the following chunks:
+            while (!_stop && !agent.hasBinaryData()
+                && agent.nextLine(length) != nullptr) {
+              // only counting
+            }
+            chunk->_lineCount = agent.currentLineNo();
+          }
+          chunk->_hasBinaryData = agent.hasBinaryData();
+        }
+        std::lock_guard<std::mutex> guard(_mutex);
+        chunk->_done = true;
+        _finished.notify_all();
+      });
+    }
+    FileChunk &chunk = _chunks[merged];
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      waitForCondition(_finished, lock, [&chunk] {
+        return chunk._done;
+      });
+    }
+    merged++;
+    if (rc) {
+      chunk._firstLineNo = lineNo;
+      lineNo += chunk._lineCount;
+      if (chunk._failed || !merge(chunk)) {
+        rc = false;
+        _stop = true;
+      }
+    }
+  }
+  return rc;
+}
+bool ChunkedFile::split(size_t chunkSize) {
+  _chunks.clear();
+  int handle = open(_filename.c_str(), O_RDONLY);
+  struct stat status;
+  bool rc = handle >= 0 && fstat(handle, &status) == 0
+      && S_ISREG(status.st_mode) && compressionOf(handle) == CT_NONE;
+  if (handle < 0) {
+    _logger->say(LV_ERROR,
+        formatCString("cannot open: %s (%d)", _filename.c_str(), errno));
+  }
+  if (rc) {
+    _fileSize = status.st_size;
+    if (chunkSize == 0) {
+      chunkSize = chunkSizeFor(_fileSize, 0);
+    }
+    size_t start = 0;
+    while (start < _fileSize) {
+      size_t end =
+          _fileSize - start <= chunkSize ?
+              _fileSize : findLineStart(handle, start + chunkSize);
+      _chunks.emplace_back(_chunks.size(), start, end);
+      start = end;
+    }
+  }
+  if (handle >= 0) {
+    close(handle);
+  }
+  return rc;
+}
+
+} /* cppknife */
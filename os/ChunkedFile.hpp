@@ -0,0 +1,140 @@
+/*
+ * ChunkedFile.hpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef OS_CHUNKEDFILE_HPP_
+#define OS_CHUNKEDFILE_HPP_
+
+namespace cppknife {
+/**
+ * @brief A part of a file: a range of complete lines.
+ */
+class FileChunk {
+public:
+  /// The index in the chunk list: the chunks are numbered in file order.
+  size_t _index;
+  /// The file position of the first line.
+  size_t _start;
+  /// The file position behind the last line (behind the '\n').
+  size_t _end;
+  /// The count of lines in the chunk. Set after processing.
+  size_t _lineCount;
+  /// The number of the first line of the chunk in the file (1 based). Valid in the merge callback.
+  size_t _firstLineNo;
+  /// <em>true</em>: the chunk contains binary data.
+  bool _hasBinaryData;
+  /// <em>true</em>: the chunk cannot be opened or mapped.
+  bool _failed;
+  bool _done;
+public:
+  FileChunk(size_t index, size_t start, size_t end) :
+      _index(index), _start(start), _end(end), _lineCount(0), _firstLineNo(0), _hasBinaryData(
+          false), _failed(false), _done(false) {
+  }
+};
+/**
+ * @brief Processes the lines of one (large) file in parallel.
+ *
+ * The file is split into chunks of complete lines: each chunk ends behind a '\n'.
+ * Each chunk is processed by a task of a <em>ThreadPool</em> with its own
+ * <em>LineAgent</em> restricted to the chunk (memory mapped mode).
+ * The results are merged in file order in the thread of the caller,
+ * while the following chunks are processed.
+ *
+ * Compressed files and non regular files cannot be split: <em>split()</em> fails,
+ * the caller should process them sequentially.
+ */
+class ChunkedFile {
+public:
+  enum {
+    /// The upper limit of the chunk size calculated by <em>chunkSizeFor()</em>.
+    DEFAULT_CHUNK_SIZE = 0x4000000,
+    /// The lower limit of the chunk size calculated by <em>chunkSizeFor()</em>.
+    MIN_CHUNK_SIZE = 0x100000
+  };
+  /**
+   * Processes the lines of one chunk in a worker thread.
+   * The agent delivers only the lines of the chunk. Lines not fetched by the callback
+   * are counted by the caller: <em>chunk._lineCount</em> is the count of the chunk,
+   * unless the data is fetched by <em>LineAgent::nextBlock()</em>.
+   */
+  typedef std::function<void(FileChunk &chunk, LineAgent &agent)> ProcessChunk_t;
+  /**
+   * Merges the result of one chunk in the thread of the caller of <em>process()</em>.
+   * The chunks are merged in file order.
+   * @return <em>false</em>: stop processing, e.g. the maximal count of hits is reached.
+   */
+  typedef std::function<bool(FileChunk &chunk)> MergeChunk_t;
+protected:
+  Logger *_logger;
+  std::string _filename;
+  size_t _fileSize;
+  std::vector<FileChunk> _chunks;
+  std::mutex _mutex;
+  std::condition_variable _finished;
+  std::atomic<bool> _stop;
+  bool _checkBinary;
+public:
+  /**
+   * Constructor.
+   * @param filename The name of the file to process.
+   * @param logger The logger.
+   * @param checkBinary <em>true</em>: the first 4 KiByte of the file are tested for '\0' like
+   *  <em>LineAgent::openFile()</em>. If found the first chunk is not processed.
+   */
+  ChunkedFile(const char *filename, Logger *logger, bool checkBinary = true);
+  virtual ~ChunkedFile();
+private:
+  ChunkedFile(const ChunkedFile &other);
+  ChunkedFile&
+  operator=(const ChunkedFile &other);
+public:
+  /**
+   * Returns the chunks found by <em>split()</em>.
+   */
+  inline const std::vector<FileChunk>& chunks() const {
+    return _chunks;
+  }
+  /**
+   * Returns the size of the file found by <em>split()</em>.
+   */
+  inline size_t fileSize() const {
+    return _fileSize;
+  }
+  /**
+   * Processes all chunks and merges the results in file order.
+   * @param pool The workers processing the chunks. The caller must not be a worker of <em>pool</em>.
+   * @param process Processes one chunk in a worker thread.
+   * @param merge Merges the result of one chunk in the thread of the caller.
+   * @param maxPending The maximal count of chunks processed but not merged (limits the memory).
+   *  0: twice the count of threads of <em>pool</em>.
+   * @return <em>false</em>: processing was stopped by <em>merge</em> or a chunk could not be read.
+   */
+  bool process(ThreadPool &pool, ProcessChunk_t process, MergeChunk_t merge,
+      size_t maxPending = 0);
+  /**
+   * Splits the file into chunks of complete lines.
+   * @param chunkSize The wanted size of a chunk. The real size is larger: up to the next '\n'.
+   *  0: the size is calculated by <em>chunkSizeFor()</em> with the CPU core count.
+   * @return <em>false</em>: the file cannot be split: not a regular file, compressed or not readable.
+   */
+  bool split(size_t chunkSize = 0);
+public:
+  /**
+   * Returns a chunk size giving some chunks per thread (for load balancing).
+   * @param fileSize The size of the file.
+   * @param threads The count of threads processing the file.
+   * @return A size between <em>MIN_CHUNK_SIZE</em> and <em>DEFAULT_CHUNK_SIZE</em>.
+   */
+  static size_t chunkSizeFor(size_t fileSize, int threads);
+protected:
+  size_t findLineStart(int handle, size_t position);
+};
+
+} /* cppknife */
+
+#endif /* OS_CHUNKEDFILE_HPP_ */
@@ -0,0 +1,201 @@
+/*
+ * Decompressor.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "os.hpp"
+#include <zlib.h>
+#if defined CPPKNIFE_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace cppknife {
+
+/**
+ * @brief Decompresses gzip (and zlib) data, also concatenated gzip members.
+ */
+class GzipReadAhead: public ReadAhead {
+protected:
+  z_stream _stream;
+  std::string _input;
+  /// <em>false</em>: the initialization has failed.
+  bool _valid;
+  /// <em>true</em>: the last member is complete: the end of file is allowed.
+  bool _memberEnd;
+  bool _failed;
+public:
+  GzipReadAhead(int handle, size_t chunks, size_t chunkSize) :
+      ReadAhead(handle, chunks, chunkSize), _stream(), _input(), _valid(false), _memberEnd(
+          false), _failed(false) {
+    memset(&_stream, 0, sizeof _stream);
+    _input.resize(0x10000);
+    // 15 + 32: maximal window, automatic detection of the gzip or zlib header.
+    _valid = inflateInit2(&_stream, 15 + 32) == Z_OK;
+    _failed = !_valid;
+  }
+  virtual ~GzipReadAhead() {
+    stop();
+    if (_valid) {
+      inflateEnd(&_stream);
+    }
+  }
+private:
+  GzipReadAhead(const GzipReadAhead &other);
+  GzipReadAhead&
+  operator=(const GzipReadAhead &other);
+protected:
+  virtual ssize_t readChunk(char *buffer, size_t size) {
+    bool failed = _failed;
+    _stream.next_out = reinterpret_cast<Bytef*>(buffer);
+    _stream.avail_out = static_cast<uInt>(size);
+    while (!failed && _stream.avail_out > 0) {
+      if (_stream.avail_in == 0) {
+        auto bytes = ::read(_handle, &_input[0], _input.size());
+        if (bytes <= 0) {
+          // A truncated stream is an error:
+          failed = bytes < 0 || !_memberEnd;
+          break;
+        }
+        _stream.next_in = reinterpret_cast<Bytef*>(&_input[0]);
+        _stream.avail_in = static_cast<uInt>(bytes);
+      }
+      int result = inflate(&_stream, Z_NO_FLUSH);
+      if (result == Z_STREAM_END) {
+        // The next gzip member can follow:
+        _memberEnd = true;
+        inflateReset(&_stream);
+      } else if (result == Z_OK || result == Z_BUF_ERROR) {
+        _memberEnd = false;
+      } else {
+        failed = true;
+      }
+    }
+    // The data in front of an error is delivered, the error with the next call:
+    ssize_t rc = size - _stream.avail_out;
+    if (failed) {
+      _failed = true;
+      if (rc == 0) {
+        rc = -1;
+      }
+    }
+    return rc;
+  }
+};
+
+#if defined CPPKNIFE_WITH_ZSTD
+/**
+ * @brief Decompresses zstd data, also concatenated frames.
+ */
+class ZstdReadAhead: public ReadAhead {
+protected:
+  ZSTD_DCtx *_context;
+  std::string _input;
+  ZSTD_inBuffer _inBuffer;
+  /// <em>true</em>: the last frame is complete: the end of file is allowed.
+  bool _frameEnd;
+  bool _failed;
+public:
+  ZstdReadAhead(int handle, size_t chunks, size_t chunkSize) :
+      ReadAhead(handle, chunks, chunkSize), _context(ZSTD_createDCtx()), _input(), _inBuffer(), _frameEnd(
+          false), _failed(_context == nullptr) {
+    _input.resize(ZSTD_DStreamInSize());
+    _inBuffer.src = _input.data();
+    _inBuffer.size = _inBuffer.pos = 0;
+  }
+  virtual ~ZstdReadAhead() {
+    stop();
+    ZSTD_freeDCtx(_context);
+  }
+private:
+  ZstdReadAhead(const ZstdReadAhead &other);
+  ZstdReadAhead&
+  operator=(const ZstdReadAhead &other);
+protected:
+  virtual ssize_t readChunk(char *buffer, size_t size) {
+    bool failed = _failed;
+    ZSTD_outBuffer outBuffer = { buffer, size, 0 };
+    while (!failed && outBuffer.pos < outBuffer.size) {
+      if (_inBuffer.pos >= _inBuffer.size) {
+        auto bytes = ::read(_handle, &_input[0], _input.size());
+        if (bytes <= 0) {
+          failed = bytes < 0 || !_frameEnd;
+          break;
+        }
+        _inBuffer.size = bytes;
+        _inBuffer.pos = 0;
+      }
+      size_t result = ZSTD_decompressStream(_context, &outBuffer, &_inBuffer);
+      if (ZSTD_isError(result)) {
+        failed = true;
+      } else {
+        // 0: a frame is completely decoded and flushed.
+        _frameEnd = result == 0;
+      }
+    }
+    ssize_t rc = outBuffer.pos;
+    if (failed) {
+      _failed = true;
+      if (rc == 0) {
+        rc = -1;
+      }
+    }
+    return rc;
+  }
+};
+#endif
+
+CompressionType compressionOf(int handle) {
+  CompressionType rc = CT_NONE;
+  unsigned char header[4];
+  if (pread(handle, header, sizeof header, 0) == sizeof header) {
+    if (header[0] == 0x1f && header[1] == 0x8b) {
+      rc = CT_GZIP;
+    } else if (header[0] == 0x28 && header[1] == 0xb5 && header[2] == 0x2f
+        && header[3] == 0xfd) {
+      rc = CT_ZSTD;
+    }
+  }
+  return rc;
+}
+
+const char* compressionName(CompressionType type) {
+  const char *rc = "none";
+  switch (type) {
+  case CT_GZIP:
+    rc = "gzip";
+    break;
+  case CT_ZSTD:
+    rc = "zstd";
+    break;
+  default:
+    break;
+  }
+  return rc;
+}
+
+ReadAhead* createDecompressor(CompressionType type, int handle, size_t chunks,
+    size_t chunkSize) {
+  ReadAhead *rc = nullptr;
+  switch (type) {
+  case CT_GZIP:
+    rc = new GzipReadAhead(handle, chunks, chunkSize);
+    break;
+#if defined CPPKNIFE_WITH_ZSTD
+  case CT_ZSTD:
+    rc = new ZstdReadAhead(handle, chunks, chunkSize);
+    break;
+#endif
+  default:
+    break;
+  }
+  if (rc != nullptr) {
+    posix_fadvise(handle, 0, 0, POSIX_FADV_SEQUENTIAL);
+    rc->start();
+  }
+  return rc;
+}
+
+} /* cppknife */
@@ -0,0 +1,43 @@
+/*
+ * Decompressor.hpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef OS_DECOMPRESSOR_HPP_
+#define OS_DECOMPRESSOR_HPP_
+
+namespace cppknife {
+/**
+ * The compression formats recognized by their magic bytes.
+ */
+enum CompressionType {
+  CT_NONE, CT_GZIP, CT_ZSTD
+};
+/**
+ * Detects the compression of a file by its magic bytes.
+ * @param handle The file to inspect. Read with <em>pread()</em>: the file position remains unchanged.
+ * @return <em>CT_NONE</em>: not compressed or not seekable (pipe). Otherwise: the compression format.
+ */
+CompressionType compressionOf(int handle);
+/**
+ * Returns the name of a compression format, e.g. "gzip".
+ */
+const char* compressionName(CompressionType type);
+/**
+ * Creates a read-ahead instance decompressing the file in a background thread.
+ * @param type The compression format of the file.
+ * @param handle The file to read. Not closed by the instance.
+ * @param chunks The count of decompressed chunks held in advance.
+ * @param chunkSize The size of one decompressed chunk.
+ * @return <em>nullptr</em>: the format is not supported by this build (zstd without libzstd).
+ *  Otherwise: the started instance. Must be freed by the caller.
+ */
+ReadAhead* createDecompressor(CompressionType type, int handle, size_t chunks,
+    size_t chunkSize);
+
+} /* cppknife */
+
+#endif /* OS_DECOMPRESSOR_HPP_ */
@@ -0,0 +1,551 @@
+/*
+ * DirectoryIndex.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "os.hpp"
+
+namespace cppknife {
+
+/**
+ * @brief The header of an index file.
+ *
+ * Layout of the file: <pre>IndexFileHeader record1 record2 ... uint64_t table[_records]</pre>
+ * The table contains the offsets of the records, sorted by the path of the records.
+ */
+struct IndexFileHeader {
+  char _magic[8];
+  uint64_t _records;
+  uint64_t _tableOffset;
+};
+static const char *indexMagic = "CKDIRIX1";
+
+inline int compareTime(int64_t seconds1, int64_t nanoseconds1,
+    int64_t seconds2, int64_t nanoseconds2) {
+  int rc =
+      seconds1 < seconds2 ? -1 :
+      seconds1 > seconds2 ? 1 :
+      nanoseconds1 < nanoseconds2 ? -1 : nanoseconds1 > nanoseconds2 ? 1 : 0;
+  return rc;
+}
+
+/**
+ * Tests whether a record of a loaded index file is consistent:
+ * all parts are inside the record and the strings are terminated.
+ * @param data The record.
+ * @param available The count of bytes from the record start to the end of the record area.
+ * @return <em>true</em>: the record may be accessed by a <em>RecordView</em>.
+ */
+static bool isValidRecord(const char *data, size_t available) {
+  auto record = reinterpret_cast<const IndexRecord*>(data);
+  size_t size = record->_size;
+  // The node area starts behind the path and its '\0':
+  size_t nodes = sizeof(IndexRecord) + record->_entries * sizeof(IndexEntry)
+      + record->_candidates * sizeof(uint32_t) + record->_pathLength + 1;
+  bool rc = size % 8 == 0 && size <= available && nodes <= size;
+  if (rc) {
+    DirectoryIndex::RecordView view(data);
+    rc = view.path()[record->_pathLength] == '\0';
+    for (size_t ix = 0; rc && ix < record->_candidates; ix++) {
+      rc = view.candidates()[ix] < record->_entries;
+    }
+    for (size_t ix = 0; rc && ix < record->_entries; ix++) {
+      size_t start = nodes + view.entries()[ix]._nodeOffset;
+      rc = start < size && memchr(data + start, '\0', size - start) != nullptr;
+    }
+  }
+  return rc;
+}
+
+DirectoryIndex::DirectoryIndex(const char *filename, Logger *logger) :
+    _filename(filename), _logger(logger), _data(nullptr), _dataSize(0), _table(
+        nullptr), _countRecords(0), _records(), _completedTrees(), _changed(
+        false) {
+}
+
+DirectoryIndex::~DirectoryIndex() {
+  unload();
+}
+
+void DirectoryIndex::buildRecord(std::string &record, const std::string &path,
+    const FileTime_t &modified, std::vector<IndexEntry> &entries,
+    const std::string &nodes, size_t extremaCount) {
+  IndexRecord header;
+  memset(&header, 0, sizeof header);
+  header._mtimeSeconds = modified.tv_sec;
+  header._mtimeNanoseconds = modified.tv_nsec;
+  header._entries = static_cast<uint32_t>(entries.size());
+  header._extremaCount = static_cast<uint32_t>(extremaCount);
+  header._pathLength = static_cast<uint32_t>(path.size());
+  std::vector<uint32_t> files;
+  std::vector<uint32_t> regularFiles;
+  for (size_t ix = 0; ix < entries.size(); ix++) {
+    auto mode = entries[ix]._mode;
+    if (!S_ISDIR(mode)) {
+      header._files++;
+      files.push_back(static_cast<uint32_t>(ix));
+      if (S_ISREG(mode)) {
+        header._sizes += entries[ix]._size;
+        regularFiles.push_back(static_cast<uint32_t>(ix));
+      }
+    }
+  }
+  std::vector<uint32_t> candidates;
+  auto addBest = [&](std::vector<uint32_t> &list,
+      std::function<bool(uint32_t, uint32_t)> better) {
+    if (list.size() > extremaCount) {
+      std::nth_element(list.begin(), list.begin() + extremaCount, list.end(),
+          better);
+      list.resize(extremaCount);
+    }
+    candidates.insert(candidates.end(), list.begin(), list.end());
+  };
+  if (extremaCount > 0) {
+    addBest(regularFiles, [&entries](uint32_t ix1, uint32_t ix2) {
+      return entries[ix1]._size > entries[ix2]._size;
+    });
+    std::vector<uint32_t> files2(files);
+    addBest(files, [&entries](uint32_t ix1, uint32_t ix2) {
+      return compareTime(entries[ix1]._mtimeSeconds,
+          entries[ix1]._mtimeNanoseconds, entries[ix2]._mtimeSeconds,
+          entries[ix2]._mtimeNanoseconds) > 0;
+    });
+    addBest(files2, [&entries](uint32_t ix1, uint32_t ix2) {
+      return compareTime(entries[ix1]._mtimeSeconds,
+          entries[ix1]._mtimeNanoseconds, entries[ix2]._mtimeSeconds,
+          entries[ix2]._mtimeNanoseconds) < 0;
+    });
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()),
+        candidates.end());
+  }
+  header._candidates = static_cast<uint32_t>(candidates.size());
+  size_t size = sizeof header + entries.size() * sizeof(IndexEntry)
+      + candidates.size() * sizeof(uint32_t) + path.size() + 1 + nodes.size();
+  size = (size + 7) & ~size_t(7);
+  header._size = static_cast<uint32_t>(size);
+  record.assign(size, '\0');
+  char *data = &record[0];
+  memcpy(data, &header, sizeof header);
+  data += sizeof header;
+  if (!entries.empty()) {
+    memcpy(data, entries.data(), entries.size() * sizeof(IndexEntry));
+    data += entries.size() * sizeof(IndexEntry);
+  }
+  if (!candidates.empty()) {
+    memcpy(data, candidates.data(), candidates.size() * sizeof(uint32_t));
+    data += candidates.size() * sizeof(uint32_t);
+  }
+  memcpy(data, path.c_str(), path.size() + 1);
+  data += path.size() + 1;
+  memcpy(data, nodes.data(), nodes.size());
+}
+
+const char*
+DirectoryIndex::find(const std::string &path) const {
+  const char *rc = nullptr;
+  size_t low = 0;
+  size_t high = _countRecords;
+  const char *key = path.c_str();
+  while (low < high) {
+    size_t middle = (low + high) / 2;
+    const char *record = _data + _table[middle];
+    int compare = strcmp(key, RecordView(record).path());
+    if (compare == 0) {
+      rc = record;
+      break;
+    } else if (compare < 0) {
+      high = middle;
+    } else {
+      low = middle + 1;
+    }
+  }
+  return rc;
+}
+
+void DirectoryIndex::finishTree(const std::string &path) {
+  _completedTrees.push_back(path);
+  _changed = true;
+}
+
+bool DirectoryIndex::load() {
+  bool rc = false;
+  unload();
+  int handle = open(_filename.c_str(), O_RDONLY | O_CLOEXEC);
+  if (handle >= 0) {
+    struct stat status;
+    if (fstat(handle, &status) == 0
+        && static_cast<size_t>(status.st_size) >= sizeof(IndexFileHeader)) {
+      void *data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE,
+          handle, 0);
+      if (data != MAP_FAILED) {
+        _data = reinterpret_cast<const char*>(data);
+        _dataSize = status.st_size;
+        auto header = reinterpret_cast<const IndexFileHeader*>(_data);
+        rc = memcmp(header->_magic, indexMagic, sizeof header->_magic) == 0
+            && header->_tableOffset % 8 == 0
+            && header->_tableOffset <= _dataSize
+            && header->_records <= (_dataSize - header->_tableOffset) / 8;
+        if (rc) {
+          _table = reinterpret_cast<const uint64_t*>(_data
+              + header->_tableOffset);
+          _countRecords = header->_records;
+          for (size_t ix = 0; rc && ix < _countRecords; ix++) {
+            auto offset = _table[ix];
+            rc = offset % 8 == 0
+                && offset + sizeof(IndexRecord) <= header->_tableOffset
+                && isValidRecord(_data + offset, header->_tableOffset - offset);
+          }
+        }
+        if (!rc) {
+          if (_logger != nullptr) {
+            _logger->say(LV_ERROR,
+                formatCString("invalid index file, ignored: %s",
+                    _filename.c_str()));
+          }
+          unload();
+        }
+      }
+    }
+    close(handle);
+  }
+  return rc;
+}
+
+void DirectoryIndex::put(const std::string &path, std::string &record) {
+  _records[path] = std::move(record);
+  _changed = true;
+}
+
+bool DirectoryIndex::save() {
+  bool rc = true;
+  if (_changed) {
+    std::string tempName(_filename + ".tmp");
+    FILE *fp = fopen(tempName.c_str(), "wb");
+    if (fp == nullptr) {
+      rc = false;
+      if (_logger != nullptr) {
+        _logger->say(LV_ERROR,
+            formatCString("cannot write index: %s (%d)", tempName.c_str(),
+                errno));
+      }
+    } else {
+      IndexFileHeader header;
+      memcpy(header._magic, indexMagic, sizeof header._magic);
+      header._records = 0;
+      header._tableOffset = 0;
+      fwrite(&header, sizeof header, 1, fp);
+      std::vector<uint64_t> table;
+      uint64_t offset = sizeof header;
+      auto write = [&](const char *record) {
+        auto size = reinterpret_cast<const IndexRecord*>(record)->_size;
+        table.push_back(offset);
+        rc = rc && fwrite(record, size, 1, fp) == 1;
+        offset += size;
+      };
+      auto isObsolete = [this](const char *path) {
+        bool rc2 = false;
+        auto length = strlen(path);
+        for (auto &tree : _completedTrees) {
+          if (startsWith(path, length, tree.c_str(), tree.size())
+              && (length == tree.size() || path[tree.size()] == '/'
+                  || (tree.size() > 0 && tree[tree.size() - 1] == '/'))) {
+            rc2 = true;
+            break;
+          }
+        }
+        return rc2;
+      };
+      // Merge the sorted old records with the sorted new records:
+      size_t ixOld = 0;
+      auto itNew = _records.begin();
+      while (ixOld < _countRecords || itNew != _records.end()) {
+        const char *oldRecord =
+            ixOld < _countRecords ? _data + _table[ixOld] : nullptr;
+        int compare = 1;
+        if (oldRecord == nullptr) {
+          compare = -1;
+        } else if (itNew != _records.end()) {
+          compare = strcmp(itNew->first.c_str(),
+              RecordView(oldRecord).path());
+        }
+        if (compare <= 0) {
+          write(itNew->second.data());
+          ++itNew;
+          if (compare == 0) {
+            ixOld++;
+          }
+        } else {
+          if (!isObsolete(RecordView(oldRecord).path())) {
+            write(oldRecord);
+          }
+          ixOld++;
+        }
+      }
+      header._records = table.size();
+      header._tableOffset = offset;
+      if (!table.empty()) {
+        rc = rc && fwrite(table.data(), sizeof(uint64_t), table.size(), fp)
+            == table.size();
+      }
+      rc = rc && fseek(fp, 0, SEEK_SET) == 0
+          && fwrite(&header, sizeof header, 1, fp) == 1;
+      rc = fclose(fp) == 0 && rc;
+      if (rc) {
+        rc = rename(tempName.c_str(), _filename.c_str()) == 0;
+      }
+      if (!rc) {
+        unlink(tempName.c_str());
+        if (_logger != nullptr) {
+          _logger->say(LV_ERROR,
+              formatCString("cannot write index: %s (%d)", _filename.c_str(),
+                  errno));
+        }
+      } else {
+        _records.clear();
+        _completedTrees.clear();
+        _changed = false;
+        load();
+      }
+    }
+  }
+  return rc;
+}
+
+void DirectoryIndex::unload() {
+  if (_data != nullptr) {
+    munmap(const_cast<char*>(_data), _dataSize);
+    _data = nullptr;
+  }
+  _dataSize = 0;
+  _table = nullptr;
+  _countRecords = 0;
+}
+
+IndexedFileAgent::IndexedFileAgent(const char *base,
+    const DirEntryFilter *filter, TraceUnit *tracer, Logger *logger,
+    DirTreeStatistic &statistics, const char *indexFile) :
+    FileAgent(), _base(base == nullptr ? "." : base), _filter(filter), _tracer(
+        tracer), _logger(logger), _statistics(statistics), _index(indexFile,
+        logger), _frames(), _depth(0), _currentEntry(), _started(false), _extremaCount(
+        20), _candidatesOnly(false), _cachedDirectories(0), _scannedDirectories(
+        0) {
+  _index.load();
+}
+
+IndexedFileAgent::~IndexedFileAgent() {
+  save();
+  for (auto frame : _frames) {
+    delete frame;
+  }
+  _frames.clear();
+}
+
+void IndexedFileAgent::changeBase(const char *base) {
+  closeAll();
+  _base = base == nullptr ? "." : base;
+  _started = false;
+}
+
+void IndexedFileAgent::closeAll() {
+  _depth = 0;
+}
+
+bool IndexedFileAgent::enterDirectory(const std::string &parentPath,
+    const char *node) {
+  bool rc = false;
+  if (_frames.size() <= _depth) {
+    _frames.push_back(new Frame());
+  }
+  Frame &frame = *_frames[_depth];
+  if (node == nullptr) {
+    frame._key = _base;
+    frame._node.clear();
+  } else {
+    frame._key = parentPath + node;
+    frame._node = node;
+  }
+  frame._path = frame._key;
+  if (!frame._path.empty() && frame._path[frame._path.size() - 1] != '/') {
+    frame._path += '/';
+  }
+  const char *name = frame._key.empty() ? "." : frame._key.c_str();
+  // The base may be a symbolic link, subdirectories are never links:
+  int error = node == nullptr ?
+      stat(name, &frame._status) : lstat(name, &frame._status);
+  const char *record = error != 0 ? nullptr : _index.find(frame._key);
+  if (record != nullptr) {
+    DirectoryIndex::RecordView view(record);
+    if (compareTime(view._record->_mtimeSeconds,
+        view._record->_mtimeNanoseconds, frame._status.st_mtim.tv_sec,
+        frame._status.st_mtim.tv_nsec) != 0
+        || (_candidatesOnly && view._record->_extremaCount < _extremaCount)) {
+      record = nullptr;
+    }
+  }
+  if (record != nullptr) {
+    frame._record.assign(record,
+        reinterpret_cast<const IndexRecord*>(record)->_size);
+    _cachedDirectories++;
+    rc = true;
+  } else if (error == 0 && scanDirectory(frame)) {
+    _scannedDirectories++;
+    rc = true;
+  }
+  if (!rc) {
+    _statistics._ignoredDirectories++;
+    if (_logger != nullptr && _logger->currentLevel() >= LV_FINE) {
+      _logger->say(LV_FINE, formatCString("_ ignored: %s", frame._path.c_str()));
+    }
+  } else {
+    frame._nextEntry = frame._nextCandidate = 0;
+    frame._candidatesOnly = _candidatesOnly && isTrivialFilter();
+    if (frame._candidatesOnly) {
+      // The files are not returned: the statistic is taken from the aggregates.
+      DirectoryIndex::RecordView view(frame._record.data());
+      _statistics._files += view._record->_files;
+      _statistics._sizes += view._record->_sizes;
+    }
+    _statistics._directories++;
+    _depth++;
+  }
+  return rc;
+}
+
+bool IndexedFileAgent::isTrivialFilter() const {
+  bool rc = _filter == nullptr
+      || (_filter->_nodePatterns == nullptr && _filter->_types == FsEntry::TC_ALL
+          && !_filter->hasSizeCondition() && !_filter->hasAgeCondition());
+  return rc;
+}
+
+FsEntry*
+IndexedFileAgent::rawNextFile(int &level) {
+  FsEntry *rc = nullptr;
+  if (!_started) {
+    _started = true;
+    enterDirectory(_base, nullptr);
+  }
+  struct stat status;
+  while (rc == nullptr && _depth > 0) {
+    Frame &frame = *_frames[_depth - 1];
+    int currentLevel = static_cast<int>(_depth) - 1;
+    DirectoryIndex::RecordView view(frame._record.data());
+    bool counted = false;
+    if (frame._nextEntry < view._record->_entries) {
+      size_t ix = frame._nextEntry++;
+      const IndexEntry &entry = view.entries()[ix];
+      const char *node = view.node(entry);
+      if (S_ISDIR(entry._mode)) {
+        // Like FileAgentLinux: only the path patterns restrict the descent.
+        if (_filter != nullptr && _filter->_pathPatterns != nullptr
+            && !_filter->_pathPatterns->match(node)) {
+          _statistics._ignoredDirectories++;
+        } else {
+          // The directory itself is returned after its content:
+          enterDirectory(frame._path, node);
+        }
+        continue;
+      }
+      if (frame._candidatesOnly) {
+        auto candidates = view.candidates();
+        auto count = view._record->_candidates;
+        while (frame._nextCandidate < count
+            && candidates[frame._nextCandidate] < ix) {
+          frame._nextCandidate++;
+        }
+        if (frame._nextCandidate >= count
+            || candidates[frame._nextCandidate] != ix) {
+          continue;
+        }
+        counted = true;
+      }
+      memset(&status, 0, sizeof status);
+      status.st_mode = entry._mode;
+      status.st_size = entry._size;
+      status.st_mtim.tv_sec = entry._mtimeSeconds;
+      status.st_mtim.tv_nsec = entry._mtimeNanoseconds;
+      status.st_atim = status.st_mtim;
+      _currentEntry.set(frame._path, node, status);
+    } else {
+      // The directory is complete: return it (if it is not the base).
+      _index.put(frame._key, frame._record);
+      if (--_depth == 0) {
+        _index.finishTree(frame._key);
+        break;
+      }
+      Frame &parent = *_frames[_depth - 1];
+      currentLevel = static_cast<int>(_depth) - 1;
+      _currentEntry.set(parent._path, frame._node.c_str(), frame._status);
+    }
+    if (_tracer != nullptr && _tracer->isCountTriggered()
+        && _tracer->isTimeTriggered()) {
+      _tracer->trace(_currentEntry.fullName());
+    }
+    if (_filter == nullptr || _filter->match(_currentEntry, nullptr)) {
+      if (!counted) {
+        if (_currentEntry.isRegular()) {
+          _statistics._files++;
+          _statistics._sizes += _currentEntry.fileSize();
+        } else if (!_currentEntry.isDirectory()) {
+          _statistics._files++;
+        }
+      }
+      _currentEntry._level = currentLevel;
+      level = currentLevel;
+      rc = &_currentEntry;
+    }
+  }
+  return rc;
+}
+
+bool IndexedFileAgent::save() {
+  return _index.save();
+}
+
+bool IndexedFileAgent::scanDirectory(Frame &frame) {
+  bool rc = false;
+  DIR *handle = opendir(frame._key.empty() ? "." : frame._key.c_str());
+  if (handle != nullptr) {
+    int fd = dirfd(handle);
+    std::vector<IndexEntry> entries;
+    std::string nodes;
+    struct dirent *data;
+    struct stat status;
+    IndexEntry entry;
+    memset(&entry, 0, sizeof entry);
+    while ((data = readdir(handle)) != nullptr) {
+      const char *node = data->d_name;
+      if (node[0] == '.'
+          && (node[1] == '\0' || (node[1] == '.' && node[2] == '\0'))) {
+        continue;
+      }
+      if (fstatat(fd, node, &status, AT_SYMLINK_NOFOLLOW) != 0) {
+        _statistics._ignoredFiles++;
+        continue;
+      }
+      entry._size = status.st_size;
+      entry._mtimeSeconds = status.st_mtim.tv_sec;
+      entry._mtimeNanoseconds = static_cast<uint32_t>(status.st_mtim.tv_nsec);
+      entry._mode = status.st_mode;
+      entry._nodeOffset = static_cast<uint32_t>(nodes.size());
+      entries.push_back(entry);
+      nodes.append(node, strlen(node) + 1);
+    }
+    closedir(handle);
+    DirectoryIndex::buildRecord(frame._record, frame._key, frame._status.st_mtim,
+        entries, nodes, _extremaCount);
+    rc = true;
+  }
+  return rc;
+}
+
+void IndexedFileAgent::setCandidatesOnly(size_t extremaCount) {
+  _candidatesOnly = true;
+  _extremaCount = extremaCount;
+}
+
+} /* cppknife */
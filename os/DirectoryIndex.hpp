@@ -0,0 +1,260 @@
+/*
+ * DirectoryIndex.hpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef OS_DIRECTORYINDEX_HPP_
+#define OS_DIRECTORYINDEX_HPP_
+
+namespace cppknife {
+/**
+ * @brief The header of a directory record in a <em>DirectoryIndex</em>.
+ *
+ * Layout of a record (8 byte aligned):
+ * <pre>IndexRecord IndexEntry[_entries] uint32_t[_candidates] path '\0' node1 '\0' node2 '\0' ... padding</pre>
+ */
+struct IndexRecord {
+  /// The modification time of the directory when the record has been built.
+  int64_t _mtimeSeconds;
+  int64_t _mtimeNanoseconds;
+  /// The sum of the sizes of the regular files in the directory (not recursive).
+  int64_t _sizes;
+  /// The count of non directory entries.
+  uint32_t _files;
+  /// The count of all entries.
+  uint32_t _entries;
+  /// The count of the extrema candidates: indexes of the entries sorted ascending.
+  uint32_t _candidates;
+  /// The candidates contain the N largest, youngest and oldest files.
+  uint32_t _extremaCount;
+  uint32_t _pathLength;
+  /// The size of the record in bytes, including the padding.
+  uint32_t _size;
+};
+/**
+ * @brief The info about one entry of a directory in a <em>DirectoryIndex</em>.
+ */
+struct IndexEntry {
+  int64_t _size;
+  int64_t _mtimeSeconds;
+  uint32_t _mtimeNanoseconds;
+  /// The <em>st_mode</em> of the entry: file type and rights.
+  uint32_t _mode;
+  /// The offset of the node behind the path of the record.
+  uint32_t _nodeOffset;
+  uint32_t _reserved;
+};
+/**
+ * @brief A persistent (memory mapped) index of directory trees.
+ *
+ * For each directory the entries (name, type, size, modification time), the aggregates
+ * (file count, sizes) and the extrema candidates are stored. A record is keyed by the
+ * directory path and is valid as long as the modification time of the directory is unchanged.
+ *
+ * Note: changing the content of a file does not change the modification time of the directory:
+ * the sizes and times of the files are as old as the record.
+ */
+class DirectoryIndex {
+public:
+  /**
+   * @brief Access to the parts of a serialized directory record.
+   */
+  class RecordView {
+  public:
+    const IndexRecord *_record;
+  public:
+    RecordView(const char *data) :
+        _record(reinterpret_cast<const IndexRecord*>(data)) {
+    }
+  public:
+    inline const uint32_t* candidates() const {
+      return reinterpret_cast<const uint32_t*>(entries() + _record->_entries);
+    }
+    inline const IndexEntry* entries() const {
+      return reinterpret_cast<const IndexEntry*>(_record + 1);
+    }
+    inline const char* node(const IndexEntry &entry) const {
+      return path() + _record->_pathLength + 1 + entry._nodeOffset;
+    }
+    inline const char* path() const {
+      return reinterpret_cast<const char*>(candidates() + _record->_candidates);
+    }
+  };
+protected:
+  std::string _filename;
+  Logger *_logger;
+  /// The content of the loaded index file (memory mapped).
+  const char *_data;
+  size_t _dataSize;
+  /// The record offsets of the loaded index, sorted by path.
+  const uint64_t *_table;
+  size_t _countRecords;
+  /// The records built or confirmed in this session.
+  std::map<std::string, std::string> _records;
+  /// The trees completely traversed in this session.
+  std::vector<std::string> _completedTrees;
+  bool _changed;
+public:
+  /**
+   * Constructor.
+   * @param filename The name of the index file.
+   * @param logger The logging unit.
+   */
+  DirectoryIndex(const char *filename, Logger *logger);
+  virtual ~DirectoryIndex();
+private:
+  DirectoryIndex(const DirectoryIndex &other);
+  DirectoryIndex&
+  operator=(const DirectoryIndex &other);
+public:
+  /**
+   * Searches a record in the loaded index file.
+   * @param path The directory path.
+   * @return <em>nullptr</em>: not found. Otherwise: the serialized record.
+   */
+  const char* find(const std::string &path) const;
+  /**
+   * Marks a directory tree as completely traversed:
+   * records of the loaded index below that tree not stored again are obsolete.
+   * @param path The base directory of the tree.
+   */
+  void finishTree(const std::string &path);
+  /**
+   * Loads the index file (memory mapped).
+   * @return <em>true</em>: success.
+   */
+  bool load();
+  /**
+   * Stores a record valid for the next session.
+   * @param path The directory path.
+   * @param record The serialized record. Will be moved.
+   */
+  void put(const std::string &path, std::string &record);
+  /**
+   * Writes the index file: the records of this session and the still valid records of the loaded index.
+   * @return <em>true</em>: success.
+   */
+  bool save();
+public:
+  /**
+   * Serializes a directory record.
+   * @param[out] record The serialized record.
+   * @param path The path of the directory.
+   * @param modified The modification time of the directory.
+   * @param entries The entries of the directory. <em>_nodeOffset</em> is relative to <em>nodes</em>.
+   * @param nodes The names of the entries, each terminated by '\0'.
+   * @param extremaCount The count of the stored largest, youngest and oldest files.
+   */
+  static void buildRecord(std::string &record, const std::string &path,
+      const FileTime_t &modified, std::vector<IndexEntry> &entries,
+      const std::string &nodes, size_t extremaCount);
+protected:
+  void unload();
+};
+/**
+ * @brief A <em>FileAgent</em> using a <em>DirectoryIndex</em> as cache.
+ *
+ * Only directories with a changed modification time are read from the filesystem,
+ * the entries of the other directories are taken from the index.
+ * The order of the entries and the filter semantics are the same as in <em>FileAgentLinux</em>.
+ *
+ * In the "candidates only" mode (used for extrema) only the extrema candidates
+ * of a directory are returned, the statistics are taken from the aggregates.
+ */
+class IndexedFileAgent: public FileAgent {
+protected:
+  /**
+   * @brief The info about an open directory.
+   */
+  class Frame {
+  public:
+    /// The path of the directory with trailing separator.
+    std::string _path;
+    /// The key of the directory in the index.
+    std::string _key;
+    /// The node of the directory in its parent directory.
+    std::string _node;
+    struct stat _status;
+    /// The serialized record of the directory.
+    std::string _record;
+    size_t _nextEntry;
+    size_t _nextCandidate;
+    bool _candidatesOnly;
+  };
+  std::string _base;
+  const DirEntryFilter *_filter;
+  TraceUnit *_tracer;
+  Logger *_logger;
+  DirTreeStatistic &_statistics;
+  DirectoryIndex _index;
+  std::vector<Frame*> _frames;
+  /// Count of valid frames in <em>_frames</em>.
+  size_t _depth;
+  ParallelFsEntry _currentEntry;
+  bool _started;
+  size_t _extremaCount;
+  bool _candidatesOnly;
+  size_t _cachedDirectories;
+  size_t _scannedDirectories;
+public:
+  /**
+   * Constructor.
+   *
+   * @param base The base directory. The traversal starts at this point.
+   * @param filter Specifies the search criteria. May be <em>nullptr</em>.
+   * @param tracer <em>nullptr</em> or a handler of trigger points.
+   * @param logger The logging unit.
+   * @param[out] statistics The statistics about files and directories is updated here.
+   * @param indexFile The name of the index file. Will be created if it does not exist.
+   */
+  IndexedFileAgent(const char *base, const DirEntryFilter *filter,
+      TraceUnit *tracer, Logger *logger, DirTreeStatistic &statistics,
+      const char *indexFile);
+  virtual
+  ~IndexedFileAgent();
+private:
+  IndexedFileAgent(const IndexedFileAgent &other);
+  IndexedFileAgent&
+  operator=(const IndexedFileAgent &other);
+public:
+  /**
+   * Returns the count of directories taken from the index.
+   */
+  inline size_t cachedDirectories() const {
+    return _cachedDirectories;
+  }
+  virtual void changeBase(const char *base);
+  inline virtual bool isPrefiltered() const {
+    return true;
+  }
+  virtual FsEntry* rawNextFile(int &level);
+  /**
+   * Writes the index file.
+   * @return <em>true</em>: success.
+   */
+  bool save();
+  /**
+   * Returns the count of directories read from the filesystem.
+   */
+  inline size_t scannedDirectories() const {
+    return _scannedDirectories;
+  }
+  /**
+   * Sets the "candidates only" mode: only the files which can be extrema are returned.
+   * The mode is active only if the filter has no conditions.
+   * @param extremaCount The count of largest/youngest/oldest files needed.
+   */
+  void setCandidatesOnly(size_t extremaCount);
+protected:
+  void closeAll();
+  bool enterDirectory(const std::string &parentPath, const char *node);
+  bool isTrivialFilter() const;
+  bool scanDirectory(Frame &frame);
+};
+
+} /* cppknife */
+
+#endif /* OS_DIRECTORYINDEX_HPP_ */
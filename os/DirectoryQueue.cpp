@@ -0,0 +1,196 @@
+/*
+ * DirectoryQueue.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "os.hpp"
+
+namespace cppknife {
+
+DirectoryQueue::DirectoryQueue(bool depthFirst, size_t memoryBudget,
+    Logger *logger) :
+    _depthFirst(depthFirst), _memoryBudget(
+        memoryBudget == 0 ?
+            static_cast<size_t>(DEFAULT_MEMORY_BUDGET) : memoryBudget), _memory(), _tail(), _memoryUsage(
+        0), _tailUsage(0), _spillFile(nullptr), _fileStart(0), _fileEnd(0), _spilledBlocks(
+        0), _spilledItems(0), _logger(logger) {
+}
+
+DirectoryQueue::~DirectoryQueue() {
+  if (_spillFile != nullptr) {
+    fclose(_spillFile);
+    _spillFile = nullptr;
+  }
+}
+
+void DirectoryQueue::clear() {
+  _memory.clear();
+  _tail.clear();
+  _memoryUsage = _tailUsage = 0;
+  // The spill file is reused:
+  _fileStart = _fileEnd = 0;
+}
+
+bool DirectoryQueue::pop(std::string &path, int &level) {
+  if (_memory.empty()) {
+    if (_fileStart < _fileEnd) {
+      readBlock(_depthFirst);
+    } else if (!_tail.empty()) {
+      _memory.swap(_tail);
+      _tailUsage = 0;
+    }
+  }
+  bool rc = !_memory.empty();
+  if (rc) {
+    Item &item = _depthFirst ? _memory.back() : _memory.front();
+    _memoryUsage -= costOf(item);
+    path = std::move(item._path);
+    level = item._level;
+    if (_depthFirst) {
+      _memory.pop_back();
+    } else {
+      _memory.pop_front();
+    }
+  }
+  return rc;
+}
+
+void DirectoryQueue::push(const std::string &path, int level) {
+  Item item { path, level };
+  size_t cost = costOf(item);
+  _memoryUsage += cost;
+  if (!_depthFirst && (_fileStart < _fileEnd || !_tail.empty())) {
+    // Younger than the spilled entries: they must wait behind them.
+    _tail.push_back(std::move(item));
+    _tailUsage += cost;
+    if (_tailUsage > _memoryBudget / 2 && writeBlock(_tail, 0, _tail.size())) {
+      _tail.clear();
+      _memoryUsage -= _tailUsage;
+      _tailUsage = 0;
+    }
+  } else {
+    _memory.push_back(std::move(item));
+    if (_memoryUsage > _memoryBudget && _memory.size() > 1) {
+      // About the half is spilled: the entries processed last.
+      size_t spilled = 0;
+      size_t count = 0;
+      size_t size = _memory.size();
+      while (count < size - 1 && spilled < _memoryUsage / 2) {
+        spilled += costOf(_memory[_depthFirst ? count : size - 1 - count]);
+        count++;
+      }
+      size_t start = _depthFirst ? 0 : size - count;
+      if (writeBlock(_memory, start, count)) {
+        _memory.erase(_memory.begin() + start,
+            _memory.begin() + start + count);
+        _memoryUsage -= spilled;
+      }
+    }
+  }
+}
+
+bool DirectoryQueue::readBlock(bool fromEnd) {
+  uint64_t size = 0;
+  int64_t offset;
+  bool rc = _spillFile != nullptr;
+  if (rc) {
+    if (fromEnd) {
+      rc = fseeko(_spillFile, _fileEnd - sizeof size, SEEK_SET) == 0
+          && fread(&size, sizeof size, 1, _spillFile) == 1;
+      offset = _fileEnd - sizeof size - size;
+    } else {
+      rc = fseeko(_spillFile, _fileStart, SEEK_SET) == 0
+          && fread(&size, sizeof size, 1, _spillFile) == 1;
+      offset = _fileStart + sizeof size;
+    }
+  }
+  std::string buffer;
+  if (rc) {
+    buffer.resize(size);
+    rc = fseeko(_spillFile, offset, SEEK_SET) == 0
+        && fread(&buffer[0], 1, size, _spillFile) == size;
+  }
+  if (!rc) {
+    if (_logger != nullptr) {
+      _logger->say(LV_ERROR,
+          formatCString("cannot read the directory spill file (%d): %s", errno,
+              strerror(errno)));
+    }
+    _fileStart = _fileEnd = 0;
+  } else {
+    const char *ptr = buffer.c_str();
+    const char *end = ptr + size;
+    int32_t level;
+    uint32_t length;
+    while (ptr + sizeof level + sizeof length <= end) {
+      memcpy(&level, ptr, sizeof level);
+      memcpy(&length, ptr + sizeof level, sizeof length);
+      ptr += sizeof level + sizeof length;
+      _memory.push_back(Item { std::string(ptr, length), level });
+      _memoryUsage += costOf(_memory.back());
+      ptr += length;
+    }
+    if (fromEnd) {
+      _fileEnd = offset - sizeof size;
+    } else {
+      _fileStart = offset + size + sizeof size;
+    }
+    if (_fileStart >= _fileEnd) {
+      // All blocks are read: the file can be reused from the start.
+      _fileStart = _fileEnd = 0;
+    }
+  }
+  return rc;
+}
+
+void DirectoryQueue::setDepthFirst(bool depthFirst) {
+  clear();
+  _depthFirst = depthFirst;
+}
+
+bool DirectoryQueue::writeBlock(std::deque<Item> &items, size_t start,
+    size_t count) {
+  if (_spillFile == nullptr) {
+    _spillFile = tmpfile();
+    if (_spillFile == nullptr && _logger != nullptr) {
+      _logger->say(LV_ERROR,
+          formatCString(
+              "cannot create a directory spill file (%d): %s: memory is used",
+              errno, strerror(errno)));
+    }
+  }
+  bool rc = false;
+  if (_spillFile != nullptr) {
+    std::string buffer;
+    for (size_t ix = start; ix < start + count; ix++) {
+      const Item &item = items[ix];
+      int32_t level = item._level;
+      uint32_t length = static_cast<uint32_t>(item._path.size());
+      buffer.append(reinterpret_cast<const char*>(&level), sizeof level);
+      buffer.append(reinterpret_cast<const char*>(&length), sizeof length);
+      buffer.append(item._path);
+    }
+    uint64_t size = buffer.size();
+    rc = fseeko(_spillFile, _fileEnd, SEEK_SET) == 0
+        && fwrite(&size, sizeof size, 1, _spillFile) == 1
+        && fwrite(buffer.c_str(), 1, size, _spillFile) == size
+        && fwrite(&size, sizeof size, 1, _spillFile) == 1;
+    if (!rc) {
+      if (_logger != nullptr) {
+        _logger->say(LV_ERROR,
+            formatCString("cannot write the directory spill file (%d): %s",
+                errno, strerror(errno)));
+      }
+    } else {
+      _fileEnd += 2 * sizeof size + size;
+      _spilledBlocks++;
+      _spilledItems += count;
+    }
+  }
+  return rc;
+}
+
+} /* cppknife */
@@ -0,0 +1,142 @@
+/*
+ * DirectoryQueue.hpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef OS_DIRECTORYQUEUE_HPP_
+#define OS_DIRECTORYQUEUE_HPP_
+
+namespace cppknife {
+/**
+ * @brief Stores the directories not yet read by a tree traversal with a bounded memory.
+ *
+ * Depth first: the queue is a stack (last in, first out).
+ * Breadth first: the queue is a FIFO (first in, first out).
+ *
+ * If the memory used by the stored paths exceeds the budget, a block of entries
+ * is written into a temporary file (the oldest half of the stack, the newest entries of the FIFO).
+ * The blocks are read again when the entries in memory are used up. The order is not changed by spilling.
+ *
+ * Block format: [uint64 size][records][uint64 size], record: [int32 level][uint32 length][path].
+ */
+class DirectoryQueue {
+public:
+  enum {
+    DEFAULT_MEMORY_BUDGET = 16 * 1024 * 1024
+  };
+  /**
+   * @brief A directory waiting for processing.
+   */
+  struct Item {
+    std::string _path;
+    int _level;
+  };
+protected:
+  bool _depthFirst;
+  size_t _memoryBudget;
+  /// Depth first: the stack, the top at the end. Breadth first: the oldest entries, the next at the front.
+  std::deque<Item> _memory;
+  /// Breadth first only: the newest entries, stored while the spill file contains entries.
+  std::deque<Item> _tail;
+  /// The memory used by <em>_memory</em> and <em>_tail</em> (estimated).
+  size_t _memoryUsage;
+  size_t _tailUsage;
+  /// <em>nullptr</em> or the temporary file with the spilled blocks.
+  FILE *_spillFile;
+  /// The start of the unread blocks (breadth first only).
+  int64_t _fileStart;
+  /// The end of the used area of the spill file.
+  int64_t _fileEnd;
+  size_t _spilledBlocks;
+  size_t _spilledItems;
+  Logger *_logger;
+public:
+  /**
+   * Constructor.
+   * @param depthFirst <em>true</em>: the last stored entry is processed first.
+   * @param memoryBudget The maximal count of bytes used in memory for the entries.
+   * @param logger <em>nullptr</em> or the logger for errors of the spill file.
+   */
+  DirectoryQueue(bool depthFirst = true, size_t memoryBudget =
+      DEFAULT_MEMORY_BUDGET, Logger *logger = nullptr);
+  virtual ~DirectoryQueue();
+private:
+  DirectoryQueue(const DirectoryQueue &other);
+  DirectoryQueue&
+  operator=(const DirectoryQueue &other);
+public:
+  /**
+   * Removes all entries.
+   */
+  void clear();
+  /**
+   * Returns whether the last stored entry is processed first.
+   */
+  inline bool depthFirst() const {
+    return _depthFirst;
+  }
+  /**
+   * Returns whether no entry is stored.
+   */
+  inline bool empty() const {
+    return _memory.empty() && _tail.empty() && _fileStart == _fileEnd;
+  }
+  /**
+   * Returns the memory used by the entries in memory (estimated).
+   */
+  inline size_t memoryUsage() const {
+    return _memoryUsage;
+  }
+  /**
+   * Removes the next entry.
+   * @param[out] path The directory name.
+   * @param[out] level The depth of the directory in the tree.
+   * @return <em>false</em>: the queue is empty.
+   */
+  bool pop(std::string &path, int &level);
+  /**
+   * Stores an entry.
+   * @param path The directory name.
+   * @param level The depth of the directory in the tree.
+   */
+  void push(const std::string &path, int level);
+  /**
+   * Sets the processing order. Removes all entries.
+   * @param depthFirst <em>true</em>: the last stored entry is processed first.
+   */
+  void setDepthFirst(bool depthFirst);
+  /**
+   * Sets the maximal memory used for the entries.
+   * @param memoryBudget The count of bytes. 0: <em>DEFAULT_MEMORY_BUDGET</em>.
+   */
+  inline void setMemoryBudget(size_t memoryBudget) {
+    _memoryBudget =
+        memoryBudget == 0 ?
+            static_cast<size_t>(DEFAULT_MEMORY_BUDGET) : memoryBudget;
+  }
+  /**
+   * Returns the count of blocks written into the spill file.
+   */
+  inline size_t spilledBlocks() const {
+    return _spilledBlocks;
+  }
+  /**
+   * Returns the count of entries written into the spill file.
+   */
+  inline size_t spilledItems() const {
+    return _spilledItems;
+  }
+protected:
+  static inline size_t costOf(const Item &item) {
+    return sizeof(Item) + item._path.size();
+  }
+  bool readBlock(bool fromEnd);
+  bool writeBlock(std::deque<Item> &items, size_t start, size_t count);
+};
+
+} /* cppknife */
+
+#endif /* OS_DIRECTORYQUEUE_HPP_ */
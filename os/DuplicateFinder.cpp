@@ -0,0 +1,370 @@
+/*
+ * DuplicateFinder.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "os.hpp"
+
+namespace cppknife {
+
+static const uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+static const uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rotateLeft(uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+static inline uint64_t read64(const char *data) {
+  uint64_t rc;
+  memcpy(&rc, data, sizeof rc);
+  return rc;
+}
+static inline uint64_t mixRound(uint64_t accumulator, uint64_t input) {
+  accumulator += input * PRIME2;
+  return rotateLeft(accumulator, 31) * PRIME1;
+}
+static inline uint64_t mergeRound(uint64_t accumulator, uint64_t value) {
+  accumulator ^= mixRound(0, value);
+  return accumulator * PRIME1 + PRIME4;
+}
+
+DuplicateFinder::DuplicateFinder(Logger *logger, int threads) :
+    _logger(logger), _threads(
+        threads <= 0 ? ThreadPool::defaultThreadCount() : threads), _names(), _candidates(), _sizeGroups(), _pool(
+        nullptr), _readBuffers(), _outputMutex(), _handler(), _groups(0), _duplicates(
+        0), _wastedBytes(0), _hashedBytes(0), _comparedBytes(0), _errors(0) {
+}
+
+DuplicateFinder::~DuplicateFinder() {
+  for (auto group : _sizeGroups) {
+    delete group;
+  }
+  _sizeGroups.clear();
+  for (auto buffer : _readBuffers) {
+    free(buffer);
+  }
+  _readBuffers.clear();
+  delete _pool;
+  _pool = nullptr;
+}
+
+void DuplicateFinder::add(const char *name, FileSize_t size) {
+  if (size > 0) {
+    size_t length = strlen(name);
+    char *copy = _names.allocate(length);
+    if (copy != nullptr) {
+      memcpy(copy, name, length);
+      _candidates.push_back(Candidate { copy, size, 0, true });
+    }
+  }
+}
+
+size_t DuplicateFinder::find(GroupHandler_t handler) {
+  _handler = handler;
+  // Stage 1: the size. The largest files first: they are the most interesting.
+  std::sort(_candidates.begin(), _candidates.end(),
+      [](const Candidate &candidate1, const Candidate &candidate2) {
+        return candidate1._size > candidate2._size;
+      });
+  size_t start = 0;
+  while (start < _candidates.size()) {
+    size_t end = start + 1;
+    while (end < _candidates.size()
+        && _candidates[end]._size == _candidates[start]._size) {
+      end++;
+    }
+    if (end - start > 1) {
+      auto group = new SizeGroup();
+      group->_first = start;
+      group->_count = end - start;
+      group->_pending = 0;
+      _sizeGroups.push_back(group);
+    }
+    start = end;
+  }
+  if (_threads > 1 && !_sizeGroups.empty()) {
+    _pool = new ThreadPool(_threads);
+  }
+  int buffers = 2 * (_pool == nullptr ? 1 : _pool->countThreads());
+  for (int ix = static_cast<int>(_readBuffers.size()); ix < buffers; ix++) {
+    _readBuffers.push_back(
+        static_cast<char*>(aligned_alloc(4096, BLOCK_SIZE)));
+  }
+  // Stage 2: the partial hash.
+  for (auto group : _sizeGroups) {
+    group->_pending = group->_count;
+    for (size_t ix = 0; ix < group->_count; ix++) {
+      Candidate *candidate = &_candidates[group->_first + ix];
+      submit([this, group, candidate] {
+        hashFile(*candidate, true);
+        if (--group->_pending == 0) {
+          finishPartialStage(*group);
+        }
+      });
+    }
+  }
+  if (_pool != nullptr) {
+    _pool->waitIdle();
+  }
+  return _groups;
+}
+
+void DuplicateFinder::finishPartialStage(SizeGroup &group) {
+  if (_candidates[group._first]._size <= 2 * PARTIAL_SIZE) {
+    // The whole content has been hashed:
+    report(group);
+  } else {
+    auto begin = _candidates.begin() + group._first;
+    auto end = begin + group._count;
+    std::sort(begin, end,
+        [](const Candidate &candidate1, const Candidate &candidate2) {
+          return candidate1._valid != candidate2._valid ?
+              candidate1._valid : candidate1._hash < candidate2._hash;
+        });
+    // Only the files with the same partial hash as another file are hashed completely:
+    std::vector<Candidate*> toHash;
+    for (auto current = begin; current != end && current->_valid; ++current) {
+      if ((current != begin && (current - 1)->_hash == current->_hash)
+          || (current + 1 != end && (current + 1)->_valid
+              && (current + 1)->_hash == current->_hash)) {
+        toHash.push_back(&*current);
+      } else {
+        current->_valid = false;
+      }
+    }
+    if (!toHash.empty()) {
+      SizeGroup *group2 = &group;
+      group._pending = toHash.size();
+      for (auto candidate : toHash) {
+        submit([this, group2, candidate] {
+          hashFile(*candidate, false);
+          if (--group2->_pending == 0) {
+            report(*group2);
+          }
+        });
+      }
+    }
+  }
+}
+
+uint64_t DuplicateFinder::hashBlock(const char *data, size_t length,
+    uint64_t seed) {
+  const char *end = data + length;
+  uint64_t rc;
+  if (length >= 32) {
+    const char *limit = end - 32;
+    uint64_t value1 = seed + PRIME1 + PRIME2;
+    uint64_t value2 = seed + PRIME2;
+    uint64_t value3 = seed;
+    uint64_t value4 = seed - PRIME1;
+    do {
+      value1 = mixRound(value1, read64(data));
+      value2 = mixRound(value2, read64(data + 8));
+      value3 = mixRound(value3, read64(data + 16));
+      value4 = mixRound(value4, read64(data + 24));
+      data += 32;
+    } while (data <= limit);
+    rc = rotateLeft(value1, 1) + rotateLeft(value2, 7)
+        + rotateLeft(value3, 12) + rotateLeft(value4, 18);
+    rc = mergeRound(rc, value1);
+    rc = mergeRound(rc, value2);
+    rc = mergeRound(rc, value3);
+    rc = mergeRound(rc, value4);
+  } else {
+    rc = seed + PRIME5;
+  }
+  rc += length;
+  while (data + 8 <= end) {
+    rc ^= mixRound(0, read64(data));
+    rc = rotateLeft(rc, 27) * PRIME1 + PRIME4;
+    data += 8;
+  }
+  while (data < end) {
+    rc ^= static_cast<unsigned char>(*data++) * PRIME5;
+    rc = rotateLeft(rc, 11) * PRIME1;
+  }
+  rc ^= rc >> 33;
+  rc *= PRIME2;
+  rc ^= rc >> 29;
+  rc *= PRIME3;
+  rc ^= rc >> 32;
+  return rc;
+}
+
+bool DuplicateFinder::hashFile(Candidate &candidate, bool partial) {
+  int worker = _pool == nullptr ? 0 : _pool->currentWorker();
+  char *buffer = _readBuffers[worker < 0 ? 0 : 2 * worker];
+  int handle = open(candidate._name, O_RDONLY | O_CLOEXEC);
+  bool rc = handle >= 0;
+  // Saved before close() may change errno:
+  int error = rc ? 0 : errno;
+  if (rc) {
+    uint64_t hash = static_cast<uint64_t>(candidate._size);
+    FileSize_t total = 0;
+    if (partial && candidate._size > 2 * PARTIAL_SIZE) {
+      // The first and the last block:
+      FileSize_t offsets[] = { 0, candidate._size - PARTIAL_SIZE };
+      for (auto offset : offsets) {
+        ssize_t bytes = pread(handle, buffer, PARTIAL_SIZE, offset);
+        if (bytes != PARTIAL_SIZE) {
+          error = bytes < 0 ? errno : 0;
+          rc = false;
+          break;
+        }
+        hash = hashBlock(buffer, bytes, hash);
+        total += bytes;
+      }
+    } else {
+      posix_fadvise(handle, 0, 0, POSIX_FADV_SEQUENTIAL);
+      ssize_t bytes = 0;
+      do {
+        // A block is filled completely (except at the end): the hash is independent of short reads.
+        size_t filled = 0;
+        while (filled < BLOCK_SIZE
+            && (bytes = read(handle, buffer + filled, BLOCK_SIZE - filled))
+                > 0) {
+          filled += bytes;
+        }
+        if (bytes < 0) {
+          error = errno;
+        }
+        if (filled > 0) {
+          hash = hashBlock(buffer, filled, hash);
+          total += filled;
+        }
+      } while (bytes > 0);
+      // A changed file cannot be compared:
+      rc = bytes == 0 && total == candidate._size;
+    }
+    close(handle);
+    _hashedBytes += total;
+    candidate._hash = hash;
+  }
+  if (!rc) {
+    candidate._valid = false;
+    _errors++;
+    if (_logger != nullptr) {
+      std::lock_guard<std::mutex> guard(_outputMutex);
+      _logger->say(LV_ERROR,
+          error == 0 ?
+              formatCString("changed while reading: %s", candidate._name) :
+              formatCString("cannot read %s (%d): %s", candidate._name,
+                  error, strerror(error)));
+    }
+  }
+  return rc;
+}
+
+void DuplicateFinder::report(SizeGroup &group) {
+  auto begin = _candidates.begin() + group._first;
+  auto end = begin + group._count;
+  std::sort(begin, end,
+      [](const Candidate &candidate1, const Candidate &candidate2) {
+        bool rc;
+        if (candidate1._valid != candidate2._valid) {
+          rc = candidate1._valid;
+        } else if (candidate1._hash != candidate2._hash) {
+          rc = candidate1._hash < candidate2._hash;
+        } else {
+          rc = strcmp(candidate1._name, candidate2._name) < 0;
+        }
+        return rc;
+      });
+  Group found;
+  found._size = begin->_size;
+  auto current = begin;
+  while (current != end && current->_valid) {
+    auto last = current + 1;
+    while (last != end && last->_valid && last->_hash == current->_hash) {
+      last++;
+    }
+    // The same hash: the content decides. Usually all files are identical.
+    std::vector<const Candidate*> rest;
+    for (auto item = current; item != last; ++item) {
+      rest.push_back(&*item);
+    }
+    while (rest.size() > 1) {
+      std::vector<const Candidate*> others;
+      found._files.clear();
+      found._files.push_back(rest[0]->_name);
+      for (size_t ix = 1; ix < rest.size(); ix++) {
+        if (sameContent(*rest[0], *rest[ix])) {
+          found._files.push_back(rest[ix]->_name);
+        } else {
+          others.push_back(rest[ix]);
+        }
+      }
+      if (found._files.size() > 1) {
+        _groups++;
+        _duplicates += found._files.size() - 1;
+        _wastedBytes += found._size * (found._files.size() - 1);
+        std::lock_guard<std::mutex> guard(_outputMutex);
+        if (_handler) {
+          _handler(found);
+        }
+      }
+      rest.swap(others);
+    }
+    current = last;
+  }
+}
+
+bool DuplicateFinder::sameContent(const Candidate &candidate1,
+    const Candidate &candidate2) {
+  int worker = _pool == nullptr ? 0 : _pool->currentWorker();
+  char *buffer1 = _readBuffers[worker < 0 ? 0 : 2 * worker];
+  char *buffer2 = _readBuffers[worker < 0 ? 1 : 2 * worker + 1];
+  int handle1 = open(candidate1._name, O_RDONLY | O_CLOEXEC);
+  int handle2 = handle1 < 0 ? -1 : open(candidate2._name, O_RDONLY | O_CLOEXEC);
+  bool rc = handle1 >= 0 && handle2 >= 0;
+  int error = rc ? 0 : errno;
+  FileSize_t position = 0;
+  while (rc && position < candidate1._size) {
+    size_t length = std::min(static_cast<FileSize_t>(BLOCK_SIZE),
+        candidate1._size - position);
+    ssize_t bytes1 = pread(handle1, buffer1, length, position);
+    ssize_t bytes2 = bytes1 < 0 ? 0 : pread(handle2, buffer2, length, position);
+    if (bytes1 < 0 || bytes2 < 0) {
+      error = errno;
+      rc = false;
+    } else {
+      // A shorter file has been changed: not equal.
+      rc = static_cast<size_t>(bytes1) == length
+          && static_cast<size_t>(bytes2) == length
+          && memcmp(buffer1, buffer2, length) == 0;
+      _comparedBytes += bytes1 + bytes2;
+    }
+    position += length;
+  }
+  if (handle1 >= 0) {
+    close(handle1);
+  }
+  if (handle2 >= 0) {
+    close(handle2);
+  }
+  if (error != 0) {
+    _errors++;
+    if (_logger != nullptr) {
+      std::lock_guard<std::mutex> guard(_outputMutex);
+      _logger->say(LV_ERROR,
+          formatCString("cannot compare %s with %s (%d): %s", candidate1._name,
+              candidate2._name, error, strerror(error)));
+    }
+  }
+  return rc;
+}
+
+void DuplicateFinder::submit(ThreadPool::Task_t task) {
+  if (_pool == nullptr) {
+    task();
+  } else {
+    _pool->submit(task);
+  }
+}
+
+} /* cppknife */
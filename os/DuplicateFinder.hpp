@@ -0,0 +1,168 @@
+/*
+ * DuplicateFinder.hpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef OS_DUPLICATEFINDER_HPP_
+#define OS_DUPLICATEFINDER_HPP_
+
+namespace cppknife {
+/**
+ * @brief Finds files with identical content.
+ *
+ * The candidates are collected with <em>add()</em>, e.g. from a <em>Traverser</em>.
+ * <em>find()</em> checks them in three stages, each stage only for the files
+ * not yet distinguished by the previous one:
+ * <ol><li>the file size</li>
+ * <li>a hash of the first and the last <em>PARTIAL_SIZE</em> bytes</li>
+ * <li>a hash of the whole content</li></ol>
+ * Files not larger than 2 * <em>PARTIAL_SIZE</em> are hashed completely in the second stage.
+ *
+ * The hashes are computed by a <em>ThreadPool</em> with large aligned reads.
+ * A group of duplicates is reported as soon as all files of its size are hashed:
+ * the groups are streamed. The hashing starts with the largest files.
+ *
+ * The hash is a 64 bit hash (similar to xxHash64) of the blocks of <em>BLOCK_SIZE</em> bytes,
+ * chained by the seed. It only selects the candidates: before a group is reported
+ * the content of its files is compared byte by byte, so a hash collision cannot
+ * produce a wrong group.
+ */
+class DuplicateFinder {
+public:
+  enum {
+    /// The count of bytes hashed at the start and at the end of a file in the second stage.
+    PARTIAL_SIZE = 64 * 1024,
+    /// The size of one read operation (and of the read buffers).
+    BLOCK_SIZE = 1024 * 1024
+  };
+  /**
+   * @brief A group of files with identical content.
+   */
+  struct Group {
+    FileSize_t _size;
+    std::vector<const char*> _files;
+  };
+  /// Handles a found group. Called by only one thread at a time.
+  typedef std::function<void(const Group &group)> GroupHandler_t;
+protected:
+  /**
+   * @brief A candidate: a file with a size shared by other files.
+   */
+  struct Candidate {
+    const char *_name;
+    FileSize_t _size;
+    uint64_t _hash;
+    bool _valid;
+  };
+  /**
+   * @brief The candidates with the same file size.
+   */
+  struct SizeGroup {
+    /// The index of the first candidate in <em>_candidates</em>.
+    size_t _first;
+    size_t _count;
+    /// The count of hash tasks not yet finished.
+    std::atomic<size_t> _pending;
+  };
+protected:
+  Logger *_logger;
+  int _threads;
+  /// The names of the files: not freed until the destruction.
+  ByteStorage _names;
+  std::vector<Candidate> _candidates;
+  std::vector<SizeGroup*> _sizeGroups;
+  ThreadPool *_pool;
+  /// Two read buffers per thread, aligned to a memory page. The second one is used by the comparison.
+  std::vector<char*> _readBuffers;
+  std::mutex _outputMutex;
+  GroupHandler_t _handler;
+  std::atomic<size_t> _groups;
+  std::atomic<size_t> _duplicates;
+  std::atomic<int64_t> _wastedBytes;
+  std::atomic<size_t> _hashedBytes;
+  std::atomic<size_t> _comparedBytes;
+  std::atomic<size_t> _errors;
+public:
+  /**
+   * Constructor.
+   * @param logger The logger for error messages. May be <em>nullptr</em>.
+   * @param threads The count of hashing threads. &lt;= 0: the count of CPU cores.
+   */
+  DuplicateFinder(Logger *logger, int threads = 1);
+  virtual ~DuplicateFinder();
+private:
+  DuplicateFinder(const DuplicateFinder &other);
+  DuplicateFinder&
+  operator=(const DuplicateFinder &other);
+public:
+  /**
+   * Stores a candidate.
+   * @param name The filename. Must be usable from all threads (absolute or independent of a changing current directory).
+   * @param size The file size. Empty files are ignored.
+   */
+  void add(const char *name, FileSize_t size);
+  /**
+   * Returns the count of bytes read for the byte by byte comparison.
+   */
+  inline size_t comparedBytes() const {
+    return _comparedBytes;
+  }
+  /**
+   * Returns the count of files found as duplicates (without the first file of each group).
+   */
+  inline size_t duplicates() const {
+    return _duplicates;
+  }
+  /**
+   * Returns the count of files that could not be read.
+   */
+  inline size_t errors() const {
+    return _errors;
+  }
+  /**
+   * Checks the candidates and reports the groups of identical files.
+   * @param handler Called for each group of identical files.
+   * @return The count of groups.
+   */
+  size_t find(GroupHandler_t handler);
+  /**
+   * Returns the count of found groups.
+   */
+  inline size_t groups() const {
+    return _groups;
+  }
+  /**
+   * Returns the count of bytes read for the hashes.
+   */
+  inline size_t hashedBytes() const {
+    return _hashedBytes;
+  }
+  /**
+   * Returns the count of bytes used by the duplicates (without the first file of each group).
+   */
+  inline int64_t wastedBytes() const {
+    return _wastedBytes;
+  }
+public:
+  /**
+   * Computes the hash of a memory block.
+   * @param data The block to hash.
+   * @param length The length of <em>data</em>.
+   * @param seed The start value, e.g. the hash of the previous block.
+   * @return The hash value.
+   */
+  static uint64_t hashBlock(const char *data, size_t length, uint64_t seed);
+protected:
+  void finishPartialStage(SizeGroup &group);
+  virtual bool hashFile(Candidate &candidate, bool partial);
+  void report(SizeGroup &group);
+  bool sameContent(const Candidate &candidate1, const Candidate &candidate2);
+  void submit(ThreadPool::Task_t task);
+};
+
+} /* cppknife */
+
+#endif /* OS_DUPLICATEFINDER_HPP_ */
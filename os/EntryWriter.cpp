@@ -0,0 +1,259 @@
+/*
+ * EntryWriter.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "os.hpp"
+#include <charconv>
+
+namespace cppknife {
+
+const char *BinaryEntryWriter::MAGIC = "CKLIST01";
+static const size_t MAGIC_LENGTH = 8;
+
+/**
+ * Returns the type of an entry as a character for the machine readable formats.
+ */
+static char typeCharOf(FsEntry &entry) {
+  char rc = 'o';
+  switch (entry.type()) {
+  case FsEntry::TF_REGULAR:
+    rc = 'f';
+    break;
+  case FsEntry::TF_SUBDIR:
+    rc = 'd';
+    break;
+  case FsEntry::TF_LINK:
+  case FsEntry::TF_LINK_DIR:
+    rc = 'l';
+    break;
+  case FsEntry::TF_BLOCK:
+    rc = 'b';
+    break;
+  case FsEntry::TF_CHAR:
+    rc = 'c';
+    break;
+  case FsEntry::TF_PIPE:
+    rc = 'p';
+    break;
+  case FsEntry::TF_SOCKET:
+    rc = 's';
+    break;
+  default:
+    break;
+  }
+  return rc;
+}
+
+EntryWriter::EntryWriter(FILE *output, size_t bufferSize) :
+    _output(output), _bufferSize(bufferSize == 0 ? DEFAULT_BUFFER_SIZE : bufferSize), _entries(
+        0), _error(false) {
+}
+
+EntryWriter::~EntryWriter() {
+}
+
+void EntryWriter::writeData(const void *data, size_t size) {
+  if (!_error && size > 0 && fwrite(data, 1, size, _output) != size) {
+    _error = true;
+  }
+}
+
+NdjsonEntryWriter::NdjsonEntryWriter(FILE *output, size_t bufferSize) :
+    EntryWriter(output, bufferSize), _buffer() {
+  // Space for the last entry exceeding the chunk size:
+  _buffer.reserve(_bufferSize + 2 * PATH_MAX);
+}
+
+NdjsonEntryWriter::~NdjsonEntryWriter() {
+  flush();
+}
+
+void NdjsonEntryWriter::appendNumber(int64_t value) {
+  char buffer[32];
+  auto result = std::to_chars(buffer, buffer + sizeof buffer, value);
+  _buffer.append(buffer, result.ptr - buffer);
+}
+
+/**
+ * Appends a string as JSON string constant (with quotes).
+ */
+void NdjsonEntryWriter::appendString(const char *string) {
+  static const char *hexDigits = "0123456789abcdef";
+  _buffer += '"';
+  const char *start = string;
+  unsigned char cc;
+  for (; (cc = *string) != '\0'; string++) {
+    if (cc >= ' ' && cc != '"' && cc != '\\') {
+      continue;
+    }
+    _buffer.append(start, string - start);
+    start = string + 1;
+    switch (cc) {
+    case '"':
+      _buffer += "\\\"";
+      break;
+    case '\\':
+      _buffer += "\\\\";
+      break;
+    case '\n':
+      _buffer += "\\n";
+      break;
+    case '\t':
+      _buffer += "\\t";
+      break;
+    default:
+      _buffer += "\\u00";
+      _buffer += hexDigits[cc >> 4];
+      _buffer += hexDigits[cc & 0xf];
+      break;
+    }
+  }
+  _buffer.append(start, string - start);
+  _buffer += '"';
+}
+
+void NdjsonEntryWriter::flush() {
+  writeData(_buffer.c_str(), _buffer.size());
+  _buffer.clear();
+  if (!_error && fflush(_output) != 0) {
+    _error = true;
+  }
+}
+
+void NdjsonEntryWriter::write(FsEntry &entry, int level) {
+  uint32_t mode = 0;
+  uint32_t owner = 0;
+  uint32_t group = 0;
+  entry.modeAndOwner(mode, owner, group);
+  char type = typeCharOf(entry);
+  _buffer += "{\"path\":";
+  appendString(entry.fullName());
+  _buffer += ",\"type\":\"";
+  _buffer += type;
+  _buffer += "\",\"size\":";
+  appendNumber(type == 'd' ? 0 : entry.fileSize());
+  _buffer += ",\"mtime\":";
+  appendNumber(entry.modified()->tv_sec);
+  _buffer += ",\"mode\":";
+  appendNumber(mode);
+  _buffer += ",\"uid\":";
+  appendNumber(owner);
+  _buffer += ",\"gid\":";
+  appendNumber(group);
+  _buffer += ",\"level\":";
+  appendNumber(level);
+  if (type == 'l') {
+    _buffer += ",\"link\":";
+    appendString(entry.linkTarget());
+  }
+  _buffer += "}\n";
+  _entries++;
+  if (_buffer.size() >= _bufferSize) {
+    // No fflush(): the data is given to the kernel in one chunk.
+    writeData(_buffer.c_str(), _buffer.size());
+    _buffer.clear();
+  }
+}
+
+BinaryEntryWriter::BinaryEntryWriter(FILE *output, size_t bufferSize) :
+    EntryWriter(output, bufferSize), _records(), _names(), _headerWritten(
+        false) {
+  // The offsets in the names area have 32 bit:
+  _bufferSize = std::min(_bufferSize, static_cast<size_t>(0x40000000));
+  _records.reserve(_bufferSize / sizeof(Record) / 2);
+  _names.reserve(_bufferSize);
+}
+
+BinaryEntryWriter::~BinaryEntryWriter() {
+  flush();
+}
+
+void BinaryEntryWriter::flush() {
+  if (!_headerWritten) {
+    _headerWritten = true;
+    writeData(MAGIC, MAGIC_LENGTH);
+  }
+  if (!_records.empty()) {
+    uint32_t header[2] = { static_cast<uint32_t>(_records.size()),
+        static_cast<uint32_t>(_names.size()) };
+    writeData(header, sizeof header);
+    writeData(_records.data(), _records.size() * sizeof(Record));
+    writeData(_names.c_str(), _names.size());
+    _records.clear();
+    _names.clear();
+  }
+  if (!_error && fflush(_output) != 0) {
+    _error = true;
+  }
+}
+
+void BinaryEntryWriter::write(FsEntry &entry, int level) {
+  Record record;
+  record._pathOffset = static_cast<uint32_t>(_names.size());
+  record._pathLength = static_cast<uint32_t>(entry.fullNameLength());
+  record._size = entry.isDirectory() ? 0 : entry.fileSize();
+  record._modified = entry.modified()->tv_sec;
+  record._mode = record._uid = record._gid = 0;
+  entry.modeAndOwner(record._mode, record._uid, record._gid);
+  record._level = level;
+  _names.append(entry.fullName(), record._pathLength);
+  _records.push_back(record);
+  _entries++;
+  if (_records.size() * sizeof(Record) + _names.size() >= _bufferSize) {
+    flush();
+  }
+}
+
+BinaryEntryReader::BinaryEntryReader(FILE *input) :
+    _input(input), _records(), _names(), _nextRecord(0), _started(false), _error(
+        false) {
+}
+
+BinaryEntryReader::~BinaryEntryReader() {
+}
+
+bool BinaryEntryReader::next(BinaryEntryWriter::Record &record,
+    std::string &path) {
+  if (!_started) {
+    _started = true;
+    char magic[MAGIC_LENGTH];
+    _error = fread(magic, 1, MAGIC_LENGTH, _input) != MAGIC_LENGTH
+        || memcmp(magic, BinaryEntryWriter::MAGIC, MAGIC_LENGTH) != 0;
+  }
+  bool rc = false;
+  if (!_error && (_nextRecord < _records.size() || readBlock())) {
+    record = _records[_nextRecord++];
+    rc = static_cast<size_t>(record._pathOffset) + record._pathLength
+        <= _names.size();
+    if (!rc) {
+      _error = true;
+    } else {
+      path.assign(_names, record._pathOffset, record._pathLength);
+    }
+  }
+  return rc;
+}
+
+bool BinaryEntryReader::readBlock() {
+  uint32_t header[2];
+  _records.clear();
+  _names.clear();
+  _nextRecord = 0;
+  bool rc = fread(header, sizeof header, 1, _input) == 1;
+  // 0 records is never written:
+  if (rc && header[0] > 0) {
+    _records.resize(header[0]);
+    _names.resize(header[1]);
+    rc = fread(_records.data(), sizeof(BinaryEntryWriter::Record), header[0],
+        _input) == header[0]
+        && fread(&_names[0], 1, header[1], _input) == header[1];
+    _error = !rc;
+  }
+  return rc && !_records.empty();
+}
+
+} /* cppknife */
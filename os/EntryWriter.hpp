@@ -0,0 +1,180 @@
+/*
+ * EntryWriter.hpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef OS_ENTRYWRITER_HPP_
+#define OS_ENTRYWRITER_HPP_
+
+namespace cppknife {
+/**
+ * @brief Writes the data of directory entries in a machine readable format.
+ *
+ * The output is collected in a large buffer and written in big chunks:
+ * there is no flush and no formatting via the logger per entry.
+ */
+class EntryWriter {
+public:
+  enum {
+    DEFAULT_BUFFER_SIZE = 1024 * 1024
+  };
+protected:
+  FILE *_output;
+  size_t _bufferSize;
+  size_t _entries;
+  /// <em>true</em>: a write error has occurred.
+  bool _error;
+public:
+  /**
+   * Constructor.
+   * @param output The target file, e.g. <em>stdout</em>. Not closed by the instance.
+   * @param bufferSize The size of the output chunks.
+   */
+  EntryWriter(FILE *output, size_t bufferSize = DEFAULT_BUFFER_SIZE);
+  virtual ~EntryWriter();
+private:
+  EntryWriter(const EntryWriter &other);
+  EntryWriter&
+  operator=(const EntryWriter &other);
+public:
+  /**
+   * Returns the count of written entries.
+   */
+  inline size_t entries() const {
+    return _entries;
+  }
+  /**
+   * Returns whether a write error has occurred.
+   */
+  inline bool error() const {
+    return _error;
+  }
+  /**
+   * Writes the buffered data into the output file.
+   */
+  virtual void flush() = 0;
+  /**
+   * Stores the data of an entry.
+   * @param entry The entry to write.
+   * @param level The depth in the directory tree: 0 means in the base directory.
+   */
+  virtual void write(FsEntry &entry, int level) = 0;
+protected:
+  void writeData(const void *data, size_t size);
+};
+/**
+ * @brief Writes one JSON object per entry and line (NDJSON).
+ *
+ * Example: <pre>{"path":"/home/x.txt","type":"f","size":1234,"mtime":1697444000,"mode":33188,"uid":1000,"gid":1000,"level":0}</pre>
+ * Types: f(ile) d(irectory) l(ink) b(lock) c(har) p(ipe) s(ocket) o(ther).
+ * Symbolic links have an additional member "link" with the target.
+ * Bytes &gt;= 0x80 are written unchanged: a filename with invalid UTF-8 gives invalid JSON.
+ */
+class NdjsonEntryWriter: public EntryWriter {
+protected:
+  /// Reserved once with the chunk size: no allocation per entry.
+  std::string _buffer;
+public:
+  NdjsonEntryWriter(FILE *output, size_t bufferSize = DEFAULT_BUFFER_SIZE);
+  virtual ~NdjsonEntryWriter();
+private:
+  NdjsonEntryWriter(const NdjsonEntryWriter &other);
+  NdjsonEntryWriter&
+  operator=(const NdjsonEntryWriter &other);
+public:
+  virtual void flush();
+  virtual void write(FsEntry &entry, int level);
+protected:
+  void appendNumber(int64_t value);
+  void appendString(const char *string);
+};
+/**
+ * @brief Writes the entries as fixed-width binary records.
+ *
+ * Format: <pre>"CKLIST01" { block }*
+ * block: [uint32 recordCount][uint32 namesSize] record{recordCount} names</pre>
+ * The names are the full paths without a terminating '\\0', stored in the names area of the block.
+ * All numbers are stored in the byte order of the host.
+ * A record (40 bytes) can be located without parsing the names: see <em>Record</em>.
+ */
+class BinaryEntryWriter: public EntryWriter {
+public:
+  /**
+   * @brief A fixed-width record of the binary format.
+   */
+  struct Record {
+    /// The offset of the path in the names area of the block.
+    uint32_t _pathOffset;
+    uint32_t _pathLength;
+    int64_t _size;
+    /// The modification time in seconds since the epoch.
+    int64_t _modified;
+    /// The st_mode value: file type and rights.
+    uint32_t _mode;
+    uint32_t _uid;
+    uint32_t _gid;
+    int32_t _level;
+  };
+  static const char *MAGIC;
+protected:
+  std::vector<Record> _records;
+  std::string _names;
+  bool _headerWritten;
+public:
+  BinaryEntryWriter(FILE *output, size_t bufferSize = DEFAULT_BUFFER_SIZE);
+  virtual ~BinaryEntryWriter();
+private:
+  BinaryEntryWriter(const BinaryEntryWriter &other);
+  BinaryEntryWriter&
+  operator=(const BinaryEntryWriter &other);
+public:
+  virtual void flush();
+  virtual void write(FsEntry &entry, int level);
+};
+/**
+ * @brief Reads the files written by <em>BinaryEntryWriter</em>.
+ */
+class BinaryEntryReader {
+protected:
+  FILE *_input;
+  std::vector<BinaryEntryWriter::Record> _records;
+  std::string _names;
+  size_t _nextRecord;
+  bool _started;
+  /// <em>true</em>: the input is not in the binary format or truncated.
+  bool _error;
+public:
+  /**
+   * Constructor.
+   * @param input The file to read. Not closed by the instance.
+   */
+  BinaryEntryReader(FILE *input);
+  virtual ~BinaryEntryReader();
+private:
+  BinaryEntryReader(const BinaryEntryReader &other);
+  BinaryEntryReader&
+  operator=(const BinaryEntryReader &other);
+public:
+  /**
+   * Returns whether the input is not in the binary format or truncated.
+   */
+  inline bool error() const {
+    return _error;
+  }
+  /**
+   * Returns the next entry.
+   * @param[out] record The data of the entry.
+   * @param[out] path The full name of the entry.
+   * @return <em>false</em>: no more entries.
+   */
+  bool next(BinaryEntryWriter::Record &record, std::string &path);
+protected:
+  bool readBlock();
+};
+
+} /* cppknife */
+
+#endif /* OS_ENTRYWRITER_HPP_ */
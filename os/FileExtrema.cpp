@@ -0,0 +1,119 @@
+/*
+ * FileExtrema.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "os.hpp"
+
+namespace cppknife {
+
+ExtremaHeap::ExtremaHeap(size_t maxCount, bool smallest,
+    const std::string &pool) :
+    _records(), _maxCount(maxCount), _smallest(smallest), _pool(pool) {
+  _records.reserve(maxCount);
+}
+
+void ExtremaHeap::add(int64_t key, size_t path) {
+  const char *pool = _pool.c_str();
+  // The root of the heap is the least extreme record:
+  auto compare = [this, pool](const Record &record1, const Record &record2) {
+    return isMoreExtreme(record1._key, pool + record1._path, record2._key,
+        pool + record2._path);
+  };
+  if (_records.size() >= _maxCount) {
+    std::pop_heap(_records.begin(), _records.end(), compare);
+    _records.pop_back();
+  }
+  _records.push_back(Record { key, path });
+  std::push_heap(_records.begin(), _records.end(), compare);
+}
+
+std::vector<ExtremaHeap::Record> ExtremaHeap::sorted() const {
+  std::vector<Record> rc(_records);
+  const char *pool = _pool.c_str();
+  std::sort(rc.begin(), rc.end(),
+      [this, pool](const Record &record1, const Record &record2) {
+        return isMoreExtreme(record2._key, pool + record2._path, record1._key,
+            pool + record1._path);
+      });
+  return rc;
+}
+
+FileExtrema::FileExtrema(size_t maxCount) :
+    _pool(), _largest(maxCount, false, _pool), _youngest(maxCount, false,
+        _pool), _oldest(maxCount, true, _pool), _compactionLimit(1024 * 1024) {
+}
+
+void FileExtrema::add(FsEntry &entry) {
+  add(entry.fullName(), entry.modified()->tv_sec,
+      entry.isRegular() ? entry.fileSize() : -1);
+}
+
+void FileExtrema::add(const char *path, int64_t modified, int64_t size) {
+  bool isLargest = size >= 0 && _largest.accepts(size, path);
+  bool isYoungest = _youngest.accepts(modified, path);
+  bool isOldest = _oldest.accepts(modified, path);
+  if (isLargest || isYoungest || isOldest) {
+    // The path is stored only once for all heaps:
+    size_t offset = intern(path);
+    if (isLargest) {
+      _largest.add(size, offset);
+    }
+    if (isYoungest) {
+      _youngest.add(modified, offset);
+    }
+    if (isOldest) {
+      _oldest.add(modified, offset);
+    }
+  }
+}
+
+void FileExtrema::compact() {
+  std::string pool;
+  std::map<size_t, size_t> offsets;
+  ExtremaHeap *heaps[] = { &_largest, &_youngest, &_oldest };
+  for (auto heap : heaps) {
+    for (auto &record : heap->records()) {
+      auto it = offsets.find(record._path);
+      if (it == offsets.end()) {
+        size_t offset = pool.size();
+        const char *path = _pool.c_str() + record._path;
+        pool.append(path, strlen(path) + 1);
+        offsets[record._path] = offset;
+        record._path = offset;
+      } else {
+        record._path = it->second;
+      }
+    }
+  }
+  _pool = std::move(pool);
+  _compactionLimit = std::max(_compactionLimit, 2 * _pool.size());
+}
+
+size_t FileExtrema::intern(const char *path) {
+  if (_pool.size() > _compactionLimit) {
+    compact();
+  }
+  size_t rc = _pool.size();
+  _pool.append(path, strlen(path) + 1);
+  return rc;
+}
+
+void FileExtrema::merge(const FileExtrema &other) {
+  const ExtremaHeap *sources[] = { &other._largest, &other._youngest,
+      &other._oldest };
+  ExtremaHeap *targets[] = { &_largest, &_youngest, &_oldest };
+  for (size_t ix = 0; ix < 3; ix++) {
+    for (auto &record : sources[ix]->records()) {
+      const char *path = other.path(record);
+      if (targets[ix]->accepts(record._key, path)) {
+        targets[ix]->add(record._key, intern(path));
+      }
+    }
+  }
+}
+
+} /* cppknife */
@@ -0,0 +1,163 @@
+/*
+ * FileExtrema.hpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef OS_FILEEXTREMA_HPP_
+#define OS_FILEEXTREMA_HPP_
+
+namespace cppknife {
+/**
+ * @brief A bounded heap keeping the N most extreme (largest or smallest) records.
+ *
+ * The paths of the records are offsets into a string pool owned by the caller.
+ * The root of the heap is the least extreme record: a new record is accepted
+ * only if it is more extreme than the root.
+ */
+class ExtremaHeap {
+public:
+  /**
+   * @brief An entry of the heap: the key (size, time...) and the path.
+   */
+  struct Record {
+    int64_t _key;
+    /// The offset of the path in the string pool.
+    size_t _path;
+  };
+protected:
+  std::vector<Record> _records;
+  size_t _maxCount;
+  /// <em>true</em>: the smallest keys are extreme.
+  bool _smallest;
+  const std::string &_pool;
+public:
+  /**
+   * Constructor.
+   * @param maxCount The maximal count of records.
+   * @param smallest <em>true</em>: the records with the smallest keys are kept.
+   * @param pool The string pool containing the paths.
+   */
+  ExtremaHeap(size_t maxCount, bool smallest, const std::string &pool);
+public:
+  /**
+   * Tests whether a record would be stored.
+   * @param key The key of the record.
+   * @param path The path of the record.
+   * @return <em>true</em>: the record belongs to the N most extreme records.
+   */
+  inline bool accepts(int64_t key, const char *path) const {
+    return _records.size() < _maxCount
+        || (_maxCount > 0
+            && isMoreExtreme(key, path, _records[0]._key,
+                _pool.c_str() + _records[0]._path));
+  }
+  /**
+   * Stores a record. The least extreme record is removed if the heap is full.
+   * Precondition: <em>accepts()</em> returns <em>true</em>.
+   * @param key The key of the record.
+   * @param path The offset of the path in the string pool.
+   */
+  void add(int64_t key, size_t path);
+  /**
+   * Returns the count of stored records.
+   */
+  inline size_t count() const {
+    return _records.size();
+  }
+  /**
+   * Compares two records.
+   * @return <em>true</em>: the first record is more extreme than the second.
+   */
+  inline bool isMoreExtreme(int64_t key1, const char *path1, int64_t key2,
+      const char *path2) const {
+    bool rc;
+    if (key1 != key2) {
+      rc = _smallest ? key1 < key2 : key1 > key2;
+    } else {
+      int compare = strcmp(path1, path2);
+      rc = _smallest ? compare < 0 : compare > 0;
+    }
+    return rc;
+  }
+  /**
+   * Returns the records for changing the path offsets (e.g. after a compaction of the pool).
+   */
+  inline std::vector<Record>& records() {
+    return _records;
+  }
+  inline const std::vector<Record>& records() const {
+    return _records;
+  }
+  /**
+   * Returns the records sorted: the least extreme first, the most extreme last.
+   */
+  std::vector<Record> sorted() const;
+};
+/**
+ * @brief Collects the largest, youngest and oldest files of a directory tree in one pass.
+ *
+ * The paths are interned in a string pool shared by all heaps.
+ * Collectors filled by different threads can be combined with <em>merge()</em>.
+ */
+class FileExtrema {
+protected:
+  std::string _pool;
+  ExtremaHeap _largest;
+  ExtremaHeap _youngest;
+  ExtremaHeap _oldest;
+  /// If the pool exceeds that size the unused paths are removed.
+  size_t _compactionLimit;
+public:
+  /**
+   * Constructor.
+   * @param maxCount The count of the stored records per extremum.
+   */
+  FileExtrema(size_t maxCount);
+private:
+  FileExtrema(const FileExtrema &other);
+  FileExtrema&
+  operator=(const FileExtrema &other);
+public:
+  /**
+   * Inspects a file.
+   * @param entry The file to inspect.
+   */
+  void add(FsEntry &entry);
+  /**
+   * Inspects a file.
+   * @param path The full name of the file.
+   * @param modified The modification time (seconds since the epoch).
+   * @param size The file size. If &lt; 0: the file is not a candidate for the largest files.
+   */
+  void add(const char *path, int64_t modified, int64_t size);
+  inline const ExtremaHeap& largest() const {
+    return _largest;
+  }
+  /**
+   * Adds the records of another collector, e.g. filled by another thread.
+   * @param other The collector to merge.
+   */
+  void merge(const FileExtrema &other);
+  inline const ExtremaHeap& oldest() const {
+    return _oldest;
+  }
+  /**
+   * Returns the path of a record.
+   */
+  inline const char* path(const ExtremaHeap::Record &record) const {
+    return _pool.c_str() + record._path;
+  }
+  inline const ExtremaHeap& youngest() const {
+    return _youngest;
+  }
+protected:
+  void compact();
+  size_t intern(const char *path);
+};
+
+} /* cppknife */
+
+#endif /* OS_FILEEXTREMA_HPP_ */
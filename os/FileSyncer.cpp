@@ -0,0 +1,269 @@
+/*
+ * FileSyncer.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "os.hpp"
+
+namespace cppknife {
+/**
+ * Returns the absolute name of a directory without trailing separator.
+ * @param directory The directory name, may be relative.
+ * @return The absolute name, e.g. "/home/jonny".
+ */
+static std::string absoluteDirectory(const char *directory) {
+  std::string rc =
+      directory[0] == '/' ?
+          std::string(directory) :
+          joinPath(currentDirectory().c_str(), directory);
+  while (rc.size() > 1 && rc[rc.size() - 1] == '/') {
+    rc.resize(rc.size() - 1);
+  }
+  return rc;
+}
+
+FileSyncer::FileSyncer(Logger *logger, int threads, bool dryRun) :
+    _logger(logger), _threads(
+        threads <= 0 ? ThreadPool::defaultThreadCount() : threads), _dryRun(
+        dryRun), _pool(nullptr), _mutex(), _slotFree(), _inFlight(0), _maxInFlight(
+        4 * _threads), _lastDirectory(), _files(0), _copied(0), _unchanged(0), _links(
+        0), _errors(0), _bytes(0), _methods(), _seconds(0.0) {
+  for (auto &count : _methods) {
+    count = 0;
+  }
+}
+
+FileSyncer::~FileSyncer() {
+  delete _pool;
+  _pool = nullptr;
+}
+
+bool FileSyncer::copyLink(const char *source, const char *target) {
+  char reference[PATH_MAX];
+  char reference2[PATH_MAX];
+  bool rc = true;
+  auto length = readlink(source, reference, sizeof reference - 1);
+  if (length < 0) {
+    error(formatCString("cannot read link %s", source).c_str());
+    rc = false;
+  } else {
+    reference[length] = '\0';
+    auto length2 = readlink(target, reference2, sizeof reference2 - 1);
+    if (length2 == length && strncmp(reference, reference2, length) == 0) {
+      _unchanged++;
+    } else if (_dryRun) {
+      _copied++;
+      _logger->say(LV_INFO, formatCString("link: %s -> %s", target, reference));
+    } else {
+      unlink(target);
+      if (symlink(reference, target) != 0) {
+        error(formatCString("cannot create link %s", target).c_str());
+        rc = false;
+      } else {
+        _copied++;
+        _links++;
+      }
+    }
+  }
+  return rc;
+}
+
+bool FileSyncer::copyOne(const std::string &source, const std::string &target) {
+  bool rc = false;
+  int sourceHandle = open(source.c_str(), O_RDONLY | O_CLOEXEC);
+  struct stat status;
+  if (sourceHandle < 0 || fstat(sourceHandle, &status) != 0) {
+    error(formatCString("cannot open %s", source.c_str()).c_str());
+  } else {
+    // The copy is renamed when complete: the target never contains a partial copy.
+    auto separator = target.rfind('/');
+    std::string temporary = target.substr(0, separator + 1) + "."
+        + target.substr(separator + 1) + ".fksync";
+    int targetHandle = open(temporary.c_str(),
+        O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, status.st_mode & ALLPERMS);
+    if (targetHandle < 0) {
+      error(formatCString("cannot create %s", temporary.c_str()).c_str());
+    } else {
+      std::string message;
+      auto method = copyFileContent(sourceHandle, targetHandle, status.st_size,
+          &message);
+      if (method != CM_NONE) {
+        struct timespec times[2] = { status.st_atim, status.st_mtim };
+        // The umask may have reduced the rights:
+        fchmod(targetHandle, status.st_mode & ALLPERMS);
+        futimens(targetHandle, times);
+      }
+      if (close(targetHandle) != 0 && method != CM_NONE) {
+        method = CM_NONE;
+        message = formatCString("cannot close (%d): %s", errno,
+            strerror(errno));
+      }
+      if (method == CM_NONE) {
+        unlink(temporary.c_str());
+        error(formatCString("%s: %s", target.c_str(), message.c_str()).c_str());
+      } else if (rename(temporary.c_str(), target.c_str()) != 0) {
+        unlink(temporary.c_str());
+        error(formatCString("cannot rename to %s", target.c_str()).c_str());
+      } else {
+        rc = true;
+        _copied++;
+        _bytes += status.st_size;
+        _methods[method]++;
+        std::lock_guard<std::mutex> guard(_mutex);
+        _logger->say(LV_DETAIL,
+            formatCString("%s: %s", copyMethodName(method), target.c_str()));
+      }
+    }
+  }
+  if (sourceHandle >= 0) {
+    close(sourceHandle);
+  }
+  return rc;
+}
+
+bool FileSyncer::ensureParent(const std::string &target) {
+  bool rc = true;
+  auto parent = target.substr(0, target.rfind('/'));
+  if (parent != _lastDirectory) {
+    try {
+      rc = ensureDirectory(parent.c_str());
+    } catch (OsException &exception) {
+      rc = false;
+    }
+    if (!rc) {
+      error(formatCString("cannot create directory %s", parent.c_str()).c_str());
+    } else {
+      _lastDirectory = parent;
+    }
+  }
+  return rc;
+}
+
+void FileSyncer::error(const char *message) {
+  int lastError = errno;
+  _errors++;
+  std::lock_guard<std::mutex> guard(_mutex);
+  _logger->say(LV_ERROR,
+      formatCString("%s (%d): %s", message, lastError, strerror(lastError)));
+}
+
+std::string FileSyncer::statisticAsString() const {
+  double megaBytes = _bytes / 1E6;
+  std::string rc = formatCString(
+      "%d file(s) copied %.6f MB in %.3f sec %.3f MB/s %d unchanged %d error(s)",
+      static_cast<int>(_copied), megaBytes, _seconds,
+      _seconds <= 0.0 ? 0.0 : megaBytes / _seconds,
+      static_cast<int>(_unchanged), static_cast<int>(_errors));
+  for (int method = CM_CLONE; method < CM_COUNT; method++) {
+    rc += formatCString(" %s: %d",
+        copyMethodName(static_cast<CopyMethod>(method)),
+        static_cast<int>(_methods[method]));
+  }
+  return rc;
+}
+
+void FileSyncer::submitCopy(const std::string &source,
+    const std::string &target, FileSize_t size) {
+  if (_dryRun) {
+    _copied++;
+    _bytes += size;
+    _logger->say(LV_INFO, formatCString("copy: %s", target.c_str()));
+  } else if (ensureParent(target)) {
+    if (_pool == nullptr) {
+      copyOne(source, target);
+    } else {
+      {
+        // Bounded: the traversal waits for the workers.
+        std::unique_lock<std::mutex> lock(_mutex);
+        waitForCondition(_slotFree, lock, [this] {
+          return _inFlight < _maxInFlight;
+        });
+        _inFlight++;
+      }
+      _pool->submit([this, source, target] {
+        copyOne(source, target);
+        {
+          std::lock_guard<std::mutex> guard(_mutex);
+          _inFlight--;
+        }
+        _slotFree.notify_one();
+      });
+    }
+  }
+}
+
+bool FileSyncer::sync(const char *source, const char *target,
+    const DirEntryFilter *filter) {
+  double start = nowAsDouble();
+  size_t errors = _errors;
+  std::string sourceBase = absoluteDirectory(source);
+  std::string targetBase = absoluteDirectory(target);
+  if (!isDirectory(sourceBase.c_str())) {
+    errno = ENOTDIR;
+    error(formatCString("missing source directory %s", sourceBase.c_str()).c_str());
+  } else if (!_dryRun && !ensureParent(targetBase + "/")) {
+    // error is already logged
+  } else {
+    if (!_dryRun && _threads > 1 && _pool == nullptr) {
+      _pool = new ThreadPool(_threads);
+    }
+    DirEntryFilter allFiles;
+    Traverser traverser(sourceBase.c_str(),
+        filter == nullptr ? &allFiles : filter, nullptr, _logger);
+    traverser.setLazyStatus(STATX_TYPE | STATX_SIZE | STATX_MTIME);
+    size_t prefixLength = sourceBase.size() + (sourceBase == "/" ? 0 : 1);
+    int level = 0;
+    FsEntry *entry;
+    std::string sourceName;
+    std::string targetName;
+    while ((entry = traverser.nextFile(level)) != nullptr) {
+      if (entry->fullNameLength() <= prefixLength) {
+        continue;
+      }
+      const char *relativeName = entry->fullName() + prefixLength;
+      targetName = targetBase;
+      targetName += '/';
+      targetName += relativeName;
+      switch (entry->type()) {
+      case FsEntry::TF_SUBDIR:
+        // Returned after its content: only empty directories are created here.
+        if (!_dryRun) {
+          ensureParent(targetName + "/");
+        }
+        break;
+      case FsEntry::TF_LINK:
+        if (_dryRun || ensureParent(targetName)) {
+          copyLink(entry->fullName(), targetName.c_str());
+        }
+        break;
+      case FsEntry::TF_REGULAR: {
+        _files++;
+        struct stat status;
+        FileSize_t size = entry->fileSize();
+        if (lstat(targetName.c_str(), &status) == 0 && S_ISREG(status.st_mode)
+            && status.st_size == size
+            && status.st_mtim.tv_sec == entry->modified()->tv_sec) {
+          _unchanged++;
+        } else {
+          sourceName = entry->fullName();
+          submitCopy(sourceName, targetName, size);
+        }
+        break;
+      }
+      default:
+        // Special files are not copied.
+        break;
+      }
+    }
+    if (_pool != nullptr) {
+      _pool->waitIdle();
+    }
+  }
+  _seconds += nowAsDouble() - start;
+  return _errors == errors;
+}
+
+} /* cppknife */
@@ -0,0 +1,117 @@
+/*
+ * FileSyncer.hpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef OS_FILESYNCER_HPP_
+#define OS_FILESYNCER_HPP_
+
+namespace cppknife {
+/**
+ * @brief Mirrors a directory tree into another directory on the same host.
+ *
+ * The source tree is traversed by a <em>Traverser</em>. A file is copied only if the
+ * target does not exist or differs in size or modification time (seconds).
+ * The content is copied by <em>copyFileContent()</em>: reflink, <em>copy_file_range()</em>,
+ * <em>sendfile()</em> or <em>read()</em>/<em>write()</em>, whatever the file systems support.
+ *
+ * The copies are done by a <em>ThreadPool</em>. The count of queued copies is limited,
+ * so the traversal does not run far ahead of the workers.
+ * A file is written into a temporary file in the target directory and renamed
+ * when complete: the target never contains partially copied files.
+ * Symbolic links are copied as links. Files missing in the source are not deleted in the target.
+ */
+class FileSyncer {
+protected:
+  Logger *_logger;
+  int _threads;
+  bool _dryRun;
+  ThreadPool *_pool;
+  std::mutex _mutex;
+  std::condition_variable _slotFree;
+  /// The count of copies queued or running.
+  size_t _inFlight;
+  /// The maximal value of <em>_inFlight</em>.
+  size_t _maxInFlight;
+  /// The last target directory ensured: avoids a check for each file.
+  std::string _lastDirectory;
+  std::atomic<size_t> _files;
+  std::atomic<size_t> _copied;
+  std::atomic<size_t> _unchanged;
+  std::atomic<size_t> _links;
+  std::atomic<size_t> _errors;
+  std::atomic<int64_t> _bytes;
+  std::atomic<size_t> _methods[CM_COUNT];
+  double _seconds;
+public:
+  /**
+   * Constructor.
+   * @param logger The logger for the copied files (LV_DETAIL) and the errors.
+   * @param threads The count of copy workers. &lt;= 0: the count of CPU cores.
+   * @param dryRun <em>true</em>: the files to copy are only logged (LV_INFO).
+   */
+  FileSyncer(Logger *logger, int threads = 1, bool dryRun = false);
+  virtual ~FileSyncer();
+private:
+  FileSyncer(const FileSyncer &other);
+  FileSyncer&
+  operator=(const FileSyncer &other);
+public:
+  /**
+   * Returns the count of copied bytes.
+   */
+  inline int64_t bytes() const {
+    return _bytes;
+  }
+  /**
+   * Returns the count of copied files and links.
+   */
+  inline size_t copied() const {
+    return _copied;
+  }
+  /**
+   * Returns the count of files that could not be copied.
+   */
+  inline size_t errors() const {
+    return _errors;
+  }
+  /**
+   * Returns how often a copy method has been used.
+   */
+  inline size_t methodCount(CopyMethod method) const {
+    return _methods[method];
+  }
+  /**
+   * Returns the statistic as text, e.g. throughput in MB/s.
+   */
+  std::string statisticAsString() const;
+  /**
+   * Copies the changed files of a source tree into the target tree.
+   * @param source The source directory.
+   * @param target The target directory. Will be created if needed.
+   * @param filter <em>nullptr</em> or the filter of the source files.
+   * @return <em>true</em>: no error occurred.
+   */
+  bool sync(const char *source, const char *target,
+      const DirEntryFilter *filter = nullptr);
+  /**
+   * Returns the count of files that are already up to date.
+   */
+  inline size_t unchanged() const {
+    return _unchanged;
+  }
+protected:
+  bool copyOne(const std::string &source, const std::string &target);
+  bool copyLink(const char *source, const char *target);
+  void error(const char *message);
+  bool ensureParent(const std::string &target);
+  void submitCopy(const std::string &source, const std::string &target,
+      FileSize_t size);
+};
+
+} /* cppknife */
+
+#endif /* OS_FILESYNCER_HPP_ */
@@ -8,6 +8,14 @@
 
 #include "os.hpp"
 #include <unistd.h>
+#if defined __linux__
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#ifndef FICLONE
+// From linux/fs.h:
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+#endif
 namespace cppknife {
 std::string buildFileTree(const char *data) {
   auto lines = splitCString(data, "\n");
@@ -51,45 +59,112 @@ bool copyFile(const char *source, const char *target,
       target2 = joinPath(target, basename(source).c_str(), nullptr);
       target = const_cast<const char*>(target2.c_str());
     }
-    FILE *fpSource = fopen(source, "rb");
-    if (fpSource == nullptr) {
+    int sourceHandle = open(source, O_RDONLY | O_CLOEXEC);
+    struct stat sourceStatus;
+    if (sourceHandle < 0 || fstat(sourceHandle, &sourceStatus) != 0) {
       *errorMessage = formatCString("cannot open (%d): %s [%s]", errno, source,
           strerror(errno));
     } else {
-      FILE *fpTarget = fopen(target, "wb");
-      if (fpTarget == nullptr) {
+      int targetHandle = open(target, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+          0666);
+      if (targetHandle < 0) {
         *errorMessage = formatCString("cannot open (%d): %s [%s]", errno,
             source, strerror(errno));
       } else {
-        char buffer[64000];
-        ssize_t readBytes = 0;
-        ssize_t writtenBytes = 0;
-        rc = true;
-        while ((readBytes = fread(buffer, 1, sizeof buffer, fpSource)) > 0) {
-          if ((writtenBytes = fwrite(buffer, 1, readBytes, fpTarget))
-              != readBytes) {
-            *errorMessage = formatCString("cannot write (%d): %s [%s]", errno,
-                target, strerror(errno));
-            rc = false;
-            break;
-          }
+        rc = copyFileContent(sourceHandle, targetHandle, sourceStatus.st_size,
+            errorMessage) != CM_NONE;
+        if (rc) {
+          // Set the file time:
+          struct timespec times[2] = { sourceStatus.st_atim,
+              sourceStatus.st_mtim };
+          futimens(targetHandle, times);
         }
-        fclose(fpTarget);
+        close(targetHandle);
         if (!rc) {
           unlink(target);
-        } else {
-          // Set the file time:
-          std::filesystem::file_time_type modificationTime =
-              std::filesystem::last_write_time(source);
-          std::filesystem::last_write_time(target, modificationTime);
         }
       }
-      fclose(fpSource);
+    }
+    if (sourceHandle >= 0) {
+      close(sourceHandle);
+    }
+  }
+  return rc;
+}
+
+CopyMethod copyFileContent(int sourceHandle, int targetHandle, FileSize_t size,
+    std::string *errorMessage) {
+  CopyMethod rc = CM_NONE;
+  FileSize_t copied = 0;
+#if defined __linux__
+  if (size > 0 && ioctl(targetHandle, FICLONE, sourceHandle) == 0) {
+    rc = CM_CLONE;
+    copied = size;
+  }
+  // Both kernel methods fail without copying anything if not supported:
+  if (rc == CM_NONE) {
+    ssize_t bytes = 0;
+    while (copied < size
+        && (bytes = copy_file_range(sourceHandle, nullptr, targetHandle,
+            nullptr, size - copied, 0)) > 0) {
+      copied += bytes;
+    }
+    if (copied > 0 || (bytes == 0 && size == 0)) {
+      rc = CM_COPY_RANGE;
+    }
+  }
+  if (rc == CM_NONE) {
+    ssize_t bytes = 0;
+    while (copied < size
+        && (bytes = sendfile(targetHandle, sourceHandle, nullptr,
+            size - copied)) > 0) {
+      copied += bytes;
+    }
+    if (copied > 0) {
+      rc = CM_SENDFILE;
+    }
+  }
+#endif
+  if (rc == CM_NONE) {
+    rc = CM_READ_WRITE;
+  }
+  if (copied < size || rc == CM_READ_WRITE) {
+    // The rest (or all) in user space, e.g. the source has grown:
+    char buffer[256 * 1024];
+    ssize_t bytes;
+    lseek(sourceHandle, copied, SEEK_SET);
+    lseek(targetHandle, copied, SEEK_SET);
+    while ((bytes = read(sourceHandle, buffer, sizeof buffer)) > 0) {
+      ssize_t written = 0;
+      ssize_t bytes2;
+      while (written < bytes
+          && (bytes2 = write(targetHandle, buffer + written, bytes - written))
+              > 0) {
+        written += bytes2;
+      }
+      if (written < bytes) {
+        bytes = -1;
+        break;
+      }
+      copied += bytes;
+    }
+    if (bytes < 0) {
+      if (errorMessage != nullptr) {
+        *errorMessage = formatCString("cannot copy (%d): %s", errno,
+            strerror(errno));
+      }
+      rc = CM_NONE;
     }
   }
   return rc;
 }
 
+const char* copyMethodName(CopyMethod method) {
+  static const char *names[] = { "none", "clone", "copy_file_range",
+      "sendfile", "read/write" };
+  return method < CM_COUNT ? names[method] : "?";
+}
+
 std::string currentDirectory() {
   char path[8192];
   getcwd(path, sizeof path);
@@ -126,6 +201,18 @@ std::string filetimeToString(const FileTime_t &time) {
   return rc;
 }
 
+const char* filetimeToString(const FileTime_t &time, char *buffer,
+    size_t bufferSize) {
+  time_t time1 = filetimeToTime(time);
+  struct tm time2;
+  localtime_r(&time1, &time2);
+  if (bufferSize > 0
+      && strftime(buffer, bufferSize, "%Y.%m.%d %H:%M:%S", &time2) == 0) {
+    buffer[0] = '\0';
+  }
+  return buffer;
+}
+
 time_t filetimeToTime(const FileTime_t &filetime) {
 #ifdef __linux__
   return filetime.tv_sec;
@@ -269,7 +356,9 @@ int makeDirectory(const char *path, bool recursive) {
         formatCString("cannot create directory %s: a file already exists.",
             path));
   } else {
-    if (mkdir(path, 0777) != 0) {
+    if (mkdir(path, 0777) == 0) {
+      rc = 1;
+    } else if (recursive) {
       auto parts = splitCString(path, info._separatorCString);
       size_t ix = 0;
       std::string current;
@@ -295,9 +384,12 @@ int makeDirectory(const char *path, bool recursive) {
           }
           rc += 1;
         }
+        if (ix >= parts.size()) {
+          break;
+        }
         current += info._separatorString;
         current += parts[ix++];
-      } while (ix < parts.size());
+      } while (true);
     }
   }
   return rc;
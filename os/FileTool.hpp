@@ -25,6 +25,38 @@ const time_t UNDEF_TIME = (time_t) 0;
  */
 std::string
 buildFileTree(const char *data);
+/**
+ * The ways to copy a file content, the fastest first.
+ */
+enum CopyMethod {
+  /// Error: nothing copied.
+  CM_NONE,
+  /// The target shares the data blocks of the source (reflink, <em>FICLONE</em>).
+  CM_CLONE,
+  /// The kernel copies the data (<em>copy_file_range()</em>).
+  CM_COPY_RANGE,
+  /// The kernel copies the data (<em>sendfile()</em>).
+  CM_SENDFILE,
+  /// The data is copied in user space (<em>read()</em>, <em>write()</em>).
+  CM_READ_WRITE,
+  CM_COUNT
+};
+/**
+ * Copies the content of an open file into another open file.
+ * The fastest method supported by the file systems is used:
+ * a reflink (clone), <em>copy_file_range()</em>, <em>sendfile()</em>, <em>read()</em>/<em>write()</em>.
+ * @param sourceHandle The file handle of the source, positioned at the start.
+ * @param targetHandle The file handle of the (empty) target, opened for writing.
+ * @param size The size of the source.
+ * @param[out] errorMessage <em>nullptr</em> or a buffer for an error message.
+ * @return <em>CM_NONE</em>: error. Otherwise: the used method.
+ */
+CopyMethod copyFileContent(int sourceHandle, int targetHandle, FileSize_t size,
+    std::string *errorMessage = nullptr);
+/**
+ * Returns the name of a copy method, e.g. "clone".
+ */
+const char* copyMethodName(CopyMethod method);
 /**
  * Copies a single file.
  * @param source The name of the file to copy.
@@ -86,6 +118,16 @@ inline bool filetimeIsUndefined(FileTime_t &time) {
  */
 std::string
 filetimeToString(const FileTime_t &time);
+/**
+ * Converts a file time to a string without heap allocation.
+ *
+ * @param time The file time to convert.
+ * @param[out] buffer The result buffer. Should have at least 20 bytes.
+ * @param bufferSize The size of <em>buffer</em>.
+ * @return <em>buffer</em> (for chaining), e.g. "2014.01.07 02:59:43".
+ */
+const char*
+filetimeToString(const FileTime_t &time, char *buffer, size_t bufferSize);
 /**
  * Converts a filetime to a unix time (seconds since the Epoche).
  *
@@ -0,0 +1,208 @@
+/*
+ * FilterProgram.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "os.hpp"
+
+namespace cppknife {
+
+static std::atomic<int> nextSlot(0);
+/**
+ * Returns the counter slot of the current thread.
+ */
+static int slotOfThread() {
+  static thread_local int rc = nextSlot++ % FilterProgram::SLOTS;
+  return rc;
+}
+
+FilterProgram::FilterProgram(const DirEntryFilter &filter) :
+    _filter(filter), _types(filter._types), _nodePatterns(
+        filter._nodePatterns), _minSize(filter._minSize), _maxSize(
+        filter._maxSize), _minAge(filter._minAge), _maxAge(filter._maxAge), _steps(), _countSteps(
+        0), _countStatFree(0), _order(0), _reordering(), _counters() {
+  _reordering.clear();
+  for (auto &counters : _counters) {
+    counters._entries = 0;
+    counters._statsAvoided = 0;
+    for (size_t ix = 0; ix < P_COUNT; ix++) {
+      counters._evaluated[ix] = 0;
+      counters._rejected[ix] = 0;
+    }
+  }
+  // The predicates needing no status info first:
+  if (_nodePatterns != nullptr) {
+    _steps[_countSteps++] = P_NAME;
+  }
+  if (_types != FsEntry::TC_ALL) {
+    _steps[_countSteps++] = P_TYPE;
+  }
+  _countStatFree = _countSteps;
+  if (filter.hasSizeCondition()) {
+    _steps[_countSteps++] = P_SIZE;
+  }
+  if (filter.hasAgeCondition()) {
+    _steps[_countSteps++] = P_AGE;
+  }
+  uint32_t order = 0;
+  for (size_t ix = 0; ix < _countSteps; ix++) {
+    order |= static_cast<uint32_t>(_steps[ix]) << (4 * ix);
+  }
+  _order = order;
+}
+
+int FilterProgram::costs(Predicate predicate) {
+  // A pattern match is more expensive than a comparison of numbers:
+  return predicate == P_NAME ? 4 : 1;
+}
+
+uint64_t FilterProgram::entries() const {
+  uint64_t rc = 0;
+  for (auto &counters : _counters) {
+    rc += counters._entries.load(std::memory_order_relaxed);
+  }
+  return rc;
+}
+
+bool FilterProgram::evaluate(Predicate predicate, FsEntry &entry) const {
+  bool rc = true;
+  switch (predicate) {
+  case P_NAME:
+    rc = _nodePatterns->match(entry.node());
+    break;
+  case P_TYPE:
+    rc = (entry.type() & _types) != 0;
+    break;
+  case P_SIZE: {
+    int64_t size = entry.fileSize();
+    rc = size >= _minSize && size <= _maxSize;
+    break;
+  }
+  case P_AGE: {
+    auto modified = entry.modified();
+    rc = fileTimeCompare(_minAge, *modified) <= 0
+        && fileTimeCompare(_maxAge, *modified) >= 0;
+    break;
+  }
+  default:
+    break;
+  }
+  return rc;
+}
+
+uint64_t FilterProgram::evaluated(Predicate predicate) const {
+  uint64_t rc = 0;
+  for (auto &counters : _counters) {
+    rc += counters._evaluated[predicate].load(std::memory_order_relaxed);
+  }
+  return rc;
+}
+
+std::string FilterProgram::orderAsString() const {
+  std::string rc;
+  uint32_t order = _order.load(std::memory_order_relaxed);
+  for (size_t ix = 0; ix < _countSteps; ix++) {
+    if (ix > 0) {
+      rc += ' ';
+    }
+    rc += predicateName(static_cast<Predicate>((order >> (4 * ix)) & 0xf));
+  }
+  return rc;
+}
+
+const char* FilterProgram::predicateName(Predicate predicate) {
+  static const char *names[] = { "name", "type", "size", "age" };
+  return predicate < P_COUNT ? names[predicate] : "?";
+}
+
+uint64_t FilterProgram::rejected(Predicate predicate) const {
+  uint64_t rc = 0;
+  for (auto &counters : _counters) {
+    rc += counters._rejected[predicate].load(std::memory_order_relaxed);
+  }
+  return rc;
+}
+
+void FilterProgram::reorder() {
+  // Only one thread reorders, the others continue with the old order:
+  if (_reordering.test_and_set(std::memory_order_acquire)) {
+    return;
+  }
+  double scores[P_COUNT];
+  for (size_t ix = 0; ix < _countSteps; ix++) {
+    Predicate predicate = _steps[ix];
+    uint64_t countEvaluated = evaluated(predicate);
+    scores[predicate] =
+        countEvaluated == 0 ?
+            0.0 :
+            static_cast<double>(rejected(predicate)) / countEvaluated
+                / costs(predicate);
+  }
+  uint32_t order = _order.load(std::memory_order_relaxed);
+  Predicate current[P_COUNT];
+  for (size_t ix = 0; ix < _countSteps; ix++) {
+    current[ix] = static_cast<Predicate>((order >> (4 * ix)) & 0xf);
+  }
+  auto compare = [&scores](Predicate predicate1, Predicate predicate2) {
+    return scores[predicate1] > scores[predicate2];
+  };
+  // The groups (without/with status info) are sorted separately:
+  std::stable_sort(current, current + _countStatFree, compare);
+  std::stable_sort(current + _countStatFree, current + _countSteps, compare);
+  order = 0;
+  for (size_t ix = 0; ix < _countSteps; ix++) {
+    order |= static_cast<uint32_t>(current[ix]) << (4 * ix);
+  }
+  _order.store(order, std::memory_order_relaxed);
+  _reordering.clear(std::memory_order_release);
+}
+
+bool FilterProgram::run(FsEntry &entry) {
+  Counters &counters = _counters[slotOfThread()];
+  uint32_t order = _order.load(std::memory_order_relaxed);
+  bool rc = true;
+  size_t ix;
+  for (ix = 0; ix < _countSteps; ix++) {
+    auto predicate = static_cast<Predicate>((order >> (4 * ix)) & 0xf);
+    increment(counters._evaluated[predicate]);
+    if (!evaluate(predicate, entry)) {
+      increment(counters._rejected[predicate]);
+      rc = false;
+      break;
+    }
+  }
+  if (!rc && ix < _countStatFree && _countStatFree < _countSteps) {
+    increment(counters._statsAvoided);
+  }
+  if (increment(counters._entries) % REORDER_INTERVAL == 0) {
+    reorder();
+  }
+  return rc;
+}
+
+std::string FilterProgram::statisticAsString() const {
+  std::string rc = formatCString("filter: %llu entries %llu stats avoided order: %s",
+      static_cast<unsigned long long>(entries()),
+      static_cast<unsigned long long>(statsAvoided()),
+      orderAsString().c_str());
+  for (size_t ix = 0; ix < _countSteps; ix++) {
+    Predicate predicate = _steps[ix];
+    rc += formatCString(" %s: %llu/%llu", predicateName(predicate),
+        static_cast<unsigned long long>(rejected(predicate)),
+        static_cast<unsigned long long>(evaluated(predicate)));
+  }
+  return rc;
+}
+
+uint64_t FilterProgram::statsAvoided() const {
+  uint64_t rc = 0;
+  for (auto &counters : _counters) {
+    rc += counters._statsAvoided.load(std::memory_order_relaxed);
+  }
+  return rc;
+}
+
+} /* cppknife */
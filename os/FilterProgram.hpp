@@ -0,0 +1,143 @@
+/*
+ * FilterProgram.hpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef OS_FILTERPROGRAM_HPP_
+#define OS_FILTERPROGRAM_HPP_
+
+namespace cppknife {
+/**
+ * @brief The conditions of a <em>DirEntryFilter</em> compiled into a flat list of predicates.
+ *
+ * The predicates needing no status info (name, type) are evaluated first,
+ * the predicates needing the status info (size, age) at the end.
+ * Predicates without a condition (e.g. all file types) are not part of the program.
+ * Inside each group the predicate rejecting the most entries (relative to its costs)
+ * is evaluated first: the order is adapted at runtime from the rejection counters.
+ *
+ * The counters are kept in some cache line aligned slots: the threads of a parallel
+ * traversal use different slots. Each slot is updated without locks, so the counters are
+ * exact in a single threaded traversal and may lose some increments otherwise.
+ */
+class FilterProgram {
+public:
+  enum Predicate {
+    P_NAME, P_TYPE, P_SIZE, P_AGE, P_COUNT
+  };
+  enum {
+    /// The count of counter slots.
+    SLOTS = 16,
+    /// The order is adapted after this count of entries (per slot).
+    REORDER_INTERVAL = 4096
+  };
+protected:
+  /**
+   * @brief The runtime counters of one slot.
+   */
+  struct alignas(64) Counters {
+    std::atomic<uint64_t> _entries;
+    std::atomic<uint64_t> _statsAvoided;
+    std::atomic<uint64_t> _evaluated[P_COUNT];
+    std::atomic<uint64_t> _rejected[P_COUNT];
+  };
+protected:
+  const DirEntryFilter &_filter;
+  // The filter conditions the program is compiled from:
+  FsEntry::Type_t _types;
+  PatternList *_nodePatterns;
+  FileSize_t _minSize;
+  FileSize_t _maxSize;
+  FileTime_t _minAge;
+  FileTime_t _maxAge;
+  /// The predicates of the program, the first <em>_countStatFree</em> need no status info.
+  Predicate _steps[P_COUNT];
+  size_t _countSteps;
+  size_t _countStatFree;
+  /// The current evaluation order: 4 bits per step (a <em>Predicate</em>), the first step in the lowest bits.
+  std::atomic<uint32_t> _order;
+  std::atomic_flag _reordering;
+  Counters _counters[SLOTS];
+public:
+  /**
+   * Constructor.
+   * @param filter The filter to compile.
+   */
+  FilterProgram(const DirEntryFilter &filter);
+private:
+  FilterProgram(const FilterProgram &other);
+  FilterProgram&
+  operator=(const FilterProgram &other);
+public:
+  /**
+   * Returns the count of inspected entries.
+   */
+  uint64_t entries() const;
+  /**
+   * Returns how often a predicate has been evaluated.
+   */
+  uint64_t evaluated(Predicate predicate) const;
+  /**
+   * Tests whether the program reflects the current conditions of a filter.
+   * @param filter The filter to test.
+   * @return <em>false</em>: the filter has been changed since the compilation.
+   */
+  inline bool isCompiledFrom(const DirEntryFilter &filter) const {
+    return &filter == &_filter && _types == filter._types
+        && _nodePatterns == filter._nodePatterns
+        && _minSize == filter._minSize && _maxSize == filter._maxSize
+        && fileTimeCompare(_minAge, filter._minAge) == 0
+        && fileTimeCompare(_maxAge, filter._maxAge) == 0;
+  }
+  /**
+   * Returns the current evaluation order as text, e.g. "name type size".
+   */
+  std::string orderAsString() const;
+  /**
+   * Returns how often a predicate has rejected an entry.
+   */
+  uint64_t rejected(Predicate predicate) const;
+  /**
+   * Adapts the evaluation order to the rejection rates.
+   */
+  void reorder();
+  /**
+   * Evaluates the program.
+   * @param entry The entry to test.
+   * @return <em>true</em>: all predicates are fulfilled.
+   */
+  bool run(FsEntry &entry);
+  /**
+   * Returns the statistic of the counters as text.
+   */
+  std::string statisticAsString() const;
+  /**
+   * Returns the count of entries rejected without fetching the status info
+   * although a predicate needing it exists.
+   */
+  uint64_t statsAvoided() const;
+public:
+  static const char* predicateName(Predicate predicate);
+protected:
+  /**
+   * Returns the relative costs of a predicate.
+   */
+  static int costs(Predicate predicate);
+  bool evaluate(Predicate predicate, FsEntry &entry) const;
+  /**
+   * Increments a counter of a slot.
+   * The slot is used by only one thread (as far as possible): no atomic read-modify-write is needed.
+   */
+  static inline uint64_t increment(std::atomic<uint64_t> &counter) {
+    uint64_t rc = counter.load(std::memory_order_relaxed) + 1;
+    counter.store(rc, std::memory_order_relaxed);
+    return rc;
+  }
+};
+
+} /* cppknife */
+
+#endif /* OS_FILTERPROGRAM_HPP_ */
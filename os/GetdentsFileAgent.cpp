@@ -0,0 +1,387 @@
+/*
+ * GetdentsFileAgent.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "os.hpp"
+
+namespace cppknife {
+
+LazyFsEntry::LazyFsEntry(GetdentsFileAgent *parent) :
+    _parent(parent), _fullName(""), _fullNameLength(0), _nodeOffset(0), _arena(
+        nullptr), _ownArena(nullptr), _directoryHandle(AT_FDCWD), _directoryType(
+        DT_UNKNOWN), _statusMask(0), _status(), _accessed(), _modified(), _linkTarget(
+        nullptr), _linkReference() {
+}
+LazyFsEntry::~LazyFsEntry() {
+  delete _ownArena;
+  _ownArena = nullptr;
+}
+const FileTime_t*
+LazyFsEntry::accessed() {
+  getStatus(STATX_ATIME);
+  return &_accessed;
+}
+const char*
+LazyFsEntry::accessFullName() {
+  return _fullName;
+}
+FileSize_t LazyFsEntry::fileSize() {
+  return getStatus(STATX_SIZE).stx_size;
+}
+std::string LazyFsEntry::filetimeAsString() {
+  return filetimeToString(*modified());
+}
+void LazyFsEntry::finishCertainFile() {
+}
+const char*
+LazyFsEntry::fullName() {
+  return _fullName;
+}
+size_t LazyFsEntry::fullNameLength() {
+  return _fullNameLength;
+}
+const struct statx&
+LazyFsEntry::getStatus(unsigned int mask) {
+  if ((_statusMask & mask) != mask) {
+    unsigned int wanted = mask | _statusMask;
+    if (_parent != nullptr) {
+      wanted |= _parent->_statusMask;
+      _parent->_statusCalls++;
+    }
+    const char *name = _directoryHandle == AT_FDCWD ? _fullName : node();
+    if (statx(_directoryHandle, name, AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT,
+        wanted, &_status) != 0) {
+      memset(&_status, 0, sizeof _status);
+    }
+    // Fields not supported by the filesystem are not requested again:
+    _statusMask |= wanted;
+    setFiletime(_accessed, _status.stx_atime.tv_sec,
+        _status.stx_atime.tv_nsec);
+    setFiletime(_modified, _status.stx_mtime.tv_sec,
+        _status.stx_mtime.tv_nsec);
+    if (_directoryType == DT_UNKNOWN && (_status.stx_mask & STATX_TYPE) != 0) {
+      _directoryType = IFTODT(_status.stx_mode);
+    }
+  }
+  return _status;
+}
+bool LazyFsEntry::isDirectory() {
+  return type() == TF_SUBDIR;
+}
+bool LazyFsEntry::isDotDir() {
+  // "." and ".." are never stored by the agent.
+  return false;
+}
+bool LazyFsEntry::isLink() {
+  return type() == TF_LINK;
+}
+bool LazyFsEntry::isRegular() {
+  return type() == TF_REGULAR;
+}
+const FileTime_t*
+LazyFsEntry::modified() {
+  getStatus(STATX_MTIME);
+  return &_modified;
+}
+const char*
+LazyFsEntry::node() {
+  return _fullName + _nodeOffset;
+}
+const std::string&
+LazyFsEntry::linkReference() {
+  _linkReference = linkTarget();
+  return _linkReference;
+}
+const char*
+LazyFsEntry::linkTarget() {
+  if (_linkTarget == nullptr) {
+    _linkTarget = "";
+    if (type() == TF_LINK) {
+      char buffer[PATH_MAX];
+      const char *name = _directoryHandle == AT_FDCWD ? _fullName : node();
+      auto len = readlinkat(_directoryHandle, name, buffer, sizeof buffer);
+      char *target;
+      if (len > 0 && (target = _arena->allocate(len)) != nullptr) {
+        memcpy(target, buffer, len);
+        _linkTarget = target;
+      }
+    }
+  }
+  return _linkTarget;
+}
+bool LazyFsEntry::modeAndOwner(uint32_t &mode, uint32_t &owner,
+    uint32_t &group) {
+  auto &status = getStatus(STATX_MODE | STATX_UID | STATX_GID);
+  mode = status.stx_mode;
+  owner = status.stx_uid;
+  group = status.stx_gid;
+  return (status.stx_mask & STATX_MODE) != 0;
+}
+const char*
+LazyFsEntry::rightsAsString(std::string &buffer, bool numerical,
+    int ownerWidth) {
+  const char *rc = "";
+  return rc;
+}
+void LazyFsEntry::set(const char *fullName, size_t fullNameLength,
+    size_t nodeOffset, int directoryHandle, unsigned char directoryType,
+    ByteStorage *arena) {
+  _fullName = fullName;
+  _fullNameLength = fullNameLength;
+  _nodeOffset = nodeOffset;
+  _arena = arena;
+  _directoryHandle = directoryHandle;
+  _directoryType = directoryType;
+  _statusMask = 0;
+  _linkTarget = nullptr;
+}
+bool LazyFsEntry::setCertainFile(const char *fullName) {
+  if (_ownArena == nullptr) {
+    _ownArena = new ByteStorage();
+  }
+  _ownArena->reset();
+  size_t length = strlen(fullName);
+  char *name = _ownArena->allocate(length);
+  bool rc = name != nullptr;
+  if (rc) {
+    memcpy(name, fullName, length);
+    auto separator = strrchr(name, '/');
+    size_t nodeOffset = separator == nullptr ? 0 : separator - name + 1;
+    // The status is fetched with the full name (AT_FDCWD):
+    set(name, length, nodeOffset, AT_FDCWD, DT_UNKNOWN, _ownArena);
+    rc = type() != TF_UNDEF;
+  }
+  return rc;
+}
+FsEntry::Type_t LazyFsEntry::type() {
+  if (_directoryType == DT_UNKNOWN) {
+    getStatus(STATX_TYPE);
+  }
+  Type_t rc = TF_UNDEF;
+  switch (_directoryType) {
+  case DT_DIR:
+    rc = TF_SUBDIR;
+    break;
+  case DT_REG:
+    rc = TF_REGULAR;
+    break;
+  case DT_LNK:
+    rc = TF_LINK;
+    break;
+  case DT_CHR:
+    rc = TF_CHAR;
+    break;
+  case DT_BLK:
+    rc = TF_BLOCK;
+    break;
+  case DT_FIFO:
+    rc = TF_PIPE;
+    break;
+  case DT_SOCK:
+    rc = TF_SOCKET;
+    break;
+  case DT_UNKNOWN:
+    // statx() has failed:
+    break;
+  default:
+    rc = TF_OTHER;
+    break;
+  }
+  return rc;
+}
+
+GetdentsFileAgent::GetdentsFileAgent(const char *base,
+    const DirEntryFilter *filter, TraceUnit *tracer, Logger *logger,
+    DirTreeStatistic &statistics, unsigned int statusMask) :
+    FileAgent(), _base(base == nullptr ? "." : base), _filter(filter), _tracer(
+        tracer), _logger(logger), _statistics(statistics), _statusMask(
+        statusMask), _frames(), _depth(0), _currentEntry(this), _buffer(
+        nullptr), _bufferSize(128 * 1024), _started(false), _statusCalls(0) {
+  if (filter != nullptr) {
+    if (filter->hasSizeCondition()) {
+      _statusMask |= STATX_SIZE;
+    }
+    if (filter->hasAgeCondition()) {
+      _statusMask |= STATX_MTIME;
+    }
+  }
+  _buffer = new char[_bufferSize];
+}
+
+GetdentsFileAgent::~GetdentsFileAgent() {
+  closeAll();
+  for (auto frame : _frames) {
+    delete frame;
+  }
+  _frames.clear();
+  delete[] _buffer;
+  _buffer = nullptr;
+}
+
+void GetdentsFileAgent::changeBase(const char *base) {
+  closeAll();
+  _base = base == nullptr ? "." : base;
+  _started = false;
+}
+
+void GetdentsFileAgent::closeAll() {
+  while (_depth > 0) {
+    close(_frames[--_depth]->_handle);
+  }
+}
+
+bool GetdentsFileAgent::openDirectory(int parentHandle, const char *fullName,
+    size_t fullNameLength, size_t nodeOffset) {
+  bool rc = false;
+  int handle;
+  if (parentHandle == AT_FDCWD) {
+    handle = open(fullNameLength == 0 ? "." : fullName,
+        O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  } else {
+    handle = openat(parentHandle, fullName + nodeOffset,
+        O_RDONLY | O_DIRECTORY | O_CLOEXEC | O_NOFOLLOW);
+  }
+  if (handle < 0) {
+    _statistics._ignoredDirectories++;
+    if (_logger != nullptr && _logger->currentLevel() >= LV_FINE) {
+      _logger->say(LV_FINE, formatCString("_ ignored: %s/", fullName));
+    }
+  } else {
+    if (_frames.size() <= _depth) {
+      _frames.push_back(new Frame());
+    }
+    Frame &frame = *_frames[_depth];
+    // The names of the previous directory of this level are no longer needed:
+    frame._arena.reset();
+    frame._handle = handle;
+    frame._fullName = fullName;
+    frame._fullNameLength = fullNameLength;
+    bool withSeparator = fullNameLength > 0
+        && fullName[fullNameLength - 1] != '/';
+    frame._pathLength = fullNameLength + (withSeparator ? 1 : 0);
+    char *path = frame._arena.allocate(frame._pathLength);
+    if (path == nullptr) {
+      frame._path = "";
+      frame._pathLength = 0;
+    } else {
+      memcpy(path, fullName, fullNameLength);
+      if (withSeparator) {
+        path[fullNameLength] = '/';
+      }
+      frame._path = path;
+    }
+    if (path == nullptr || !readDirectory(frame)) {
+      close(handle);
+      _statistics._ignoredDirectories++;
+      if (_logger != nullptr && _logger->currentLevel() >= LV_FINE) {
+        _logger->say(LV_FINE, formatCString("_ ignored: %s/", fullName));
+      }
+    } else {
+      _depth++;
+      _statistics._directories++;
+      rc = true;
+    }
+  }
+  return rc;
+}
+
+FsEntry*
+GetdentsFileAgent::rawNextFile(int &level) {
+  FsEntry *rc = nullptr;
+  if (!_started) {
+    _started = true;
+    openDirectory(AT_FDCWD, _base.c_str(), _base.size(), 0);
+  }
+  while (rc == nullptr && _depth > 0) {
+    Frame &frame = *_frames[_depth - 1];
+    int currentLevel = static_cast<int>(_depth) - 1;
+    if (frame._nextEntry < frame._entries.size()) {
+      auto &item = frame._entries[frame._nextEntry++];
+      size_t fullNameLength = frame._pathLength + item._nodeLength;
+      _currentEntry.set(item._fullName, fullNameLength, frame._pathLength,
+          frame._handle, item._directoryType, &frame._arena);
+      if (_currentEntry.isDirectory()) {
+        // Like FileAgentLinux: only the path patterns restrict the descent.
+        bool doEnter = _filter == nullptr || _filter->_pathPatterns == nullptr
+            || _filter->_pathPatterns->match(_currentEntry.node());
+        if (!doEnter) {
+          _statistics._ignoredDirectories++;
+        } else {
+          // The directory itself is returned after its content:
+          openDirectory(frame._handle, item._fullName, fullNameLength,
+              frame._pathLength);
+        }
+        continue;
+      }
+    } else {
+      // The directory is complete: return it (if it is not the base).
+      close(frame._handle);
+      if (--_depth == 0) {
+        break;
+      }
+      Frame &parent = *_frames[_depth - 1];
+      currentLevel = static_cast<int>(_depth) - 1;
+      _currentEntry.set(frame._fullName, frame._fullNameLength,
+          parent._pathLength, parent._handle, DT_DIR, &parent._arena);
+    }
+    if (_tracer != nullptr && _tracer->isCountTriggered()
+        && _tracer->isTimeTriggered()) {
+      _tracer->trace(_currentEntry.fullName());
+    }
+    if (_filter == nullptr || _filter->match(_currentEntry, nullptr)) {
+      if (_currentEntry.isRegular()) {
+        _statistics._files++;
+        if ((_statusMask & STATX_SIZE) != 0) {
+          _statistics._sizes += _currentEntry.fileSize();
+        }
+      } else if (!_currentEntry.isDirectory()) {
+        _statistics._files++;
+      }
+      level = currentLevel;
+      rc = &_currentEntry;
+    }
+  }
+  return rc;
+}
+
+bool GetdentsFileAgent::readDirectory(Frame &frame) {
+  bool rc = true;
+  frame._entries.clear();
+  frame._nextEntry = 0;
+  long count;
+  while ((count = syscall(SYS_getdents64, frame._handle, _buffer, _bufferSize))
+      > 0) {
+    long offset = 0;
+    while (offset < count) {
+      auto record = reinterpret_cast<const struct dirent64*>(_buffer + offset);
+      offset += record->d_reclen;
+      const char *node = record->d_name;
+      if (node[0] == '.'
+          && (node[1] == '\0' || (node[1] == '.' && node[2] == '\0'))) {
+        continue;
+      }
+      size_t nodeLength = strlen(node);
+      // The full name is stored: the entry needs no copy when it is fetched.
+      char *fullName = frame._arena.allocate(frame._pathLength + nodeLength);
+      if (fullName == nullptr) {
+        // Longer than the arena capacity:
+        continue;
+      }
+      memcpy(fullName, frame._path, frame._pathLength);
+      memcpy(fullName + frame._pathLength, node, nodeLength);
+      frame._entries.push_back(
+          Frame::Entry { fullName, static_cast<unsigned short>(nodeLength),
+              record->d_type });
+    }
+  }
+  if (count < 0) {
+    rc = false;
+  }
+  return rc;
+}
+
+} /* cppknife */
@@ -0,0 +1,221 @@
+/*
+ * GetdentsFileAgent.hpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef OS_GETDENTSFILEAGENT_HPP_
+#define OS_GETDENTSFILEAGENT_HPP_
+
+namespace cppknife {
+class GetdentsFileAgent;
+/**
+ * @brief A <em>FsEntry</em> with lazy status info fetched by <em>statx()</em>.
+ *
+ * The file type is taken from the directory entry (<em>d_type</em>).
+ * Only if other properties (size, times, rights) are requested a <em>statx()</em> call is done.
+ *
+ * The full name and the link target are slices of the arena of the directory
+ * (owned by the agent): no heap allocation is done per entry.
+ */
+class LazyFsEntry: public FsEntry {
+  friend GetdentsFileAgent;
+protected:
+  GetdentsFileAgent *_parent;
+  /// The name with path: a slice of <em>_arena</em>.
+  const char *_fullName;
+  size_t _fullNameLength;
+  /// The offset of the node in <em>_fullName</em>.
+  size_t _nodeOffset;
+  /// The storage of the names, e.g. the arena of the directory containing the entry.
+  ByteStorage *_arena;
+  /// The arena of the names given by <em>setCertainFile()</em>.
+  ByteStorage *_ownArena;
+  /// The handle of the directory containing the entry (for <em>statx()</em>).
+  int _directoryHandle;
+  /// The file type from the directory entry: DT_REG, DT_DIR...
+  unsigned char _directoryType;
+  /// The STATX_* flags of the fields already available in <em>_status</em>.
+  unsigned int _statusMask;
+  struct statx _status;
+  FileTime_t _accessed;
+  FileTime_t _modified;
+  /// <em>nullptr</em> or the link target: a slice of <em>_arena</em>.
+  const char *_linkTarget;
+  std::string _linkReference;
+public:
+  LazyFsEntry(GetdentsFileAgent *parent);
+  virtual ~LazyFsEntry();
+public:
+  virtual const FileTime_t*
+  accessed();
+  virtual const char*
+  accessFullName();
+  virtual FileSize_t
+  fileSize();
+  virtual std::string
+  filetimeAsString();
+  virtual void finishCertainFile();
+  virtual const char*
+  fullName();
+  virtual size_t fullNameLength();
+  /**
+   * Returns the status info containing at least the given fields.
+   * @param mask The wanted fields, e.g. STATX_SIZE | STATX_MTIME.
+   * @return The status info.
+   */
+  const struct statx& getStatus(unsigned int mask);
+  virtual bool
+  isDirectory();
+  virtual bool
+  isDotDir();
+  virtual bool
+  isLink();
+  virtual bool
+  isRegular();
+  virtual const FileTime_t*
+  modified();
+  virtual const char*
+  node();
+  virtual const std::string&
+  linkReference();
+  virtual const char*
+  linkTarget();
+  virtual bool
+  modeAndOwner(uint32_t &mode, uint32_t &owner, uint32_t &group);
+  virtual const char*
+  rightsAsString(std::string &buffer, bool numerical, int ownerWidth);
+  /**
+   * Sets the name and the directory entry type.
+   * @param fullName The name with path, stored in <em>arena</em>.
+   * @param fullNameLength The length of <em>fullName</em>.
+   * @param nodeOffset The offset of the node (name without path) in <em>fullName</em>.
+   * @param directoryHandle The handle of the directory containing the entry.
+   * @param directoryType The type from the directory entry: DT_REG, DT_UNKNOWN...
+   * @param arena The storage of <em>fullName</em>. Further data (link target) is stored there too.
+   */
+  void set(const char *fullName, size_t fullNameLength, size_t nodeOffset,
+      int directoryHandle, unsigned char directoryType, ByteStorage *arena);
+  virtual bool setCertainFile(const char *fullName);
+  inline virtual bool testNamesFirst() const {
+    return true;
+  }
+  virtual Type_t
+  type();
+};
+/**
+ * @brief A Linux specific <em>FileAgent</em> reading the directories with <em>getdents64()</em>.
+ *
+ * The directory entries are read in large blocks and the file type is taken from <em>d_type</em>.
+ * A <em>statx()</em> call is done only for the fields needed by the filter or the caller
+ * (given as STATX_* mask), e.g. a name only listing needs no status info at all.
+ *
+ * The order of the entries and the filter semantics are the same as in <em>FileAgentLinux</em>:
+ * a directory is returned after its content, the base directory is not returned.
+ *
+ * The names are stored in an arena per directory level (<em>ByteStorage</em>).
+ * The arena is recycled when the next directory of the same level is opened.
+ */
+class GetdentsFileAgent: public FileAgent {
+  friend LazyFsEntry;
+protected:
+  /**
+   * @brief The data of a directory in the stack of the open directories.
+   */
+  class Frame {
+  public:
+    /**
+     * @brief A directory entry: the name is stored in the arena of the frame.
+     */
+    struct Entry {
+      const char *_fullName;
+      unsigned short _nodeLength;
+      unsigned char _directoryType;
+    };
+  public:
+    /// Stores the path and the full names of the entries. Recycled with the frame.
+    ByteStorage _arena;
+    /// The directory with trailing separator: a slice of <em>_arena</em>.
+    const char *_path;
+    size_t _pathLength;
+    int _handle;
+    std::vector<Entry> _entries;
+    size_t _nextEntry;
+    /// The full name of the directory (without trailing separator), stored in the parent's arena.
+    const char *_fullName;
+    size_t _fullNameLength;
+  public:
+    Frame() :
+        _arena(), _path(""), _pathLength(0), _handle(-1), _entries(), _nextEntry(
+            0), _fullName(""), _fullNameLength(0) {
+    }
+  };
+  std::string _base;
+  const DirEntryFilter *_filter;
+  TraceUnit *_tracer;
+  Logger *_logger;
+  DirTreeStatistic &_statistics;
+  /// The STATX_* fields fetched with each status request.
+  unsigned int _statusMask;
+  std::vector<Frame*> _frames;
+  /// Count of valid frames in <em>_frames</em>.
+  size_t _depth;
+  LazyFsEntry _currentEntry;
+  /// The buffer for <em>getdents64()</em>.
+  char *_buffer;
+  size_t _bufferSize;
+  bool _started;
+  /// Count of <em>statx()</em> calls.
+  size_t _statusCalls;
+public:
+  /**
+   * Constructor.
+   *
+   * @param base The base directory. The traversal starts at this point.
+   * @param filter Specifies the search criteria. May be <em>nullptr</em>.
+   * @param tracer <em>nullptr</em> or a handler of trigger points.
+   * @param logger The logging unit.
+   * @param[out] statistics The statistics about files and directories is updated here.
+   *  The file sizes are summed only if <em>statusMask</em> contains STATX_SIZE.
+   * @param statusMask The STATX_* fields needed by the caller, e.g. 0 for a name only listing.
+   *  The fields needed by the filter are added automatically.
+   */
+  GetdentsFileAgent(const char *base, const DirEntryFilter *filter,
+      TraceUnit *tracer, Logger *logger, DirTreeStatistic &statistics,
+      unsigned int statusMask = STATX_BASIC_STATS);
+  virtual
+  ~GetdentsFileAgent();
+private:
+  GetdentsFileAgent(const GetdentsFileAgent &other);
+  GetdentsFileAgent&
+  operator=(const GetdentsFileAgent &other);
+public:
+  virtual void changeBase(const char *base);
+  inline virtual bool isPrefiltered() const {
+    return true;
+  }
+  virtual FsEntry* rawNextFile(int &level);
+  /**
+   * Returns the count of <em>statx()</em> calls since the start.
+   */
+  inline size_t statusCalls() const {
+    return _statusCalls;
+  }
+  /**
+   * Returns the STATX_* fields fetched with each status request.
+   */
+  inline unsigned int statusMask() const {
+    return _statusMask;
+  }
+protected:
+  void closeAll();
+  bool openDirectory(int parentHandle, const char *fullName,
+      size_t fullNameLength, size_t nodeOffset);
+  bool readDirectory(Frame &frame);
+};
+
+} /* cppknife */
+
+#endif /* OS_GETDENTSFILEAGENT_HPP_ */
@@ -34,6 +34,7 @@ void FileBuffer::clone(FileBuffer &other) {
   _restLength = other._restLength;
   _nextLine = _buffer + (other._nextLine - other._buffer);
   _filePosition = other._filePosition;
+  _lineNo = other._lineNo;
   if (static_cast<size_t>(other._endOfBuffer - other._buffer) > _bufferSize) {
     increaseBuffer(other._bufferSize - _bufferSize);
   }
@@ -97,18 +98,102 @@ void FileBuffer::setBufferSize(size_t bufferSize) {
   }
 }
 
+ReadAhead::ReadAhead(int handle, size_t chunks, size_t chunkSize) :
+    _handle(handle), _chunkSize(chunkSize), _chunks(), _lengths(), _head(0), _count(
+        0), _consumed(0), _eof(false), _stop(false), _error(false), _mutex(), _filled(), _emptied(), _thread() {
+  if (chunks < 2) {
+    chunks = 2;
+  }
+  _chunks.reserve(chunks);
+  for (size_t ix = 0; ix < chunks; ix++) {
+    _chunks.push_back(new char[_chunkSize]);
+  }
+  _lengths.resize(chunks);
+}
+ReadAhead::~ReadAhead() {
+  stop();
+  for (auto chunk : _chunks) {
+    delete[] chunk;
+  }
+  _chunks.clear();
+}
+size_t ReadAhead::read(char *buffer, size_t size) {
+  size_t rc = 0;
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (rc < size) {
+    waitForCondition(_filled, lock, [this] {
+      return _count > 0 || _eof;
+    });
+    if (_count == 0) {
+      break;
+    }
+    size_t length = std::min(size - rc, _lengths[_head] - _consumed);
+    memcpy(buffer + rc, _chunks[_head] + _consumed, length);
+    rc += length;
+    if ((_consumed += length) >= _lengths[_head]) {
+      _consumed = 0;
+      _head = (_head + 1) % _chunks.size();
+      _count--;
+      _emptied.notify_one();
+    }
+  }
+  return rc;
+}
+ssize_t ReadAhead::readChunk(char *buffer, size_t size) {
+  return ::read(_handle, buffer, size);
+}
+void ReadAhead::start() {
+  _thread = std::thread(&ReadAhead::run, this);
+}
+void ReadAhead::stop() {
+  if (_thread.joinable()) {
+    {
+      std::lock_guard<std::mutex> guard(_mutex);
+      _stop = true;
+    }
+    _emptied.notify_one();
+    _thread.join();
+  }
+}
+void ReadAhead::run() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (!_stop) {
+    waitForCondition(_emptied, lock, [this] {
+      return _count < _chunks.size() || _stop;
+    });
+    if (_stop) {
+      break;
+    }
+    size_t tail = (_head + _count) % _chunks.size();
+    // Only the consumer changes _head: the chunk tail is not in use.
+    lock.unlock();
+    auto bytes = readChunk(_chunks[tail], _chunkSize);
+    lock.lock();
+    if (bytes <= 0) {
+      _error = bytes < 0;
+      _eof = true;
+      _filled.notify_one();
+      break;
+    }
+    _lengths[tail] = bytes;
+    _count++;
+    _filled.notify_one();
+  }
+}
+
 LineAgent::LineAgent(Logger *logger, size_t startBufferSize, size_t clusterSize) :
     _logger(logger), _handle(-1), _filename(),
     _currentBuffer(nullptr), _previousBuffer(
         nullptr), _eofReached(false), _hasBinaryData(false), _clusterSize(
-        clusterSize) {
+        clusterSize), _useMapping(false), _mapped(false), _mapping(nullptr), _mappingOffset(
+        0), _mappingLength(0), _windowSize(DEFAULT_WINDOW_SIZE), _fileSize(0), _position(
+        0), _mappedLineOffset(0), _scanner(), _skippedLineEnds(), _readAheadChunks(
+        0), _readAhead(nullptr) {
   _currentBuffer = new FileBuffer(startBufferSize);
   _previousBuffer = new FileBuffer(startBufferSize);
 }
 LineAgent::~LineAgent() {
-  if (_handle > 0) {
-    close(_handle);
-  }
+  closeFile();
   delete _currentBuffer;
   _currentBuffer = nullptr;
   delete _previousBuffer;
@@ -118,7 +203,19 @@ LineAgent::~LineAgent() {
 int LineAgent::estimateLineCount() {
   size_t rc = -1;
   struct stat state;
-  if (::stat(_filename.c_str(), &state) == 0) {
+  if (_mapped && _mapping != nullptr) {
+    // A sample from the start of the mapping:
+    size_t length = std::min(_mappingLength, static_cast<size_t>(0x10000));
+    size_t lines = 1;
+    const char *ptr = _mapping;
+    const char *end = _mapping + length;
+    while ((ptr = static_cast<const char*>(memchr(ptr, '\n', end - ptr)))
+        != nullptr) {
+      lines++;
+      ptr++;
+    }
+    rc = 1 + int(static_cast<double>(_fileSize) / length * lines);
+  } else if (::stat(_filename.c_str(), &state) == 0) {
     auto fileSize = state.st_size;
     if (_currentBuffer->_restLength == 0) {
       fillBuffer(0);
@@ -140,12 +237,186 @@ int LineAgent::estimateLineCount() {
   }
   return rc;
 }
+bool LineAgent::mapWindow(size_t position) {
+  static const size_t pageSize = sysconf(_SC_PAGESIZE);
+  size_t offset = position - position % pageSize;
+  size_t length = std::min(_windowSize, _fileSize - offset);
+  unmap();
+  void *mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, _handle,
+      offset);
+  bool rc = mapping != MAP_FAILED;
+  if (!rc) {
+    _logger->say(LV_ERROR,
+        formatCString("cannot map: %s (%d): %s", _filename.c_str(), errno,
+            strerror(errno)));
+  } else {
+    _mapping = static_cast<char*>(mapping);
+    _mappingOffset = offset;
+    _mappingLength = length;
+    madvise(_mapping, _mappingLength, MADV_SEQUENTIAL);
+  }
+  return rc;
+}
+const char* LineAgent::nextBlock(size_t &length) {
+  const char *rc = nullptr;
+  length = 0;
+  if (_mapped && _mapping != nullptr && _position < _fileSize
+      && (_position < _mappingOffset + _mappingLength || mapWindow(_position))) {
+    rc = _mapping + (_position - _mappingOffset);
+    length = _mappingOffset + _mappingLength - _position;
+    _position += length;
+  }
+  return rc;
+}
+const char* LineAgent::nextCandidateLine(const RegexPrefilter &prefilter,
+    size_t &length) {
+  const char *rc = nullptr;
+  length = 0;
+  if (!_mapped || !prefilter.isActive()) {
+    while ((rc = nextLine(length)) != nullptr && !_hasBinaryData
+        && !prefilter.mayMatch(rc, length)) {
+      // skip the line
+    }
+    return rc;
+  }
+  while (rc == nullptr && _position < _fileSize && _mapping != nullptr
+      && !_hasBinaryData) {
+    size_t windowEnd = _mappingOffset + _mappingLength;
+    if (_position >= windowEnd) {
+      if (!mapWindow(_position)) {
+        break;
+      }
+      continue;
+    }
+    const char *start = _mapping + (_position - _mappingOffset);
+    size_t rest = windowEnd - _position;
+    const char *found = prefilter.find(start, rest);
+    bool lastWindow = windowEnd >= _fileSize;
+    // The lines in front of the candidate line are skipped.
+    // Without candidate: all lines of the window, but the last line only at the file end.
+    size_t skipped = rest;
+    if (found != nullptr || !lastWindow) {
+      auto lastEnd = static_cast<const char*>(memrchr(start, '\n',
+          found != nullptr ? found - start : rest));
+      skipped = lastEnd == nullptr ? 0 : lastEnd + 1 - start;
+    }
+    if (skipped > 0) {
+      if (_scanner.indexBlock(start, skipped, _skippedLineEnds)) {
+        // The line containing the binary data is returned:
+        while ((rc = nextMappedLine(length)) != nullptr && !_hasBinaryData) {
+          // skip the line
+        }
+        break;
+      }
+      size_t lines = _skippedLineEnds.size();
+      if (start[skipped - 1] != '\n') {
+        // The last line of the file without '\n':
+        lines++;
+      }
+      _mappedLineOffset = _position
+          + (lines >= 2 ? _skippedLineEnds[lines - 2] + 1 : 0);
+      _currentBuffer->_lineNo += lines;
+      _position += skipped;
+    }
+    if (found != nullptr) {
+      rc = nextMappedLine(length);
+      break;
+    }
+    if (!lastWindow) {
+      if (skipped > 0) {
+        // The next window starts with the unfinished line:
+        if (!mapWindow(_position)) {
+          break;
+        }
+      } else {
+        // A line longer than the window: handled by nextMappedLine().
+        rc = nextMappedLine(length);
+        if (rc != nullptr && !_hasBinaryData
+            && !prefilter.mayMatch(rc, length)) {
+          rc = nullptr;
+        }
+      }
+    }
+  }
+  return rc;
+}
+const char* LineAgent::nextMappedLine(size_t &length) {
+  static const size_t pageSize = sysconf(_SC_PAGESIZE);
+  const char *rc = nullptr;
+  bool binary = false;
+  length = 0;
+  while (rc == nullptr && _position < _fileSize && _mapping != nullptr) {
+    size_t windowEnd = _mappingOffset + _mappingLength;
+    if (_position >= windowEnd) {
+      if (!mapWindow(_position)) {
+        break;
+      }
+      continue;
+    }
+    const char *start = _mapping + (_position - _mappingOffset);
+    size_t rest = windowEnd - _position;
+    binary = false;
+    size_t lineEnd = _scanner.findLineEnd(start, rest, binary);
+    const char *end = lineEnd < rest ? start + lineEnd : nullptr;
+    if (end == nullptr && windowEnd < _fileSize) {
+      // The line crosses the end of the window: remap at the line start.
+      if (_position < _mappingOffset + pageSize) {
+        // The line is longer than the window:
+        _windowSize *= 2;
+      }
+      if (!mapWindow(_position)) {
+        break;
+      }
+      continue;
+    }
+    rc = start;
+    length = end == nullptr ? rest : end - start;
+    _mappedLineOffset = _position;
+    _position += end == nullptr ? length : length + 1;
+  }
+  if (rc != nullptr) {
+    _currentBuffer->_lineNo++;
+    if (binary) {
+      _hasBinaryData = true;
+    }
+  }
+  return rc;
+}
 char* LineAgent::previousLine(int no, size_t &size) {
+  char *rc = nullptr;
   size = 0;
-  return nullptr;
+  // Only the memory mapped mode holds the previous lines:
+  bool ok = _mapped && _mapping != nullptr && no > 0
+      && _currentBuffer->_lineNo > static_cast<size_t>(no);
+  size_t start = _mappedLineOffset;
+  size_t end = start;
+  for (int ix = 0; ok && ix < no; ix++) {
+    // The '\n' of the predecessor must be inside the window:
+    ok = start > _mappingOffset;
+    if (ok) {
+      end = start - 1;
+      auto found = static_cast<char*>(memrchr(_mapping, '\n',
+          end - _mappingOffset));
+      if (found != nullptr) {
+        start = _mappingOffset + (found - _mapping) + 1;
+      } else if (_mappingOffset == 0) {
+        start = 0;
+      } else {
+        ok = false;
+      }
+    }
+  }
+  if (ok) {
+    rc = _mapping + (start - _mappingOffset);
+    size = end - start;
+  }
+  return rc;
 }
 const char* LineAgent::nextLine(size_t &length) {
   const char *rc = nullptr;
+  if (_mapped) {
+    return nextMappedLine(length);
+  }
   if (_handle > 0) {
     if (!_eofReached && _currentBuffer->_restLength == 0) {
       fillBuffer(0);
@@ -155,12 +426,16 @@ const char* LineAgent::nextLine(size_t &length) {
             _currentBuffer->_buffer : _currentBuffer->_nextLine;
     _currentBuffer->_lineNo++;
     bool again = false;
+    bool binary = false;
     do {
       again = false;
-      if (_currentBuffer->_restLength > 0
-          && (_currentBuffer->_nextLine = static_cast<char*>(memchr(
-              static_cast<void*>(_currentBuffer->_nextLine), '\n',
-              _currentBuffer->_restLength))) != nullptr) {
+      size_t lineEnd =
+          _currentBuffer->_restLength == 0 ?
+              0 :
+              _scanner.findLineEnd(_currentBuffer->_nextLine,
+                  _currentBuffer->_restLength, binary);
+      if (lineEnd < _currentBuffer->_restLength) {
+        _currentBuffer->_nextLine += lineEnd;
         *_currentBuffer->_nextLine = '\0';
         length = _currentBuffer->_nextLine - rc;
         if (++(_currentBuffer->_nextLine) > _currentBuffer->_endOfBuffer) {
@@ -192,21 +467,23 @@ const char* LineAgent::nextLine(size_t &length) {
         again = true;
       }
     } while (again);
-    if (rc != nullptr) {
-      unsigned char *ptr = (unsigned char*) rc;
-      auto count = length;
-      unsigned char cc;
-      while (count-- > 0) {
-        if ((cc = *ptr) == '0' || (cc < ' ' && (cc < '\t' || cc > '\r'))) {
-          _hasBinaryData = true;
-          break;
-        }
-      }
+    if (rc != nullptr && binary) {
+      _hasBinaryData = true;
     }
   }
   _currentBuffer->_offsetCurrentLine = rc - _currentBuffer->_buffer;
   return rc;
 }
+void LineAgent::closeFile() {
+  // The read thread uses the handle:
+  delete _readAhead;
+  _readAhead = nullptr;
+  unmap();
+  if (_handle > 0) {
+    close(_handle);
+    _handle = -1;
+  }
+}
 void LineAgent::fillBuffer(size_t startOffset) {
   // Swap the two buffers:
   auto swap = _currentBuffer;
@@ -220,19 +497,26 @@ void LineAgent::fillBuffer(size_t startOffset) {
   _currentBuffer->addOffset();
   _currentBuffer->_nextLine = _currentBuffer->_buffer
       + _currentBuffer->_restLength;
-  ssize_t requested = _currentBuffer->_endOfBuffer - _currentBuffer->_nextLine;
+  // The free space behind the rest, not the end of the last valid data:
+  ssize_t requested = _currentBuffer->_bufferSize - _currentBuffer->_restLength;
   if (requested <= 0) {
     _currentBuffer->_nextLine = _currentBuffer->_buffer;
     requested = _currentBuffer->_bufferSize;
   }
-  auto bytes = read(_handle, _currentBuffer->_nextLine, requested);
+  ssize_t bytes =
+      _readAhead != nullptr ?
+          _readAhead->read(_currentBuffer->_nextLine, requested) :
+          read(_handle, _currentBuffer->_nextLine, requested);
   if (bytes < 0) {
     bytes = 0;
   }
-  if (_currentBuffer->_restLength + bytes < _currentBuffer->_bufferSize) {
-    _currentBuffer->_endOfBuffer = _currentBuffer->_nextLine + bytes;
-    *(_currentBuffer->_endOfBuffer) = '\0';
+  if (_readAhead != nullptr && bytes < requested && _readAhead->error()) {
+    _logger->say(LV_ERROR,
+        formatCString("cannot read: %s: corrupted or truncated",
+            _filename.c_str()));
   }
+  _currentBuffer->_endOfBuffer = _currentBuffer->_nextLine + bytes;
+  *(_currentBuffer->_endOfBuffer) = '\0';
   if (bytes > 0 && memchr(_currentBuffer->_nextLine, '\0', bytes) != nullptr) {
     _hasBinaryData = true;
   }
@@ -242,14 +526,16 @@ void LineAgent::fillBuffer(size_t startOffset) {
 }
 
 size_t LineAgent::offsetCurrentLine() const {
-  return _currentBuffer->_filePosition + _currentBuffer->_offsetCurrentLine;
+  return
+      _mapped ?
+          _mappedLineOffset :
+          _currentBuffer->_filePosition + _currentBuffer->_offsetCurrentLine;
 }
 bool LineAgent::openFile(const char *filename, bool checkBinary,
     bool ignoreError) {
-  if (_handle > 0) {
-    close(_handle);
-  }
+  closeFile();
   _eofReached = false;
+  _mapped = false;
   _handle = open(filename, O_RDONLY);
   _filename = filename;
   _hasBinaryData = false;
@@ -264,9 +550,44 @@ bool LineAgent::openFile(const char *filename, bool checkBinary,
     rc = false;
   }
   reset();
-  if (checkBinary) {
+  CompressionType compression = rc ? compressionOf(_handle) : CT_NONE;
+  if (compression != CT_NONE) {
+    // Decompressed as a stream in a background thread:
+    _readAhead = createDecompressor(compression, _handle,
+        std::max(_readAheadChunks, static_cast<size_t>(2)),
+        _currentBuffer->_bufferSize);
+    if (_readAhead == nullptr) {
+      _logger->say(LV_ERROR,
+          formatCString("%s: %s compression is not supported", filename,
+              compressionName(compression)));
+      rc = false;
+    }
+  } else if (rc && !_useMapping && _readAheadChunks > 0) {
+    posix_fadvise(_handle, 0, 0, POSIX_FADV_SEQUENTIAL);
+    _readAhead = new ReadAhead(_handle, _readAheadChunks,
+        _currentBuffer->_bufferSize);
+    _readAhead->start();
+  }
+  struct stat status;
+  if (rc && compression == CT_NONE && _useMapping && fstat(_handle, &status) == 0
+      && S_ISREG(status.st_mode) && status.st_size > 0) {
+    _fileSize = status.st_size;
+    _position = _mappedLineOffset = 0;
+    _currentBuffer->_lineNo = 0;
+    _mapped = mapWindow(0);
+    if (_mapped && checkBinary
+        && memchr(_mapping, '\0', std::min(_mappingLength, static_cast<size_t>(4096)))
+            != nullptr) {
+      _hasBinaryData = true;
+      rc = false;
+    }
+  }
+  if (checkBinary && !_mapped) {
     size_t tempSize = min(_currentBuffer->_bufferSize, 4096);
-    auto bytes = read(_handle, _currentBuffer->_buffer, tempSize);
+    ssize_t bytes =
+        _readAhead != nullptr ?
+            _readAhead->read(_currentBuffer->_buffer, tempSize) :
+            read(_handle, _currentBuffer->_buffer, tempSize);
     if (bytes <= 0) {
       if (!ignoreError) {
         char buffer[512];
@@ -282,16 +603,56 @@ bool LineAgent::openFile(const char *filename, bool checkBinary,
       }
       _eofReached = static_cast<size_t>(bytes) < tempSize;
       _currentBuffer->_restLength += bytes;
+      _currentBuffer->_endOfBuffer = _currentBuffer->_buffer + bytes;
+      *(_currentBuffer->_endOfBuffer) = '\0';
       _currentBuffer->_nextLine = _currentBuffer->_buffer;
     }
   }
   return rc;
 }
+bool LineAgent::openRange(const char *filename, size_t start, size_t end,
+    bool checkBinary) {
+  closeFile();
+  _eofReached = false;
+  _mapped = false;
+  _hasBinaryData = false;
+  _filename = filename;
+  _handle = open(filename, O_RDONLY);
+  reset();
+  _currentBuffer->_lineNo = 0;
+  struct stat status;
+  bool rc = _handle >= 0 && fstat(_handle, &status) == 0
+      && S_ISREG(status.st_mode);
+  if (!rc) {
+    _logger->say(LV_ERROR,
+        formatCString("cannot open: %s (%d)", filename, errno));
+  } else {
+    _fileSize = std::min(end, static_cast<size_t>(status.st_size));
+    _position = _mappedLineOffset = start;
+    // An empty range has no mapping: nextLine() returns nullptr.
+    _mapped = start >= _fileSize || mapWindow(start);
+    rc = _mapped;
+    if (rc && checkBinary && start == 0 && _mapping != nullptr
+        && memchr(_mapping, '\0',
+            std::min(_mappingLength, static_cast<size_t>(4096))) != nullptr) {
+      _hasBinaryData = true;
+      rc = false;
+    }
+  }
+  return rc;
+}
 
 void LineAgent::reset() {
   _currentBuffer->reset();
   _previousBuffer->reset();
 }
+void LineAgent::setMemoryMapped(bool useMapping, size_t windowSize) {
+  _useMapping = useMapping;
+  _windowSize = windowSize == 0 ? DEFAULT_WINDOW_SIZE : windowSize;
+}
+void LineAgent::setReadAhead(size_t chunks) {
+  _readAheadChunks = chunks;
+}
 void LineAgent::setBufferSize(size_t bufferSize) {
   if (_currentBuffer->_nextLine != _currentBuffer->_buffer) {
     _logger->say(LV_ERROR, "setBufferSize(): illegal state. No change done.");
@@ -300,4 +661,11 @@ void LineAgent::setBufferSize(size_t bufferSize) {
     _previousBuffer->setBufferSize(bufferSize);
   }
 }
+void LineAgent::unmap() {
+  if (_mapping != nullptr) {
+    munmap(_mapping, _mappingLength);
+    _mapping = nullptr;
+    _mappingLength = 0;
+  }
+}
 } /* namespace */
@@ -74,6 +74,78 @@ public:
    */
   void setBufferSize(size_t bufferSize);
 };
+/**
+ * @brief Reads a file in a background thread into a ring of chunks.
+ *
+ * The consumer (<em>LineAgent::fillBuffer()</em>) takes the data from the ring
+ * while the thread reads the next chunks: parsing and I/O overlap.
+ * Derived classes can transform the data in <em>readChunk()</em>, e.g. decompress it.
+ */
+class ReadAhead {
+protected:
+  int _handle;
+  size_t _chunkSize;
+  /// The ring: <em>_count</em> filled chunks starting at <em>_head</em>.
+  std::vector<char*> _chunks;
+  std::vector<size_t> _lengths;
+  size_t _head;
+  size_t _count;
+  /// The already consumed bytes of the chunk <em>_head</em>.
+  size_t _consumed;
+  /// <em>true</em>: the thread has read the last chunk.
+  bool _eof;
+  bool _stop;
+  /// <em>true</em>: <em>readChunk()</em> has failed, e.g. corrupted compressed data.
+  bool _error;
+  std::mutex _mutex;
+  std::condition_variable _filled;
+  std::condition_variable _emptied;
+  std::thread _thread;
+public:
+  /**
+   * Constructor. The read thread is started by <em>start()</em>.
+   * @param handle The file to read. Not closed by the instance.
+   * @param chunks The count of chunks in the ring.
+   * @param chunkSize The size of one chunk: the size of one <em>read()</em>.
+   */
+  ReadAhead(int handle, size_t chunks, size_t chunkSize);
+  virtual ~ReadAhead();
+private:
+  ReadAhead(const ReadAhead &other);
+  ReadAhead&
+  operator=(const ReadAhead &other);
+public:
+  /**
+   * Returns whether reading the data has failed.
+   */
+  inline bool error() const {
+    return _error;
+  }
+  /**
+   * Copies data from the ring into a buffer like <em>read()</em>.
+   * @param buffer The target.
+   * @param size The size of <em>buffer</em>.
+   * @return The count of copied bytes: less than <em>size</em> only at the end of file.
+   */
+  size_t read(char *buffer, size_t size);
+  /**
+   * Starts the read thread at the current file position of the handle.
+   */
+  void start();
+  /**
+   * Stops the read thread. Must be called in the destructor of derived classes.
+   */
+  void stop();
+protected:
+  /**
+   * Fills one chunk. Called by the read thread.
+   * @param buffer The chunk to fill.
+   * @param size The size of <em>buffer</em>.
+   * @return The count of bytes stored in <em>buffer</em>. 0: end of file. &lt; 0: error.
+   */
+  virtual ssize_t readChunk(char *buffer, size_t size);
+  void run();
+};
 /**
  * @brief Allows splitting a file into lines like <em>FILE</em>: Binary data detection, unlimited line size. previous line(s), file position of the line.
  *
@@ -83,9 +155,16 @@ public:
  * <li>The file position of the current line can be requested: <em>offsetCurrentLine()</em></li>
  * <li>Avoids memory allocation for one line.</li>
  * <li>At least one previous line can be requested: <em>previousLine()</em>.
+ * <li>Optional memory mapped mode (<em>setMemoryMapped()</em>): the lines are views into the mapping, no copy.
+ * <li>Optional read-ahead (<em>setReadAhead()</em>): a background thread reads the next blocks.
  * </ul>
  */
 class LineAgent {
+public:
+  enum {
+    /// The size of the mapped part of the file in the memory mapped mode.
+    DEFAULT_WINDOW_SIZE = 0x10000000
+  };
 protected:
   Logger *_logger;
   int _handle;
@@ -99,6 +178,29 @@ protected:
   ///
   /// 0: If the buffer is too small the size will be doubled. Otherwise: the buffer is increased by that amount of bytes.
   size_t _clusterSize;
+  /// <em>true</em>: regular files are mapped into memory instead of read.
+  bool _useMapping;
+  /// <em>true</em>: the current file is processed in the memory mapped mode.
+  bool _mapped;
+  /// <em>nullptr</em> or the mapped window of the file.
+  char *_mapping;
+  /// The file position of the window.
+  size_t _mappingOffset;
+  size_t _mappingLength;
+  size_t _windowSize;
+  size_t _fileSize;
+  /// Memory mapped mode: the file position of the next line.
+  size_t _position;
+  /// Memory mapped mode: the file position of the current line.
+  size_t _mappedLineOffset;
+  /// Finds the line ends and the binary data in one pass.
+  LineScanner _scanner;
+  /// The line ends of the lines skipped by <em>nextCandidateLine()</em>.
+  std::vector<uint32_t> _skippedLineEnds;
+  /// 0 or the count of chunks read in advance in the buffered mode.
+  size_t _readAheadChunks;
+  /// <em>nullptr</em> or the read thread of the current file.
+  ReadAhead *_readAhead;
 public:
   /**
    * Constructor.
@@ -121,7 +223,10 @@ public:
    * Tests whether the end of file has been reached: No more data available.
    */
   bool eof() const {
-    return _eofReached && _currentBuffer->_restLength == 0;
+    return
+        _mapped ?
+            _position >= _fileSize :
+            _eofReached && _currentBuffer->_restLength == 0;
   }
   /**
    * Estimates the count of lines of the file.
@@ -136,11 +241,19 @@ public:
   inline bool hasBinaryData() const {
     return _hasBinaryData;
   }
+  /**
+   * Returns whether the current file is mapped into memory.
+   */
+  inline bool isMapped() const {
+    return _mapped;
+  }
   /**
    * Returns the no-th predesessor line of the current line.
+   * Only available in the memory mapped mode.
    * @param no The number of the predesessor: 1: the direct predesessor ...
    * @param[out] size The length of the returned line.
    * @return <em>nullptr</em>: the line cannot returned: no more in the buffer. Otherwise: the requested line.
+   *  Not terminated by '\0'.
    */
   char* previousLine(int no, size_t &size);
   /**
@@ -149,8 +262,32 @@ public:
    * @param[out] length The line length.
    * @return <em>nullptr</em>: no more data.
    *   Otherwise: the line without ending '\n'.
+   *   Note: in the memory mapped mode the line is a view into the mapping
+   *   and not terminated by '\0': use <em>length</em>.
    */
   const char* nextLine(size_t &length);
+  /**
+   * Returns the next line which may contain a hit of a prefilter: the other lines are skipped.
+   *
+   * In the memory mapped mode the literals of the prefilter are searched in the whole window,
+   * not line by line: the skipped lines are only counted. Binary data in the skipped lines
+   * are detected: the line containing them is returned.
+   * @param prefilter Finds the candidates of the hits.
+   * @param[out] length The line length.
+   * @return <em>nullptr</em>: no more candidates. Otherwise: the line (see <em>nextLine()</em>).
+   */
+  const char* nextCandidateLine(const RegexPrefilter &prefilter,
+      size_t &length);
+  /**
+   * Returns the unprocessed data of the current window as one block.
+   * Only available in the memory mapped mode.
+   *
+   * For processing independent of lines (e.g. counting words): the block ends at
+   * the window end, not at a line end, and the line number remains unchanged.
+   * @param[out] length The length of the block.
+   * @return <em>nullptr</em>: no more data. Otherwise: the block, a view into the mapping.
+   */
+  const char* nextBlock(size_t &length);
   /**
    * Returns the file position of the current line;
    */
@@ -163,14 +300,53 @@ public:
    */
   bool openFile(const char *filename, bool testBinary = true, bool ignoreError =
       false);
+  /**
+   * Opens a part of a regular file in the memory mapped mode.
+   *
+   * Used for processing one file in parallel (see <em>ChunkedFile</em>):
+   * the lines of the range are returned, the line numbers start with 1 at <em>start</em>.
+   * @param filename The name of the file. Must not be compressed.
+   * @param start The file position of the first line of the range.
+   * @param end The file position behind the range.
+   * @param checkBinary <em>true</em>: if the range starts at the file start the first 4 KiByte are tested for binary data.
+   * @return <em>false</em>: the file cannot be mapped or contains binary data.
+   */
+  bool openRange(const char *filename, size_t start, size_t end,
+      bool checkBinary = true);
   void reset();
   /**
    * Sets the buffer size. This is the maximal possible line length.
    * @param bufferSize the new buffersize.
    */
   void setBufferSize(size_t bufferSize);
+  /**
+   * Sets the memory mapped mode. Used from the next <em>openFile()</em>.
+   *
+   * A regular file is mapped window by window (read only, sequential access advice).
+   * The lines are returned as views into the mapping: no copy, but no terminating '\0'.
+   * A line crossing the end of the window is handled by remapping at the line start.
+   * If the file cannot be mapped (pipes, special files) the buffered mode is used.
+   * Note: if the file is truncated while it is processed (e.g. log rotation) the access
+   * of a page behind the new end raises SIGBUS. Use the buffered mode for such files.
+   * @param useMapping <em>true</em>: regular files are mapped.
+   * @param windowSize The size of the mapped part of the file. 0: <em>DEFAULT_WINDOW_SIZE</em>.
+   */
+  void setMemoryMapped(bool useMapping, size_t windowSize = 0);
+  /**
+   * Sets the read-ahead of the buffered mode. Used from the next <em>openFile()</em>.
+   *
+   * A background thread reads the file into a ring of <em>chunks</em> blocks
+   * (with the size of the buffer) while the lines of the current block are processed.
+   * Useful for large files not in the page cache.
+   * @param chunks 0: no read-ahead. Otherwise: the count of blocks read in advance.
+   */
+  void setReadAhead(size_t chunks);
 protected:
+  void closeFile();
   void fillBuffer(size_t startOffset);
+  bool mapWindow(size_t position);
+  const char* nextMappedLine(size_t &length);
+  void unmap();
 }
 ;
 } /* namespace */
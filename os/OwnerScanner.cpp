@@ -0,0 +1,345 @@
+/*
+ * OwnerScanner.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "os.hpp"
+
+namespace cppknife {
+
+static const char *binaryMagic = "CKOWNER1";
+static const int openFlags = O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC;
+
+static void appendVarint(std::string &buffer, uint64_t value) {
+  while (value >= 0x80) {
+    buffer += static_cast<char>((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  buffer += static_cast<char>(value);
+}
+static void appendDelta(std::string &buffer, int64_t delta) {
+  // zigzag encoding: small negative numbers become small positive numbers.
+  appendVarint(buffer,
+      (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63));
+}
+static void appendBytes(std::string &buffer, const char *string,
+    size_t length) {
+  appendVarint(buffer, length);
+  buffer.append(string, length);
+}
+static bool readVarint(const unsigned char *&ptr, const unsigned char *end,
+    uint64_t &value) {
+  value = 0;
+  int shift = 0;
+  bool rc = false;
+  while (ptr < end && shift < 64) {
+    unsigned char cc = *ptr++;
+    value |= static_cast<uint64_t>(cc & 0x7f) << shift;
+    shift += 7;
+    if ((cc & 0x80) == 0) {
+      rc = true;
+      break;
+    }
+  }
+  return rc;
+}
+static bool readDelta(const unsigned char *&ptr, const unsigned char *end,
+    int64_t &delta) {
+  uint64_t value = 0;
+  bool rc = readVarint(ptr, end, value);
+  delta = static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  return rc;
+}
+static bool readString(const unsigned char *&ptr, const unsigned char *end,
+    std::string &string) {
+  uint64_t length = 0;
+  bool rc = readVarint(ptr, end, length)
+      && length <= static_cast<uint64_t>(end - ptr);
+  if (rc) {
+    string.assign(reinterpret_cast<const char*>(ptr), length);
+    ptr += length;
+  }
+  return rc;
+}
+
+OwnerScanner::OwnerScanner(Logger *logger, FILE *textOutput,
+    FILE *binaryOutput, int threads) :
+    _logger(logger), _textOutput(textOutput), _binaryOutput(binaryOutput), _pool(
+        nullptr), _mutex(), _countFiles(0), _countDirs(0), _countErrors(0), _openHandles(
+        0), _maxOpenHandles(256), _uids(), _gids(), _lastPath(), _lastUid(0), _lastGid(
+        0) {
+  if (threads == 0) {
+    threads = ThreadPool::defaultThreadCount();
+  }
+  if (threads > 1) {
+    _pool = new ThreadPool(threads);
+  }
+  if (_binaryOutput != nullptr) {
+    fwrite(binaryMagic, 1, strlen(binaryMagic), _binaryOutput);
+  }
+}
+
+OwnerScanner::~OwnerScanner() {
+  delete _pool;
+  _pool = nullptr;
+}
+
+bool OwnerScanner::binaryToText(const char *filename, std::string &text,
+    Logger *logger) {
+  std::string content = readAsString(filename, logger);
+  const unsigned char *ptr =
+      reinterpret_cast<const unsigned char*>(content.data());
+  const unsigned char *end = ptr + content.size();
+  size_t magicLength = strlen(binaryMagic);
+  bool rc = content.size() >= magicLength
+      && memcmp(ptr, binaryMagic, magicLength) == 0;
+  ptr += rc ? magicLength : 0;
+  std::string path;
+  std::string name;
+  int64_t uid = 0;
+  int64_t gid = 0;
+  while (rc && ptr < end) {
+    char tag = static_cast<char>(*ptr++);
+    uint64_t prefix = 0;
+    uint64_t count = 0;
+    int64_t delta = 0;
+    int64_t delta2 = 0;
+    switch (tag) {
+    case 'D':
+      rc = readVarint(ptr, end, prefix) && prefix <= path.size()
+          && readString(ptr, end, name) && readDelta(ptr, end, delta)
+          && readDelta(ptr, end, delta2) && readVarint(ptr, end, count);
+      if (rc) {
+        path.resize(prefix);
+        path += name;
+        uid += delta;
+        gid += delta2;
+        text += formatCString("=%lld %lld %s\n", static_cast<long long>(uid),
+            static_cast<long long>(gid), path.c_str());
+        for (uint64_t ix = 0; rc && ix < count; ix++) {
+          rc = readDelta(ptr, end, delta) && readDelta(ptr, end, delta2)
+              && readString(ptr, end, name);
+          if (rc) {
+            text += formatCString("%lld %lld %s\n",
+                static_cast<long long>(uid + delta),
+                static_cast<long long>(gid + delta2), name.c_str());
+          }
+        }
+      }
+      break;
+    case 'U':
+    case 'G':
+      rc = readVarint(ptr, end, count) && readString(ptr, end, name);
+      if (rc) {
+        text += formatCString("%c%llu %s\n", tag == 'U' ? 'u' : 'g',
+            static_cast<unsigned long long>(count), name.c_str());
+      }
+      break;
+    default:
+      rc = false;
+      break;
+    }
+  }
+  if (!rc && logger != nullptr) {
+    logger->say(LV_ERROR,
+        formatCString("not a valid owner file: %s", filename));
+  }
+  return rc;
+}
+
+void OwnerScanner::finish() {
+  std::string buffer;
+  for (auto uid : _uids) {
+    struct passwd *info = getpwuid(uid);
+    const char *name = info == nullptr ? "?" : info->pw_name;
+    if (_textOutput != nullptr) {
+      fprintf(_textOutput, "u%d %s\n", uid, name);
+    }
+    buffer += 'U';
+    appendVarint(buffer, uid);
+    appendBytes(buffer, name, strlen(name));
+  }
+  for (auto gid : _gids) {
+    struct group *info = getgrgid(gid);
+    const char *name = info == nullptr ? "?" : info->gr_name;
+    if (_textOutput != nullptr) {
+      fprintf(_textOutput, "g%d %s\n", gid, name);
+    }
+    buffer += 'G';
+    appendVarint(buffer, gid);
+    appendBytes(buffer, name, strlen(name));
+  }
+  if (_binaryOutput != nullptr) {
+    fwrite(buffer.data(), 1, buffer.size(), _binaryOutput);
+  }
+}
+
+void OwnerScanner::openSubDirectory(int parent, const std::string &path,
+    const char *node, uid_t uid, gid_t gid) {
+  std::string fullName(path);
+  if (fullName.empty() || fullName.back() != '/') {
+    fullName += '/';
+  }
+  fullName += node;
+  int handle = -1;
+  if (_pool == nullptr || _openHandles < _maxOpenHandles) {
+    if ((handle = openat(parent, node, openFlags)) < 0) {
+      _logger->say(LV_DETAIL,
+          formatCString("openat() failed: %s (%d)", fullName.c_str(), errno));
+      ++_countErrors;
+      return;
+    }
+    ++_openHandles;
+  }
+  if (_pool == nullptr) {
+    scanDirectory(handle, fullName, uid, gid);
+  } else {
+    _pool->submit([this, handle, fullName, uid, gid] {
+      int handle2 = handle;
+      if (handle2 < 0) {
+        // Too many open handles: the directory is opened by name.
+        if ((handle2 = open(fullName.c_str(), openFlags)) < 0) {
+          _logger->say(LV_DETAIL,
+              formatCString("open() failed: %s (%d)", fullName.c_str(),
+              errno));
+          ++_countErrors;
+          return;
+        }
+        ++_openHandles;
+      }
+      scanDirectory(handle2, fullName, uid, gid);
+    });
+  }
+}
+
+bool OwnerScanner::scan(const char *base) {
+  bool rc = false;
+  struct stat status;
+  int handle = open(base, openFlags & ~O_NOFOLLOW);
+  if (handle < 0 || fstat(handle, &status) != 0) {
+    _logger->say(LV_ERROR,
+        formatCString("cannot open directory: %s (%d)", base, errno));
+    if (handle >= 0) {
+      close(handle);
+    }
+  } else {
+    rc = true;
+    std::vector<Deviation> noDeviations;
+    writeDirectory(base, status.st_uid, status.st_gid, noDeviations, "");
+    ++_openHandles;
+    scanDirectory(handle, base, status.st_uid, status.st_gid);
+    if (_pool != nullptr) {
+      _pool->waitIdle();
+    }
+  }
+  return rc;
+}
+
+void OwnerScanner::scanDirectory(int handle, const std::string &path,
+    uid_t uid, gid_t gid) {
+  DIR *dir = fdopendir(handle);
+  if (dir == nullptr) {
+    _logger->say(LV_DETAIL,
+        formatCString("fdopendir() failed: %s (%d)", path.c_str(), errno));
+    ++_countErrors;
+    close(handle);
+    --_openHandles;
+    return;
+  }
+  std::vector<Deviation> deviations;
+  std::string nodes;
+  std::vector<SubDirectory> subDirectories;
+  std::string subNodes;
+  struct dirent *data;
+  struct stat status;
+  int64_t files = 0;
+  int64_t dirs = 0;
+  while ((data = readdir(dir)) != nullptr) {
+    const char *node = data->d_name;
+    if (node[0] == '.'
+        && (node[1] == '\0' || (node[1] == '.' && node[2] == '\0'))) {
+      continue;
+    }
+    if (fstatat(handle, node, &status, AT_SYMLINK_NOFOLLOW) != 0) {
+      _logger->say(LV_DETAIL,
+          formatCString("fstatat() failed: %s/%s", path.c_str(), node));
+      ++_countErrors;
+      continue;
+    }
+    if (status.st_uid != uid || status.st_gid != gid) {
+      deviations.push_back(Deviation { status.st_uid, status.st_gid,
+          nodes.size() });
+      nodes.append(node, strlen(node) + 1);
+    }
+    if (S_ISDIR(status.st_mode)) {
+      dirs++;
+      subDirectories.push_back(SubDirectory { status.st_uid, status.st_gid,
+          subNodes.size() });
+      subNodes.append(node, strlen(node) + 1);
+    } else {
+      files++;
+    }
+  }
+  _countFiles += files;
+  _countDirs += dirs;
+  if (!deviations.empty()) {
+    writeDirectory(path, uid, gid, deviations, nodes);
+  }
+  // The handle is still open: the subdirectories are opened relative to it.
+  for (auto &subDirectory : subDirectories) {
+    openSubDirectory(handle, path, subNodes.c_str() + subDirectory._node,
+        subDirectory._uid, subDirectory._gid);
+  }
+  closedir(dir);
+  --_openHandles;
+}
+
+void OwnerScanner::writeDirectory(const std::string &path, uid_t uid,
+    gid_t gid, const std::vector<Deviation> &deviations,
+    const std::string &nodes) {
+  std::lock_guard<std::mutex> guard(_mutex);
+  _uids.insert(uid);
+  _gids.insert(gid);
+  if (_textOutput != nullptr) {
+    fprintf(_textOutput, "=%d %d %s\n", uid, gid, path.c_str());
+    for (auto &deviation : deviations) {
+      fprintf(_textOutput, "%d %d %s\n", deviation._uid, deviation._gid,
+          nodes.c_str() + deviation._node);
+    }
+  }
+  for (auto &deviation : deviations) {
+    _uids.insert(deviation._uid);
+    _gids.insert(deviation._gid);
+  }
+  if (_binaryOutput != nullptr) {
+    std::string buffer;
+    size_t prefix = 0;
+    size_t maxPrefix = std::min(path.size(), _lastPath.size());
+    while (prefix < maxPrefix && path[prefix] == _lastPath[prefix]) {
+      prefix++;
+    }
+    buffer += 'D';
+    appendVarint(buffer, prefix);
+    appendBytes(buffer, path.c_str() + prefix, path.size() - prefix);
+    appendDelta(buffer, static_cast<int64_t>(uid) - _lastUid);
+    appendDelta(buffer, static_cast<int64_t>(gid) - _lastGid);
+    appendVarint(buffer, deviations.size());
+    for (auto &deviation : deviations) {
+      const char *node = nodes.c_str() + deviation._node;
+      appendDelta(buffer,
+          static_cast<int64_t>(deviation._uid) - static_cast<int64_t>(uid));
+      appendDelta(buffer,
+          static_cast<int64_t>(deviation._gid) - static_cast<int64_t>(gid));
+      appendBytes(buffer, node, strlen(node));
+    }
+    fwrite(buffer.data(), 1, buffer.size(), _binaryOutput);
+    _lastPath = path;
+    _lastUid = uid;
+    _lastGid = gid;
+  }
+}
+
+} /* cppknife */
@@ -0,0 +1,138 @@
+/*
+ * OwnerScanner.hpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef OS_OWNERSCANNER_HPP_
+#define OS_OWNERSCANNER_HPP_
+
+namespace cppknife {
+/**
+ * @brief Collects the entries of a directory tree with another owner or group than their directory.
+ *
+ * Each directory is read in one pass: the entries are inspected with <em>fstatat()</em>
+ * relative to the directory handle, the subdirectories are opened with <em>openat()</em>.
+ * With more than one thread the subdirectories are scanned by a <em>ThreadPool</em>.
+ *
+ * Text format: one block per directory with deviations:
+ * <pre>=&lt;uid> &lt;gid> &lt;directory>
+ * &lt;uid> &lt;gid> &lt;node>
+ * ...
+ * u&lt;uid> &lt;user name>
+ * g&lt;gid> &lt;group name></pre>
+ * The first line contains the base directory, the user and group names are written at the end.
+ *
+ * Binary format: the same information, delta encoded:
+ * <pre>"CKOWNER1"
+ * 'D' prefix suffixLength suffix uidDelta gidDelta countEntries { uidDelta gidDelta nameLength name }*
+ * 'U' uid nameLength name
+ * 'G' gid nameLength name</pre>
+ * All numbers are LEB128 varints, deltas are zigzag encoded. The directory path is
+ * stored as the length of the common prefix with the previous directory plus the rest,
+ * the directory ids relative to the previous directory, the entry ids relative to the directory.
+ */
+class OwnerScanner {
+protected:
+  /**
+   * @brief An entry with another owner or group than its directory.
+   */
+  struct Deviation {
+    uid_t _uid;
+    gid_t _gid;
+    /// The offset of the node in the node buffer.
+    size_t _node;
+  };
+  /**
+   * @brief A subdirectory found while scanning a directory.
+   */
+  struct SubDirectory {
+    uid_t _uid;
+    gid_t _gid;
+    size_t _node;
+  };
+protected:
+  Logger *_logger;
+  FILE *_textOutput;
+  FILE *_binaryOutput;
+  ThreadPool *_pool;
+  /// Protects the outputs and the id sets.
+  std::mutex _mutex;
+  std::atomic<int64_t> _countFiles;
+  std::atomic<int64_t> _countDirs;
+  std::atomic<int64_t> _countErrors;
+  /// The count of open directory handles waiting for their scan.
+  std::atomic<int> _openHandles;
+  int _maxOpenHandles;
+  std::set<uid_t> _uids;
+  std::set<gid_t> _gids;
+  /// The last directory written to the binary output: base of the delta encoding.
+  std::string _lastPath;
+  int64_t _lastUid;
+  int64_t _lastGid;
+public:
+  /**
+   * Constructor.
+   * @param logger The logging unit.
+   * @param textOutput <em>nullptr</em> or the file for the text format.
+   * @param binaryOutput <em>nullptr</em> or the file for the binary format.
+   * @param threads The count of threads. 0: the count of CPU cores.
+   */
+  OwnerScanner(Logger *logger, FILE *textOutput, FILE *binaryOutput,
+      int threads = 1);
+  virtual ~OwnerScanner();
+private:
+  OwnerScanner(const OwnerScanner &other);
+  OwnerScanner&
+  operator=(const OwnerScanner &other);
+public:
+  inline int64_t countDirs() const {
+    return _countDirs;
+  }
+  inline int64_t countErrors() const {
+    return _countErrors;
+  }
+  inline int64_t countFiles() const {
+    return _countFiles;
+  }
+  inline size_t countGids() const {
+    return _gids.size();
+  }
+  inline size_t countUids() const {
+    return _uids.size();
+  }
+  /**
+   * Writes the names of the found users and groups.
+   * The output files are not closed.
+   */
+  void finish();
+  /**
+   * Scans a directory tree.
+   * @param base The base directory.
+   * @return <em>false</em>: the base directory cannot be opened.
+   */
+  bool scan(const char *base);
+public:
+  /**
+   * Converts a file in the binary format into the text format.
+   * @param filename The binary file.
+   * @param[out] text The content in the text format.
+   * @param logger The logging unit.
+   * @return <em>false</em>: the file cannot be read or is corrupted.
+   */
+  static bool binaryToText(const char *filename, std::string &text,
+      Logger *logger);
+protected:
+  void openSubDirectory(int parent, const std::string &path,
+      const char *node, uid_t uid, gid_t gid);
+  void scanDirectory(int handle, const std::string &path, uid_t uid,
+      gid_t gid);
+  void writeDirectory(const std::string &path, uid_t uid, gid_t gid,
+      const std::vector<Deviation> &deviations, const std::string &nodes);
+};
+
+} /* cppknife */
+
+#endif /* OS_OWNERSCANNER_HPP_ */
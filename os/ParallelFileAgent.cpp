@@ -0,0 +1,324 @@
+/*
+ * ParallelFileAgent.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "os.hpp"
+
+namespace cppknife {
+
+ParallelFsEntry::ParallelFsEntry() :
+    _fullName(), _nodeOffset(0), _status(), _linkReference(), _type(
+        FsEntry::TF_UNDEF), _level(0) {
+}
+ParallelFsEntry::~ParallelFsEntry() {
+}
+const FileTime_t*
+ParallelFsEntry::accessed() {
+  return &_status.st_atim;
+}
+const char*
+ParallelFsEntry::accessFullName() {
+  return _fullName.c_str();
+}
+FileSize_t ParallelFsEntry::fileSize() {
+  return _status.st_size;
+}
+std::string ParallelFsEntry::filetimeAsString() {
+  return filetimeToString(_status.st_mtim);
+}
+void ParallelFsEntry::finishCertainFile() {
+}
+const char*
+ParallelFsEntry::fullName() {
+  return _fullName.c_str();
+}
+size_t ParallelFsEntry::fullNameLength() {
+  return _fullName.size();
+}
+bool ParallelFsEntry::isDirectory() {
+  return _type == TF_SUBDIR;
+}
+bool ParallelFsEntry::isDotDir() {
+  // "." and ".." are never stored by the workers.
+  return false;
+}
+bool ParallelFsEntry::isLink() {
+  return _type == TF_LINK;
+}
+bool ParallelFsEntry::isRegular() {
+  return _type == TF_REGULAR;
+}
+const FileTime_t*
+ParallelFsEntry::modified() {
+  return &_status.st_mtim;
+}
+const char*
+ParallelFsEntry::node() {
+  return _fullName.c_str() + _nodeOffset;
+}
+const std::string&
+ParallelFsEntry::linkReference() {
+  if (_linkReference.empty() && _type == TF_LINK) {
+    char buffer[8192];
+    auto len = readlink(_fullName.c_str(), buffer, sizeof buffer - 1);
+    if (len >= 0) {
+      buffer[len] = '\0';
+      _linkReference = buffer;
+    }
+  }
+  return _linkReference;
+}
+bool ParallelFsEntry::modeAndOwner(uint32_t &mode, uint32_t &owner,
+    uint32_t &group) {
+  mode = _status.st_mode;
+  owner = _status.st_uid;
+  group = _status.st_gid;
+  return true;
+}
+const char*
+ParallelFsEntry::rightsAsString(std::string &buffer, bool numerical,
+    int ownerWidth) {
+  const char *rc = "";
+  return rc;
+}
+void ParallelFsEntry::set(const std::string &path, const char *node,
+    const struct stat &status) {
+  _fullName.reserve(path.size() + strlen(node));
+  _fullName = path;
+  _fullName += node;
+  _nodeOffset = path.size();
+  _status = status;
+  _linkReference.clear();
+  auto mode = status.st_mode;
+  if (S_ISDIR(mode))
+    _type = TF_SUBDIR;
+  else if (S_ISREG(mode))
+    _type = TF_REGULAR;
+  else if (S_ISLNK(mode))
+    _type = TF_LINK;
+  else if (S_ISCHR(mode))
+    _type = TF_CHAR;
+  else if (S_ISBLK(mode))
+    _type = TF_BLOCK;
+  else if (S_ISFIFO(mode))
+    _type = TF_PIPE;
+  else if (S_ISSOCK(mode))
+    _type = TF_SOCKET;
+  else
+    _type = TF_OTHER;
+}
+bool ParallelFsEntry::setCertainFile(const char *fullName) {
+  bool rc = false;
+  struct stat status;
+  if (lstat(fullName, &status) == 0) {
+    auto path = dirname(fullName);
+    if (!path.empty()) {
+      path += '/';
+    }
+    set(path, fullName + path.size(), status);
+    rc = true;
+  }
+  return rc;
+}
+FsEntry::Type_t ParallelFsEntry::type() {
+  return _type;
+}
+
+ParallelFileAgent::ParallelFileAgent(const char *base,
+    const DirEntryFilter *filter, TraceUnit *tracer, Logger *logger,
+    DirTreeStatistic &statistics, int threads) :
+    FileAgent(), _base(base == nullptr ? "." : base), _filter(filter), _tracer(
+        tracer), _logger(logger), _statistics(statistics), _threads(
+        threads <= 0 ? ThreadPool::defaultThreadCount() : threads), _pool(
+        nullptr), _workerStatistics(), _mutex(), _available(), _space(), _blocks(), _currentBlock(
+        nullptr), _currentIndex(0), _pendingDirectories(0), _aborted(false), _logMutex(), _started(
+        false), _finished(false), _maxBlocks(4 * _threads), _blockSize(512) {
+}
+
+ParallelFileAgent::~ParallelFileAgent() {
+  abort();
+  delete _pool;
+  _pool = nullptr;
+}
+
+void ParallelFileAgent::abort() {
+  if (_started) {
+    _aborted = true;
+    {
+      std::lock_guard<std::mutex> guard(_mutex);
+      _space.notify_all();
+    }
+    _pool->waitIdle();
+    finishTraversal();
+    for (auto block : _blocks) {
+      delete block;
+    }
+    _blocks.clear();
+    _started = false;
+    _aborted = false;
+  }
+  delete _currentBlock;
+  _currentBlock = nullptr;
+  _currentIndex = 0;
+}
+
+void ParallelFileAgent::changeBase(const char *base) {
+  abort();
+  _base = base == nullptr ? "." : base;
+}
+
+void ParallelFileAgent::finishTraversal() {
+  if (!_finished) {
+    _pool->waitIdle();
+    for (auto &statistics : _workerStatistics) {
+      _statistics._directories += statistics._directories;
+      _statistics._files += statistics._files;
+      _statistics._sizes += statistics._sizes;
+      _statistics._ignoredDirectories += statistics._ignoredDirectories;
+      _statistics._ignoredFiles += statistics._ignoredFiles;
+      statistics.clear();
+    }
+    _finished = true;
+  }
+}
+
+void ParallelFileAgent::publish(EntryBlock_t *block) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  // Limits the memory if the consumer is slower than the workers:
+  waitForCondition(_space, lock, [this] {
+    return _blocks.size() < _maxBlocks || _aborted;
+  });
+  if (_aborted) {
+    delete block;
+  } else {
+    _blocks.push_back(block);
+    _available.notify_one();
+  }
+}
+
+FsEntry*
+ParallelFileAgent::rawNextFile(int &level) {
+  FsEntry *rc = nullptr;
+  if (!_started) {
+    start();
+  }
+  while (true) {
+    if (_currentBlock != nullptr && _currentIndex < _currentBlock->size()) {
+      auto &entry = (*_currentBlock)[_currentIndex++];
+      level = entry._level;
+      rc = &entry;
+      if (_tracer != nullptr && _tracer->isCountTriggered()
+          && _tracer->isTimeTriggered()) {
+        _tracer->trace(entry.fullName());
+      }
+      break;
+    }
+    delete _currentBlock;
+    _currentBlock = nullptr;
+    std::unique_lock<std::mutex> lock(_mutex);
+    waitForCondition(_available, lock, [this] {
+      return !_blocks.empty() || _pendingDirectories == 0;
+    });
+    if (_blocks.empty()) {
+      lock.unlock();
+      finishTraversal();
+      break;
+    }
+    _currentBlock = _blocks.front();
+    _blocks.pop_front();
+    _currentIndex = 0;
+    _space.notify_one();
+  }
+  return rc;
+}
+
+void ParallelFileAgent::scanDirectory(std::string path, int level) {
+  if (!_aborted) {
+    auto &statistics = _workerStatistics[_pool->currentWorker()];
+    DIR *handle = opendir(path.c_str());
+    if (handle == nullptr) {
+      statistics._ignoredDirectories++;
+      if (_logger != nullptr && _logger->currentLevel() >= LV_FINE) {
+        std::lock_guard<std::mutex> guard(_logMutex);
+        _logger->say(LV_FINE, formatCString("_ ignored: %s/", path.c_str()));
+      }
+    } else {
+      statistics._directories++;
+      int fd = dirfd(handle);
+      if (path.empty() || path[path.size() - 1] != '/') {
+        path += '/';
+      }
+      struct dirent *data;
+      struct stat status;
+      auto block = new EntryBlock_t();
+      block->reserve(_blockSize);
+      while (!_aborted && (data = readdir(handle)) != nullptr) {
+        const char *node = data->d_name;
+        if (node[0] == '.'
+            && (node[1] == '\0' || (node[1] == '.' && node[2] == '\0'))) {
+          continue;
+        }
+        if (fstatat(fd, node, &status, AT_SYMLINK_NOFOLLOW) != 0) {
+          statistics._ignoredFiles++;
+          continue;
+        }
+        if (S_ISDIR(status.st_mode)) {
+          bool doEnter = _filter == nullptr
+              || (level < _filter->_maxDepth
+                  && (_filter->_pathPatterns == nullptr
+                      || _filter->_pathPatterns->match(node)));
+          if (!doEnter) {
+            statistics._ignoredDirectories++;
+            continue;
+          }
+          submitDirectory(path + node, level + 1);
+        }
+        block->emplace_back();
+        auto &entry = block->back();
+        entry.set(path, node, status);
+        entry._level = level;
+        if (_filter != nullptr && !_filter->match(entry, &statistics)) {
+          block->pop_back();
+        } else if (block->size() >= _blockSize) {
+          publish(block);
+          block = new EntryBlock_t();
+          block->reserve(_blockSize);
+        }
+      }
+      closedir(handle);
+      if (block->empty()) {
+        delete block;
+      } else {
+        publish(block);
+      }
+    }
+  }
+  if (--_pendingDirectories == 0) {
+    std::lock_guard<std::mutex> guard(_mutex);
+    _available.notify_all();
+  }
+}
+
+void ParallelFileAgent::start() {
+  if (_pool == nullptr) {
+    _pool = new ThreadPool(_threads);
+  }
+  _workerStatistics.assign(_pool->countThreads(), DirTreeStatistic());
+  _started = true;
+  _finished = false;
+  _aborted = false;
+  submitDirectory(_base, 0);
+}
+
+void ParallelFileAgent::submitDirectory(const std::string &path, int level) {
+  ++_pendingDirectories;
+  _pool->submit([this, path, level]() {
+    scanDirectory(path, level);
+  });
+}
+
+} /* cppknife */
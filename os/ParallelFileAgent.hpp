@@ -0,0 +1,159 @@
+/*
+ * ParallelFileAgent.hpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef OS_PARALLELFILEAGENT_HPP_
+#define OS_PARALLELFILEAGENT_HPP_
+
+namespace cppknife {
+/**
+ * @brief A <em>FsEntry</em> filled by a worker thread of the <em>ParallelFileAgent</em>.
+ *
+ * All data (name and status) is stored in the instance itself:
+ * it is independent from any directory handle.
+ */
+class ParallelFsEntry: public FsEntry {
+public:
+  std::string _fullName;
+  /// The offset of the node in <em>_fullName</em>.
+  size_t _nodeOffset;
+  struct stat _status;
+  std::string _linkReference;
+  Type_t _type;
+  /// The depth in the directory tree: 0 means in the base directory.
+  int _level;
+public:
+  ParallelFsEntry();
+  virtual ~ParallelFsEntry();
+public:
+  virtual const FileTime_t*
+  accessed();
+  virtual const char*
+  accessFullName();
+  virtual FileSize_t
+  fileSize();
+  virtual std::string
+  filetimeAsString();
+  virtual void finishCertainFile();
+  virtual const char*
+  fullName();
+  virtual size_t fullNameLength();
+  virtual bool
+  isDirectory();
+  virtual bool
+  isDotDir();
+  virtual bool
+  isLink();
+  virtual bool
+  isRegular();
+  virtual const FileTime_t*
+  modified();
+  virtual const char*
+  node();
+  virtual const std::string&
+  linkReference();
+  virtual bool
+  modeAndOwner(uint32_t &mode, uint32_t &owner, uint32_t &group);
+  virtual const char*
+  rightsAsString(std::string &buffer, bool numerical, int ownerWidth);
+  /**
+   * Sets the name and the status of the entry.
+   * @param path The directory containing the entry, with trailing separator.
+   * @param node The name of the entry without path.
+   * @param status The status info of the entry.
+   */
+  void set(const std::string &path, const char *node,
+      const struct stat &status);
+  virtual bool setCertainFile(const char *fullName);
+  inline virtual bool testNamesFirst() const {
+    return true;
+  }
+  virtual Type_t
+  type();
+};
+/**
+ * @brief A <em>FileAgent</em> scanning the directory tree with a pool of worker threads.
+ *
+ * Each directory is scanned by one worker: the subdirectories found are put
+ * into the work-stealing deque of that worker, so idle workers take over
+ * whole subtrees of busy workers.
+ * The workers apply the filter (with a statistic per worker),
+ * the found entries are delivered in blocks to the consumer calling <em>rawNextFile()</em>.
+ * The per worker statistics are merged into the statistic of the owner at the end of the traversal.
+ *
+ * Note: the order of the entries is not deterministic.
+ */
+class ParallelFileAgent: public FileAgent {
+protected:
+  /**
+   * @brief A block of entries found by a worker.
+   */
+  typedef std::vector<ParallelFsEntry> EntryBlock_t;
+  std::string _base;
+  const DirEntryFilter *_filter;
+  TraceUnit *_tracer;
+  Logger *_logger;
+  DirTreeStatistic &_statistics;
+  int _threads;
+  ThreadPool *_pool;
+  /// One statistic for each worker.
+  std::vector<DirTreeStatistic> _workerStatistics;
+  std::mutex _mutex;
+  std::condition_variable _available;
+  std::condition_variable _space;
+  std::deque<EntryBlock_t*> _blocks;
+  /// The block returned to the consumer at the moment.
+  EntryBlock_t *_currentBlock;
+  size_t _currentIndex;
+  /// Count of directories submitted but not scanned.
+  std::atomic<size_t> _pendingDirectories;
+  std::atomic<bool> _aborted;
+  std::mutex _logMutex;
+  bool _started;
+  bool _finished;
+  size_t _maxBlocks;
+  size_t _blockSize;
+public:
+  /**
+   * Constructor.
+   *
+   * @param base The base directory. The traversal starts at this point.
+   * @param filter Specifies the search criteria. May be <em>nullptr</em>.
+   * @param tracer <em>nullptr</em> or a handler of trigger points.
+   * @param logger The logging unit.
+   * @param[out] statistics The statistics about files and directories is updated here.
+   * @param threads The count of worker threads. If &lt;= 0: the count of CPU cores.
+   */
+  ParallelFileAgent(const char *base, const DirEntryFilter *filter,
+      TraceUnit *tracer, Logger *logger, DirTreeStatistic &statistics,
+      int threads = 0);
+  virtual
+  ~ParallelFileAgent();
+public:
+  virtual void changeBase(const char *base);
+  inline virtual bool isPrefiltered() const {
+    return true;
+  }
+  virtual FsEntry* rawNextFile(int &level);
+  /**
+   * Returns the count of worker threads.
+   */
+  inline int threads() const {
+    return _threads;
+  }
+protected:
+  void abort();
+  void finishTraversal();
+  void publish(EntryBlock_t *block);
+  void scanDirectory(std::string path, int level);
+  void start();
+  void submitDirectory(const std::string &path, int level);
+};
+
+} /* cppknife */
+
+#endif /* OS_PARALLELFILEAGENT_HPP_ */
@@ -0,0 +1,144 @@
+/*
+ * ThreadPool.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "os.hpp"
+
+namespace cppknife {
+
+thread_local ThreadPool *ThreadPool::_currentPool = nullptr;
+thread_local int ThreadPool::_currentWorker = -1;
+
+void ThreadPool::WorkQueue::pushBack(Task_t &&task) {
+  std::lock_guard<std::mutex> guard(_mutex);
+  _tasks.push_back(std::move(task));
+}
+bool ThreadPool::WorkQueue::popBack(Task_t &task) {
+  std::lock_guard<std::mutex> guard(_mutex);
+  bool rc = !_tasks.empty();
+  if (rc) {
+    task = std::move(_tasks.back());
+    _tasks.pop_back();
+  }
+  return rc;
+}
+bool ThreadPool::WorkQueue::stealFront(Task_t &task) {
+  std::lock_guard<std::mutex> guard(_mutex);
+  bool rc = !_tasks.empty();
+  if (rc) {
+    task = std::move(_tasks.front());
+    _tasks.pop_front();
+  }
+  return rc;
+}
+
+ThreadPool::ThreadPool(int threads) :
+    _threads(), _queues(), _mutex(), _wakeUp(), _idle(), _queued(0), _pending(
+        0), _nextQueue(0), _steals(0), _stop(false) {
+  if (threads <= 0) {
+    threads = defaultThreadCount();
+  }
+  _queues.reserve(threads);
+  for (int ix = 0; ix < threads; ix++) {
+    _queues.push_back(new WorkQueue());
+  }
+  _threads.reserve(threads);
+  for (int ix = 0; ix < threads; ix++) {
+    _threads.emplace_back(&ThreadPool::run, this, ix);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> guard(_mutex);
+    _stop = true;
+  }
+  _wakeUp.notify_all();
+  for (auto &thread : _threads) {
+    thread.join();
+  }
+  for (auto queue : _queues) {
+    delete queue;
+  }
+  _queues.clear();
+}
+
+int ThreadPool::currentWorker() const {
+  return _currentPool == this ? _currentWorker : -1;
+}
+
+int ThreadPool::defaultThreadCount() {
+  int rc = static_cast<int>(std::thread::hardware_concurrency());
+  return rc <= 0 ? 2 : rc;
+}
+
+bool ThreadPool::nextTask(int index, Task_t &task) {
+  bool rc = _queues[index]->popBack(task);
+  if (!rc) {
+    size_t count = _queues.size();
+    for (size_t ix = 1; ix < count; ix++) {
+      if (_queues[(index + ix) % count]->stealFront(task)) {
+        ++_steals;
+        rc = true;
+        break;
+      }
+    }
+  }
+  if (rc) {
+    --_queued;
+  }
+  return rc;
+}
+
+void ThreadPool::run(int index) {
+  _currentPool = this;
+  _currentWorker = index;
+  Task_t task;
+  while (true) {
+    if (nextTask(index, task)) {
+      task();
+      task = nullptr;
+      if (--_pending == 0) {
+        std::lock_guard<std::mutex> guard(_mutex);
+        _idle.notify_all();
+      }
+    } else {
+      std::unique_lock<std::mutex> lock(_mutex);
+      waitForCondition(_wakeUp, lock, [this] {
+        return _stop || _queued > 0;
+      });
+      if (_stop && _queued == 0) {
+        break;
+      }
+    }
+  }
+}
+
+void ThreadPool::submit(Task_t task) {
+  int worker = currentWorker();
+  size_t index =
+      worker >= 0 ?
+          static_cast<size_t>(worker) : _nextQueue++ % _queues.size();
+  ++_pending;
+  {
+    // _queued is incremented before the task is visible:
+    // nextTask() can never decrement it below 0.
+    std::lock_guard<std::mutex> guard(_mutex);
+    ++_queued;
+  }
+  _queues[index]->pushBack(std::move(task));
+  _wakeUp.notify_one();
+}
+
+void ThreadPool::waitIdle() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  waitForCondition(_idle, lock, [this] {
+    return _pending == 0;
+  });
+}
+
+} /* cppknife */
@@ -0,0 +1,121 @@
+/*
+ * ThreadPool.hpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef OS_THREADPOOL_HPP_
+#define OS_THREADPOOL_HPP_
+
+namespace cppknife {
+
+/**
+ * Waits until a condition is fulfilled.
+ *
+ * Timed waits are used: <em>std::condition_variable::wait()</em> requires
+ * a newer C++ runtime library (GLIBCXX_3.4.30) than the rest of the library.
+ * @param condition The condition variable signaling changes.
+ * @param lock The locked mutex belonging to <em>condition</em>.
+ * @param predicate Returns <em>true</em> if the waiting should end.
+ */
+template<typename Predicate>
+inline void waitForCondition(std::condition_variable &condition,
+    std::unique_lock<std::mutex> &lock, Predicate predicate) {
+  while (!condition.wait_for(lock, std::chrono::milliseconds(100), predicate)) {
+    // wait again
+  }
+}
+/**
+ * @brief A pool of worker threads with one work-stealing deque per worker.
+ *
+ * Tasks submitted from outside the pool are distributed round robin.
+ * Tasks submitted by a worker (e.g. subdirectories found while scanning a directory)
+ * are put at the back of the own deque and processed LIFO by that worker.
+ * An idle worker steals from the front of the other deques (the oldest, usually largest tasks).
+ */
+class ThreadPool {
+public:
+  typedef std::function<void()> Task_t;
+protected:
+  /**
+   * @brief A double ended queue of tasks owned by one worker.
+   */
+  class WorkQueue {
+  public:
+    std::mutex _mutex;
+    std::deque<Task_t> _tasks;
+  public:
+    void pushBack(Task_t &&task);
+    bool popBack(Task_t &task);
+    bool stealFront(Task_t &task);
+  };
+protected:
+  std::vector<std::thread> _threads;
+  std::vector<WorkQueue*> _queues;
+  std::mutex _mutex;
+  std::condition_variable _wakeUp;
+  std::condition_variable _idle;
+  ///
+  /// Count of tasks stored in the queues.
+  std::atomic<size_t> _queued;
+  ///
+  /// Count of tasks submitted but not finished.
+  std::atomic<size_t> _pending;
+  std::atomic<size_t> _nextQueue;
+  std::atomic<size_t> _steals;
+  bool _stop;
+  static thread_local ThreadPool *_currentPool;
+  static thread_local int _currentWorker;
+public:
+  /**
+   * Constructor.
+   * @param threads The count of worker threads. If &lt;= 0: the count of CPU cores is used.
+   */
+  ThreadPool(int threads = 0);
+  virtual ~ThreadPool();
+private:
+  ThreadPool(const ThreadPool &other);
+  ThreadPool&
+  operator=(const ThreadPool &other);
+public:
+  /**
+   * Returns the count of worker threads.
+   */
+  inline int countThreads() const {
+    return static_cast<int>(_threads.size());
+  }
+  /**
+   * Returns the index of the current worker (0..N-1) or -1 if the caller is not a worker of this pool.
+   */
+  int currentWorker() const;
+  /**
+   * Returns the count of tasks taken from the deque of another worker.
+   */
+  inline size_t steals() const {
+    return _steals;
+  }
+  /**
+   * Puts a task into the pool.
+   * If called from a worker of this pool the task is stored in the deque of that worker.
+   * @param task The task to do.
+   */
+  void submit(Task_t task);
+  /**
+   * Waits until all submitted tasks are finished.
+   */
+  void waitIdle();
+public:
+  /**
+   * Returns the number of threads if the caller does not specify it: the count of CPU cores.
+   */
+  static int defaultThreadCount();
+protected:
+  bool nextTask(int index, Task_t &task);
+  void run(int index);
+};
+
+} /* cppknife */
+
+#endif /* OS_THREADPOOL_HPP_ */
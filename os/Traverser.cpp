@@ -50,6 +50,22 @@ char FsEntry::typeAsChar() {
   }
   return rc;
 }
+const char* FsEntry::filetimeToBuffer(char *buffer, size_t bufferSize) {
+  return filetimeToString(*modified(), buffer, bufferSize);
+}
+const char* FsEntry::linkTarget() {
+  return linkReference().c_str();
+}
+bool FsEntry::modeAndOwner(uint32_t &mode, uint32_t &owner, uint32_t &group) {
+  struct stat status;
+  bool rc = lstat(fullName(), &status) == 0;
+  if (rc) {
+    mode = status.st_mode;
+    owner = status.st_uid;
+    group = status.st_gid;
+  }
+  return rc;
+}
 FsEntryLinux::FsEntryLinux(FileAgentLinux &parent) :
     _parent(parent), _singleFileFts(nullptr), _intrinsicStatInfo(false), _state(
         nullptr), _linkReference(), _type(FsEntry::TF_UNDEF), _statInfo(
@@ -162,6 +178,14 @@ FsEntryLinux::linkReference() {
   return _linkReference;
 }
 
+bool FsEntryLinux::modeAndOwner(uint32_t &mode, uint32_t &owner,
+    uint32_t &group) {
+  auto status = getStatus();
+  mode = status->st_mode;
+  owner = status->st_uid;
+  group = status->st_gid;
+  return true;
+}
 const char*
 FsEntryLinux::rightsAsString(std::string &buffer, bool numerical,
     int ownerWidth) {
@@ -476,7 +500,7 @@ size_t FsEntryWithStack::fullNameLength() {
 struct stat*
 FsEntryWithStack::getStatus() {
   if (_status.st_ino == 0) {
-    if (stat(fullName(), &_status) != 0)
+    if (lstat(fullName(), &_status) != 0)
       _status.st_ino = 0;
   }
   return &_status;
@@ -614,6 +638,14 @@ inline void addId(const char *id, int maxLength, std::string &string) {
     string.append(id + length - maxLength - 2, maxLength - 2);
   }
 }
+bool FsEntryWithStack::modeAndOwner(uint32_t &mode, uint32_t &owner,
+    uint32_t &group) {
+  auto status = getStatus();
+  mode = status->st_mode;
+  owner = status->st_uid;
+  group = status->st_gid;
+  return status->st_ino != 0;
+}
 const char*
 FsEntryWithStack::rightsAsString(std::string &string, bool numerical,
     int ownerWidth) {
@@ -724,7 +756,7 @@ FsEntry::Type_t FsEntryWithStack::type() {
 DirEntryFilter::DirEntryFilter() :
     _types(FsEntry::TC_ALL), _nodePatterns(nullptr), _pathPatterns(nullptr), _minSize(
         0), _maxSize(0x7fffffffffffffffLL), _minAge(), _maxAge(), _minDepth(0), _maxDepth(
-        512) {
+        512), _program(nullptr), _oldPrograms(), _programMutex() {
   memset(_first, 'x', sizeof _first - 1);
   _first[sizeof _first - 1] = '\0';
   memset(_last, 'x', sizeof _last - 1);
@@ -734,39 +766,26 @@ DirEntryFilter::DirEntryFilter() :
 }
 
 DirEntryFilter::~DirEntryFilter() {
+  delete _program.load();
+  for (auto program : _oldPrograms) {
+    delete program;
+  }
+  _oldPrograms.clear();
 }
 
-bool DirEntryFilter::match(FsEntry &entry, DirTreeStatistic *statistics) const {
-  bool testNamesFirst = entry.testNamesFirst();
-  const char *node = nullptr;
-  bool rc;
-  do {
-    rc = false;
-    if (testNamesFirst) {
-      node = entry.node();
-      if (_nodePatterns != nullptr && !_nodePatterns->match(node)) {
-        break;
-      }
-    }
-    if (0 == (entry.type() & _types)) {
-      break;
-    }
-    int64_t size = entry.fileSize();
-    if (size < _minSize || size > _maxSize) {
-      break;
-    }
-    if (fileTimeCompare(_minAge, *entry.modified()) > 0
-        || fileTimeCompare(_maxAge, *entry.modified()) < 0) {
-      break;
-    }
-    if (!testNamesFirst) {
-      node = entry.node();
-      if (_nodePatterns != nullptr && !_nodePatterns->match(node)) {
-        break;
-      }
+void DirEntryFilter::compile() const {
+  std::lock_guard<std::mutex> guard(_programMutex);
+  FilterProgram *program = _program.load();
+  if (program == nullptr || !program->isCompiledFrom(*this)) {
+    if (program != nullptr) {
+      _oldPrograms.push_back(program);
     }
-    rc = true;
-  } while (false);
+    _program.store(new FilterProgram(*this));
+  }
+}
+
+bool DirEntryFilter::match(FsEntry &entry, DirTreeStatistic *statistics) const {
+  bool rc = program()->run(entry);
   if (statistics != nullptr) {
     if (rc) {
       if (entry.isRegular()) {
@@ -780,6 +799,15 @@ bool DirEntryFilter::match(FsEntry &entry, DirTreeStatistic *statistics) const {
   return rc;
 }
 
+FilterProgram* DirEntryFilter::program() const {
+  FilterProgram *rc = _program.load(std::memory_order_acquire);
+  if (rc == nullptr || !rc->isCompiledFrom(*this)) {
+    compile();
+    rc = _program.load(std::memory_order_acquire);
+  }
+  return rc;
+}
+
 /**
  * Constructor.
  */
@@ -833,27 +861,19 @@ bool TraceUnit::trace(const char *message) {
 
 FileAgentWithStack::FileAgentWithStack(const char *base,
     const DirEntryFilter *filter, TraceUnit *tracer, Logger *logger,
-    DirTreeStatistic &statistics) :
-    FileAgent(), _depth(-1), _base(base),
-    // m_dirs
-    _passNoForDirSearch(2), _filter(filter), _tracer(tracer), _logger(logger), _statistics(
-        statistics), _separator(0) {
-  auto theOsInfo = osInfo();
-  _separator = theOsInfo._separatorChar;
-  memset(m_dirs, 0, sizeof m_dirs);
-  m_dirs[0] = new FsEntryWithStack(_logger);
-// remove a preceding "./". This simplifies the pattern expressions:
-  if (_base.size() > 0 && _base[0] == '.'
-      && _base[1] == theOsInfo._separatorChar) {
-    _base.erase(0, 2);
-  }
+    DirTreeStatistic &statistics, bool depthFirst, size_t memoryBudget) :
+    FileAgent(), _base(), _current(logger), _currentLevel(0), _open(false), _started(
+        false), _alreadyRead(false), _pending(depthFirst, memoryBudget, logger), _subdirectories(), _filter(
+        filter), _tracer(tracer), _logger(logger), _statistics(statistics), _separator(
+        osInfo()._separatorChar) {
+  changeBase(base == nullptr ? "." : base);
 }
 
 /**
  * Destructor.
  */
 FileAgentWithStack::~FileAgentWithStack() {
-  destroy();
+  _current.freeEntry();
 }
 
 /**
@@ -862,29 +882,44 @@ FileAgentWithStack::~FileAgentWithStack() {
  * @param base	the base directory to search
  */
 void FileAgentWithStack::changeBase(const char *base) {
-  destroy();
+  _current.freeEntry();
+  _open = _started = _alreadyRead = false;
+  _pending.clear();
+  _subdirectories.clear();
   _base.clear();
   appendString(_base, base);
-  memset(m_dirs, 0, sizeof m_dirs);
-  m_dirs[0] = new FsEntryWithStack(_logger);
 // remove a preceding "./". This simplifies the pattern expressions:
-  if (_base.size() > 0 && _base[0] == '.'
-      && _base[1] == osInfo()._separatorChar) {
+  if (_base.size() > 2 && _base[0] == '.' && _base[1] == _separator) {
     _base.erase(0, 2);
   }
 }
+
 /**
- * Releases the resources.
+ * Opens a directory for reading.
+ * @param path The directory name.
+ * @param level The depth of the directory in the tree.
+ * @return <em>true</em>: the first entry has been read.
  */
-void FileAgentWithStack::destroy() {
-  for (size_t ix = 0; ix < sizeof m_dirs / sizeof m_dirs[0]; ix++) {
-    if (m_dirs[ix] != nullptr) {
-      m_dirs[ix]->freeEntry();
-      delete m_dirs[ix];
-      m_dirs[ix] = nullptr;
+bool FileAgentWithStack::openDirectory(const std::string &path, int level) {
+  _current._path = path;
+  if (path.empty() || path[path.size() - 1] != _separator) {
+    _current._path += _separator;
+  }
+  bool rc = _current.findFirst();
+  if (rc) {
+    _alreadyRead = true;
+    _currentLevel = level;
+    _statistics._directories++;
+  } else {
+    _current.freeEntry();
+    _statistics._ignoredDirectories++;
+    if (_logger != nullptr && _logger->currentLevel() >= LV_FINE) {
+      _logger->say(LV_FINE, formatCString("_ ignored: %s", path.c_str()));
     }
   }
+  return rc;
 }
+
 /**
  * Returns the info about the next file in the directory tree traversal.
  *
@@ -892,153 +927,93 @@ void FileAgentWithStack::destroy() {
  * 					0 means the file is inside the base.<br>
  * 					Not defined if the result is nullptr
  * @return nullptr	no more files<br>
- * 					otherwise: the stack entry with the next file in the
+ * 					otherwise: the entry with the next file in the
  * 					directory tree. May be a directory too
  */
 FsEntry*
 FileAgentWithStack::rawNextFile(int &level) {
   FsEntry *rc = nullptr;
-  bool alreadyRead = false;
-  bool again;
-  do {
-    again = false;
-    if (_depth < 0) {
-      // Not yet initialized?
-      if (m_dirs[0]->_passNo == 2)
-        rc = nullptr;
-      else {
-        // first call:
-        if (initEntry(_base.c_str(), nullptr, 0)) {
-          _statistics._directories++;
-          if (1 != _passNoForDirSearch)
-            rc = m_dirs[0];
-          else
-            again = alreadyRead = true;
-        }
+  if (!_started) {
+    _started = true;
+    _pending.push(_base, 0);
+  }
+  while (rc == nullptr) {
+    if (!_open) {
+      std::string path;
+      int nextLevel;
+      if (!_pending.pop(path, nextLevel)) {
+        break;
       }
-    } else {
-      FsEntryWithStack *current = m_dirs[_depth];
-      if (alreadyRead || current->findNext()) {
-        alreadyRead = false;
-        // a file or directory found:
-        if (_tracer != nullptr && _tracer->isCountTriggered()
-            && _tracer->isTimeTriggered())
-          _tracer->trace(current->fullName());
-        if (current->_passNo != _passNoForDirSearch) {
-          // we search for any file:
-          rc = m_dirs[_depth];
-        } else {
-          // we are interested only in true subdirectories:
-          again = true;
-          if (current->isDirectory()) {
-            if (!current->isDotDir()) {
-              bool doEnter = true;
-              if (_filter != nullptr) {
-                doEnter = _depth < _filter->_maxDepth && !current->isLink()
-                    && (_filter->_pathPatterns == nullptr
-                        || _filter->_pathPatterns->match(current->node()));
-              }
-              if (doEnter) {
-                // open a new level
-                alreadyRead = initEntry(current->_path, current->node(),
-                    _depth + 1);
-                _statistics._directories++;
-                if (_logger->currentLevel() >= LV_DETAIL) {
-                  _logger->say(LV_DETAIL,
-                      formatCString("- ignored: %s%c", current->_path,
-                          _separator));
-                }
-
-              } else {
-                _statistics._ignoredDirectories++;
-                if (_logger->currentLevel() >= LV_DETAIL) {
-                  _logger->say(LV_DETAIL,
-                      formatCString("+ ignored: %s%c", current->_path,
-                          _separator));
-                }
-              }
-            }
-          }
-        }
+      _open = openDirectory(path, nextLevel);
+      continue;
+    }
+    if (!_alreadyRead && !_current.findNext()) {
+      // The directory is complete:
+      _current.freeEntry();
+      _open = false;
+      storeSubdirectories();
+      continue;
+    }
+    _alreadyRead = false;
+    if (_current.isDotDir()) {
+      continue;
+    }
+    if (_tracer != nullptr && _tracer->isCountTriggered()
+        && _tracer->isTimeTriggered()) {
+      _tracer->trace(_current.fullName());
+    }
+    if (_current.isDirectory() && !_current.isLink()) {
+      bool doEnter = _filter == nullptr
+          || (_currentLevel < _filter->_maxDepth
+              && (_filter->_pathPatterns == nullptr
+                  || _filter->_pathPatterns->match(_current.node())));
+      if (doEnter) {
+        _subdirectories.push_back(_current.fullName());
       } else {
-        // the current subdir does not have more files:
-        if (current->_passNo == 1) {
-          // we start the second pass:
-          alreadyRead = initEntry(current->_path, nullptr, -1);
-          current->_passNo = 2;
-          again = true;
-        } else {
-          // this subdirectory is complete. We continue in the parent directory:
-          current->freeEntry();
-          if (--_depth >= 0) {
-            again = true;
-          }
+        _statistics._ignoredDirectories++;
+        if (_logger != nullptr && _logger->currentLevel() >= LV_FINE) {
+          _logger->say(LV_FINE,
+              formatCString("_ ignored: %s%c", _current.fullName(),
+                  _separator));
         }
       }
     }
-    if (rc != nullptr && rc->isDotDir())
-      again = true;
-  } while (again);
-  if (rc != nullptr && !rc->isDirectory()) {
-    _statistics._files++;
-    if (_statistics._sizes >= 0)
-      _statistics._sizes += rc->fileSize();
+    if (_filter == nullptr || _filter->match(_current, nullptr)) {
+      if (_current.isRegular()) {
+        _statistics._files++;
+        _statistics._sizes += _current.fileSize();
+      } else if (!_current.isDirectory()) {
+        _statistics._files++;
+      }
+      level = _currentLevel;
+      rc = &_current;
+    }
   }
-  level = _depth;
   return rc;
 }
-void FileAgentWithStack::freeEntry(int level) {
+
+void FileAgentWithStack::setDepthFirst(bool depthFirst) {
+  _pending.setDepthFirst(depthFirst);
+  std::string base = _base;
+  changeBase(base.c_str());
 }
 
 /**
- * Initializes an entry in the directory entry stack.
- *
- * @param parent The parent directory of the entry
- * @param node <em>nullptr</em> or the name of the directory belonging to the entry (without path)
- * @param level The index of the entry in the stack.<br>
- *   If < 0: m_levels and m_path will not be changed
- * @return <em>true</em>: a new file is available<br>
- *   <em>false</em>: findFirstEntry() signals: no entry.
+ * Stores the subdirectories of the completed directory as pending.
  */
-bool FileAgentWithStack::initEntry(const std::string &parent, const char *node,
-    int level) {
-  bool rc = false;
-  if (level < MAX_ENTRY_STACK_DEPTH) {
-    auto theOsInfo = osInfo();
-    //printf ("node: %s\n", node);
-    if (level >= 0)
-      _depth = level;
-    if (m_dirs[_depth] == nullptr)
-      m_dirs[_depth] = new FsEntryWithStack(_logger);
-    FsEntryWithStack *current = m_dirs[_depth];
-    current->_passNo = 1;
-    if (level >= 0) {
-      current->_path = parent;
-      if (!endsWith(parent.c_str(), parent.size(), theOsInfo._separatorCString))
-        appendString(current->_path, theOsInfo._separatorCString);
-      if (node != nullptr)
-        appendString(current->_path, node, theOsInfo._separatorCString);
+void FileAgentWithStack::storeSubdirectories() {
+  // The stack returns the last stored entry first: the directory order is kept in both modes.
+  if (_pending.depthFirst()) {
+    for (auto it = _subdirectories.rbegin(); it != _subdirectories.rend();
+        ++it) {
+      _pending.push(*it, _currentLevel + 1);
+    }
+  } else {
+    for (auto &path : _subdirectories) {
+      _pending.push(path, _currentLevel + 1);
     }
-    rc = current->findFirst();
   }
-  return rc;
-}
-
-/**
- * Returns the info of an entry the directory stack.
- *
- * @param offsetFromTop 0: return the top of stack.<br>
- *   1: returns the entry one below the top.<br>
- *   2: ...
- * @return <em>nullptr</em>: not available<br>
- *   Otherwise: the wanted entry.
- */
-FsEntryWithStack*
-FileAgentWithStack::topOfStack(int offsetFromTop) {
-  FsEntryWithStack *rc = nullptr;
-  if (offsetFromTop >= 0 && _depth - 1 - offsetFromTop >= 0)
-    rc = m_dirs[_depth - 1 - offsetFromTop];
-  return rc;
+  _subdirectories.clear();
 }
 
 FileAgentLinux::FileAgentLinux(const char *base, const DirEntryFilter *filter,
@@ -1149,6 +1124,8 @@ FileAgentLinux::rawNextFile(int &level) {
     }
     rc = &_currentEntry;
     _currentEntry.set(_currentRawEntry);
+    // FTS level 0 is the base itself: its entries have level 0.
+    level = _currentRawEntry->fts_level - 1;
     if (_filter != nullptr && _filter->_pathPatterns != nullptr) {
       if (!_filter->_pathPatterns->match(_currentRawEntry->fts_name)) {
         fts_set(_fts, _currentRawEntry, FTS_SKIP);
@@ -1169,7 +1146,8 @@ FileAgentLinux::rawNextFile(int &level) {
 Traverser::Traverser(const char *base, const DirEntryFilter *filter,
     TraceUnit *tracer, Logger *logger) :
     _base(base == nullptr ? "." : base), _filter(filter), _tracer(tracer), _logger(
-        logger), _fileAgent(nullptr), _osInfo(osInfo()) {
+        logger), _fileAgent(nullptr), _osInfo(osInfo()), _threadCount(1), _lazyStatus(false), _statusMask(
+        STATX_BASIC_STATS), _indexFile(), _order(TO_NATIVE), _queueMemory(0), _queueDepth(0) {
   _fileAgent = new FileAgentLinux(base, filter, tracer, logger, *this);
 }
 
@@ -1196,11 +1174,12 @@ FsEntry*
 Traverser::nextFile(int &level) {
   FsEntry *rc = _fileAgent->rawNextFile(level);
   auto baseLength = _base.length();
+  bool prefiltered = _fileAgent->isPrefiltered();
 //const char *node;
   while (rc != nullptr) {
     //node = rc->fullName();
     size_t len = 0;
-    if ((_filter == nullptr || _filter->match(*rc, this))
+    if ((prefiltered || _filter == nullptr || _filter->match(*rc, this))
         && (level > 0 || (len = rc->fullNameLength()) > baseLength)) {
       break;
     }
@@ -1209,4 +1188,62 @@ Traverser::nextFile(int &level) {
   return rc;
 }
 
+void Traverser::createFileAgent() {
+  delete _fileAgent;
+  if (!_indexFile.empty()) {
+    _fileAgent = new IndexedFileAgent(_base.c_str(), _filter, _tracer,
+        _logger, *this, _indexFile.c_str());
+  } else if (_order != TO_NATIVE) {
+    _fileAgent = new FileAgentWithStack(_base.c_str(), _filter, _tracer,
+        _logger, *this, _order == TO_DEPTH_FIRST, _queueMemory);
+  } else if (_queueDepth > 0 && IoUring::isAvailable()) {
+    _fileAgent = new UringFileAgent(_base.c_str(), _filter, _tracer, _logger,
+        *this, _queueDepth);
+  } else if (_threadCount > 1) {
+    _fileAgent = new ParallelFileAgent(_base.c_str(), _filter, _tracer,
+        _logger, *this, _threadCount);
+  } else if (_lazyStatus) {
+    _fileAgent = new GetdentsFileAgent(_base.c_str(), _filter, _tracer,
+        _logger, *this, _statusMask);
+  } else {
+    _fileAgent = new FileAgentLinux(_base.c_str(), _filter, _tracer, _logger,
+        *this);
+  }
+}
+
+void Traverser::setAsyncStatus(unsigned queueDepth) {
+  _queueDepth = queueDepth;
+  if (_queueDepth > 0 && !IoUring::isAvailable() && _logger != nullptr) {
+    _logger->say(LV_FINE, "io_uring is not available: synchronous status requests");
+  }
+  createFileAgent();
+}
+
+void Traverser::setIndexFile(const char *indexFile) {
+  _indexFile = indexFile == nullptr ? "" : indexFile;
+  createFileAgent();
+}
+
+void Traverser::setLazyStatus(unsigned int statusMask) {
+  _lazyStatus = true;
+  _statusMask = statusMask;
+  createFileAgent();
+}
+
+void Traverser::setTraversalOrder(TraversalOrder order, size_t queueMemory) {
+  _order = order;
+  _queueMemory = queueMemory;
+  createFileAgent();
+}
+
+void Traverser::setThreadCount(int threads) {
+  if (threads <= 0) {
+    threads = ThreadPool::defaultThreadCount();
+  }
+  if (threads != _threadCount) {
+    _threadCount = threads;
+    createFileAgent();
+  }
+}
+
 } /* cppknife */
@@ -67,6 +67,14 @@ public:
    */
   virtual std::string
   filetimeAsString() = 0;
+  /**
+   * Returns the modified time as string without heap allocation.
+   * @param[out] buffer The result buffer. Should have at least 20 bytes.
+   * @param bufferSize The size of <em>buffer</em>.
+   * @return <em>buffer</em> (for chaining), e.g. "2014.01.07 02:59:43".
+   */
+  const char*
+  filetimeToBuffer(char *buffer, size_t bufferSize);
   /**
    * Returns the name with path.
    */
@@ -111,6 +119,23 @@ public:
    */
   virtual const std::string&
   linkReference() = 0;
+  /**
+   * Returns the name of the referenced file of a symbolic link.
+   * Implementations storing the name in an arena do that without a heap allocation.
+   * @return The referenced file or "". Valid until the next entry is fetched.
+   */
+  virtual const char*
+  linkTarget();
+  /**
+   * Returns the mode (file type and rights), the owner and the group.
+   * The default implementation calls <em>lstat()</em>.
+   * @param[out] mode The st_mode value.
+   * @param[out] owner The user id.
+   * @param[out] group The group id.
+   * @return <em>false</em>: the info is not available.
+   */
+  virtual bool
+  modeAndOwner(uint32_t &mode, uint32_t &owner, uint32_t &group);
   /**
    * Returns the file rights as a string.
    * @param[out] buffer The result buffer.
@@ -145,6 +170,7 @@ public:
 class TraverserLinux;
 class FileAgentLinux;
 class DirEntryFilter;
+class FilterProgram;
 /**
  * @brief The Linux implementation of <em>FsEntry</em>.
  */
@@ -194,6 +220,8 @@ public:
   node();
   virtual const std::string&
   linkReference();
+  virtual bool
+  modeAndOwner(uint32_t &mode, uint32_t &owner, uint32_t &group);
   virtual const char*
   rightsAsString(std::string &buffer, bool numerical, int ownerWidth);
   void
@@ -212,7 +240,7 @@ public:
 /**
  * @brief An implementation using the portable <em>struct stat</em>.
  *
- * <b>Under construction.</b>
+ * Holds an open directory and its current entry. The status is fetched by <em>lstat()</em> on demand.
  */
 class FsEntryWithStack: public FsEntry {
 public:
@@ -274,6 +302,8 @@ public:
   node();
   virtual const std::string&
   linkReference();
+  virtual bool
+  modeAndOwner(uint32_t &mode, uint32_t &owner, uint32_t &group);
   /**
    * Returns the file rights as a string.
    *
@@ -314,10 +344,39 @@ public:
   int _minDepth;
   int _maxDepth;
   char _last[16];
+protected:
+  /// The conditions compiled into a predicate program. Rebuilt if the conditions change.
+  mutable std::atomic<FilterProgram*> _program;
+  /// The outdated programs: they may still be used by other threads.
+  mutable std::vector<FilterProgram*> _oldPrograms;
+  mutable std::mutex _programMutex;
 public:
   DirEntryFilter();
   ~DirEntryFilter();
+private:
+  DirEntryFilter(const DirEntryFilter &other);
+  DirEntryFilter&
+  operator=(const DirEntryFilter &other);
 public:
+  /**
+   * Compiles the conditions into a predicate program.
+   * Not necessary but recommended after setting the conditions:
+   * <em>match()</em> compiles the conditions if they have been changed.
+   */
+  void compile() const;
+  /**
+   * Returns whether the filter tests the file age.
+   */
+  inline bool hasAgeCondition() const {
+    return _minAge.tv_sec != 0 || _minAge.tv_nsec != 0
+        || _maxAge.tv_sec != 0x7fffffffffffffffL;
+  }
+  /**
+   * Returns whether the filter tests the file size.
+   */
+  inline bool hasSizeCondition() const {
+    return _minSize > 0 || _maxSize != 0x7fffffffffffffffLL;
+  }
   bool
   /**
    * Tests whether an entry matches the conditions of the filter.
@@ -328,6 +387,11 @@ public:
    *   <em>false</em>: otherwise
    */
   match(FsEntry &entry, DirTreeStatistic *statistics) const;
+  /**
+   * Returns the compiled conditions, e.g. for the counters.
+   * @return The program matching the current conditions.
+   */
+  FilterProgram* program() const;
   /**
    * Returns whether the name matching test should be before the other matching tests.
    */
@@ -452,8 +516,6 @@ public:
     return _sizes;
   }
 };
-static const int MAX_ENTRY_STACK_DEPTH = 256;
-
 /**
  * @brief An interface (abstract class) for fetching files from a file tree.
  */
@@ -467,6 +529,13 @@ public:
    */
   virtual void
   changeBase(const char *base) = 0;
+  /**
+   * Returns whether the agent applies the filter itself (and updates the statistics).
+   * @return <em>true</em>: <em>rawNextFile()</em> returns only matching entries.
+   */
+  virtual bool isPrefiltered() const {
+    return false;
+  }
   /**
    * Returns the next file without filtering.
    */
@@ -474,19 +543,29 @@ public:
   rawNextFile(int &level) = 0;
 };
 /**
- * @brief Implements a <em>FileAgent</em> for "struct stat" based filesystems.
+ * @brief Implements a portable <em>FileAgent</em> for "struct stat" based filesystems.
+ *
+ * Only one directory is open at a time: the depth of the tree is not limited.
+ * The subdirectories found are stored in a <em>DirectoryQueue</em> with a memory budget:
+ * depth first (a stack) or breadth first (a FIFO, level by level).
+ * A directory is returned before its content.
+ * The agent applies the filter itself and updates the statistic.
  */
-class FileAgentWithStack: FileAgent {
+class FileAgentWithStack: public FileAgent {
 protected:
-  ///
-  /// The current depth of the directory tree: 0 means in the base directory.
-  int _depth;
   std::string _base;
-  FsEntryWithStack *m_dirs[MAX_ENTRY_STACK_DEPTH];
-  ///
-  /// Each directory will be passed twice: for all files + for directories only
-  /// 1: depth first 2: breadth first
-  int _passNoForDirSearch;
+  /// The entry of the directory currently read.
+  FsEntryWithStack _current;
+  /// The depth of the current directory: 0 means the base directory.
+  int _currentLevel;
+  /// <em>true</em>: <em>_current</em> contains an open directory.
+  bool _open;
+  bool _started;
+  /// <em>true</em>: the first entry of the current directory is already read.
+  bool _alreadyRead;
+  DirectoryQueue _pending;
+  /// The subdirectories of the current directory: stored when the directory is complete.
+  std::vector<std::string> _subdirectories;
   ///
   /// The filter criteria.
   const DirEntryFilter *_filter;
@@ -503,32 +582,47 @@ public:
    * @param tracer <em>nullptr</em> or a handler of trigger points.
    * @param logger The logging unit.
    * @param statistics The statistics about files and directories will be updated here.
+   * @param depthFirst <em>true</em>: the subdirectories are processed before the siblings of the parent.
+   *  <em>false</em>: breadth first: all directories of a level are processed before the next level.
+   * @param memoryBudget The maximal memory for the pending directories. 0: the default.
    */
   FileAgentWithStack(const char *base, const DirEntryFilter *filter,
-      TraceUnit *tracer, Logger *logger, DirTreeStatistic &statistics);
+      TraceUnit *tracer, Logger *logger, DirTreeStatistic &statistics,
+      bool depthFirst = true, size_t memoryBudget = 0);
   virtual
   ~FileAgentWithStack();
 public:
   virtual void
   changeBase(const char *base);
+  inline virtual bool isPrefiltered() const {
+    return true;
+  }
+  /**
+   * Returns the directories not yet read.
+   */
+  inline const DirectoryQueue& pending() const {
+    return _pending;
+  }
   virtual FsEntry*
   rawNextFile(int &level);
-  /** Sets the tree traversal algorithm.
+  /** Sets the tree traversal algorithm. Starts the traversal again.
    * @param depthFirst <em>true</em>: files of the subdirectories will
    *                      be returned earlier
    */
-  void setDepthFirst(bool depthFirst) {
-    _passNoForDirSearch = depthFirst ? 1 : 2;
+  void setDepthFirst(bool depthFirst);
+  /**
+   * Sets the maximal memory for the pending directories.
+   * More directories are stored in a temporary file.
+   * @param memoryBudget The count of bytes. 0: the default.
+   */
+  inline void setMemoryBudget(size_t memoryBudget) {
+    _pending.setMemoryBudget(memoryBudget);
   }
-  FsEntryWithStack*
-  topOfStack(int offset = 0);
 protected:
-  void
-  destroy();
-  void
-  freeEntry(int level);
   bool
-  initEntry(const std::string &parent, const char *node, int level);
+  openDirectory(const std::string &path, int level);
+  void
+  storeSubdirectories();
 };
 /// The Linux implementation of <em>FileAgent</em>.
 /**
@@ -569,6 +663,18 @@ public:
  * @brief Allows to traverse a directory tree file by file with many filter options.
  */
 class Traverser: public DirTreeStatistic {
+public:
+  /**
+   * The order of the traversal.
+   */
+  enum TraversalOrder {
+    /// The order of the platform specific agent (FTS, getdents...): a directory after its content.
+    TO_NATIVE,
+    /// Portable, a directory before its content, subdirectories before siblings.
+    TO_DEPTH_FIRST,
+    /// Portable, level by level.
+    TO_BREADTH_FIRST
+  };
 protected:
   std::string _base;
   const DirEntryFilter *_filter;
@@ -576,6 +682,13 @@ protected:
   Logger *_logger;
   FileAgent *_fileAgent;
   const OsInfo &_osInfo;
+  int _threadCount;
+  bool _lazyStatus;
+  unsigned int _statusMask;
+  std::string _indexFile;
+  TraversalOrder _order;
+  size_t _queueMemory;
+  unsigned _queueDepth;
 public:
   /**
    * Constructor.
@@ -617,6 +730,50 @@ public:
   inline FileAgent* fileAgent() {
     return _fileAgent;
   }
+  /**
+   * Fetches only the needed status info of the entries.
+   * If only one thread is used the directories are read with <em>getdents64()</em>
+   * and the status info (<em>statx()</em>) is fetched only for the given fields
+   * and the fields needed by the filter.
+   * @param statusMask The STATX_* fields needed by the caller, e.g. 0 for a name only listing.
+   */
+  void setLazyStatus(unsigned int statusMask);
+  /**
+   * Fetches the status info asynchronously with io_uring (<em>UringFileAgent</em>).
+   * Has a lower priority than an index file and a portable traversal order.
+   * If the kernel does not support io_uring the other settings are used.
+   * @param queueDepth The maximal count of status requests in flight. 0: synchronous requests.
+   */
+  void setAsyncStatus(unsigned queueDepth);
+  /**
+   * Uses a persistent index as cache: only directories with a changed modification time are read.
+   * @param indexFile The name of the index file. Will be created if it does not exist.
+   *  <em>nullptr</em> or "": no index is used.
+   */
+  void setIndexFile(const char *indexFile);
+  /**
+   * Selects the portable agent with a given traversal order.
+   * Has a lower priority than an index file.
+   * @param order <em>TO_NATIVE</em>: the platform specific agent is used.
+   *  Otherwise: the portable agent (<em>FileAgentWithStack</em>) with that order.
+   * @param queueMemory The maximal memory for the pending directories of the portable agent. 0: the default.
+   */
+  void setTraversalOrder(TraversalOrder order, size_t queueMemory = 0);
+  /**
+   * Sets the count of threads scanning the directory tree.
+   * @param threads 1: the directory tree is scanned by the caller (FTS).
+   *  &gt; 1: the directory tree is scanned by that count of worker threads.
+   *  &lt;= 0: the count of CPU cores is used.
+   */
+  void setThreadCount(int threads);
+  /**
+   * Returns the count of threads scanning the directory tree.
+   */
+  inline int threadCount() const {
+    return _threadCount;
+  }
+protected:
+  void createFileAgent();
 };
 } /* cppknife */
 
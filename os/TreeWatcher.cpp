@@ -0,0 +1,320 @@
+/*
+ * TreeWatcher.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "os.hpp"
+#if defined __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+namespace cppknife {
+
+static const uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MODIFY
+    | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR
+    | IN_DONT_FOLLOW | IN_EXCL_UNLINK;
+static const size_t EVENT_BUFFER_SIZE = 64 * 1024;
+
+TreeWatcher::TreeWatcher(Logger *logger, size_t extremaCount) :
+    _logger(logger), _base(), _handle(-1), _directories(), _root(nullptr), _statistic(), _extrema(
+        new FileExtrema(extremaCount)), _extremaCount(extremaCount), _extremaDirty(
+        false), _changes(0), _rescans(0), _eventBuffer(
+        new char[EVENT_BUFFER_SIZE]) {
+}
+
+TreeWatcher::~TreeWatcher() {
+  clear();
+  if (_handle >= 0) {
+    close(_handle);
+    _handle = -1;
+  }
+  delete _extrema;
+  _extrema = nullptr;
+  delete[] _eventBuffer;
+  _eventBuffer = nullptr;
+}
+
+void TreeWatcher::addSize(Directory *directory, int64_t delta) {
+  directory->_ownSizes += delta;
+  _statistic._sizes += delta;
+  // Only the ancestors are affected:
+  while (directory != nullptr) {
+    directory->_treeSizes += delta;
+    directory = directory->_parent;
+  }
+}
+
+void TreeWatcher::clear() {
+  if (_root != nullptr) {
+    forget(_root);
+    _root = nullptr;
+  }
+  _statistic.clear();
+  _extremaDirty = true;
+}
+
+int64_t TreeWatcher::directorySize(const char *path) const {
+  int64_t rc = -1;
+  size_t length = _base.size();
+  if (_root != nullptr && strncmp(path, _base.c_str(), length) == 0
+      && (path[length] == '\0' || path[length] == '/')) {
+    const Directory *current = _root;
+    auto parts = splitCString(path + length, "/");
+    for (auto &part : parts) {
+      if (!part.empty()) {
+        auto child = current->_children.find(part);
+        if (child == current->_children.end()) {
+          current = nullptr;
+          break;
+        }
+        current = _directories.at(child->second);
+      }
+    }
+    if (current != nullptr) {
+      rc = current->_treeSizes;
+    }
+  }
+  return rc;
+}
+
+const FileExtrema& TreeWatcher::extrema() {
+  if (_extremaDirty) {
+    delete _extrema;
+    _extrema = new FileExtrema(_extremaCount);
+    std::string fullName;
+    for (auto &item : _directories) {
+      auto directory = item.second;
+      for (auto &file : directory->_files) {
+        fullName = directory->_path;
+        fullName += '/';
+        fullName += file.first;
+        _extrema->add(fullName.c_str(), file.second._modified,
+            file.second._size);
+      }
+    }
+    _extremaDirty = false;
+  }
+  return *_extrema;
+}
+
+void TreeWatcher::forget(Directory *directory) {
+  for (auto &child : directory->_children) {
+    auto found = _directories.find(child.second);
+    if (found != _directories.end()) {
+      forget(found->second);
+    }
+  }
+  _statistic._files -= static_cast<int>(directory->_files.size());
+  _statistic._directories--;
+  // Fails if the directory is already deleted: the kernel has removed the watch.
+  inotify_rm_watch(_handle, directory->_watch);
+  _directories.erase(directory->_watch);
+  delete directory;
+}
+
+size_t TreeWatcher::poll(int timeoutMillis) {
+  size_t rc = 0;
+  struct pollfd request = { _handle, POLLIN, 0 };
+  if (_handle >= 0 && ::poll(&request, 1, timeoutMillis) > 0) {
+    // The files of a batch are inspected only once, after all events:
+    std::set<std::pair<int, std::string>> touched;
+    bool overflow = false;
+    ssize_t length;
+    while ((length = read(_handle, _eventBuffer, EVENT_BUFFER_SIZE)) > 0) {
+      for (char *ptr = _eventBuffer; ptr < _eventBuffer + length;) {
+        auto event = reinterpret_cast<const struct inotify_event*>(ptr);
+        ptr += sizeof(struct inotify_event) + event->len;
+        if ((event->mask & IN_Q_OVERFLOW) != 0) {
+          overflow = true;
+          continue;
+        }
+        auto found = _directories.find(event->wd);
+        // Events about the directory itself are handled by its parent:
+        if (found == _directories.end() || event->len == 0) {
+          continue;
+        }
+        Directory *directory = found->second;
+        std::string node(event->name);
+        if ((event->mask & IN_ISDIR) == 0) {
+          touched.insert(std::make_pair(event->wd, node));
+        } else if ((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0) {
+          rc++;
+          if (directory->_children.find(node) == directory->_children.end()) {
+            scan(directory->_path + "/" + node, directory, node.c_str());
+          }
+        } else if ((event->mask & (IN_DELETE | IN_MOVED_FROM)) != 0) {
+          rc++;
+          removeDirectory(directory, node);
+        }
+      }
+    }
+    for (auto &item : touched) {
+      auto found = _directories.find(item.first);
+      if (found != _directories.end()) {
+        rc++;
+        updateFile(found->second, item.second);
+      }
+    }
+    if (overflow) {
+      _logger->say(LV_WARNING, "inotify queue overflow: scanning again");
+      _rescans++;
+      std::string base = _base;
+      start(base.c_str());
+    }
+  }
+  _changes += rc;
+  return rc;
+}
+
+void TreeWatcher::removeDirectory(Directory *parent, const std::string &node) {
+  auto child = parent->_children.find(node);
+  if (child != parent->_children.end()) {
+    auto found = _directories.find(child->second);
+    parent->_children.erase(child);
+    if (found != _directories.end()) {
+      Directory *directory = found->second;
+      int64_t sizes = directory->_treeSizes;
+      if (sizes != 0) {
+        // The own sizes of the parent are not affected:
+        addSize(parent, -sizes);
+        parent->_ownSizes += sizes;
+      }
+      forget(directory);
+      _extremaDirty = true;
+    }
+  }
+}
+
+void TreeWatcher::removeFile(Directory *directory, const std::string &node) {
+  auto found = directory->_files.find(node);
+  if (found != directory->_files.end()) {
+    addSize(directory, -found->second._size);
+    directory->_files.erase(found);
+    _statistic._files--;
+    _extremaDirty = true;
+  }
+}
+
+TreeWatcher::Directory* TreeWatcher::scan(const std::string &path,
+    Directory *parent, const char *node) {
+  // The watch is installed before reading: no file can be missed.
+  int watch = inotify_add_watch(_handle, path.c_str(), WATCH_MASK);
+  Directory *rc = nullptr;
+  if (watch < 0) {
+    _logger->say(LV_ERROR,
+        formatCString("cannot watch %s (%d): %s", path.c_str(), errno,
+            strerror(errno)));
+  } else if (_directories.find(watch) != _directories.end()) {
+    // Already known, e.g. by a link or a very fast move.
+    rc = _directories[watch];
+  } else {
+    rc = new Directory();
+    rc->_path = path;
+    rc->_parent = parent;
+    rc->_watch = watch;
+    rc->_ownSizes = rc->_treeSizes = 0;
+    _directories[watch] = rc;
+    _statistic._directories++;
+    if (parent != nullptr) {
+      parent->_children[node] = watch;
+    }
+    int handle = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    DIR *dir = handle < 0 ? nullptr : fdopendir(handle);
+    if (dir == nullptr) {
+      if (handle >= 0) {
+        close(handle);
+      }
+      _logger->say(LV_ERROR,
+          formatCString("cannot read directory %s (%d): %s", path.c_str(),
+              errno, strerror(errno)));
+    } else {
+      std::vector<std::string> subdirectories;
+      struct dirent *entry;
+      struct stat status;
+      while ((entry = readdir(dir)) != nullptr) {
+        const char *name = entry->d_name;
+        if (name[0] == '.'
+            && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+          continue;
+        }
+        if (entry->d_type == DT_DIR) {
+          subdirectories.push_back(name);
+        } else if (fstatat(handle, name, &status, AT_SYMLINK_NOFOLLOW) == 0) {
+          if (S_ISDIR(status.st_mode)) {
+            subdirectories.push_back(name);
+          } else {
+            setFile(rc, name, status);
+          }
+        }
+      }
+      closedir(dir);
+      for (auto &subdirectory : subdirectories) {
+        scan(path + "/" + subdirectory, rc, subdirectory.c_str());
+      }
+    }
+  }
+  return rc;
+}
+
+void TreeWatcher::setFile(Directory *directory, const std::string &node,
+    const struct stat &status) {
+  FileSize_t size = S_ISREG(status.st_mode) ? status.st_size : 0;
+  auto found = directory->_files.find(node);
+  if (found == directory->_files.end()) {
+    directory->_files[node] = FileInfo { size, status.st_mtim.tv_sec };
+    _statistic._files++;
+    addSize(directory, size);
+    if (!_extremaDirty) {
+      std::string fullName = directory->_path + "/" + node;
+      _extrema->add(fullName.c_str(), status.st_mtim.tv_sec,
+          S_ISREG(status.st_mode) ? size : -1);
+    }
+  } else if (found->second._size != size
+      || found->second._modified != status.st_mtim.tv_sec) {
+    addSize(directory, size - found->second._size);
+    found->second._size = size;
+    found->second._modified = status.st_mtim.tv_sec;
+    // The old values may be stored in the extrema:
+    _extremaDirty = true;
+  }
+}
+
+bool TreeWatcher::start(const char *base) {
+  if (_handle < 0) {
+    _handle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  }
+  clear();
+  _base = base;
+  while (_base.size() > 1 && _base[_base.size() - 1] == '/') {
+    _base.resize(_base.size() - 1);
+  }
+  bool rc = _handle >= 0;
+  if (!rc) {
+    _logger->say(LV_ERROR,
+        formatCString("cannot initialize inotify (%d): %s", errno,
+            strerror(errno)));
+  } else {
+    _root = scan(_base, nullptr, nullptr);
+    rc = _root != nullptr;
+  }
+  return rc;
+}
+
+void TreeWatcher::updateFile(Directory *directory, const std::string &node) {
+  struct stat status;
+  std::string fullName = directory->_path + "/" + node;
+  if (lstat(fullName.c_str(), &status) != 0) {
+    removeFile(directory, node);
+  } else if (S_ISDIR(status.st_mode)) {
+    // A file has been replaced by a directory: the directory event follows.
+    removeFile(directory, node);
+  } else {
+    setFile(directory, node, status);
+  }
+}
+
+} /* cppknife */
@@ -0,0 +1,138 @@
+/*
+ * TreeWatcher.hpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef OS_TREEWATCHER_HPP_
+#define OS_TREEWATCHER_HPP_
+
+namespace cppknife {
+/**
+ * @brief Keeps the statistic of a directory tree up to date using inotify events.
+ *
+ * <em>start()</em> scans the tree once and installs an inotify watch for each directory.
+ * After that <em>poll()</em> processes the events: the costs depend on the count of changes,
+ * not on the size of the tree. Multiple events of one file in one batch are handled once.
+ *
+ * The size of each file is held in memory. Each directory knows the sum of its own files
+ * and of its subtree: a change is propagated to the ancestors only.
+ * Added files are put into the extrema directly. If a file is changed or removed
+ * the extrema are rebuilt from the memory (without disk access) on the next <em>extrema()</em>.
+ *
+ * A created or moved in directory is scanned, a removed or moved out directory is forgotten.
+ * If the kernel queue overflows the whole tree is scanned again.
+ * Note: the count of watches is limited by /proc/sys/fs/inotify/max_user_watches.
+ */
+class TreeWatcher {
+public:
+  /**
+   * @brief The info about a file needed for the statistic.
+   */
+  struct FileInfo {
+    FileSize_t _size;
+    int64_t _modified;
+  };
+  /**
+   * @brief A watched directory.
+   */
+  struct Directory {
+    std::string _path;
+    Directory *_parent;
+    /// The inotify watch descriptor.
+    int _watch;
+    /// The files (and other non directory entries) by node name.
+    std::map<std::string, FileInfo> _files;
+    /// The subdirectories: node name => watch descriptor.
+    std::map<std::string, int> _children;
+    /// The sum of the file sizes in this directory.
+    int64_t _ownSizes;
+    /// The sum of the file sizes in this directory and all subdirectories.
+    int64_t _treeSizes;
+  };
+protected:
+  Logger *_logger;
+  std::string _base;
+  /// The inotify file handle.
+  int _handle;
+  std::map<int, Directory*> _directories;
+  Directory *_root;
+  DirTreeStatistic _statistic;
+  FileExtrema *_extrema;
+  size_t _extremaCount;
+  /// <em>true</em>: the extrema must be rebuilt because a file has been changed or removed.
+  bool _extremaDirty;
+  size_t _changes;
+  size_t _rescans;
+  char *_eventBuffer;
+public:
+  /**
+   * Constructor.
+   * @param logger The logger for error messages.
+   * @param extremaCount The count of records per extremum.
+   */
+  TreeWatcher(Logger *logger, size_t extremaCount = 20);
+  virtual ~TreeWatcher();
+private:
+  TreeWatcher(const TreeWatcher &other);
+  TreeWatcher&
+  operator=(const TreeWatcher &other);
+public:
+  /**
+   * Returns the count of processed file or directory changes since the start.
+   */
+  inline size_t changes() const {
+    return _changes;
+  }
+  /**
+   * Returns the sum of the file sizes of a directory tree.
+   * @param path The directory. Must be inside the watched tree.
+   * @return -1: unknown directory. Otherwise: the sum of the file sizes in the subtree.
+   */
+  int64_t directorySize(const char *path) const;
+  /**
+   * Returns the largest, youngest and oldest files. Rebuilt if needed.
+   */
+  const FileExtrema& extrema();
+  /**
+   * Processes the pending events.
+   * @param timeoutMillis The maximal time to wait for the first event. 0: do not wait, -1: wait endlessly.
+   * @return The count of processed changes.
+   */
+  size_t poll(int timeoutMillis);
+  /**
+   * Returns how often the whole tree has been scanned again after an event queue overflow.
+   */
+  inline size_t rescans() const {
+    return _rescans;
+  }
+  /**
+   * Scans the directory tree and starts watching.
+   * @param base The top directory of the tree.
+   * @return <em>true</em>: success.
+   */
+  bool start(const char *base);
+  /**
+   * Returns the current statistic: files, directories and sizes.
+   */
+  inline const DirTreeStatistic& statistic() const {
+    return _statistic;
+  }
+protected:
+  void addSize(Directory *directory, int64_t delta);
+  void clear();
+  void forget(Directory *directory);
+  void removeDirectory(Directory *parent, const std::string &node);
+  void removeFile(Directory *directory, const std::string &node);
+  Directory* scan(const std::string &path, Directory *parent,
+      const char *node);
+  void setFile(Directory *directory, const std::string &node,
+      const struct stat &status);
+  void updateFile(Directory *directory, const std::string &node);
+};
+
+} /* cppknife */
+
+#endif /* OS_TREEWATCHER_HPP_ */
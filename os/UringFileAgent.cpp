@@ -0,0 +1,604 @@
+/*
+ * UringFileAgent.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "os.hpp"
+#if defined __linux__
+#include <linux/io_uring.h>
+#endif
+
+namespace cppknife {
+
+IoUring::IoUring(unsigned entries) :
+    _handle(-1), _entries(0), _error(0), _submissionRing(nullptr), _submissionRingSize(
+        0), _completionRing(nullptr), _completionRingSize(0), _submissionEntries(
+        nullptr), _submissionEntriesSize(0), _submissionHead(nullptr), _submissionTail(
+        nullptr), _submissionMask(0), _submissionArray(nullptr), _completionHead(
+        nullptr), _completionTail(nullptr), _completionMask(0), _completionEntries(
+        nullptr), _localTail(0), _unsubmitted(0) {
+#if defined __linux__ && defined __NR_io_uring_setup
+  struct io_uring_params params;
+  memset(&params, 0, sizeof params);
+  _handle = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+  if (_handle < 0) {
+    _error = errno;
+  } else {
+    _entries = params.sq_entries;
+    _submissionRingSize = params.sq_off.array
+        + params.sq_entries * sizeof(unsigned);
+    _completionRingSize = params.cq_off.cqes
+        + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMap) {
+      _submissionRingSize = _completionRingSize = std::max(
+          _submissionRingSize, _completionRingSize);
+    }
+    _submissionRing = mmap(nullptr, _submissionRingSize,
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _handle,
+        IORING_OFF_SQ_RING);
+    if (_submissionRing == MAP_FAILED) {
+      _submissionRing = nullptr;
+    } else if (singleMap) {
+      _completionRing = _submissionRing;
+    } else if ((_completionRing = mmap(nullptr, _completionRingSize,
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _handle,
+        IORING_OFF_CQ_RING)) == MAP_FAILED) {
+      _completionRing = nullptr;
+    }
+    _submissionEntriesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    if (_completionRing != nullptr) {
+      void *mapped = mmap(nullptr, _submissionEntriesSize,
+          PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _handle,
+          IORING_OFF_SQES);
+      if (mapped != MAP_FAILED) {
+        _submissionEntries = reinterpret_cast<struct io_uring_sqe*>(mapped);
+      }
+    }
+    if (_submissionEntries == nullptr) {
+      _error = errno;
+      release();
+    } else {
+      auto submission = reinterpret_cast<char*>(_submissionRing);
+      _submissionHead = reinterpret_cast<unsigned*>(submission
+          + params.sq_off.head);
+      _submissionTail = reinterpret_cast<unsigned*>(submission
+          + params.sq_off.tail);
+      _submissionMask = *reinterpret_cast<unsigned*>(submission
+          + params.sq_off.ring_mask);
+      _submissionArray = reinterpret_cast<unsigned*>(submission
+          + params.sq_off.array);
+      auto completion = reinterpret_cast<char*>(_completionRing);
+      _completionHead = reinterpret_cast<unsigned*>(completion
+          + params.cq_off.head);
+      _completionTail = reinterpret_cast<unsigned*>(completion
+          + params.cq_off.tail);
+      _completionMask = *reinterpret_cast<unsigned*>(completion
+          + params.cq_off.ring_mask);
+      _completionEntries = reinterpret_cast<struct io_uring_cqe*>(completion
+          + params.cq_off.cqes);
+      _localTail = *_submissionTail;
+    }
+  }
+#else
+  _error = ENOSYS;
+#endif
+}
+
+IoUring::~IoUring() {
+  release();
+}
+
+static bool probeRing() {
+  IoUring ring(2);
+  struct statx status;
+  uint64_t userData = 0;
+  int result = -1;
+  bool rc = ring.valid()
+      && ring.prepareStatus(AT_FDCWD, "/", 0, STATX_TYPE, &status, 1)
+      && ring.submit(1) && ring.nextCompletion(userData, result)
+      && result >= 0;
+  return rc;
+}
+
+bool IoUring::isAvailable() {
+  // Thread safe since C++11:
+  static const bool rc = probeRing();
+  return rc;
+}
+
+bool IoUring::nextCompletion(uint64_t &userData, int &result) {
+  bool rc = false;
+#if defined __linux__
+  if (_handle >= 0) {
+    unsigned head = *_completionHead;
+    // The kernel writes the entry before it publishes the tail:
+    unsigned tail = __atomic_load_n(_completionTail, __ATOMIC_ACQUIRE);
+    if ((rc = head != tail)) {
+      const struct io_uring_cqe &entry = _completionEntries[head
+          & _completionMask];
+      userData = entry.user_data;
+      result = entry.res;
+      __atomic_store_n(_completionHead, head + 1, __ATOMIC_RELEASE);
+    }
+  }
+#endif
+  return rc;
+}
+
+bool IoUring::prepareStatus(int directoryHandle, const char *path, int flags,
+    unsigned mask, struct statx *status, uint64_t userData) {
+  bool rc = false;
+#if defined __linux__
+  if (_handle >= 0) {
+    unsigned head = __atomic_load_n(_submissionHead, __ATOMIC_ACQUIRE);
+    if ((rc = _localTail - head < _entries)) {
+      unsigned index = _localTail & _submissionMask;
+      struct io_uring_sqe &entry = _submissionEntries[index];
+      memset(&entry, 0, sizeof entry);
+      entry.opcode = IORING_OP_STATX;
+      entry.fd = directoryHandle;
+      entry.addr = reinterpret_cast<uint64_t>(path);
+      entry.len = mask;
+      entry.off = reinterpret_cast<uint64_t>(status);
+      entry.statx_flags = flags;
+      entry.user_data = userData;
+      _submissionArray[index] = index;
+      _localTail++;
+      __atomic_store_n(_submissionTail, _localTail, __ATOMIC_RELEASE);
+      _unsubmitted++;
+    }
+  }
+#endif
+  return rc;
+}
+
+void IoUring::release() {
+  if (_submissionEntries != nullptr) {
+    munmap(_submissionEntries, _submissionEntriesSize);
+    _submissionEntries = nullptr;
+  }
+  if (_completionRing != nullptr && _completionRing != _submissionRing) {
+    munmap(_completionRing, _completionRingSize);
+  }
+  _completionRing = nullptr;
+  if (_submissionRing != nullptr) {
+    munmap(_submissionRing, _submissionRingSize);
+    _submissionRing = nullptr;
+  }
+  if (_handle >= 0) {
+    close(_handle);
+    _handle = -1;
+  }
+}
+
+bool IoUring::submit(unsigned waitFor) {
+  bool rc = false;
+#if defined __linux__ && defined __NR_io_uring_enter
+  if (_handle >= 0) {
+    unsigned flags = waitFor > 0 ? IORING_ENTER_GETEVENTS : 0;
+    long count;
+    while ((count = syscall(__NR_io_uring_enter, _handle, _unsubmitted,
+        waitFor, flags, nullptr, 0)) < 0 && errno == EINTR) {
+      // A signal has interrupted the waiting: try again.
+    }
+    if ((rc = count >= 0)) {
+      _unsubmitted -= static_cast<unsigned>(count);
+    }
+  }
+#endif
+  return rc;
+}
+
+UringFsEntry::UringFsEntry() :
+    _request(nullptr), _ownRequest(), _accessed(), _modified(), _linkReference() {
+}
+
+UringFsEntry::~UringFsEntry() {
+}
+
+const FileTime_t*
+UringFsEntry::accessed() {
+  return &_accessed;
+}
+const char*
+UringFsEntry::accessFullName() {
+  return fullName();
+}
+FileSize_t UringFsEntry::fileSize() {
+  return _request == nullptr ? 0 : _request->_status.stx_size;
+}
+std::string UringFsEntry::filetimeAsString() {
+  return filetimeToString(_modified);
+}
+void UringFsEntry::finishCertainFile() {
+}
+const char*
+UringFsEntry::fullName() {
+  return _request == nullptr ? "" : _request->_fullName.c_str();
+}
+size_t UringFsEntry::fullNameLength() {
+  return _request == nullptr ? 0 : _request->_fullName.size();
+}
+bool UringFsEntry::isDirectory() {
+  return type() == TF_SUBDIR;
+}
+bool UringFsEntry::isDotDir() {
+  // "." and ".." are never stored by the agent.
+  return false;
+}
+bool UringFsEntry::isLink() {
+  return type() == TF_LINK;
+}
+bool UringFsEntry::isRegular() {
+  return type() == TF_REGULAR;
+}
+const FileTime_t*
+UringFsEntry::modified() {
+  return &_modified;
+}
+const char*
+UringFsEntry::node() {
+  return _request == nullptr ?
+      "" : _request->_fullName.c_str() + _request->_nodeOffset;
+}
+const std::string&
+UringFsEntry::linkReference() {
+  _linkReference.clear();
+  if (type() == TF_LINK) {
+    char buffer[PATH_MAX];
+    auto length = readlink(fullName(), buffer, sizeof buffer);
+    if (length > 0) {
+      _linkReference.assign(buffer, length);
+    }
+  }
+  return _linkReference;
+}
+bool UringFsEntry::modeAndOwner(uint32_t &mode, uint32_t &owner,
+    uint32_t &group) {
+  bool rc = _request != nullptr
+      && (_request->_status.stx_mask & STATX_MODE) != 0;
+  if (rc) {
+    mode = _request->_status.stx_mode;
+    owner = _request->_status.stx_uid;
+    group = _request->_status.stx_gid;
+  }
+  return rc;
+}
+const char*
+UringFsEntry::rightsAsString(std::string &buffer, bool numerical,
+    int ownerWidth) {
+  const char *rc = "";
+  return rc;
+}
+void UringFsEntry::set(Request *request) {
+  _request = request;
+  setFiletime(_accessed, request->_status.stx_atime.tv_sec,
+      request->_status.stx_atime.tv_nsec);
+  setFiletime(_modified, request->_status.stx_mtime.tv_sec,
+      request->_status.stx_mtime.tv_nsec);
+}
+bool UringFsEntry::setCertainFile(const char *fullName) {
+  _ownRequest._fullName = fullName;
+  auto separator = strrchr(fullName, '/');
+  _ownRequest._nodeOffset =
+      separator == nullptr ? 0 : separator - fullName + 1;
+  _ownRequest._level = 0;
+  _ownRequest._directoryType = DT_UNKNOWN;
+  bool rc = statx(AT_FDCWD, fullName, AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT,
+      STATX_BASIC_STATS, &_ownRequest._status) == 0;
+  if (!rc) {
+    memset(&_ownRequest._status, 0, sizeof _ownRequest._status);
+  }
+  set(&_ownRequest);
+  return rc;
+}
+FsEntry::Type_t UringFsEntry::type() {
+  Type_t rc = TF_UNDEF;
+  if (_request != nullptr) {
+    unsigned char directoryType = _request->_directoryType;
+    if ((_request->_status.stx_mask & STATX_TYPE) != 0) {
+      directoryType = IFTODT(_request->_status.stx_mode);
+    }
+    switch (directoryType) {
+    case DT_DIR:
+      rc = TF_SUBDIR;
+      break;
+    case DT_REG:
+      rc = TF_REGULAR;
+      break;
+    case DT_LNK:
+      rc = TF_LINK;
+      break;
+    case DT_CHR:
+      rc = TF_CHAR;
+      break;
+    case DT_BLK:
+      rc = TF_BLOCK;
+      break;
+    case DT_FIFO:
+      rc = TF_PIPE;
+      break;
+    case DT_SOCK:
+      rc = TF_SOCKET;
+      break;
+    case DT_UNKNOWN:
+      break;
+    default:
+      rc = TF_OTHER;
+      break;
+    }
+  }
+  return rc;
+}
+
+UringFileAgent::UringFileAgent(const char *base, const DirEntryFilter *filter,
+    TraceUnit *tracer, Logger *logger, DirTreeStatistic &statistics,
+    unsigned queueDepth) :
+    FileAgent(), _base(base == nullptr ? "." : base), _filter(filter), _tracer(
+        tracer), _logger(logger), _statistics(statistics), _ring(nullptr), _queueDepth(
+        queueDepth == 0 ? DEFAULT_QUEUE_DEPTH : queueDepth), _statusMask(
+        STATX_BASIC_STATS), _requests(), _freeSlots(), _completed(), _inFlight(
+        0), _lastSlot(-1), _pending(true, 0, logger), _names(), _nextName(0), _currentNodeOffset(
+        0), _currentLevel(0), _started(false), _currentEntry(), _fallbacks(0) {
+  _ring = new IoUring(_queueDepth);
+  if (!_ring->valid() && _logger != nullptr) {
+    _logger->say(LV_FINE,
+        formatCString("io_uring is not available (%d): %s", _ring->error(),
+            strerror(_ring->error())));
+  }
+  // The storage must not be moved while the kernel uses it: the size is fixed.
+  _requests.resize(_queueDepth);
+  reset();
+}
+
+UringFileAgent::~UringFileAgent() {
+  drain();
+  delete _ring;
+  _ring = nullptr;
+}
+
+void UringFileAgent::changeBase(const char *base) {
+  _base = base == nullptr ? "." : base;
+  drain();
+  reset();
+}
+
+/**
+ * Waits for all requests in flight: the kernel may still write into the request storage.
+ */
+void UringFileAgent::drain() {
+  uint64_t slot;
+  int result;
+  while (_inFlight > 0) {
+    while (_ring->nextCompletion(slot, result)) {
+      _inFlight--;
+    }
+    if (_inFlight > 0 && !_ring->submit(1)) {
+      break;
+    }
+  }
+}
+
+/**
+ * Submits status requests for the waiting entries until the queue depth is reached.
+ */
+void UringFileAgent::fillQueue() {
+  bool added = false;
+  while (!_freeSlots.empty()) {
+    if (_nextName >= _names.size()) {
+      std::string path;
+      int level;
+      if (!_pending.pop(path, level)) {
+        break;
+      }
+      readDirectory(path, level);
+      continue;
+    }
+    unsigned slot = _freeSlots.back();
+    _freeSlots.pop_back();
+    Name &name = _names[_nextName++];
+    UringFsEntry::Request &request = _requests[slot];
+    request._fullName = std::move(name._fullName);
+    request._nodeOffset = _currentNodeOffset;
+    request._level = _currentLevel;
+    request._directoryType = name._directoryType;
+    if (_ring->prepareStatus(AT_FDCWD, request._fullName.c_str(),
+        AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, _statusMask, &request._status,
+        slot)) {
+      _inFlight++;
+      added = true;
+    } else {
+      _fallbacks++;
+      int result =
+          statx(AT_FDCWD, request._fullName.c_str(),
+              AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, _statusMask,
+              &request._status) == 0 ? 0 : -errno;
+      _completed.push_back(std::make_pair(slot, result));
+    }
+  }
+  if (added) {
+    _ring->submit(0);
+  }
+}
+
+/**
+ * Returns the next finished status request.
+ * @param[out] slot The index of the request in <em>_requests</em>.
+ * @param[out] result The result of the request: 0 or -errno.
+ * @return <em>false</em>: no request is left.
+ */
+bool UringFileAgent::nextResult(unsigned &slot, int &result) {
+  bool rc = false;
+  uint64_t userData;
+  if (!_completed.empty()) {
+    slot = _completed.back().first;
+    result = _completed.back().second;
+    _completed.pop_back();
+    rc = true;
+  } else {
+    while (_inFlight > 0 && !(rc = _ring->nextCompletion(userData, result))) {
+      if (!_ring->submit(1)) {
+        if (_logger != nullptr) {
+          _logger->say(LV_ERROR,
+              formatCString("io_uring_enter() failed (%d): %s", errno,
+                  strerror(errno)));
+        }
+        break;
+      }
+    }
+    if (rc) {
+      _inFlight--;
+      slot = static_cast<unsigned>(userData);
+      if (result == -EINVAL || result == -EOPNOTSUPP) {
+        // No statx support in the ring:
+        _fallbacks++;
+        UringFsEntry::Request &request = _requests[slot];
+        result = statx(AT_FDCWD, request._fullName.c_str(),
+            AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, _statusMask,
+            &request._status) == 0 ? 0 : -errno;
+      }
+    }
+  }
+  return rc;
+}
+
+FsEntry*
+UringFileAgent::rawNextFile(int &level) {
+  FsEntry *rc = nullptr;
+  if (_lastSlot >= 0) {
+    releaseSlot(_lastSlot);
+    _lastSlot = -1;
+  }
+  if (!_started) {
+    _started = true;
+    _pending.push(_base, 0);
+  }
+  unsigned slot;
+  int result;
+  while (rc == nullptr) {
+    fillQueue();
+    if (!nextResult(slot, result)) {
+      break;
+    }
+    UringFsEntry::Request &request = _requests[slot];
+    if (result < 0) {
+      // Removed since the directory has been read:
+      if (_logger != nullptr && _logger->currentLevel() >= LV_FINE) {
+        _logger->say(LV_FINE,
+            formatCString("_ no status: %s (%d)", request._fullName.c_str(),
+                -result));
+      }
+      releaseSlot(slot);
+      continue;
+    }
+    _currentEntry.set(&request);
+    if (_tracer != nullptr && _tracer->isCountTriggered()
+        && _tracer->isTimeTriggered()) {
+      _tracer->trace(_currentEntry.fullName());
+    }
+    if (request._directoryType == DT_UNKNOWN && _currentEntry.isDirectory()) {
+      // Not yet known as directory while reading the parent:
+      storeDirectory(request._fullName, request._nodeOffset, request._level);
+    }
+    if (_filter == nullptr || _filter->match(_currentEntry, nullptr)) {
+      if (_currentEntry.isRegular()) {
+        _statistics._files++;
+        _statistics._sizes += _currentEntry.fileSize();
+      } else if (!_currentEntry.isDirectory()) {
+        _statistics._files++;
+      }
+      level = request._level;
+      _lastSlot = static_cast<int>(slot);
+      rc = &_currentEntry;
+    } else {
+      releaseSlot(slot);
+    }
+  }
+  return rc;
+}
+
+/**
+ * Reads the names of a directory. The status info is fetched later.
+ * @param path The directory to read.
+ * @param level The depth of the directory: 0 means the base directory.
+ */
+void UringFileAgent::readDirectory(const std::string &path, int level) {
+  _names.clear();
+  _nextName = 0;
+  DIR *dir = opendir(path.c_str());
+  if (dir == nullptr) {
+    _statistics._ignoredDirectories++;
+    if (_logger != nullptr && _logger->currentLevel() >= LV_FINE) {
+      _logger->say(LV_FINE, formatCString("_ ignored: %s", path.c_str()));
+    }
+  } else {
+    _statistics._directories++;
+    _currentLevel = level;
+    std::string prefix = path;
+    if (prefix.empty() || prefix[prefix.size() - 1] != '/') {
+      prefix += '/';
+    }
+    _currentNodeOffset = prefix.size();
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr) {
+      const char *name = entry->d_name;
+      if (name[0] == '.'
+          && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+        continue;
+      }
+      _names.push_back(Name { prefix + name, entry->d_type });
+      if (entry->d_type == DT_DIR) {
+        // Entered before its own status is known: the queue is not drained.
+        storeDirectory(_names.back()._fullName, _currentNodeOffset, level);
+      }
+    }
+    closedir(dir);
+  }
+}
+
+void UringFileAgent::releaseSlot(unsigned slot) {
+  _freeSlots.push_back(slot);
+}
+
+void UringFileAgent::reset() {
+  _freeSlots.clear();
+  for (unsigned ix = _queueDepth; ix > 0; ix--) {
+    _freeSlots.push_back(ix - 1);
+  }
+  _completed.clear();
+  _inFlight = 0;
+  _lastSlot = -1;
+  _pending.clear();
+  _names.clear();
+  _nextName = 0;
+  _started = false;
+}
+
+/**
+ * Stores a subdirectory as pending if the filter allows to enter it.
+ * @param fullName The name of the subdirectory.
+ * @param nodeOffset The offset of the node in <em>fullName</em>.
+ * @param level The depth of the parent directory.
+ */
+void UringFileAgent::storeDirectory(const std::string &fullName,
+    size_t nodeOffset, int level) {
+  bool doEnter = _filter == nullptr
+      || (level < _filter->_maxDepth
+          && (_filter->_pathPatterns == nullptr
+              || _filter->_pathPatterns->match(fullName.c_str() + nodeOffset)));
+  if (doEnter) {
+    _pending.push(fullName, level + 1);
+  } else {
+    _statistics._ignoredDirectories++;
+    if (_logger != nullptr && _logger->currentLevel() >= LV_FINE) {
+      _logger->say(LV_FINE,
+          formatCString("_ ignored: %s/", fullName.c_str()));
+    }
+  }
+}
+
+} /* cppknife */
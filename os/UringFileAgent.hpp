@@ -0,0 +1,279 @@
+/*
+ * UringFileAgent.hpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef OS_URINGFILEAGENT_HPP_
+#define OS_URINGFILEAGENT_HPP_
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace cppknife {
+/**
+ * @brief A minimal io_uring instance using the raw system calls (no liburing needed).
+ *
+ * Only the operations needed by <em>UringFileAgent</em> are offered.
+ * The instance is used by one thread only.
+ */
+class IoUring {
+protected:
+  int _handle;
+  unsigned _entries;
+  /// The errno of the setup, 0: success.
+  int _error;
+  void *_submissionRing;
+  size_t _submissionRingSize;
+  void *_completionRing;
+  size_t _completionRingSize;
+  struct io_uring_sqe *_submissionEntries;
+  size_t _submissionEntriesSize;
+  unsigned *_submissionHead;
+  unsigned *_submissionTail;
+  unsigned _submissionMask;
+  unsigned *_submissionArray;
+  unsigned *_completionHead;
+  unsigned *_completionTail;
+  unsigned _completionMask;
+  struct io_uring_cqe *_completionEntries;
+  /// The tail including the prepared but not yet published entries.
+  unsigned _localTail;
+  /// The count of published but not yet submitted entries.
+  unsigned _unsubmitted;
+public:
+  /**
+   * Constructor.
+   * @param entries The size of the submission queue. Rounded up to a power of 2 by the kernel.
+   */
+  IoUring(unsigned entries);
+  virtual ~IoUring();
+private:
+  IoUring(const IoUring &other);
+  IoUring&
+  operator=(const IoUring &other);
+public:
+  /**
+   * Returns the errno of the setup, 0: the instance is usable.
+   */
+  inline int error() const {
+    return _error;
+  }
+  /**
+   * Returns whether the kernel offers io_uring with <em>statx</em> support.
+   * The result of the first call is cached.
+   */
+  static bool isAvailable();
+  /**
+   * Fetches the next completion.
+   * @param[out] userData The value given in the request.
+   * @param[out] result The result of the request: &lt; 0: -errno.
+   * @return <em>false</em>: no completion is available.
+   */
+  bool nextCompletion(uint64_t &userData, int &result);
+  /**
+   * Queues a <em>statx</em> request. It is started with the next <em>submit()</em>.
+   * @param directoryHandle AT_FDCWD or the handle of the directory containing <em>path</em>.
+   * @param path The name of the file. Must be valid until the completion.
+   * @param flags The AT_* flags, e.g. AT_SYMLINK_NOFOLLOW.
+   * @param mask The STATX_* fields to fetch.
+   * @param[out] status The result. Must be valid until the completion.
+   * @param userData Identifies the request in the completion.
+   * @return <em>false</em>: the submission queue is full.
+   */
+  bool prepareStatus(int directoryHandle, const char *path, int flags,
+      unsigned mask, struct statx *status, uint64_t userData);
+  /**
+   * Starts the queued requests and waits for completions.
+   * @param waitFor The count of completions to wait for. 0: do not wait.
+   * @return <em>true</em>: success.
+   */
+  bool submit(unsigned waitFor);
+  /**
+   * Returns whether the instance is usable.
+   */
+  inline bool valid() const {
+    return _handle >= 0;
+  }
+protected:
+  void release();
+};
+/**
+ * @brief A <em>FsEntry</em> whose status info is delivered by an io_uring completion.
+ */
+class UringFsEntry: public FsEntry {
+public:
+  /**
+   * @brief The storage of an asynchronous status request: used by the kernel until the completion.
+   */
+  struct Request {
+    std::string _fullName;
+    size_t _nodeOffset;
+    int _level;
+    unsigned char _directoryType;
+    struct statx _status;
+  };
+protected:
+  Request *_request;
+  /// Used by <em>setCertainFile()</em>.
+  Request _ownRequest;
+  FileTime_t _accessed;
+  FileTime_t _modified;
+  std::string _linkReference;
+public:
+  UringFsEntry();
+  virtual ~UringFsEntry();
+private:
+  UringFsEntry(const UringFsEntry &other);
+  UringFsEntry&
+  operator=(const UringFsEntry &other);
+public:
+  virtual const FileTime_t*
+  accessed();
+  virtual const char*
+  accessFullName();
+  virtual FileSize_t fileSize();
+  virtual std::string filetimeAsString();
+  virtual void finishCertainFile();
+  virtual const char*
+  fullName();
+  virtual size_t fullNameLength();
+  virtual bool
+  isDirectory();
+  virtual bool
+  isDotDir();
+  virtual bool
+  isLink();
+  virtual bool
+  isRegular();
+  virtual const FileTime_t*
+  modified();
+  virtual const char*
+  node();
+  virtual const std::string&
+  linkReference();
+  virtual bool
+  modeAndOwner(uint32_t &mode, uint32_t &owner, uint32_t &group);
+  virtual const char*
+  rightsAsString(std::string &buffer, bool numerical, int ownerWidth);
+  /**
+   * Sets the request with a completed status.
+   * @param request The completed request.
+   */
+  void set(Request *request);
+  virtual bool setCertainFile(const char *fullName);
+  inline virtual bool testNamesFirst() const {
+    return false;
+  }
+  virtual Type_t
+  type();
+};
+/**
+ * @brief A Linux specific <em>FileAgent</em> fetching the status info asynchronously with io_uring.
+ *
+ * The directories are read synchronously, the <em>statx()</em> calls of the entries are submitted
+ * in batches to an io_uring instance: up to <em>queueDepth</em> requests are in flight at once.
+ * This hides the latency of slow (network, cold cache) filesystems.
+ *
+ * The entries are returned in the order of the completions, not in the directory order.
+ * The pending directories are stored in a <em>DirectoryQueue</em> (depth first).
+ * A directory may be returned after parts of its content.
+ * The agent applies the filter itself and updates the statistic.
+ *
+ * If the ring cannot be set up or a request fails with EINVAL or EOPNOTSUPP
+ * (a kernel without <em>statx</em> support in io_uring) the status is fetched synchronously.
+ */
+class UringFileAgent: public FileAgent {
+public:
+  enum {
+    DEFAULT_QUEUE_DEPTH = 64
+  };
+protected:
+  /**
+   * @brief A directory entry waiting for its status request.
+   */
+  struct Name {
+    std::string _fullName;
+    unsigned char _directoryType;
+  };
+protected:
+  std::string _base;
+  const DirEntryFilter *_filter;
+  TraceUnit *_tracer;
+  Logger *_logger;
+  DirTreeStatistic &_statistics;
+  IoUring *_ring;
+  unsigned _queueDepth;
+  unsigned _statusMask;
+  /// The storage of the requests, the index is the user data of the request.
+  std::vector<UringFsEntry::Request> _requests;
+  std::vector<unsigned> _freeSlots;
+  /// The requests done synchronously: (slot, result).
+  std::vector<std::pair<unsigned, int>> _completed;
+  unsigned _inFlight;
+  /// The slot of the last returned entry: freed with the next call.
+  int _lastSlot;
+  DirectoryQueue _pending;
+  /// The entries of the current directory.
+  std::vector<Name> _names;
+  size_t _nextName;
+  size_t _currentNodeOffset;
+  int _currentLevel;
+  bool _started;
+  UringFsEntry _currentEntry;
+  /// Count of requests done synchronously.
+  size_t _fallbacks;
+public:
+  /**
+   * Constructor.
+   *
+   * @param base The base directory. The traversal starts at this point.
+   * @param filter Specifies the search criteria. May be <em>nullptr</em>.
+   * @param tracer <em>nullptr</em> or a handler of trigger points.
+   * @param logger The logging unit.
+   * @param[out] statistics The statistics about files and directories is updated here.
+   * @param queueDepth The maximal count of status requests in flight.
+   */
+  UringFileAgent(const char *base, const DirEntryFilter *filter,
+      TraceUnit *tracer, Logger *logger, DirTreeStatistic &statistics,
+      unsigned queueDepth = DEFAULT_QUEUE_DEPTH);
+  virtual
+  ~UringFileAgent();
+private:
+  UringFileAgent(const UringFileAgent &other);
+  UringFileAgent&
+  operator=(const UringFileAgent &other);
+public:
+  virtual void changeBase(const char *base);
+  /**
+   * Returns the count of status requests done synchronously because of missing kernel support.
+   */
+  inline size_t fallbacks() const {
+    return _fallbacks;
+  }
+  inline virtual bool isPrefiltered() const {
+    return true;
+  }
+  /**
+   * Returns the maximal count of status requests in flight.
+   */
+  inline unsigned queueDepth() const {
+    return _queueDepth;
+  }
+  virtual FsEntry* rawNextFile(int &level);
+protected:
+  void drain();
+  void fillQueue();
+  bool nextResult(unsigned &slot, int &result);
+  void readDirectory(const std::string &path, int level);
+  void releaseSlot(unsigned slot);
+  void reset();
+  void storeDirectory(const std::string &fullName, size_t nodeOffset,
+      int level);
+};
+
+} /* cppknife */
+
+#endif /* OS_URINGFILEAGENT_HPP_ */
@@ -0,0 +1,214 @@
+/*
+ * WordCounter.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "os.hpp"
+#if defined __x86_64__
+#include <immintrin.h>
+#endif
+
+namespace cppknife {
+
+WordCounter::WordCounter(Kernel kernel) :
+    _lines(0), _words(0), _bytes(0), _maxLength(0), _hasBinaryData(false), _kernel(
+        kernel), _lineLength(0), _inWord(false) {
+  Kernel best = bestKernel();
+  if (_kernel == K_AUTO || _kernel > best) {
+    _kernel = best;
+  }
+}
+
+void WordCounter::add(const WordCounter &other) {
+  _lines += other._lines;
+  _words += other._words;
+  _bytes += other._bytes;
+  if (other._maxLength > _maxLength) {
+    _maxLength = other._maxLength;
+  }
+  if (other._hasBinaryData) {
+    _hasBinaryData = true;
+  }
+}
+
+WordCounter::Kernel WordCounter::bestKernel() {
+#if defined __x86_64__
+  static Kernel rc = __builtin_cpu_supports("avx2") ? K_AVX2 : K_SSE2;
+  return rc;
+#else
+  return K_SCALAR;
+#endif
+}
+
+void WordCounter::count(const char *data, size_t length) {
+  _bytes += length;
+  switch (_kernel) {
+#if defined __x86_64__
+  case K_AVX2:
+    countAvx2(data, length);
+    break;
+  case K_SSE2:
+    countSse2(data, length);
+    break;
+#endif
+  default:
+    countScalar(data, length);
+    break;
+  }
+}
+
+#if defined __x86_64__
+__attribute__((target("avx2")))
+void WordCounter::countAvx2(const char *data, size_t length) {
+  const __m256i newline = _mm256_set1_epi8('\n');
+  const __m256i blank = _mm256_set1_epi8(' ');
+  const __m256i tab = _mm256_set1_epi8('\t');
+  const __m256i zero = _mm256_setzero_si256();
+  uint32_t inWord = _inWord ? 1 : 0;
+  __m256i zeros = zero;
+  size_t rest = length;
+  while (rest >= 32) {
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    __m256i isNewline = _mm256_cmpeq_epi8(block, newline);
+    __m256i isSeparator = _mm256_or_si256(isNewline,
+        _mm256_or_si256(_mm256_cmpeq_epi8(block, blank),
+            _mm256_cmpeq_epi8(block, tab)));
+    zeros = _mm256_or_si256(zeros, _mm256_cmpeq_epi8(block, zero));
+    uint32_t wordChars = ~static_cast<uint32_t>(_mm256_movemask_epi8(
+        isSeparator));
+    // A word starts at a word char following a separator:
+    uint32_t starts = wordChars & ~((wordChars << 1) | inWord);
+    _words += __builtin_popcount(starts);
+    inWord = wordChars >> 31;
+    handleNewlines(static_cast<uint32_t>(_mm256_movemask_epi8(isNewline)), 32);
+    data += 32;
+    rest -= 32;
+  }
+  if (_mm256_movemask_epi8(zeros) != 0) {
+    _hasBinaryData = true;
+  }
+  _inWord = inWord != 0;
+  if (rest > 0) {
+    countScalar(data, rest);
+  }
+}
+
+void WordCounter::countSse2(const char *data, size_t length) {
+  const __m128i newline = _mm_set1_epi8('\n');
+  const __m128i blank = _mm_set1_epi8(' ');
+  const __m128i tab = _mm_set1_epi8('\t');
+  const __m128i zero = _mm_setzero_si128();
+  uint32_t inWord = _inWord ? 1 : 0;
+  __m128i zeros = zero;
+  size_t rest = length;
+  while (rest >= 16) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    __m128i isNewline = _mm_cmpeq_epi8(block, newline);
+    __m128i isSeparator = _mm_or_si128(isNewline,
+        _mm_or_si128(_mm_cmpeq_epi8(block, blank), _mm_cmpeq_epi8(block, tab)));
+    zeros = _mm_or_si128(zeros, _mm_cmpeq_epi8(block, zero));
+    uint32_t wordChars = ~static_cast<uint32_t>(_mm_movemask_epi8(isSeparator))
+        & 0xffff;
+    uint32_t starts = wordChars & ~((wordChars << 1) | inWord);
+    _words += __builtin_popcount(starts);
+    inWord = (wordChars >> 15) & 1;
+    handleNewlines(static_cast<uint32_t>(_mm_movemask_epi8(isNewline)), 16);
+    data += 16;
+    rest -= 16;
+  }
+  if (_mm_movemask_epi8(zeros) != 0) {
+    _hasBinaryData = true;
+  }
+  _inWord = inWord != 0;
+  if (rest > 0) {
+    countScalar(data, rest);
+  }
+}
+#else
+void WordCounter::countAvx2(const char *data, size_t length) {
+  countScalar(data, length);
+}
+void WordCounter::countSse2(const char *data, size_t length) {
+  countScalar(data, length);
+}
+#endif
+
+void WordCounter::countScalar(const char *data, size_t length) {
+  const char *end = data + length;
+  while (data < end) {
+    char cc = *data++;
+    if (cc == '\n') {
+      if (_lineLength > _maxLength) {
+        _maxLength = _lineLength;
+      }
+      _lineLength = 0;
+      _lines++;
+      _inWord = false;
+    } else {
+      _lineLength++;
+      if (cc == ' ' || cc == '\t') {
+        _inWord = false;
+      } else {
+        if (!_inWord) {
+          _words++;
+          _inWord = true;
+        }
+        if (cc == '\0') {
+          _hasBinaryData = true;
+        }
+      }
+    }
+  }
+}
+
+bool WordCounter::countFile(const char *filename, char *buffer,
+    size_t bufferSize) {
+  bool rc = false;
+  reset();
+  int handle = open(filename, O_RDONLY);
+  if (handle >= 0) {
+    posix_fadvise(handle, 0, 0, POSIX_FADV_SEQUENTIAL);
+    // Compressed files are counted decompressed:
+    CompressionType compression = compressionOf(handle);
+    ReadAhead *decompressor =
+        compression == CT_NONE ?
+            nullptr : createDecompressor(compression, handle, 4, bufferSize);
+    ssize_t bytes = 0;
+    if (compression == CT_NONE || decompressor != nullptr) {
+      while ((bytes =
+          decompressor != nullptr ?
+              decompressor->read(buffer, bufferSize) :
+              read(handle, buffer, bufferSize)) > 0 && !_hasBinaryData) {
+        count(buffer, bytes);
+      }
+    }
+    rc = bytes == 0 && !_hasBinaryData
+        && (compression == CT_NONE
+            || (decompressor != nullptr && !decompressor->error()));
+    delete decompressor;
+    close(handle);
+    finish();
+  }
+  return rc;
+}
+
+void WordCounter::finish() {
+  if (_lineLength > 0) {
+    if (_lineLength > _maxLength) {
+      _maxLength = _lineLength;
+    }
+    _lines++;
+    _lineLength = 0;
+  }
+  _inWord = false;
+}
+
+void WordCounter::reset() {
+  _lines = _words = _bytes = _maxLength = _lineLength = 0;
+  _hasBinaryData = _inWord = false;
+}
+
+} /* cppknife */
@@ -0,0 +1,119 @@
+/*
+ * WordCounter.hpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef OS_WORDCOUNTER_HPP_
+#define OS_WORDCOUNTER_HPP_
+
+namespace cppknife {
+/**
+ * @brief Counts lines, words, bytes and the maximal line length of a text block by block.
+ *
+ * The blocks are inspected directly in the read buffer, without splitting into lines.
+ * Word separators are ' ', '\t' and '\n'. A text containing '\0' is binary data.
+ * The state (current line length, inside a word) is kept between the blocks,
+ * so the block boundaries can be chosen arbitrarily.
+ *
+ * Available kernels: AVX2, SSE2 (x86_64 only) and a portable scalar kernel.
+ */
+class WordCounter {
+public:
+  enum Kernel {
+    K_AUTO, K_SCALAR, K_SSE2, K_AVX2
+  };
+public:
+  size_t _lines;
+  size_t _words;
+  size_t _bytes;
+  size_t _maxLength;
+  bool _hasBinaryData;
+protected:
+  Kernel _kernel;
+  /// The length of the current (not finished) line.
+  size_t _lineLength;
+  /// <em>true</em>: the last inspected character belongs to a word.
+  bool _inWord;
+public:
+  /**
+   * Constructor.
+   * @param kernel The algorithm to use. <em>K_AUTO</em>: the fastest available.
+   *  An unavailable kernel is replaced by the fastest available.
+   */
+  WordCounter(Kernel kernel = K_AUTO);
+public:
+  /**
+   * Adds the counters of another instance, e.g. the result of a part of the file.
+   * The parts must consist of complete lines: no word is split.
+   * @param other The counters to add.
+   */
+  void add(const WordCounter &other);
+  /**
+   * Inspects the next block of the text.
+   * @param data The block to inspect.
+   * @param length The length of <em>data</em>.
+   */
+  void count(const char *data, size_t length);
+  /**
+   * Counts a whole file.
+   * @param filename The name of the file.
+   * @param buffer The read buffer.
+   * @param bufferSize The size of <em>buffer</em>.
+   * @return <em>false</em>: the file cannot be read or contains binary data.
+   */
+  bool countFile(const char *filename, char *buffer, size_t bufferSize);
+  /**
+   * Finishes the text: a last line without '\n' is counted.
+   */
+  void finish();
+  /**
+   * Returns the kernel in use.
+   */
+  inline Kernel kernel() const {
+    return _kernel;
+  }
+  /**
+   * Resets the counters for the next text.
+   */
+  void reset();
+public:
+  /**
+   * Returns the fastest kernel available on the current CPU.
+   */
+  static Kernel bestKernel();
+protected:
+  void countAvx2(const char *data, size_t length);
+  void countScalar(const char *data, size_t length);
+  void countSse2(const char *data, size_t length);
+  /**
+   * Handles the newline positions of a SIMD block.
+   * @param newlines A bit mask: bit N is set if byte N of the block is '\n'.
+   * @param blockSize The count of bytes in the block.
+   */
+  inline void handleNewlines(uint32_t newlines, size_t blockSize) {
+    if (newlines == 0) {
+      _lineLength += blockSize;
+    } else {
+      size_t start = 0;
+      do {
+        size_t position = __builtin_ctz(newlines);
+        size_t length = _lineLength + position - start;
+        if (length > _maxLength) {
+          _maxLength = length;
+        }
+        _lineLength = 0;
+        start = position + 1;
+        _lines++;
+        newlines &= newlines - 1;
+      } while (newlines != 0);
+      _lineLength = blockSize - start;
+    }
+  }
+};
+
+} /* cppknife */
+
+#endif /* OS_WORDCOUNTER_HPP_ */
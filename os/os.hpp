@@ -19,8 +19,16 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <dirent.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
 #endif
 #include <filesystem>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <set>
 #ifndef BASIC_HPP_
 #include "../basic/basic.hpp"
 #endif
@@ -31,8 +39,24 @@
 #include "Path.hpp"
 #include "FileTool.hpp"
 #include "LineAgent.hpp"
+#include "Decompressor.hpp"
 #include "File.hpp"
+#include "DirectoryQueue.hpp"
 #include "Traverser.hpp"
+#include "FilterProgram.hpp"
+#include "ThreadPool.hpp"
+#include "ChunkedFile.hpp"
+#include "ParallelFileAgent.hpp"
+#include "GetdentsFileAgent.hpp"
+#include "UringFileAgent.hpp"
+#include "DirectoryIndex.hpp"
+#include "FileExtrema.hpp"
+#include "WordCounter.hpp"
+#include "OwnerScanner.hpp"
+#include "DuplicateFinder.hpp"
+#include "FileSyncer.hpp"
+#include "EntryWriter.hpp"
+#include "TreeWatcher.hpp"
 #include "Process.hpp"
 //#include "Traverser.hpp"
 #endif /* OS_HPP_ */
@@ -90,12 +90,15 @@ const char* Configuration::asString(const char *name,
 std::vector<std::string> Configuration::names(const char *included,
     const char *excluded) const {
   std::vector<std::string> rc;
-  std::regex filter(included == nullptr ? ".*" : included);
-  std::regex notFilter(excluded == nullptr ? "\v" : excluded);
+  std::unique_ptr<RegexEngine> filter(
+      RegexEngine::create(included == nullptr ? ".*" : included));
+  std::unique_ptr<RegexEngine> notFilter(
+      RegexEngine::create(excluded == nullptr ? "\v" : excluded));
   rc.reserve(_map.size());
   for (auto pair : _map) {
-    auto key = pair.first;
-    if (std::regex_search(key, filter) && !std::regex_search(key, notFilter)) {
+    auto &key = pair.first;
+    if (filter->search(key.c_str(), key.size())
+        && !notFilter->search(key.c_str(), key.size())) {
       rc.push_back(pair.first);
     }
   }
@@ -104,10 +107,11 @@ std::vector<std::string> Configuration::names(const char *included,
 
 void Configuration::populate(const char *lines) {
   auto lines2 = splitCString(lines, "\n");
-  std::regex regExpr("^([\\w.-]+)\\s*=\\s*(.*)$");
-  std::smatch matches;
+  std::unique_ptr<RegexEngine> regExpr(
+      RegexEngine::create("^([\\w.-]+)\\s*=\\s*(.*)$"));
+  std::cmatch matches;
   for (auto line : lines2) {
-    if (std::regex_search(line, matches, regExpr)) {
+    if (regExpr->search(line.c_str(), line.size(), matches)) {
       _map[matches[1]] = matches[2];
     }
   }
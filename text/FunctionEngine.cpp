@@ -174,18 +174,19 @@ int FunctionEngine::bufferDifference(bool testOnly) {
     _parser.assertToken(TT_EOF);
   } else {
     size_t lineNo = 0;
-    for (auto line : buffer1->constLines()) {
+    for (size_t ix = 0; ix < buffer1->countLines(); ix++) {
       lineNo++;
-      if (lineNo > buffer2->constLines().size()) {
+      if (lineNo > buffer2->countLines()) {
         rc = lineNo;
         break;
       }
-      if (line != buffer2->constLines()[lineNo - 1]) {
+      if (buffer1->lineLengthAt(ix) != buffer2->lineLengthAt(ix)
+          || strcmp(buffer1->lineAt(ix), buffer2->lineAt(ix)) != 0) {
         rc = lineNo;
         break;
       }
     }
-    if (lineNo < buffer2->constLines().size()) {
+    if (lineNo < buffer2->countLines()) {
       rc = lineNo + 1;
     }
   }
@@ -589,12 +590,13 @@ std::string FunctionEngine::stringSearch(bool testOnly) {
     _parser.assertToken(TT_EOF);
   } else {
     rc = "";
-    std::smatch matches;
-    if (searchExpression.regExpr() == nullptr) {
+    std::cmatch matches;
+    if (searchExpression.engine() == nullptr) {
       if (strstr(text.c_str(), searchExpression.pattern().c_str()) != nullptr) {
         rc = searchExpression.pattern();
       }
-    } else if (std::regex_search(text, matches, *searchExpression.regExpr())) {
+    } else if (searchExpression.engine()->search(text.c_str(), text.size(),
+        matches)) {
       rc = matches[0].str();
       for (size_t no = 1; no <= matches.size(); no++) {
         rc += separator + matches[no].str();
@@ -0,0 +1,227 @@
+/*
+ * LineArena.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "text.hpp"
+#include "../os/os.hpp"
+
+namespace cppknife {
+
+LineArena::LineArena() :
+    _text(), _index(), _edited(), _freeEdited(), _vectorMode(false), _strings() {
+}
+LineArena::~LineArena() {
+  freeEdited();
+}
+LineArena::LineArena(const LineArena &other) :
+    _text(), _index(), _edited(), _freeEdited(), _vectorMode(false), _strings() {
+  operator=(other);
+}
+LineArena& LineArena::operator=(const LineArena &other) {
+  if (this != &other) {
+    freeEdited();
+    _text = other._text;
+    _index = other._index;
+    _freeEdited = other._freeEdited;
+    _edited.reserve(other._edited.size());
+    for (auto edited : other._edited) {
+      _edited.push_back(edited == nullptr ? nullptr : new std::string(*edited));
+    }
+    _vectorMode = other._vectorMode;
+    _strings = other._strings;
+  }
+  return *this;
+}
+void LineArena::assign(const std::vector<std::string> &lines) {
+  clear();
+  insert(0, lines);
+}
+void LineArena::clear() {
+  freeEdited();
+  _index.clear();
+  _text.clear();
+  _strings.clear();
+}
+void LineArena::erase(size_t start, size_t end) {
+  if (_vectorMode) {
+    _strings.erase(_strings.begin() + start, _strings.begin() + end);
+  } else {
+    for (size_t ix = start; ix < end; ix++) {
+      if (_index[ix]._edited) {
+        auto &edited = _edited[_index[ix]._offset];
+        delete edited;
+        edited = nullptr;
+        _freeEdited.push_back(_index[ix]._offset);
+      }
+    }
+    _index.erase(_index.begin() + start, _index.begin() + end);
+  }
+}
+void LineArena::freeEdited() {
+  for (auto edited : _edited) {
+    delete edited;
+  }
+  _edited.clear();
+  _freeEdited.clear();
+}
+void LineArena::indexText(size_t length, bool &binary) {
+  LineScanner scanner;
+  // The arena contains a '\0' behind the data: the last line is terminated.
+  _text.resize(length + 1);
+  _text[length] = '\0';
+  char *data = &_text[0];
+  size_t start = 0;
+  binary = false;
+  while (start < length) {
+    size_t lineEnd = start
+        + scanner.findLineEnd(data + start, length - start, binary);
+    if (binary) {
+      break;
+    }
+    data[lineEnd] = '\0';
+    size_t lineLength = lineEnd - start;
+    if (lineLength <= 0xffffffffU) {
+      _index.emplace_back(start, static_cast<uint32_t>(lineLength));
+    } else {
+      // The index stores only 32 bit lengths:
+      _index.emplace_back(0, 0);
+      modifiable(_index.size() - 1).assign(data + start, lineLength);
+    }
+    start = lineEnd + 1;
+  }
+}
+void LineArena::insert(size_t index, const std::string &line) {
+  if (_vectorMode) {
+    _strings.insert(_strings.begin() + index, line);
+  } else {
+    _index.emplace(_index.begin() + index);
+    modifiable(index) = line;
+  }
+}
+void LineArena::insert(size_t index, const std::vector<std::string> &lines,
+    size_t first) {
+  if (_vectorMode) {
+    _strings.insert(_strings.begin() + index, lines.begin() + first,
+        lines.end());
+  } else if (first < lines.size()) {
+    _index.insert(_index.begin() + index, lines.size() - first, Entry());
+    for (size_t ix = first; ix < lines.size(); ix++) {
+      modifiable(index++) = lines[ix];
+    }
+  }
+}
+std::string& LineArena::modifiable(size_t index) {
+  if (_vectorMode) {
+    return _strings[index];
+  }
+  Entry &entry = _index[index];
+  if (!entry._edited) {
+    // Copy on write:
+    std::string *line = new std::string(_text.data() + entry._offset,
+        entry._length);
+    if (_freeEdited.empty()) {
+      entry._offset = _edited.size();
+      _edited.push_back(line);
+    } else {
+      entry._offset = _freeEdited.back();
+      _freeEdited.pop_back();
+      _edited[entry._offset] = line;
+    }
+    entry._edited = true;
+  }
+  return *_edited[entry._offset];
+}
+bool LineArena::readFromFile(const char *filename, Logger &logger) {
+  clear();
+  _vectorMode = false;
+  bool rc = false;
+  int handle = open(filename, O_RDONLY);
+  struct stat status;
+  if (handle < 0 || fstat(handle, &status) != 0) {
+    int error = errno;
+    if (handle >= 0) {
+      close(handle);
+    }
+    logger.say(LV_ERROR, formatCString("cannot open: %s (%d)", filename, error));
+  } else {
+    CompressionType compression = compressionOf(handle);
+    size_t length = 0;
+    if (compression == CT_NONE) {
+      _text.resize(status.st_size + 1);
+      ssize_t bytes;
+      while (length < static_cast<size_t>(status.st_size)
+          && (bytes = ::read(handle, &_text[length], status.st_size - length))
+              > 0) {
+        length += bytes;
+      }
+      rc = length == static_cast<size_t>(status.st_size);
+    } else {
+      auto decompressor = createDecompressor(compression, handle, 4, 0x100000);
+      if (decompressor == nullptr) {
+        logger.say(LV_ERROR,
+            formatCString("%s: %s compression is not supported", filename,
+                compressionName(compression)));
+      } else {
+        // The decompressed size is unknown: the arena grows.
+        _text.resize(4 * status.st_size + 0x100000);
+        size_t bytes;
+        while ((bytes = decompressor->read(&_text[length],
+            _text.size() - length)) > 0) {
+          length += bytes;
+          if (length == _text.size()) {
+            _text.resize(2 * _text.size());
+          }
+        }
+        rc = !decompressor->error();
+        delete decompressor;
+      }
+    }
+    close(handle);
+    if (!rc) {
+      logger.say(LV_ERROR, formatCString("cannot read: %s", filename));
+    }
+    bool binary = memchr(_text.data(), '\0',
+        std::min(length, static_cast<size_t>(4096))) != nullptr;
+    if (!binary) {
+      indexText(length, binary);
+    }
+    if (binary) {
+      rc = false;
+    }
+    _text.shrink_to_fit();
+  }
+  return rc;
+}
+void LineArena::reserve(size_t lines) {
+  if (_vectorMode) {
+    _strings.reserve(lines);
+  } else {
+    _index.reserve(lines);
+  }
+}
+std::vector<std::string>& LineArena::strings() const {
+  if (!_vectorMode) {
+    _strings.clear();
+    _strings.reserve(_index.size());
+    for (size_t ix = 0; ix < _index.size(); ix++) {
+      _strings.emplace_back(line(ix), lineLength(ix));
+    }
+    _vectorMode = true;
+  }
+  return _strings;
+}
+std::string LineArena::substr(size_t index, size_t position,
+    size_t count) const {
+  size_t length = lineLength(index);
+  if (position > length) {
+    throw std::out_of_range("LineArena::substr");
+  }
+  return std::string(line(index) + position,
+      std::min(count, length - position));
+}
+
+} /* cppknife */
@@ -0,0 +1,180 @@
+/*
+ * LineArena.hpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef TEXT_LINEARENA_HPP_
+#define TEXT_LINEARENA_HPP_
+
+namespace cppknife {
+
+/**
+ * @brief Stores the lines of a file in one block of memory with an offset index.
+ *
+ * The file contents is read into one arena where each '\n' is replaced by '\0':
+ * each line is a C string without a copy. The index stores offset and length of each line.
+ * A changed line is copied before the change (copy on write): the arena is never modified.
+ * Inserting and deleting lines moves only the index entries.
+ *
+ * For the classic interface (<em>std::vector&lt;std::string&gt;</em>) the instance can
+ * be switched into the vector mode: see <em>strings()</em>.
+ */
+class LineArena {
+protected:
+  /**
+   * @brief The index entry of one line.
+   */
+  class Entry {
+  public:
+    /// The offset of the line in <em>_text</em> or the index in <em>_edited</em>.
+    uint64_t _offset;
+    uint32_t _length;
+    /// <em>true</em>: the line is stored in <em>_edited</em>.
+    bool _edited;
+  public:
+    Entry(uint64_t offset = 0, uint32_t length = 0, bool edited = false) :
+        _offset(offset), _length(length), _edited(edited) {
+    }
+  };
+protected:
+  /// The file contents: '\n' is replaced by '\0'.
+  std::string _text;
+  std::vector<Entry> _index;
+  /// The changed or inserted lines.
+  std::vector<std::string*> _edited;
+  /// The indexes of unused entries of <em>_edited</em>.
+  std::vector<size_t> _freeEdited;
+  /// <em>true</em>: the lines are stored in <em>_strings</em>, the index is unused.
+  mutable bool _vectorMode;
+  mutable std::vector<std::string> _strings;
+public:
+  LineArena();
+  virtual ~LineArena();
+  LineArena(const LineArena &other);
+  LineArena& operator=(const LineArena &other);
+public:
+  /**
+   * Replaces the lines by a list of strings.
+   * @param lines The new lines.
+   */
+  void assign(const std::vector<std::string> &lines);
+  /**
+   * Removes all lines.
+   */
+  void clear();
+  /**
+   * Removes a range of lines.
+   * @param start The index of the first line to remove.
+   * @param end The index behind the last line to remove.
+   */
+  void erase(size_t start, size_t end);
+  /**
+   * Inserts one line.
+   * @param index The line is inserted in front of that line. <em>size()</em>: append.
+   * @param line The line to insert.
+   */
+  void insert(size_t index, const std::string &line);
+  /**
+   * Inserts some lines.
+   * @param index The lines are inserted in front of that line. <em>size()</em>: append.
+   * @param lines The lines to insert.
+   * @param first The index of the first line of <em>lines</em> to insert.
+   */
+  void insert(size_t index, const std::vector<std::string> &lines,
+      size_t first = 0);
+  /**
+   * Returns whether the instance is in the vector mode.
+   */
+  inline bool isVectorMode() const {
+    return _vectorMode;
+  }
+  /**
+   * Returns a line as C string.
+   * @param index The index of the line: must be less than <em>size()</em>.
+   */
+  inline const char* line(size_t index) const {
+    if (_vectorMode) {
+      return _strings[index].c_str();
+    }
+    const Entry &entry = _index[index];
+    return
+        entry._edited ?
+            _edited[entry._offset]->c_str() : _text.data() + entry._offset;
+  }
+  /**
+   * Returns the length of a line.
+   * @param index The index of the line: must be less than <em>size()</em>.
+   */
+  inline size_t lineLength(size_t index) const {
+    if (_vectorMode) {
+      return _strings[index].size();
+    }
+    const Entry &entry = _index[index];
+    return entry._edited ? _edited[entry._offset]->size() : entry._length;
+  }
+  /**
+   * Returns a line as string (a copy).
+   * @param index The index of the line: must be less than <em>size()</em>.
+   */
+  inline std::string lineAsString(size_t index) const {
+    return std::string(line(index), lineLength(index));
+  }
+  /**
+   * Returns a changeable line: the line is copied from the arena if needed.
+   * @param index The index of the line: must be less than <em>size()</em>.
+   * @return The line. Valid until the next change of the line list.
+   */
+  std::string& modifiable(size_t index);
+  /**
+   * Appends a line.
+   * @param line The line to append.
+   */
+  inline void push_back(const std::string &line) {
+    insert(size(), line);
+  }
+  /**
+   * Reads a file into the arena. Compressed files are decompressed.
+   * @param filename The name of the file.
+   * @param logger The logger.
+   * @return <em>false</em>: the file cannot be read or contains binary data:
+   *  only the lines in front of the binary data are stored.
+   */
+  bool readFromFile(const char *filename, Logger &logger);
+  /**
+   * Reserves space for the index.
+   * @param lines The expected count of lines.
+   */
+  void reserve(size_t lines);
+  /**
+   * Returns the count of lines.
+   */
+  inline size_t size() const {
+    return _vectorMode ? _strings.size() : _index.size();
+  }
+  /**
+   * Returns a part of a line like <em>std::string::substr()</em>.
+   * @param index The index of the line: must be less than <em>size()</em>.
+   * @param position The start of the part.
+   * @param count The maximal length of the part.
+   */
+  std::string substr(size_t index, size_t position, size_t count =
+      std::string::npos) const;
+  /**
+   * Returns the lines as vector of strings: switches to the vector mode.
+   *
+   * The lines are copied into the vector once. All following accesses use the vector:
+   * changes of the vector are visible for the owner. The vector mode ends with
+   * <em>readFromFile()</em>.
+   */
+  std::vector<std::string>& strings() const;
+protected:
+  void freeEdited();
+  void indexText(size_t length, bool &binary);
+};
+
+} /* cppknife */
+
+#endif /* TEXT_LINEARENA_HPP_ */
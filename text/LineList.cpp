@@ -18,18 +18,13 @@ BufferPosition::BufferPosition(size_t line, size_t column) :
 SearchExpression::SearchExpression(const char *pattern, bool isRegExpr,
     const char *flags) :
     _isRegExpr(isRegExpr), _ignoreCase(false), _knowsMetaCharacters(false), _beginOfLine(
-        false), _endOfLine(false), _backwards(false), _inline(false), _regExpr(
-        nullptr), _pattern(pattern == nullptr ? "" : pattern), _flags() {
-  if (isRegExpr && pattern != nullptr) {
-    _regExpr = new std::regex(pattern);
-  }
+        false), _endOfLine(false), _backwards(false), _inline(false), _engine(), _pattern(
+        pattern == nullptr ? "" : pattern), _flags() {
   handleFlags(flags);
   handlePattern(isRegExpr);
 }
 
 SearchExpression::~SearchExpression() {
-  delete _regExpr;
-  _regExpr = nullptr;
 }
 
 void SearchExpression::handleFlags(const char *flags) {
@@ -71,12 +66,10 @@ void SearchExpression::handlePattern(bool isRegExpr) {
         _pattern.erase(_pattern.size() - 2, 1);
       }
     }
-    delete _regExpr;
-    if (_ignoreCase) {
-      _regExpr = new std::regex(_pattern, std::regex::icase);
-    } else {
-      _regExpr = new std::regex(_pattern);
-    }
+  }
+  if (!_pattern.empty() || isRegExpr) {
+    // A script statement in a loop sets the same pattern again and again:
+    _engine = RegexCache::instance()->getEngine(_pattern, _ignoreCase);
   }
 }
 
@@ -126,11 +119,11 @@ ChangeType LineList::adapt(const std::regex &pattern, const char *replacement,
   ChangeType rc = CT_UNDEF;
   int lineNo = 0;
   if ((lineNo = find(pattern)) >= 0) {
-    if (strcmp(replacement, _lines[lineNo].c_str()) == 0) {
+    if (strcmp(replacement, _lines.line(lineNo)) == 0) {
       rc = CT_UNCHANGED;
     } else {
       rc = CT_CHANGED;
-      _lines[lineNo] = replacement;
+      _lines.modifiable(lineNo) = replacement;
       _hasChanged = true;
     }
   } else if (anchor != nullptr && (lineNo = find(*anchor)) >= 0) {
@@ -138,7 +131,7 @@ ChangeType LineList::adapt(const std::regex &pattern, const char *replacement,
     if (!aboveAnchor) {
       lineNo++;
     }
-    _lines.insert(_lines.begin() + lineNo, replacement);
+    _lines.insert(lineNo, replacement);
     _hasChanged = true;
   } else {
     rc = CT_APPENDED;
@@ -213,24 +206,24 @@ std::vector<std::string>& LineList::copyRange(std::vector<std::string> &target,
   size_t ixLine = start._lineIndex;
   size_t ixCol = 0;
   if (start._columnIndex > 0) {
-    if (start._columnIndex < _lines[ixLine].size()) {
+    if (start._columnIndex < _lines.lineLength(ixLine)) {
       if (end._columnIndex != 0 && ixLine == endLine) {
-        ixCol = min(_lines[ixLine].size(), end._columnIndex + !excluding);
+        ixCol = min(_lines.lineLength(ixLine), end._columnIndex + !excluding);
         target.push_back(
-            _lines[ixLine].substr(start._columnIndex,
+            _lines.substr(ixLine, start._columnIndex,
                 ixCol - start._columnIndex));
       } else {
-        target.push_back(_lines[ixLine].substr(start._columnIndex));
+        target.push_back(_lines.substr(ixLine, start._columnIndex));
       }
     }
     ixLine++;
   }
   while (ixLine < endLine) {
-    target.push_back(_lines[ixLine++]);
+    target.push_back(_lines.lineAsString(ixLine++));
   }
   if (ixLine <= endLine && end._columnIndex != 0) {
-    ixCol = min(_lines[ixLine].size(), end._columnIndex + !excluding);
-    target.push_back(_lines[ixLine].substr(0, ixCol));
+    ixCol = min(_lines.lineLength(ixLine), end._columnIndex + !excluding);
+    target.push_back(_lines.substr(ixLine, 0, ixCol));
   }
   return target;
 }
@@ -244,44 +237,45 @@ void LineList::deleteRange(BufferPosition start, BufferPosition end) {
     end = tmp;
   }
   if (end._lineIndex < _lines.size()
-      && end._columnIndex > (length = _lines[end._lineIndex].size())) {
+      && end._columnIndex > (length = _lines.lineLength(end._lineIndex))) {
     end._columnIndex = length;
   }
   if (start._lineIndex == end._lineIndex) {
     // delete inside one line:
     if (start._columnIndex < _lines.size()) {
-      _lines[start._lineIndex].erase(start._columnIndex,
+      _lines.modifiable(start._lineIndex).erase(start._columnIndex,
           end._columnIndex - start._columnIndex);
     }
   } else {
     int ixTop = -1;
     // Delete a part of the first line:
     if (start._columnIndex > 0) {
-      _lines[start._lineIndex].erase(start._columnIndex);
+      _lines.modifiable(start._lineIndex).erase(start._columnIndex);
       ixTop = start._lineIndex++;
     }
     // Delete whole lines:
     auto count = end._lineIndex - start._lineIndex;
     if (count > 0) {
-      _lines.erase(_lines.begin() + start._lineIndex,
-          _lines.begin() + end._lineIndex);
+      _lines.erase(start._lineIndex, end._lineIndex);
       end._lineIndex -= count;
     }
     // Delete a part of the last line:
     if (end._columnIndex > 0) {
-      _lines[end._lineIndex].erase(0, end._columnIndex);
+      _lines.modifiable(end._lineIndex).erase(0, end._columnIndex);
     }
     auto ixEnd = end._lineIndex;
     if (ixTop >= 0 && ixEnd == (size_t) ixTop + 1) {
-      _lines[ixTop] += _lines[ixEnd];
-      _lines.erase(_lines.begin() + ixEnd, _lines.begin() + ixEnd + 1);
+      _lines.modifiable(ixTop).append(_lines.line(ixEnd),
+          _lines.lineLength(ixEnd));
+      _lines.erase(ixEnd, ixEnd + 1);
     }
   }
 }
 int LineList::find(const std::regex &regExpr, size_t start) {
   int rc = -1;
   while (start < _lines.size()) {
-    if (std::regex_search(_lines[start], regExpr)) {
+    auto line = _lines.line(start);
+    if (std::regex_search(line, line + _lines.lineLength(start), regExpr)) {
       rc = start;
       break;
     }
@@ -291,8 +285,8 @@ int LineList::find(const std::regex &regExpr, size_t start) {
 }
 
 int LineList::find(const char *regExpr, size_t start) {
-  std::regex expr(regExpr);
-  int rc = find(expr, start);
+  auto expr = RegexCache::instance()->get(regExpr);
+  int rc = find(*expr, start);
   return rc;
 }
 
@@ -303,18 +297,20 @@ int LineList::indexOfFirstDifference(const LineList &other, int start,
     *differentLength = false;
   }
   for (size_t ix = start; ix < _lines.size(); ix++) {
-    if (ix >= other.constLines().size()) {
+    if (ix >= other._lines.size()) {
       if (differentLength != nullptr) {
         *differentLength = true;
       }
       rc = ix;
       break;
     }
-    if (_lines[ix] != other.constLines()[ix]) {
+    if (_lines.lineLength(ix) != other._lines.lineLength(ix)
+        || memcmp(_lines.line(ix), other._lines.line(ix), _lines.lineLength(ix))
+            != 0) {
       rc = ix;
       break;
     }
-    if (rc && _lines.size() < other.constLines().size()) {
+    if (rc && _lines.size() < other._lines.size()) {
       rc = _lines.size();
       if (differentLength != nullptr) {
         *differentLength = true;
@@ -328,12 +324,12 @@ void LineList::insert(const BufferPosition &position,
     const std::vector<std::string> &lines, bool addNewline) {
   if (position._lineIndex >= _lines.size()) {
     // Append all lines:
-    _lines.insert(_lines.end(), lines.begin(), lines.end());
+    _lines.insert(_lines.size(), lines);
   } else {
     std::string top;
     std::string tail;
     auto ixInsert = position._lineIndex;
-    auto line = _lines[ixInsert];
+    auto line = _lines.lineAsString(ixInsert);
     if (position._columnIndex > 0) {
       top = line.substr(0, position._columnIndex);
     }
@@ -342,30 +338,24 @@ void LineList::insert(const BufferPosition &position,
     }
     if (lines.size() == 1) {
       // only one line:
-      _lines[ixInsert] = top + lines[0] + tail;
+      _lines.modifiable(ixInsert) = top + lines[0] + tail;
     } else {
       size_t firstLine = 0;
       size_t lastLine = lines.size() - 1;
       if (position._columnIndex > 0) {
-        _lines[position._lineIndex] = top + lines[0];
+        _lines.modifiable(position._lineIndex) = top + lines[0];
         firstLine = 1;
       }
-      auto needed = _lines.size() + lines.size() - firstLine;
-      if (_lines.capacity() < needed) {
-        _lines.reserve(needed);
-      }
       if (lastLine > 0) {
         auto offset = position._columnIndex == 0 ? 0 : 1;
-        _lines.insert(_lines.begin() + ixInsert + offset,
-            lines.begin() + firstLine,
-            lines.end());
+        _lines.insert(ixInsert + offset, lines, firstLine);
       }
       // Add the tail to the last line:
       if (!tail.empty()) {
         if (addNewline) {
-          _lines.insert(_lines.begin() + ixInsert + lastLine + 1, tail);
+          _lines.insert(ixInsert + lastLine + 1, tail);
         } else {
-          _lines[ixInsert + lastLine] += tail;
+          _lines.modifiable(ixInsert + lastLine) += tail;
         }
       }
     }
@@ -396,7 +386,7 @@ int LineList::replace(const SearchExpression &searchExpression,
   if (searchExpression._inline) {
     end0.set(_position._lineIndex + 1, 0);
   } else if (end0._lineIndex < _lines.size()
-      && _lines[end0._lineIndex].size() <= end0._columnIndex) {
+      && _lines.lineLength(end0._lineIndex) <= end0._columnIndex) {
     end0._lineIndex++;
     end0._columnIndex = 0;
   }
@@ -406,51 +396,50 @@ int LineList::replace(const SearchExpression &searchExpression,
     std::string line;
     std::string prefix;
     std::string suffix;
-    size_t ixEnd = _lines[ixLine].size();
-    if (filter == nullptr
-        || std::regex_search(_lines[ixLine], *filter->_regExpr)) {
+    size_t ixEnd = _lines.lineLength(ixLine);
+    if (filter == nullptr || matches(ixLine, *filter->_engine)) {
       if (ixEndLine == ixLine && end0._columnIndex < ixEnd) {
         ixEnd = end0._columnIndex;
-        suffix = _lines[ixLine].substr(ixEnd);
+        suffix = _lines.substr(ixLine, ixEnd);
       }
       // Process the part of the start line:
       if (start->_columnIndex > 0) {
-        prefix = _lines[ixLine].substr(0, start->_columnIndex);
-        line = _lines[ixLine].substr(start->_columnIndex,
+        prefix = _lines.substr(ixLine, 0, start->_columnIndex);
+        line = _lines.substr(ixLine, start->_columnIndex,
             ixEnd - start->_columnIndex);
         int rc2 = replaceString(line, searchExpression, replacement, count,
             patternBackreference);
         rc += rc2;
         if (rc2 > 0) {
-          _lines[ixLine] = prefix + line + suffix;
+          _lines.modifiable(ixLine) = prefix + line + suffix;
         }
         ixLine++;
       }
     }
     // Process whole lines:
     while (ixLine < _lines.size() && ixLine < ixEndLine) {
-      if (filter != nullptr
-          && !std::regex_search(_lines[ixLine], *filter->_regExpr)) {
+      // Only lines with a hit are copied out of the arena:
+      if ((filter != nullptr && !matches(ixLine, *filter->_engine))
+          || !matches(ixLine, *searchExpression._engine)) {
         ixLine++;
         continue;
       }
-      int rc2 = replaceString(_lines[ixLine], searchExpression, replacement,
-          count, patternBackreference);
+      int rc2 = replaceString(_lines.modifiable(ixLine), searchExpression,
+          replacement, count, patternBackreference);
       rc += rc2;
       ixLine++;
     }
     // Process the part of the end line:
     if (ixLine < _lines.size() && ixLine == ixEndLine
         && (ixEnd = end0._columnIndex) > 0
-        && (filter == nullptr
-            || std::regex_search(_lines[ixLine], *filter->_regExpr))) {
-      line = _lines[ixLine].substr(0, ixEnd);
-      suffix = _lines[ixLine].substr(ixEnd);
+        && (filter == nullptr || matches(ixLine, *filter->_engine))) {
+      line = _lines.substr(ixLine, 0, ixEnd);
+      suffix = _lines.substr(ixLine, ixEnd);
       int rc2 = replaceString(line, searchExpression, replacement, count,
           patternBackreference);
       if (rc2 > 0) {
         rc += rc2;
-        _lines[ixLine] = line + suffix;
+        _lines.modifiable(ixLine) = line + suffix;
       }
     }
   }
@@ -466,7 +455,7 @@ int LineList::replaceString(std::string &line,
   std::string line2;
   line2.reserve(line.size() * 3);
   const char *start = line.c_str();
-  while (std::regex_search(start, matcher, *searchExpression._regExpr)) {
+  while (std::regex_search(start, matcher, searchExpression._engine->regex())) {
     line2 += matcher.prefix();
     if (patternBackreference == nullptr) {
       line2 += replacement2;
@@ -504,17 +493,17 @@ bool LineList::search(const SearchExpression &searchExpression,
   bool rc = false;
   result._found = false;
   if (searchExpression._backwards) {
-    rc = searchBackwardsRegExpr(*searchExpression._regExpr, result, setPosition,
+    rc = searchBackwardsRegExpr(searchExpression._engine->regex(), result, setPosition,
         searchExpression._endOfLine, searchExpression._inline,
         searchExpression._flags.c_str());
   } else {
-    rc = searchRegExpr(*searchExpression._regExpr, result, setPosition,
+    rc = searchRegExpr(searchExpression._engine->regex(), result, setPosition,
         searchExpression._beginOfLine, searchExpression._inline,
         searchExpression._flags.c_str());
   }
   if (rc) {
     _startLastHit = result._position;
-    _lastHit = _lines[result._position._lineIndex].substr(
+    _lastHit = _lines.substr(result._position._lineIndex,
         result._position._columnIndex, result._length);
   }
   return rc;
@@ -524,8 +513,8 @@ bool LineList::search(const SearchExpression &searchExpression,
  * Searches the most right hit of the regular expression where the hit starts below a given column.
  */
 bool LineList::searchBackwardsOneLine(size_t ixColumn, size_t ixLine,
-    std::regex &regExpr, SearchResult &result) {
-  const char *start = _lines[ixLine].c_str();
+    const std::regex &regExpr, SearchResult &result) {
+  const char *start = _lines.line(ixLine);
   const char *beginOfLine = start;
   std::cmatch matches;
   std::cmatch lastHit;
@@ -550,7 +539,7 @@ bool LineList::searchBackwardsOneLine(size_t ixColumn, size_t ixLine,
   }
   return rc;
 }
-bool LineList::searchBackwardsRegExpr(std::regex &regExpr, SearchResult &result,
+bool LineList::searchBackwardsRegExpr(const std::regex &regExpr, SearchResult &result,
     bool setPosition, bool endOfLine, bool inlineOnly, const char *flags) {
   bool rc = false;
   auto col = _position._columnIndex;
@@ -577,7 +566,8 @@ bool LineList::searchBackwardsRegExpr(std::regex &regExpr, SearchResult &result,
       ready = true;
     }
     while (!rc && !ready && line >= 0) {
-      rc = searchBackwardsOneLine(_lines[line].size(), line, regExpr, result);
+      rc = searchBackwardsOneLine(_lines.lineLength(line), line, regExpr,
+          result);
       line--;
     }
     if (setPosition || strchr(flags, 'T') == nullptr) {
@@ -590,7 +580,7 @@ bool LineList::searchBackwardsRegExpr(std::regex &regExpr, SearchResult &result,
   return rc;
 }
 
-bool LineList::searchRegExpr(std::regex &regExpr, SearchResult &result,
+bool LineList::searchRegExpr(const std::regex &regExpr, SearchResult &result,
     bool setPosition, bool beginOfLine, bool inlineOnly, const char *flags) {
   auto line = _position._lineIndex;
   auto col = _position._columnIndex;
@@ -610,10 +600,10 @@ bool LineList::searchRegExpr(std::regex &regExpr, SearchResult &result,
   if (line < _lines.size()) {
 // Search in the first line: may be only a part of the line:
     if (col > 0) {
-      if (!(col < _lines[line].size() && !beginOfLine)) {
+      if (!(col < _lines.lineLength(line) && !beginOfLine)) {
         line++;
       } else {
-        const char *start = _lines[line].c_str() + col;
+        const char *start = _lines.line(line) + col;
         if (std::regex_search(start, matches, regExpr)) {
           rc = true;
           result._position._columnIndex = col + matches.position(0) - 1;
@@ -629,7 +619,7 @@ bool LineList::searchRegExpr(std::regex &regExpr, SearchResult &result,
       }
     }
     while (!rc && line < _lines.size()) {
-      if (std::regex_search(_lines[line].c_str(), matches, regExpr)) {
+      if (std::regex_search(_lines.line(line), matches, regExpr)) {
         rc = true;
         result._position._lineIndex = line;
         result._position._columnIndex = matches.position(0);
@@ -651,31 +641,10 @@ bool LineList::searchRegExpr(std::regex &regExpr, SearchResult &result,
   return rc;
 }
 
-bool LineList::readFromFile(const char *filename, bool stripNewline) {
+bool LineList::readFromFile(const char *filename) {
   _currentFilename = filename;
   _name = basename(filename);
-  LineReader reader(nullptr, _logger, stripNewline);
-  reader.openFile(filename);
-
-  LineAgent lineAgent(&_logger);
-  lineAgent.openFile(filename);
-  auto lineCount = lineAgent.estimateLineCount();
-  if (lineCount > 0) {
-    _lines.reserve(lineCount * 3 / 2);
-  }
-  bool rc = true;
-  size_t length = 0;
-  const char *line;
-  while ((line = lineAgent.nextLine(length)) != nullptr) {
-    if (lineAgent.hasBinaryData()) {
-      rc = false;
-      break;
-    }
-    if (stripNewline && length > 0 && line[length - 1] == '\n') {
-      length--;
-    }
-    _lines.push_back(std::string(line, length));
-  }
+  bool rc = _lines.readFromFile(filename, _logger);
   return rc;
 }
 
@@ -685,7 +654,7 @@ BufferPosition& LineList::setMark(const BufferPosition &position) {
   if (_mark._lineIndex >= _lines.size()) {
     _mark._lineIndex = _lines.size();
     _mark._columnIndex = 0;
-  } else if (_mark._columnIndex > (length = _lines[_mark._lineIndex].size())) {
+  } else if (_mark._columnIndex > (length = _lines.lineLength(_mark._lineIndex))) {
     _mark._columnIndex = length;
   }
   return _mark;
@@ -698,7 +667,7 @@ BufferPosition& LineList::setPosition(int lineIndex, int columnIndex) {
   if (_position._lineIndex >= _lines.size()) {
     _position._columnIndex = 0;
   } else if (columnIndex >= 0) {
-    _position._columnIndex = min(_lines[_position._lineIndex].size(),
+    _position._columnIndex = min(_lines.lineLength(_position._lineIndex),
         columnIndex);
   }
   return _position;
@@ -715,9 +684,11 @@ bool LineList::writeToFile(const char *filename, bool force, bool append) {
     _currentFilename = filename;
     FILE *fp = fopen(filename, append ? "a" : "w");
     if (fp != nullptr) {
-      for (auto line : _lines) {
-        fputs(line.c_str(), fp);
-        if (line.back() != '\n') {
+      for (size_t ix = 0; ix < _lines.size(); ix++) {
+        size_t length = _lines.lineLength(ix);
+        const char *line = _lines.line(ix);
+        fwrite(line, 1, length, fp);
+        if (length == 0 || line[length - 1] != '\n') {
           fputc('\n', fp);
         }
       }
@@ -74,7 +74,8 @@ protected:
   bool _endOfLine;
   bool _backwards;
   bool _inline;
-  std::regex *_regExpr;
+  /// Shared with other expressions using the same pattern: see <em>RegexCache</em>.
+  RegexCache::SharedEngine_t _engine;
   std::string _pattern;
   std::string _flags;
 public:
@@ -110,14 +111,21 @@ public:
    * @return <em>true</em>The search was successful.
    */
   inline bool search(const char *text) {
-    return std::regex_search(text, *_regExpr);
+    return _engine->search(text, strlen(text));
+  }
+  /**
+   * Returns the engine searching the pattern.
+   * @return <em>nullptr</em>: there is no pattern. Otherwise: the engine.
+   */
+  inline const RegexEngine* engine() const {
+    return _engine.get();
   }
   /**
    * Returns the compiled regular expression.
    * @return <em>nullptr</em>: there is no regular expression. Otherwise: the regular expression.
    */
   inline const std::regex* regExpr() const {
-    return _regExpr;
+    return _engine == nullptr ? nullptr : &_engine->regex();
   }
   /**
    * Search the intrinsic pattern in a given buffer.
@@ -146,7 +154,8 @@ public:
   const static int END_OF_LINE = 0x7fffffff;
   const static int END_OF_FILE = 0x7fffffff;
 protected:
-  std::vector<std::string> _lines;
+  /// The lines: an arena with an offset index after <em>readFromFile()</em>.
+  LineArena _lines;
   BufferPosition _position;
   BufferPosition _mark;
   BufferPosition _startLastHit;
@@ -221,9 +230,17 @@ public:
   }
   /**
    * Returns the lines (not changeable).
+   * Note: the lines are copied into a vector once (see <em>LineArena::strings()</em>).
+   * <em>countLines()</em> and <em>lineAt()</em> avoid that copy.
    */
   const std::vector<std::string>& constLines() const {
-    return _lines;
+    return _lines.strings();
+  }
+  /**
+   * Returns the count of lines.
+   */
+  inline size_t countLines() const {
+    return _lines.size();
   }
   /**
    * Copies a range into a list of lines.
@@ -280,11 +297,27 @@ public:
    */
   int indexOfFirstDifference(const LineList &other, int start = 0,
       bool *differentLength = nullptr);
+  /**
+   * Returns a line.
+   * @param index The index of the line: must be less than <em>countLines()</em>.
+   * @return The line as C string. Valid until the next change of the instance.
+   */
+  inline const char* lineAt(size_t index) const {
+    return _lines.line(index);
+  }
+  /**
+   * Returns the length of a line.
+   * @param index The index of the line: must be less than <em>countLines()</em>.
+   */
+  inline size_t lineLengthAt(size_t index) const {
+    return _lines.lineLength(index);
+  }
   /**
    * Returns the lines (changeable).
+   * Note: the lines are copied into a vector once (see <em>LineArena::strings()</em>).
    */
   std::vector<std::string>& lines() {
-    return _lines;
+    return _lines.strings();
   }
   /**
    * Returns whether there was a modification of the lines.
@@ -344,11 +377,11 @@ public:
   }
   /**
    * Reads the content of a file into the instance.
+   * The lines are stored without "\n".
    * @param filename The name of the file to read.
-   * @param stripNewline <em>true</em>: the "\n" will be removed from the lines.
    * @return <em>true</em>: success.
    */
-  bool readFromFile(const char *filename, bool stripNewline = false);
+  bool readFromFile(const char *filename);
   /**
    * Replaces a pattern by a replacement.
    * @param searchExpression Defines the search pattern.
@@ -389,11 +422,24 @@ public:
   bool search(const SearchExpression &searchExpression, SearchResult &result,
       bool setPosition);
 protected:
+  /**
+   * Tests whether a line contains a pattern.
+   */
+  inline bool matches(size_t index, const std::regex &regExpr) const {
+    const char *line = _lines.line(index);
+    return std::regex_search(line, line + _lines.lineLength(index), regExpr);
+  }
+  /**
+   * Tests whether a line contains a pattern.
+   */
+  inline bool matches(size_t index, const RegexEngine &engine) const {
+    return engine.search(_lines.line(index), _lines.lineLength(index));
+  }
   bool searchBackwardsOneLine(size_t ixColumn, size_t ixLine,
-      std::regex &regExpr, SearchResult &result);
-  bool searchBackwardsRegExpr(std::regex &regExpr, SearchResult &result,
+      const std::regex &regExpr, SearchResult &result);
+  bool searchBackwardsRegExpr(const std::regex &regExpr, SearchResult &result,
       bool setPosition, bool endOfLine, bool inlineOnly, const char *flags);
-  bool searchRegExpr(std::regex &regExpr, SearchResult &result,
+  bool searchRegExpr(const std::regex &regExpr, SearchResult &result,
       bool setPosition, bool beginOfLine, bool inlineOnly, const char *flags);
 public:
   bool searchSimpleString(const char *pattern, int length, SearchResult &result,
@@ -414,9 +460,9 @@ public:
   inline void setLines(const std::vector<std::string> &lines, bool append =
       false) {
     if (append) {
-      _lines.insert(_lines.end(), lines.begin(), lines.end());
+      _lines.insert(_lines.size(), lines);
     } else {
-      _lines = lines;
+      _lines.assign(lines);
     }
   }
   /**
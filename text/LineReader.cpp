@@ -9,8 +9,7 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <unistd.h>
-#include "text.hpp"
-#include "LineReader.hpp"
+#include "../os/os.hpp"
 
 namespace cppknife {
 
@@ -23,20 +22,28 @@ LineReader::LineReader(const char *filename, Logger &logger, bool removeNewline,
     _filename(filename == nullptr ? "" : filename), _logger(logger), _fileHandle(
         -1), _removeNewline(removeNewline), _lookAheadLines(), _ignoreLookahead(
         false), _currentLine(), _blockSize(bufferSize), _nextBlock(), _cursorNextBlock(
-        nullptr), _countBlockReads(0) {
+        nullptr), _hasBinaryData(false), _hasBinaryBlock(false), _scanner(), _lineEnds(), _nextLineEnd(
+        0), _decompressor(nullptr), _countBlockReads(0) {
   _currentLine.reserve(bufferSize);
   _nextBlock.reserve(bufferSize);
   if (filename != nullptr) {
     if ((_fileHandle = ::open(filename, O_RDONLY)) < 0) {
       _logger.say(LV_ERROR,
           formatCString("cannot open (%d): %s", errno, filename));
-    } else {
+    } else if (startFile()) {
       readBlock();
     }
   }
 }
 
 LineReader::~LineReader() {
+  closeFile();
+}
+
+void LineReader::closeFile() {
+  // The decompressing thread uses the handle:
+  delete _decompressor;
+  _decompressor = nullptr;
   if (_fileHandle >= 0) {
     ::close(_fileHandle);
     _fileHandle = -1;
@@ -64,7 +71,7 @@ int LineReader::estimateLineCount(double factor) {
     readBlock();
   }
   auto size = _nextBlock.size();
-  size_t lines = countCharInCString(_nextBlock.c_str(), '\n') + 1;
+  size_t lines = _lineEnds.size() + 1;
   int rc = int(0.5 + (double) status.st_size / size * lines * factor);
   return rc;
 }
@@ -77,15 +84,8 @@ bool LineReader::hasBinaryData(bool localOnly) {
     if (_cursorNextBlock == nullptr) {
       readBlock();
     }
-    unsigned char *ptr = (unsigned char*) _nextBlock.c_str();
-    auto count = _nextBlock.size();
-    unsigned char cc;
-    while (count-- > 0) {
-      if ((cc = *ptr++) == '0' || (cc < ' ' && (cc < '\t' || cc > '\r'))) {
-        rc = true;
-        break;
-      }
-    }
+    // Detected by the line index of the block:
+    rc = _cursorNextBlock != nullptr && _hasBinaryBlock;
     if (rc) {
       _hasBinaryData = true;
     }
@@ -121,28 +121,40 @@ const std::string& LineReader::nextLine() {
 }
 
 bool LineReader::openFile(const char *filename) {
-  if (_fileHandle >= 0) {
-    ::close(_fileHandle);
-  }
+  closeFile();
   _filename = filename;
   _fileHandle = ::open(filename, O_RDONLY);
   _lookAheadLines.clear();
   _currentLine.clear();
   _cursorNextBlock = nullptr;
-  return _fileHandle >= 0;
+  return _fileHandle >= 0 && startFile();
 }
 
 bool LineReader::readBlock() {
   bool rc = false;
   _nextBlock.resize(_blockSize);
-  auto bytes = ::read(_fileHandle, const_cast<char*>(_nextBlock.data()),
-      _blockSize);
+  ssize_t bytes =
+      _decompressor != nullptr ?
+          _decompressor->read(const_cast<char*>(_nextBlock.data()),
+              _blockSize) :
+          ::read(_fileHandle, const_cast<char*>(_nextBlock.data()),
+              _blockSize);
+  if (_decompressor != nullptr && _decompressor->error()
+      && bytes < static_cast<ssize_t>(_blockSize)) {
+    _logger.say(LV_ERROR,
+        formatCString("cannot read: %s: corrupted or truncated",
+            _filename.c_str()));
+  }
+  _lineEnds.clear();
+  _nextLineEnd = 0;
+  _hasBinaryBlock = false;
   if (bytes <= 0) {
     _nextBlock.resize(0);
     _cursorNextBlock = nullptr;
   } else {
     _nextBlock.resize(bytes);
     _cursorNextBlock = _nextBlock.c_str();
+    _hasBinaryBlock = _scanner.indexBlock(_cursorNextBlock, bytes, _lineEnds);
     rc = true;
     _countBlockReads++;
   }
@@ -162,7 +174,7 @@ bool LineReader::readLine() {
       break;
     }
     rc = true;
-    if ((end = strchr(_cursorNextBlock, '\n')) == nullptr) {
+    if (_nextLineEnd >= _lineEnds.size()) {
       // Put the rest of the block at the end of the line:
       length = _nextBlock.c_str() + _nextBlock.size() - _cursorNextBlock;
       _currentLine.append(_cursorNextBlock, length);
@@ -174,6 +186,7 @@ bool LineReader::readLine() {
     } else {
       // '\n' found:
       again = false;
+      end = _nextBlock.c_str() + _lineEnds[_nextLineEnd++];
       const char *start = _cursorNextBlock;
       length = end - start + 1;
       _cursorNextBlock += length;
@@ -200,7 +213,27 @@ void LineReader::reset() {
   _currentLine.clear();
   _cursorNextBlock = nullptr;
   _nextBlock.clear();
+  _lineEnds.clear();
+  _nextLineEnd = 0;
+  delete _decompressor;
+  _decompressor = nullptr;
   lseek(_fileHandle, 0, SEEK_SET);
+  startFile();
+}
+bool LineReader::startFile() {
+  bool rc = true;
+  CompressionType compression = compressionOf(_fileHandle);
+  if (compression != CT_NONE) {
+    _decompressor = createDecompressor(compression, _fileHandle, 4,
+        _blockSize);
+    if (_decompressor == nullptr) {
+      _logger.say(LV_ERROR,
+          formatCString("%s: %s compression is not supported",
+              _filename.c_str(), compressionName(compression)));
+      rc = false;
+    }
+  }
+  return rc;
 }
 } /* namespace cppknife */
 
@@ -10,11 +10,13 @@
 #define TEXT_LINEREADER_HPP_
 // Implements a line reader with unlimited line size.
 namespace cppknife {
+class ReadAhead;
 
 /**
  * @brief Manages a line reader with unlimited line size and binary file detection.
  *
  * Note: fgets() operates with a limited line size.
+ * Files compressed with gzip or zstd are decompressed transparently.
  */
 class LineReader {
 protected:
@@ -34,6 +36,16 @@ protected:
   const char *_cursorNextBlock;
   /// <em>true</em>: the block contains binary data: '\0' ...
   bool _hasBinaryData;
+  /// <em>true</em>: the current block contains binary data.
+  bool _hasBinaryBlock;
+  /// Finds the line ends and the binary data of a block in one pass.
+  LineScanner _scanner;
+  /// The line index of <em>_nextBlock</em>: the offsets of the '\n'.
+  std::vector<uint32_t> _lineEnds;
+  /// The index of the line end following <em>_cursorNextBlock</em> in <em>_lineEnds</em>.
+  size_t _nextLineEnd;
+  /// <em>nullptr</em> or the decompressing reader of a compressed file.
+  ReadAhead *_decompressor;
 public:
   int _countBlockReads;
 public:
@@ -113,6 +125,9 @@ public:
   inline void setRemoveNewline(bool value) {
     _removeNewline = value;
   }
+protected:
+  void closeFile();
+  bool startFile();
 };
 
 } /* namespace cppknife */
@@ -142,11 +142,123 @@ bool SimpleMatcher::search(const char *toTest, int toTestLength, Hit *hit,
   }
   return rc;
 }
+KeywordAutomaton::KeywordAutomaton() :
+    _keywords(), _ids(), _ignoreCase(false), _countClasses(1), _transitions(), _outputStart(), _outputs() {
+  memset(_classOf, 0, sizeof _classOf);
+}
+KeywordAutomaton::~KeywordAutomaton() {
+}
+void KeywordAutomaton::add(const char *keyword, size_t length, int id) {
+  _keywords.emplace_back(keyword, length);
+  _ids.push_back(id);
+}
+void KeywordAutomaton::clear() {
+  _keywords.clear();
+  _ids.clear();
+  _transitions.clear();
+  _outputStart.clear();
+  _outputs.clear();
+}
+void KeywordAutomaton::compile(bool ignoreCase) {
+  _ignoreCase = ignoreCase;
+  memset(_classOf, 0, sizeof _classOf);
+  _countClasses = 1;
+  for (auto &keyword : _keywords) {
+    for (auto cc : keyword) {
+      auto byte = static_cast<unsigned char>(cc);
+      if (ignoreCase) {
+        byte = static_cast<unsigned char>(tolower(byte));
+      }
+      if (_classOf[byte] == 0) {
+        _classOf[byte] = _countClasses++;
+      }
+    }
+  }
+  if (ignoreCase) {
+    for (int cc = 0; cc < 256; cc++) {
+      _classOf[cc] = _classOf[static_cast<unsigned char>(tolower(cc))];
+    }
+  }
+  // The trie of the keywords: -1 is a missing transition.
+  _transitions.assign(_countClasses, -1);
+  std::vector<std::vector<int>> outputs(1);
+  for (size_t ix = 0; ix < _keywords.size(); ix++) {
+    int state = 0;
+    for (auto cc : _keywords[ix]) {
+      size_t index = state * _countClasses
+          + _classOf[static_cast<unsigned char>(cc)];
+      if (_transitions[index] < 0) {
+        _transitions[index] = outputs.size();
+        outputs.emplace_back();
+        _transitions.resize(outputs.size() * _countClasses, -1);
+      }
+      state = _transitions[index];
+    }
+    outputs[state].push_back(_ids[ix]);
+  }
+  // Breadth first: the failure state is always handled before.
+  // A missing transition is replaced by the transition of the failure state.
+  std::vector<int> failure(outputs.size(), 0);
+  std::vector<int> queue;
+  queue.reserve(outputs.size());
+  for (size_t cc = 0; cc < _countClasses; cc++) {
+    int &next = _transitions[cc];
+    if (next < 0) {
+      next = 0;
+    } else {
+      queue.push_back(next);
+    }
+  }
+  for (size_t head = 0; head < queue.size(); head++) {
+    int state = queue[head];
+    for (size_t cc = 0; cc < _countClasses; cc++) {
+      int fallback = _transitions[failure[state] * _countClasses + cc];
+      int &next = _transitions[state * _countClasses + cc];
+      if (next < 0) {
+        next = fallback;
+      } else {
+        failure[next] = fallback;
+        // A keyword ending in the failure state ends in this state too:
+        outputs[next].insert(outputs[next].end(), outputs[fallback].begin(),
+            outputs[fallback].end());
+        queue.push_back(next);
+      }
+    }
+  }
+  _outputStart.clear();
+  _outputStart.reserve(outputs.size() + 1);
+  _outputs.clear();
+  for (auto &list : outputs) {
+    _outputStart.push_back(_outputs.size());
+    _outputs.insert(_outputs.end(), list.begin(), list.end());
+  }
+  _outputStart.push_back(_outputs.size());
+}
+bool KeywordAutomaton::scan(const char *text, size_t length,
+    KeywordHit_t hit) const {
+  bool rc = true;
+  if (!_outputs.empty()) {
+    int state = 0;
+    for (size_t ix = 0; rc && ix < length; ix++) {
+      state = _transitions[state * _countClasses
+          + _classOf[static_cast<unsigned char>(text[ix])]];
+      for (int output = _outputStart[state];
+          output < _outputStart[state + 1]; output++) {
+        if (!hit(_outputs[output], ix + 1)) {
+          rc = false;
+          break;
+        }
+      }
+    }
+  }
+  return rc;
+}
 /**
  * Constructor.
  */
 PatternList::PatternList() :
-    _patternString(), _patterns() {
+    _patternString(), _patterns(), _automaton(), _unindexed(), _hasNotPatterns(
+        false) {
 }
 /**
  * Destructor.
@@ -155,11 +267,40 @@ PatternList::~PatternList() {
   clear();
 }
 
+void PatternList::buildAutomaton() {
+  _automaton.clear();
+  _unindexed.clear();
+  _hasNotPatterns = false;
+  bool ignoreCase = false;
+  for (size_t ix = 0; ix < _patterns.size(); ix++) {
+    auto pattern = _patterns[ix];
+    _hasNotPatterns = _hasNotPatterns || pattern->isNotPattern();
+    ignoreCase = ignoreCase || pattern->ignoreCase();
+    // Each token must be part of a matching string: the longest is the best filter.
+    const std::string *longest = nullptr;
+    if (!pattern->findAll()) {
+      for (auto &token : pattern->tokens()) {
+        if (longest == nullptr || token.size() > longest->size()) {
+          longest = &token;
+        }
+      }
+    }
+    if (longest == nullptr || longest->empty()) {
+      _unindexed.push_back(ix);
+    } else {
+      _automaton.add(longest->c_str(), longest->size(), ix);
+    }
+  }
+  _automaton.compile(ignoreCase);
+}
 void PatternList::clear() {
   for (auto item : _patterns) {
     delete item;
   }
   _patterns.clear();
+  _automaton.clear();
+  _unindexed.clear();
+  _hasNotPatterns = false;
 }
 /**
  * Writes the content to a stream.
@@ -178,6 +319,40 @@ void PatternList::dump(FILE *fp, const char *prefix) const {
 }
 
 bool PatternList::match(const char *toTest, int toTestLength) {
+  if (_patterns.size() < MIN_AUTOMATON_PATTERNS) {
+    return matchSequential(toTest, toTestLength);
+  }
+  if (toTestLength < 0) {
+    toTestLength = strlen(toTest);
+  }
+  // Same result as matchSequential(): a matching not pattern rejects the string.
+  // Otherwise the string is accepted if a not pattern exists or a positive pattern matches.
+  bool found = false;
+  bool rejected = false;
+  auto test = [&](int index) {
+    auto pattern = _patterns[index];
+    if (pattern->isNotPattern()) {
+      rejected = pattern->match(toTest, toTestLength);
+    } else if (!found && !_hasNotPatterns) {
+      found = pattern->match(toTest, toTestLength);
+    }
+    return !rejected && (_hasNotPatterns || !found);
+  };
+  bool again = true;
+  for (auto index : _unindexed) {
+    if (!(again = test(index))) {
+      break;
+    }
+  }
+  if (again) {
+    // Only the patterns with a found token are tested:
+    _automaton.scan(toTest, toTestLength, [&test](int index, size_t) {
+      return test(index);
+    });
+  }
+  return !rejected && (found || _hasNotPatterns);
+}
+bool PatternList::matchSequential(const char *toTest, int toTestLength) {
   int positives = 0;
   if (toTestLength < 0) {
     toTestLength = strlen(toTest);
@@ -262,6 +437,7 @@ void PatternList::set(const char *patterns, int patternsLength, bool ignoreCase,
     matcher->setIgnoreCase(ignoreCase);
     _patterns.push_back(matcher);
   }
+  buildAutomaton();
 }
 bool SimpleMatcher::matches(const char *pattern, const char *text,
     int patternLength, int textLength) {
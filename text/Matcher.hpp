@@ -154,6 +154,18 @@ public:
       Hit *hit = NULL) const;
   virtual bool search(const char *toTest, int toTestLength = -1,
       Hit *hit = NULL, bool greedy = false) const;
+  /**
+   * Returns whether the pattern matches all strings ("*").
+   */
+  inline bool findAll() const {
+    return _findAll;
+  }
+  /**
+   * Returns the parts of the pattern between the wildcards.
+   */
+  inline const std::vector<std::string>& tokens() const {
+    return _tokens;
+  }
 public:
   /**
    * Returns whether a pattern fits the given text.
@@ -204,6 +216,77 @@ protected:
       Hit *hit, bool greedy) const;
 };
 
+/// Finds a set of keywords in one pass over a text (Aho-Corasick).
+/**
+ * Finds a set of keywords in one pass over a text (Aho-Corasick).
+ *
+ * The keywords are compiled into a deterministic automaton: each byte of the text
+ * costs one table lookup, independent of the count of keywords.
+ * To keep the table small the bytes are mapped to classes: all bytes not contained
+ * in any keyword share one class.
+ */
+class KeywordAutomaton {
+public:
+  /**
+   * Will be called for each found keyword.
+   * @param id The id given in <em>add()</em>.
+   * @param end The index behind the keyword in the text.
+   * @return <em>false</em>: the scan is stopped.
+   */
+  typedef std::function<bool(int id, size_t end)> KeywordHit_t;
+protected:
+  std::vector<std::string> _keywords;
+  std::vector<int> _ids;
+  bool _ignoreCase;
+  size_t _countClasses;
+  uint16_t _classOf[256];
+  /// <em>_transitions[state * _countClasses + class]</em> is the following state.
+  std::vector<int> _transitions;
+  /// The ids of the keywords ending in state N: <em>_outputs[_outputStart[N]]</em>..<em>_outputs[_outputStart[N+1]-1]</em>
+  std::vector<int> _outputStart;
+  std::vector<int> _outputs;
+public:
+  KeywordAutomaton();
+  virtual ~KeywordAutomaton();
+public:
+  /**
+   * Adds a keyword. <em>compile()</em> must be called after the last call.
+   * @param keyword The keyword to find.
+   * @param length The length of <em>keyword</em>: must not be 0.
+   * @param id The id reported in the callback of <em>scan()</em>.
+   */
+  void add(const char *keyword, size_t length, int id);
+  /**
+   * Removes all keywords.
+   */
+  void clear();
+  /**
+   * Builds the automaton from the keywords.
+   * @param ignoreCase <em>true</em>: the case is ignored while comparison.
+   */
+  void compile(bool ignoreCase);
+  /**
+   * Returns the count of keywords.
+   */
+  inline size_t count() const {
+    return _keywords.size();
+  }
+  /**
+   * Returns the count of states of the compiled automaton.
+   */
+  inline size_t countStates() const {
+    return _outputStart.empty() ? 0 : _outputStart.size() - 1;
+  }
+  /**
+   * Searches all keywords in a text.
+   * @param text The text to inspect.
+   * @param length The length of <em>text</em>.
+   * @param hit Will be called for each found keyword, ordered by the end of the keyword.
+   * @return <em>false</em>: the callback has stopped the scan.
+   */
+  bool scan(const char *text, size_t length, KeywordHit_t hit) const;
+};
+
 /// Stores an amount of search patterns, with positive and negative patterns.
 /**
  * Stores an amount of search patterns, with positive and negative patterns.
@@ -212,10 +295,18 @@ protected:
  * Negative pattterns: only text <strong>not</strong> matching the filter will be delivered.
  */
 class PatternList {
+public:
+  /// Shorter lists are tested pattern by pattern.
+  static const size_t MIN_AUTOMATON_PATTERNS = 4;
 private:
   std::string _patternString;
   // store of all patterns: the not patterns are at the bottom
   std::vector<SimpleMatcher*> _patterns;
+  /// Finds the longest token of each pattern: only patterns with a found token are tested.
+  KeywordAutomaton _automaton;
+  /// The indexes of the patterns without token, e.g. "*": tested for each string.
+  std::vector<int> _unindexed;
+  bool _hasNotPatterns;
 public:
   PatternList();
   virtual ~PatternList();
@@ -266,6 +357,16 @@ public:
   inline bool match(const std::string &toTest) {
     return match(toTest.c_str(), toTest.size());
   }
+  /**
+   * Tests whether a string matches the patterns: each pattern is tested.
+   *
+   * Same result as <em>match()</em>, but the cost grows with the count of patterns.
+   * @param toTest The string to test.
+   * @param toTestLength -1: <em>strlen(toTest)</em> will be used.<br>
+   *   Otherwise: the length of <em>toTest</em>.
+   * @return <em>true</em>: the string matches
+   */
+  bool matchSequential(const char *toTest, int toTestLength = -1);
   /**
    * Tests whether a string matches the pattern stored in the instance.
    *
@@ -305,8 +406,10 @@ public:
   void setIgnoreCase(bool onNotOff) {
     for (size_t ii = 0; ii < _patterns.size(); ii++)
       _patterns[ii]->setIgnoreCase(onNotOff);
+    buildAutomaton();
   }
 private:
+  void buildAutomaton();
   int setOne(int index, const char *pattern, size_t patternLength,
       bool ignoreCase, const std::string &notPrefix);
 };
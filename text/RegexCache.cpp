@@ -0,0 +1,102 @@
+/*
+ * RegexCache.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "text.hpp"
+
+namespace cppknife {
+
+RegexCache::RegexCache(size_t capacity) :
+    _capacity(capacity), _entries(), _index(), _hits(0), _misses(0), _mutex() {
+}
+RegexCache::~RegexCache() {
+}
+void RegexCache::clear() {
+  std::lock_guard<std::mutex> guard(_mutex);
+  _entries.clear();
+  _index.clear();
+  _hits = _misses = 0;
+}
+size_t RegexCache::countHits() const {
+  std::lock_guard<std::mutex> guard(_mutex);
+  return _hits;
+}
+size_t RegexCache::countMisses() const {
+  std::lock_guard<std::mutex> guard(_mutex);
+  return _misses;
+}
+bool RegexCache::find(const std::string &key, Entry_t &entry) {
+  std::lock_guard<std::mutex> guard(_mutex);
+  auto it = _index.find(key);
+  bool rc = it != _index.end();
+  if (!rc) {
+    _misses++;
+  } else {
+    _hits++;
+    // Becomes the most recently used entry:
+    _entries.splice(_entries.begin(), _entries, it->second);
+    entry = *it->second;
+  }
+  return rc;
+}
+RegexCache::SharedRegex_t RegexCache::get(const std::string &pattern,
+    std::regex_constants::syntax_option_type flags) {
+  Entry_t entry;
+  entry._key = formatCString("%x:", static_cast<unsigned>(flags)) + pattern;
+  if (!find(entry._key, entry)) {
+    // Compiled without lock: other threads are not blocked meanwhile.
+    entry._regex = std::make_shared<const std::regex>(pattern, flags);
+    store(entry);
+  }
+  return entry._regex;
+}
+RegexCache::SharedEngine_t RegexCache::getEngine(const std::string &pattern,
+    bool ignoreCase) {
+  Entry_t entry;
+  // Not a hexadecimal number: differs from the keys of get().
+  entry._key = formatCString("engine%d:", ignoreCase ? 1 : 0) + pattern;
+  if (!find(entry._key, entry)) {
+    entry._engine = SharedEngine_t(
+        RegexEngine::create(pattern.c_str(), ignoreCase));
+    store(entry);
+  }
+  return entry._engine;
+}
+RegexCache* RegexCache::instance() {
+  static RegexCache globalInstance;
+  return &globalInstance;
+}
+void RegexCache::setCapacity(size_t capacity) {
+  std::lock_guard<std::mutex> guard(_mutex);
+  _capacity = capacity;
+  shrink(capacity);
+}
+void RegexCache::shrink(size_t capacity) {
+  while (_entries.size() > capacity) {
+    _index.erase(_entries.back()._key);
+    _entries.pop_back();
+  }
+}
+void RegexCache::store(const Entry_t &entry) {
+  std::lock_guard<std::mutex> guard(_mutex);
+  if (_index.find(entry._key) == _index.end() && _capacity > 0) {
+    _entries.push_front(entry);
+    _index[entry._key] = _entries.begin();
+    shrink(_capacity);
+  }
+}
+size_t RegexCache::size() const {
+  std::lock_guard<std::mutex> guard(_mutex);
+  return _entries.size();
+}
+std::string RegexCache::statistics() const {
+  std::lock_guard<std::mutex> guard(_mutex);
+  return formatCString("regex cache: %ld hit(s) %ld miss(es) %ld pattern(s)",
+      _hits, _misses, _entries.size());
+}
+
+} /* cppknife */
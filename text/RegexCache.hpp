@@ -0,0 +1,114 @@
+/*
+ * RegexCache.hpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef TEXT_REGEXCACHE_HPP_
+#define TEXT_REGEXCACHE_HPP_
+
+namespace cppknife {
+
+/**
+ * @brief A process wide cache of compiled regular expressions.
+ *
+ * Compiling a <em>std::regex</em> is expensive: a script statement inside a loop
+ * would compile its pattern in each pass. The cache stores the compiled expressions
+ * (or <em>RegexEngine</em> instances) by pattern and flags.
+ * If the capacity is reached the least recently used entry is removed.
+ *
+ * The expressions are shared and immutable: an entry removed from the cache lives as long
+ * as it is used. Thread safe.
+ */
+class RegexCache {
+public:
+  typedef std::shared_ptr<const std::regex> SharedRegex_t;
+  typedef std::shared_ptr<const RegexEngine> SharedEngine_t;
+  enum {
+    DEFAULT_CAPACITY = 256
+  };
+protected:
+  /**
+   * @brief A cached expression: only one of the pointers is set.
+   */
+  class Entry_t {
+  public:
+    std::string _key;
+    SharedRegex_t _regex;
+    SharedEngine_t _engine;
+  };
+  size_t _capacity;
+  /// The most recently used entry is the first.
+  std::list<Entry_t> _entries;
+  std::map<std::string, std::list<Entry_t>::iterator> _index;
+  size_t _hits;
+  size_t _misses;
+  mutable std::mutex _mutex;
+public:
+  RegexCache(size_t capacity = DEFAULT_CAPACITY);
+  virtual ~RegexCache();
+private:
+  // not implemented, private to avoid use
+  RegexCache(const RegexCache &other);
+  RegexCache& operator=(const RegexCache &other);
+public:
+  /**
+   * Removes all entries and resets the counters.
+   */
+  void clear();
+  /**
+   * Returns the count of the requests answered from the cache.
+   */
+  size_t countHits() const;
+  /**
+   * Returns the count of the requests needing a compilation.
+   */
+  size_t countMisses() const;
+  /**
+   * Returns the compiled regular expression of a pattern.
+   * @param pattern The regular expression.
+   * @param flags The syntax options, e.g. <em>std::regex::icase</em>.
+   * @return The compiled expression.
+   * @throws std::regex_error The pattern is not a valid regular expression.
+   */
+  SharedRegex_t get(const std::string &pattern,
+      std::regex_constants::syntax_option_type flags =
+          std::regex_constants::ECMAScript);
+  /**
+   * Returns the search engine of a pattern: see <em>RegexEngine::create()</em>.
+   * @param pattern The regular expression.
+   * @param ignoreCase <em>true</em>: the case is ignored.
+   * @return The engine.
+   * @throws std::regex_error The pattern is not a valid regular expression.
+   */
+  SharedEngine_t getEngine(const std::string &pattern, bool ignoreCase = false);
+  /**
+   * Sets the maximal count of entries.
+   * @param capacity The maximal count of entries.
+   */
+  void setCapacity(size_t capacity);
+  /**
+   * Returns the count of entries.
+   */
+  size_t size() const;
+  /**
+   * Returns the counters as a readable text.
+   */
+  std::string statistics() const;
+public:
+  /**
+   * Returns the cache shared by the whole process.
+   */
+  static RegexCache*
+  instance();
+protected:
+  bool find(const std::string &key, Entry_t &entry);
+  void shrink(size_t capacity);
+  void store(const Entry_t &entry);
+};
+
+} /* cppknife */
+
+#endif /* TEXT_REGEXCACHE_HPP_ */
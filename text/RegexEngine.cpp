@@ -0,0 +1,720 @@
+/*
+ * RegexEngine.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "text.hpp"
+
+namespace cppknife {
+
+static std::regex_constants::syntax_option_type regexFlags(bool ignoreCase) {
+  return ignoreCase ?
+      std::regex_constants::ECMAScript | std::regex_constants::icase :
+      std::regex_constants::ECMAScript;
+}
+
+RegexEngine::RegexEngine(const char *pattern, bool ignoreCase) :
+    _pattern(pattern), _ignoreCase(ignoreCase) {
+}
+RegexEngine::~RegexEngine() {
+}
+RegexEngine* RegexEngine::create(const char *pattern, bool ignoreCase,
+    bool preferDfa) {
+  RegexEngine *rc = nullptr;
+  if (preferDfa) {
+    // Throws std::regex_error for invalid patterns:
+    auto dfa = new DfaRegexEngine(pattern, ignoreCase);
+    if (dfa->isValid()) {
+      rc = dfa;
+    } else {
+      delete dfa;
+    }
+  }
+  if (rc == nullptr) {
+    rc = new StdRegexEngine(pattern, ignoreCase);
+  }
+  return rc;
+}
+
+StdRegexEngine::StdRegexEngine(const char *pattern, bool ignoreCase) :
+    RegexEngine(pattern, ignoreCase), _regex(pattern, regexFlags(ignoreCase)) {
+}
+StdRegexEngine::~StdRegexEngine() {
+}
+bool StdRegexEngine::search(const char *text, size_t length) const {
+  return std::regex_search(text, text + length, _regex);
+}
+bool StdRegexEngine::search(const char *text, size_t length,
+    std::cmatch &match) const {
+  return std::regex_search(text, text + length, match, _regex);
+}
+
+/**
+ * @brief Translates a regular expression into the NFA of a <em>DfaRegexEngine</em>.
+ *
+ * A recursive descent parser: alternatives, sequences, repetitions, atoms.
+ * Any unsupported construct marks the pattern as invalid.
+ */
+class DfaPatternParser {
+public:
+  /**
+   * A part of the NFA with one entry and one exit.
+   * The exit is a NT_SPLIT state with an undefined <em>_next</em>.
+   */
+  struct Fragment {
+    int _start;
+    int _end;
+  };
+  /// Larger repetition counts are not expanded.
+  static const int MAX_REPETITION = 100;
+protected:
+  DfaRegexEngine &_engine;
+  const char *_pattern;
+  size_t _length;
+  size_t _position;
+  bool _ignoreCase;
+  bool _valid;
+public:
+  DfaPatternParser(DfaRegexEngine &engine, const char *pattern,
+      bool ignoreCase) :
+      _engine(engine), _pattern(pattern), _length(strlen(pattern)), _position(
+          0), _ignoreCase(ignoreCase), _valid(true) {
+  }
+public:
+  /**
+   * Translates the pattern.
+   * @param[out] start The start state of the NFA.
+   * @return <em>true</em>: the pattern is supported.
+   */
+  bool parse(int &start) {
+    Fragment fragment = alternatives();
+    if (_position < _length) {
+      // A stray ')':
+      _valid = false;
+    }
+    if (_valid) {
+      _engine._nfaMatch = _engine.addState(DfaRegexEngine::NT_MATCH);
+      link(fragment, _engine._nfaMatch);
+      start = fragment._start;
+    }
+    return _valid && _engine._nfa.size() <= DfaRegexEngine::MAX_NFA_STATES;
+  }
+protected:
+  Fragment alternatives() {
+    Fragment rc = sequence();
+    while (_valid && _position < _length && _pattern[_position] == '|') {
+      _position++;
+      Fragment other = sequence();
+      int end = _engine.addState(DfaRegexEngine::NT_SPLIT);
+      int start = _engine.addState(DfaRegexEngine::NT_SPLIT, rc._start,
+          other._start);
+      link(rc, end);
+      link(other, end);
+      rc = {start, end};
+    }
+    return rc;
+  }
+  Fragment anchor(DfaRegexEngine::NfaType type) {
+    int end = _engine.addState(DfaRegexEngine::NT_SPLIT);
+    int start = _engine.addState(type, end);
+    return {start, end};
+  }
+  Fragment atom() {
+    std::bitset<256> set;
+    char cc = _pattern[_position++];
+    switch (cc) {
+    case '(': {
+      if (_position < _length && _pattern[_position] == '?') {
+        // Only non capturing groups, no lookahead assertions:
+        if (_position + 1 >= _length || _pattern[_position + 1] != ':') {
+          _valid = false;
+          return empty();
+        }
+        _position += 2;
+      }
+      Fragment rc = alternatives();
+      if (_position >= _length || _pattern[_position] != ')') {
+        _valid = false;
+      } else {
+        _position++;
+      }
+      return rc;
+    }
+    case '[':
+      charClass(set);
+      break;
+    case '.':
+      set.set();
+      set.reset('\n');
+      set.reset('\r');
+      break;
+    case '^':
+      return anchor(DfaRegexEngine::NT_BEGIN);
+    case '$':
+      return anchor(DfaRegexEngine::NT_END);
+    case '\\':
+      escape(set, false);
+      foldCase(set);
+      break;
+    case '*':
+    case '+':
+    case '?':
+    case '{':
+    case '}':
+    case ')':
+    case ']':
+      _valid = false;
+      return empty();
+    default:
+      set.set(static_cast<unsigned char>(cc));
+      foldCase(set);
+      break;
+    }
+    return chars(set);
+  }
+  void charClass(std::bitset<256> &set) {
+    bool negate = false;
+    if (_position < _length && _pattern[_position] == '^') {
+      negate = true;
+      _position++;
+    }
+    if (_position < _length && _pattern[_position] == ']') {
+      // "[]" and "[^]" are handled differently by the implementations:
+      _valid = false;
+      return;
+    }
+    while (_valid && _position < _length && _pattern[_position] != ']') {
+      int low = classMember(set);
+      if (low >= 0 && _position + 1 < _length && _pattern[_position] == '-'
+          && _pattern[_position + 1] != ']') {
+        _position++;
+        int high = classMember(set);
+        if (high < low) {
+          _valid = false;
+        } else {
+          for (int ix = low; ix <= high; ix++) {
+            set.set(ix);
+          }
+        }
+      } else if (low >= 0) {
+        set.set(low);
+      }
+    }
+    if (_position >= _length) {
+      _valid = false;
+    } else {
+      _position++;
+    }
+    // The case is folded before the negation: [^a] does not match 'A'.
+    foldCase(set);
+    if (negate) {
+      set.flip();
+    }
+  }
+  Fragment chars(const std::bitset<256> &set) {
+    int end = _engine.addState(DfaRegexEngine::NT_SPLIT);
+    int start = _engine.addState(DfaRegexEngine::NT_CHARS, end, -1,
+        _engine.addCharSet(set));
+    return {start, end};
+  }
+  /**
+   * Reads one member of a character class.
+   * @param[out] set A class like \\d is added here.
+   * @return -1: a class has been added. Otherwise: the character.
+   */
+  int classMember(std::bitset<256> &set) {
+    int rc = -1;
+    char cc = _pattern[_position++];
+    if (cc == '\\') {
+      std::bitset<256> member;
+      rc = escape(member, true);
+      if (rc < 0) {
+        set |= member;
+      }
+    } else if (cc == '[' && _position < _length
+        && strchr(":.=", _pattern[_position]) != nullptr) {
+      // POSIX classes like [:alpha:]:
+      _valid = false;
+    } else {
+      rc = static_cast<unsigned char>(cc);
+    }
+    return rc;
+  }
+  Fragment empty() {
+    int end = _engine.addState(DfaRegexEngine::NT_SPLIT);
+    return {end, end};
+  }
+  /**
+   * Reads an escape sequence behind the backslash.
+   * @param[out] set The matching characters.
+   * @param inClass <em>true</em>: the sequence is part of a character class.
+   * @return -1: a class like \\d. Otherwise: the character.
+   */
+  int escape(std::bitset<256> &set, bool inClass) {
+    int rc = -1;
+    if (_position >= _length) {
+      _valid = false;
+      return rc;
+    }
+    char cc = _pattern[_position++];
+    switch (cc) {
+    case 'd':
+    case 'D':
+      for (int ix = '0'; ix <= '9'; ix++) {
+        set.set(ix);
+      }
+      break;
+    case 'w':
+    case 'W':
+      for (int ix = 0; ix < 256; ix++) {
+        if (isalnum(ix) || ix == '_') {
+          set.set(ix);
+        }
+      }
+      break;
+    case 's':
+    case 'S':
+      for (const char *ptr = " \t\n\v\f\r"; *ptr != '\0'; ptr++) {
+        set.set(*ptr);
+      }
+      break;
+    case 't':
+      rc = '\t';
+      break;
+    case 'n':
+      rc = '\n';
+      break;
+    case 'r':
+      rc = '\r';
+      break;
+    case 'f':
+      rc = '\f';
+      break;
+    case 'v':
+      rc = '\v';
+      break;
+    case '0':
+      if (_position < _length && isdigit(_pattern[_position])) {
+        _valid = false;
+      } else {
+        rc = 0;
+      }
+      break;
+    case 'x':
+      rc = hexNumber(2);
+      break;
+    case 'u':
+      rc = hexNumber(4);
+      if (rc > 0xff) {
+        _valid = false;
+      }
+      break;
+    case 'c':
+      if (_position < _length && isalpha(_pattern[_position])) {
+        rc = _pattern[_position++] % 32;
+      } else {
+        _valid = false;
+      }
+      break;
+    case 'b':
+      // Outside of a class: a word boundary.
+      if (inClass) {
+        rc = '\b';
+      } else {
+        _valid = false;
+      }
+      break;
+    default:
+      // Back references and unknown escapes:
+      if (isalnum(static_cast<unsigned char>(cc))) {
+        _valid = false;
+      } else {
+        rc = static_cast<unsigned char>(cc);
+      }
+      break;
+    }
+    if (isupper(cc) && rc < 0) {
+      set.flip();
+    }
+    if (rc >= 0 && _valid) {
+      set.set(rc);
+    }
+    return _valid ? rc : 0;
+  }
+  void foldCase(std::bitset<256> &set) {
+    if (_ignoreCase) {
+      for (int ix = 0; ix < 256; ix++) {
+        if (set.test(ix)) {
+          set.set(tolower(ix));
+          set.set(toupper(ix));
+        }
+      }
+    }
+  }
+  int hexNumber(int digits) {
+    int rc = 0;
+    for (int ix = 0; ix < digits; ix++) {
+      char cc = _position < _length ? _pattern[_position] : '\0';
+      if (!isxdigit(cc)) {
+        _valid = false;
+        break;
+      }
+      _position++;
+      rc = rc * 16 + (isdigit(cc) ? cc - '0' : tolower(cc) - 'a' + 10);
+    }
+    return rc;
+  }
+  void link(const Fragment &fragment, int target) {
+    _engine._nfa[fragment._end]._next = target;
+  }
+  /**
+   * Reads a quantifier.
+   * @param[out] minCount The minimal count of repetitions.
+   * @param[out] maxCount The maximal count of repetitions. -1: unlimited.
+   * @return <em>false</em>: no quantifier found.
+   */
+  bool quantifier(int &minCount, int &maxCount) {
+    bool rc = true;
+    switch (_position < _length ? _pattern[_position] : '\0') {
+    case '*':
+      minCount = 0;
+      maxCount = -1;
+      _position++;
+      break;
+    case '+':
+      minCount = 1;
+      maxCount = -1;
+      _position++;
+      break;
+    case '?':
+      minCount = 0;
+      maxCount = 1;
+      _position++;
+      break;
+    case '{':
+      _position++;
+      minCount = maxCount = readNumber();
+      if (minCount < 0) {
+        _valid = false;
+      } else if (_position < _length && _pattern[_position] == ',') {
+        _position++;
+        maxCount = -1;
+        if (_position < _length && isdigit(_pattern[_position])) {
+          maxCount = readNumber();
+        }
+      }
+      if (_position >= _length || _pattern[_position] != '}'
+          || (maxCount >= 0 && maxCount < minCount)
+          || minCount > MAX_REPETITION || maxCount > MAX_REPETITION) {
+        _valid = false;
+      } else {
+        _position++;
+      }
+      break;
+    default:
+      rc = false;
+      break;
+    }
+    if (rc && _position < _length && _pattern[_position] == '?') {
+      // A lazy quantifier finds the same lines:
+      _position++;
+    }
+    return rc;
+  }
+  int readNumber() {
+    int rc = -1;
+    while (_position < _length && isdigit(_pattern[_position])) {
+      rc = (rc < 0 ? 0 : rc * 10) + _pattern[_position++] - '0';
+      if (rc > 100000) {
+        rc = 100000;
+      }
+    }
+    return rc;
+  }
+  Fragment repetition() {
+    size_t atomStart = _position;
+    Fragment first = atom();
+    int minCount = 1;
+    int maxCount = 1;
+    if (!_valid || !quantifier(minCount, maxCount) || !_valid) {
+      return first;
+    }
+    size_t behind = _position;
+    int copies = 0;
+    // Each further copy of the atom is built by parsing it again:
+    auto nextCopy = [&]() {
+      Fragment rc = first;
+      if (copies++ > 0) {
+        _position = atomStart;
+        rc = atom();
+      }
+      return rc;
+    };
+    Fragment rc = empty();
+    for (int ix = 0; ix < minCount; ix++) {
+      Fragment copy = nextCopy();
+      if (maxCount < 0 && ix == minCount - 1) {
+        // "a+": a loop back to the last mandatory copy.
+        int end = _engine.addState(DfaRegexEngine::NT_SPLIT);
+        int loop = _engine.addState(DfaRegexEngine::NT_SPLIT, copy._start,
+            end);
+        link(copy, loop);
+        copy._end = end;
+      }
+      link(rc, copy._start);
+      rc._end = copy._end;
+    }
+    if (maxCount < 0 && minCount == 0) {
+      // "a*":
+      Fragment copy = nextCopy();
+      int end = _engine.addState(DfaRegexEngine::NT_SPLIT);
+      int loop = _engine.addState(DfaRegexEngine::NT_SPLIT, copy._start, end);
+      link(copy, loop);
+      link(rc, loop);
+      rc._end = end;
+    }
+    for (int ix = minCount; ix < maxCount; ix++) {
+      // An optional copy:
+      Fragment copy = nextCopy();
+      int end = _engine.addState(DfaRegexEngine::NT_SPLIT);
+      int split = _engine.addState(DfaRegexEngine::NT_SPLIT, copy._start,
+          end);
+      link(copy, end);
+      link(rc, split);
+      rc._end = end;
+    }
+    _position = behind;
+    return rc;
+  }
+  Fragment sequence() {
+    Fragment rc = empty();
+    while (_valid && _position < _length && _pattern[_position] != '|'
+        && _pattern[_position] != ')') {
+      Fragment next = repetition();
+      link(rc, next._start);
+      rc._end = next._end;
+      if (_engine._nfa.size() > DfaRegexEngine::MAX_NFA_STATES) {
+        _valid = false;
+      }
+    }
+    return rc;
+  }
+};
+
+DfaRegexEngine::DfaState::DfaState(const std::vector<int> &nfaStates,
+    size_t countClasses) :
+    _nfaStates(nfaStates), _accepting(false), _acceptingAtEnd(false), _dead(
+        nfaStates.empty()), _next(new std::atomic<int>[countClasses]) {
+  for (size_t ix = 0; ix < countClasses; ix++) {
+    _next[ix].store(-1, std::memory_order_relaxed);
+  }
+}
+
+DfaRegexEngine::DfaRegexEngine(const char *pattern, bool ignoreCase) :
+    RegexEngine(pattern, ignoreCase), _regex(pattern, regexFlags(ignoreCase)), _valid(
+        false), _nfa(), _charSets(), _nfaStart(-1), _nfaMatch(-1), _classOf(), _classMember(), _countClasses(
+        0), _restart(), _matchesEmpty(false), _initialState(-1), _states(), _countStates(
+        0), _stateIds(), _mutex() {
+  DfaPatternParser parser(*this, pattern, ignoreCase);
+  _valid = parser.parse(_nfaStart);
+  if (_valid) {
+    buildClasses();
+    _states.reset(new DfaState*[MAX_STATES]);
+    closure(std::vector<int> { _nfaStart }, false, false, _restart);
+    std::vector<int> initial;
+    closure(std::vector<int> { _nfaStart }, true, false, initial);
+    _initialState = stateOf(initial);
+    std::vector<int> empty;
+    closure(std::vector<int> { _nfaStart }, true, true, empty);
+    _matchesEmpty = std::binary_search(empty.begin(), empty.end(), _nfaMatch);
+  }
+  // The NFA is not needed for an invalid pattern:
+  if (!_valid) {
+    _nfa.clear();
+    _charSets.clear();
+  }
+}
+DfaRegexEngine::~DfaRegexEngine() {
+  for (size_t ix = 0; ix < _countStates; ix++) {
+    delete _states[ix];
+  }
+}
+int DfaRegexEngine::addCharSet(const std::bitset<256> &charSet) {
+  int rc = _charSets.size();
+  _charSets.push_back(charSet);
+  return rc;
+}
+int DfaRegexEngine::addState(NfaType type, int next, int next2, int charSet) {
+  int rc = _nfa.size();
+  _nfa.emplace_back(type, next, next2, charSet);
+  return rc;
+}
+int DfaRegexEngine::addTransition(int state, size_t byteClass) const {
+  std::lock_guard<std::mutex> guard(_mutex);
+  DfaState *current = _states[state];
+  // Another thread may have built the transition meanwhile:
+  int rc = current->_next[byteClass].load(std::memory_order_acquire);
+  if (rc < 0) {
+    std::vector<int> seeds;
+    unsigned char member = _classMember[byteClass];
+    for (auto nfaState : current->_nfaStates) {
+      const NfaState &item = _nfa[nfaState];
+      if (item._type == NT_CHARS && _charSets[item._charSet].test(member)) {
+        seeds.push_back(item._next);
+      }
+    }
+    std::vector<int> states;
+    closure(seeds, false, false, states);
+    // A hit may start at each position:
+    states.insert(states.end(), _restart.begin(), _restart.end());
+    std::sort(states.begin(), states.end());
+    states.erase(std::unique(states.begin(), states.end()), states.end());
+    rc = stateOf(states);
+    if (rc >= 0) {
+      current->_next[byteClass].store(rc, std::memory_order_release);
+    }
+  }
+  return rc;
+}
+void DfaRegexEngine::buildClasses() {
+  // Partition refinement: each character set splits the existing classes.
+  std::vector<int> classOf(256, 0);
+  size_t count = 1;
+  for (auto &charSet : _charSets) {
+    std::map<std::pair<int, bool>, int> ids;
+    for (int ix = 0; ix < 256; ix++) {
+      auto key = std::make_pair(classOf[ix], charSet.test(ix));
+      auto it = ids.find(key);
+      if (it == ids.end()) {
+        it = ids.emplace(key, ids.size()).first;
+      }
+      classOf[ix] = it->second;
+    }
+    count = ids.size();
+  }
+  _countClasses = count;
+  _classMember.assign(count, 0);
+  std::vector<bool> found(count, false);
+  for (int ix = 0; ix < 256; ix++) {
+    _classOf[ix] = classOf[ix];
+    if (!found[classOf[ix]]) {
+      found[classOf[ix]] = true;
+      _classMember[classOf[ix]] = ix;
+    }
+  }
+}
+void DfaRegexEngine::closure(const std::vector<int> &seeds, bool atStart,
+    bool atEnd, std::vector<int> &states) const {
+  std::vector<int> stack(seeds);
+  std::vector<bool> visited(_nfa.size(), false);
+  while (!stack.empty()) {
+    int ix = stack.back();
+    stack.pop_back();
+    if (ix < 0 || visited[ix]) {
+      continue;
+    }
+    visited[ix] = true;
+    const NfaState &state = _nfa[ix];
+    switch (state._type) {
+    case NT_SPLIT:
+      stack.push_back(state._next2);
+      stack.push_back(state._next);
+      break;
+    case NT_BEGIN:
+      if (atStart) {
+        stack.push_back(state._next);
+      }
+      break;
+    case NT_END:
+      // Stored in the DFA state: the text end is tested when reached.
+      if (atEnd) {
+        stack.push_back(state._next);
+      } else {
+        states.push_back(ix);
+      }
+      break;
+    default:
+      states.push_back(ix);
+      break;
+    }
+  }
+  std::sort(states.begin(), states.end());
+  states.erase(std::unique(states.begin(), states.end()), states.end());
+}
+size_t DfaRegexEngine::countStates() const {
+  std::lock_guard<std::mutex> guard(_mutex);
+  return _countStates;
+}
+bool DfaRegexEngine::search(const char *text, size_t length) const {
+  if (length == 0) {
+    return _matchesEmpty;
+  }
+  int current = _initialState;
+  const DfaState *state = _states[current];
+  if (state->_accepting) {
+    return true;
+  }
+  for (size_t ix = 0; ix < length; ix++) {
+    size_t byteClass = _classOf[static_cast<unsigned char>(text[ix])];
+    int next = state->_next[byteClass].load(std::memory_order_acquire);
+    if (next < 0 && (next = addTransition(current, byteClass)) < 0) {
+      // Too many DFA states:
+      return std::regex_search(text, text + length, _regex);
+    }
+    current = next;
+    state = _states[current];
+    if (state->_accepting) {
+      return true;
+    }
+    if (state->_dead) {
+      return false;
+    }
+  }
+  return state->_acceptingAtEnd;
+}
+bool DfaRegexEngine::search(const char *text, size_t length,
+    std::cmatch &match) const {
+  // The DFA rejects the most texts quickly, the groups are delivered by std::regex:
+  return search(text, length)
+      && std::regex_search(text, text + length, match, _regex);
+}
+int DfaRegexEngine::stateOf(const std::vector<int> &nfaStates) const {
+  int rc = -1;
+  auto it = _stateIds.find(nfaStates);
+  if (it != _stateIds.end()) {
+    rc = it->second;
+  } else if (_countStates < MAX_STATES) {
+    rc = _countStates;
+    DfaState *state = new DfaState(nfaStates, _countClasses);
+    for (auto ix : nfaStates) {
+      if (ix == _nfaMatch) {
+        state->_accepting = true;
+      }
+    }
+    state->_acceptingAtEnd = state->_accepting;
+    if (!state->_accepting) {
+      std::vector<int> seeds;
+      for (auto ix : nfaStates) {
+        if (_nfa[ix]._type == NT_END) {
+          seeds.push_back(_nfa[ix]._next);
+        }
+      }
+      if (!seeds.empty()) {
+        std::vector<int> atEnd;
+        closure(seeds, false, true, atEnd);
+        state->_acceptingAtEnd = std::binary_search(atEnd.begin(), atEnd.end(),
+            _nfaMatch);
+      }
+    }
+    _states[rc] = state;
+    _stateIds[nfaStates] = rc;
+    // Published after the state is complete:
+    _countStates++;
+  }
+  return rc;
+}
+
+} /* cppknife */
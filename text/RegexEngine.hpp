@@ -0,0 +1,230 @@
+/*
+ * RegexEngine.hpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef TEXT_REGEXENGINE_HPP_
+#define TEXT_REGEXENGINE_HPP_
+
+namespace cppknife {
+
+enum RegexEngineType {
+  /// The implementation of the standard library: supports all features.
+  RE_STD,
+  /// A lazily built deterministic automaton: no back references and assertions.
+  RE_DFA
+};
+/**
+ * @brief An interface for searching regular expressions (ECMAScript syntax).
+ *
+ * Use <em>create()</em>: it selects the fastest engine able to handle the pattern.
+ */
+class RegexEngine {
+protected:
+  std::string _pattern;
+  bool _ignoreCase;
+public:
+  RegexEngine(const char *pattern, bool ignoreCase);
+  virtual ~RegexEngine();
+private:
+  // not implemented, private to avoid use
+  RegexEngine(const RegexEngine &other);
+  RegexEngine& operator=(const RegexEngine &other);
+public:
+  /**
+   * Tests whether a text contains a hit of the pattern.
+   * Thread safe.
+   * @param text The text to inspect. Not terminated by '\0'.
+   * @param length The length of <em>text</em>.
+   * @return <em>true</em>: the text contains a hit.
+   */
+  virtual bool search(const char *text, size_t length) const = 0;
+  /**
+   * Searches the first hit with its groups like <em>std::regex_search()</em>.
+   * Thread safe.
+   * @param text The text to inspect. Not terminated by '\0'.
+   * @param length The length of <em>text</em>.
+   * @param[out] match The hit and its groups.
+   * @return <em>true</em>: the text contains a hit.
+   */
+  virtual bool search(const char *text, size_t length,
+      std::cmatch &match) const = 0;
+  /**
+   * Returns the type of the engine.
+   */
+  virtual RegexEngineType type() const = 0;
+  /**
+   * Returns the pattern compiled by <em>std::regex</em>, e.g. for replacing or for
+   * the positions of all hits.
+   */
+  virtual const std::regex& regex() const = 0;
+  /**
+   * Returns whether the case is ignored.
+   */
+  inline bool ignoreCase() const {
+    return _ignoreCase;
+  }
+  /**
+   * Returns the regular expression.
+   */
+  inline const std::string& pattern() const {
+    return _pattern;
+  }
+public:
+  /**
+   * Returns the fastest engine able to handle a pattern.
+   * @param pattern The regular expression (ECMAScript syntax).
+   * @param ignoreCase <em>true</em>: the case is ignored.
+   * @param preferDfa <em>false</em>: the standard library is used.
+   * @return The engine. Must be deleted by the caller.
+   * @throws std::regex_error The pattern is not a valid regular expression.
+   */
+  static RegexEngine* create(const char *pattern, bool ignoreCase = false,
+      bool preferDfa = true);
+};
+
+/**
+ * @brief A <em>RegexEngine</em> using <em>std::regex</em>.
+ */
+class StdRegexEngine: public RegexEngine {
+protected:
+  std::regex _regex;
+public:
+  StdRegexEngine(const char *pattern, bool ignoreCase = false);
+  virtual ~StdRegexEngine();
+public:
+  virtual bool search(const char *text, size_t length) const;
+  virtual bool search(const char *text, size_t length,
+      std::cmatch &match) const;
+  virtual RegexEngineType type() const {
+    return RE_STD;
+  }
+  virtual const std::regex& regex() const {
+    return _regex;
+  }
+};
+
+/**
+ * @brief A <em>RegexEngine</em> using a deterministic finite automaton (DFA).
+ *
+ * The pattern is translated into a nondeterministic automaton (Thompson construction).
+ * The states of the DFA are built on demand while searching (subset construction):
+ * each byte of the text costs one table lookup, there is no backtracking.
+ *
+ * Supported: literals, '.', character classes, \\d \\w \\s (and negations), groups,
+ * alternatives, the quantifiers * + ? {n,m} and the anchors ^ and $.
+ * Not supported (see <em>isValid()</em>): back references, word boundaries (\\b)
+ * and lookahead assertions.
+ *
+ * The groups of a hit are delivered by <em>std::regex</em>: only after the DFA has found a hit.
+ */
+class DfaRegexEngine: public RegexEngine {
+public:
+  enum {
+    /// If more DFA states are needed the search is done by <em>std::regex</em>.
+    MAX_STATES = 4096,
+    /// Patterns with more NFA states are not handled by the DFA.
+    MAX_NFA_STATES = 20000
+  };
+protected:
+  enum NfaType {
+    NT_CHARS, NT_SPLIT, NT_BEGIN, NT_END, NT_MATCH
+  };
+  /**
+   * @brief A state of the nondeterministic automaton.
+   */
+  class NfaState {
+  public:
+    NfaType _type;
+    /// The following state. -1: undefined.
+    int _next;
+    /// NT_SPLIT: the second following state. -1: none.
+    int _next2;
+    /// NT_CHARS: the index in <em>_charSets</em>.
+    int _charSet;
+  public:
+    NfaState(NfaType type, int next = -1, int next2 = -1, int charSet = -1) :
+        _type(type), _next(next), _next2(next2), _charSet(charSet) {
+    }
+  };
+  /**
+   * @brief A state of the deterministic automaton: a set of NFA states.
+   */
+  class DfaState {
+  public:
+    /// The sorted indexes of the NFA states.
+    std::vector<int> _nfaStates;
+    /// <em>true</em>: a hit has been found.
+    bool _accepting;
+    /// <em>true</em>: a hit is found if the text ends here.
+    bool _acceptingAtEnd;
+    /// <em>true</em>: no hit is possible any more.
+    bool _dead;
+    /// The following states, indexed by the byte class. -1: not built yet.
+    std::unique_ptr<std::atomic<int>[]> _next;
+  public:
+    DfaState(const std::vector<int> &nfaStates, size_t countClasses);
+  };
+protected:
+  std::regex _regex;
+  bool _valid;
+  std::vector<NfaState> _nfa;
+  std::vector<std::bitset<256>> _charSets;
+  int _nfaStart;
+  /// The hit state of the NFA.
+  int _nfaMatch;
+  /// Bytes with the same behavior share a class.
+  uint16_t _classOf[256];
+  /// A member of each class.
+  std::vector<unsigned char> _classMember;
+  size_t _countClasses;
+  /// The NFA states starting a hit behind the text start (unanchored search).
+  std::vector<int> _restart;
+  bool _matchesEmpty;
+  int _initialState;
+  /// A fixed array: the states can be read without locking while new states are added.
+  mutable std::unique_ptr<DfaState*[]> _states;
+  mutable size_t _countStates;
+  mutable std::map<std::vector<int>, int> _stateIds;
+  /// Protects the construction of new DFA states.
+  mutable std::mutex _mutex;
+public:
+  DfaRegexEngine(const char *pattern, bool ignoreCase = false);
+  virtual ~DfaRegexEngine();
+public:
+  /**
+   * Returns the count of the DFA states built until now.
+   */
+  size_t countStates() const;
+  /**
+   * Returns whether the pattern can be handled by the DFA.
+   */
+  inline bool isValid() const {
+    return _valid;
+  }
+  virtual bool search(const char *text, size_t length) const;
+  virtual bool search(const char *text, size_t length,
+      std::cmatch &match) const;
+  virtual RegexEngineType type() const {
+    return RE_DFA;
+  }
+  virtual const std::regex& regex() const {
+    return _regex;
+  }
+protected:
+  friend class DfaPatternParser;
+  int addCharSet(const std::bitset<256> &charSet);
+  int addState(NfaType type, int next = -1, int next2 = -1, int charSet = -1);
+  int addTransition(int state, size_t byteClass) const;
+  void buildClasses();
+  void closure(const std::vector<int> &seeds, bool atStart, bool atEnd,
+      std::vector<int> &states) const;
+  int stateOf(const std::vector<int> &nfaStates) const;
+};
+
+} /* cppknife */
+
+#endif /* TEXT_REGEXENGINE_HPP_ */
@@ -0,0 +1,252 @@
+/*
+ * RegexPrefilter.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "text.hpp"
+
+namespace cppknife {
+
+/**
+ * Returns the position behind a character class.
+ * @param pattern The regular expression.
+ * @param position The position of the '['.
+ * @param length The length of <em>pattern</em>.
+ */
+static size_t skipClass(const char *pattern, size_t position, size_t length) {
+  position++;
+  // ECMAScript: "[]" is an empty class, a leading ']' is not a member.
+  while (position < length && pattern[position] != ']') {
+    if (pattern[position] == '\\') {
+      position++;
+    }
+    position++;
+  }
+  return std::min(position + 1, length);
+}
+/**
+ * Returns the position behind a group.
+ * @param pattern The regular expression.
+ * @param position The position of the '('.
+ * @param length The length of <em>pattern</em>.
+ */
+static size_t skipGroup(const char *pattern, size_t position, size_t length) {
+  int depth = 0;
+  while (position < length) {
+    char cc = pattern[position];
+    if (cc == '\\') {
+      position += 2;
+    } else if (cc == '[') {
+      position = skipClass(pattern, position, length);
+    } else {
+      position++;
+      if (cc == '(') {
+        depth++;
+      } else if (cc == ')' && --depth == 0) {
+        break;
+      }
+    }
+  }
+  return std::min(position, length);
+}
+
+RegexPrefilter::RegexPrefilter() :
+    _literals(), _ignoreCase(false), _automaton() {
+}
+RegexPrefilter::~RegexPrefilter() {
+}
+bool RegexPrefilter::compile(const char *pattern, bool ignoreCase) {
+  _literals.clear();
+  _ignoreCase = ignoreCase;
+  for (auto &alternative : splitAlternatives(pattern)) {
+    auto literal = requiredLiteral(alternative.c_str(), alternative.size());
+    if (literal.empty()) {
+      // This alternative can match without any literal:
+      _literals.clear();
+      break;
+    }
+    _literals.push_back(literal);
+  }
+  prepare();
+  return isActive();
+}
+const char* RegexPrefilter::find(const char *text, size_t length) const {
+  const char *rc = nullptr;
+  if (_literals.size() == 1 && !_ignoreCase) {
+    rc = static_cast<const char*>(memmem(text, length, _literals[0].c_str(),
+        _literals[0].size()));
+  } else {
+    // The literal ending first: its line is the first line with a literal.
+    _automaton.scan(text, length, [this, text, &rc](int id, size_t end) {
+      rc = text + end - _literals[id].size();
+      return false;
+    });
+  }
+  return rc;
+}
+void RegexPrefilter::prepare() {
+  _automaton.clear();
+  if (_literals.size() > 1 || _ignoreCase) {
+    for (size_t ix = 0; ix < _literals.size(); ix++) {
+      _automaton.add(_literals[ix].c_str(), _literals[ix].size(), ix);
+    }
+    _automaton.compile(_ignoreCase);
+  }
+}
+std::string RegexPrefilter::requiredLiteral(const char *pattern,
+    size_t length) {
+  std::string rc;
+  std::string current;
+  size_t position = 0;
+  while (position < length) {
+    char cc = pattern[position];
+    bool literal = false;
+    char value = cc;
+    // The atom:
+    switch (cc) {
+    case '\\':
+      value = position + 1 < length ? pattern[position + 1] : '\0';
+      position += 2;
+      switch (value) {
+      case 't':
+        value = '\t';
+        literal = true;
+        break;
+      case 'r':
+        value = '\r';
+        literal = true;
+        break;
+      case 'f':
+        value = '\f';
+        literal = true;
+        break;
+      case 'v':
+        value = '\v';
+        literal = true;
+        break;
+      case 'x':
+        position += 2;
+        break;
+      case 'u':
+        position += 4;
+        break;
+      case 'c':
+        position++;
+        break;
+      default:
+        // Letters and digits are classes (\d), assertions (\b) or back references (\1).
+        literal = value != '\0' && !isalnum(static_cast<unsigned char>(value));
+        break;
+      }
+      break;
+    case '[':
+      position = skipClass(pattern, position, length);
+      break;
+    case '(':
+      position = skipGroup(pattern, position, length);
+      break;
+    case '.':
+    case '^':
+    case '$':
+    case '|':
+    case '*':
+    case '+':
+    case '?':
+    case '{':
+    case '\n':
+      position++;
+      break;
+    default:
+      literal = true;
+      position++;
+      break;
+    }
+    // The quantifier:
+    bool quantified = false;
+    size_t minCount = 1;
+    if (position < length) {
+      switch (pattern[position]) {
+      case '*':
+      case '?':
+        minCount = 0;
+        quantified = true;
+        position++;
+        break;
+      case '+':
+        quantified = true;
+        position++;
+        break;
+      case '{':
+        quantified = true;
+        minCount = atol(pattern + position + 1);
+        while (position < length && pattern[position] != '}') {
+          position++;
+        }
+        position++;
+        break;
+      default:
+        break;
+      }
+      if (quantified && position < length && pattern[position] == '?') {
+        // Lazy quantifier:
+        position++;
+      }
+    }
+    if (literal && minCount > 0) {
+      current += value;
+    }
+    // A repeated or optional atom ends the literal:
+    if (!literal || quantified) {
+      if (current.size() > rc.size()) {
+        rc = current;
+      }
+      current.clear();
+    }
+  }
+  if (current.size() > rc.size()) {
+    rc = current;
+  }
+  return rc;
+}
+void RegexPrefilter::setLiteral(const std::string &literal, bool ignoreCase) {
+  _literals.clear();
+  if (!literal.empty()) {
+    _literals.push_back(literal);
+  }
+  _ignoreCase = ignoreCase;
+  prepare();
+}
+std::vector<std::string> RegexPrefilter::splitAlternatives(
+    const char *pattern) {
+  std::vector<std::string> rc;
+  size_t length = strlen(pattern);
+  size_t start = 0;
+  size_t position = 0;
+  while (position < length) {
+    switch (pattern[position]) {
+    case '\\':
+      position += 2;
+      break;
+    case '[':
+      position = skipClass(pattern, position, length);
+      break;
+    case '(':
+      position = skipGroup(pattern, position, length);
+      break;
+    case '|':
+      rc.emplace_back(pattern + start, position - start);
+      start = ++position;
+      break;
+    default:
+      position++;
+      break;
+    }
+  }
+  rc.emplace_back(pattern + start, std::min(position, length) - start);
+  return rc;
+}
+
+} /* cppknife */
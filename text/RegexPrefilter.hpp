@@ -0,0 +1,100 @@
+/*
+ * RegexPrefilter.hpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#ifndef TEXT_REGEXPREFILTER_HPP_
+#define TEXT_REGEXPREFILTER_HPP_
+
+namespace cppknife {
+
+/**
+ * @brief Finds the candidates of a regular expression by its mandatory literals.
+ *
+ * Most regular expressions contain a string which is part of each hit, e.g. "ERROR" in
+ * "ERROR.*timeout" or "192.168." in "192\.168\.\d+". Searching that literal
+ * with <em>memmem()</em> is much faster than <em>std::regex_search()</em>:
+ * only lines containing the literal must be inspected by the regular expression.
+ *
+ * A pattern with alternatives ("A|B") has one literal per alternative: they are searched
+ * with a <em>KeywordAutomaton</em>. If any alternative has no literal there is no prefilter.
+ */
+class RegexPrefilter {
+protected:
+  /// One literal per alternative. Empty: no prefilter.
+  std::vector<std::string> _literals;
+  bool _ignoreCase;
+  /// Used for more than one literal or ignoring case.
+  KeywordAutomaton _automaton;
+public:
+  RegexPrefilter();
+  virtual ~RegexPrefilter();
+public:
+  /**
+   * Extracts the mandatory literals of a regular expression (ECMAScript syntax).
+   * @param pattern The regular expression.
+   * @param ignoreCase <em>true</em>: the regular expression ignores the case.
+   * @return <em>true</em>: a prefilter is available.
+   */
+  bool compile(const char *pattern, bool ignoreCase = false);
+  /**
+   * Finds the first candidate of a hit in a text.
+   * @param text The text to inspect. Not terminated by '\0'.
+   * @param length The length of <em>text</em>.
+   * @return <em>nullptr</em>: no literal found: the text cannot contain a hit.
+   *   Otherwise: the start of a literal. A hit can only be in the line containing that position
+   *   or in the following lines.
+   */
+  const char* find(const char *text, size_t length) const;
+  /**
+   * Returns whether a prefilter is available.
+   */
+  inline bool isActive() const {
+    return !_literals.empty();
+  }
+  /**
+   * Returns the literals: one of them is part of each hit.
+   */
+  inline const std::vector<std::string>& literals() const {
+    return _literals;
+  }
+  /**
+   * Tests whether a line may contain a hit.
+   * @param line The line to inspect. Not terminated by '\0'.
+   * @param length The length of <em>line</em>.
+   * @return <em>false</em>: the line does not contain a hit.
+   */
+  inline bool mayMatch(const char *line, size_t length) const {
+    return _literals.empty() || find(line, length) != nullptr;
+  }
+  /**
+   * Sets one literal: for searching a simple string.
+   * @param literal The string to search.
+   * @param ignoreCase <em>true</em>: the case is ignored.
+   */
+  void setLiteral(const std::string &literal, bool ignoreCase = false);
+public:
+  /**
+   * Returns the longest literal which is part of each hit of a regular expression without
+   * alternatives.
+   * @param pattern The regular expression.
+   * @param length The length of <em>pattern</em>.
+   * @return The longest literal. Empty: there is no mandatory literal.
+   */
+  static std::string requiredLiteral(const char *pattern, size_t length);
+  /**
+   * Splits a regular expression into its top level alternatives.
+   * @param pattern The regular expression.
+   * @return The alternatives, e.g. ["a(b|c)", "d"] for "a(b|c)|d".
+   */
+  static std::vector<std::string> splitAlternatives(const char *pattern);
+protected:
+  void prepare();
+};
+
+} /* cppknife */
+
+#endif /* TEXT_REGEXPREFILTER_HPP_ */
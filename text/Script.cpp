@@ -654,7 +654,7 @@ size_t Script::findEndOfBlock(int line, int idStatement, int idEnd1, int idEnd2,
   size_t rc = 0;
   int nesting = 1;
   while (index < _lines.size()) {
-    _parser.setInput(_lines[index].c_str(), index + 1, _name.c_str());
+    _parser.setInput(_lines.line(index), index + 1, _name.c_str());
     auto type = _parser.parse();
     if (type == TT_KEYWORD) {
       auto currentId = _parser.token()._keywordId;
@@ -865,7 +865,7 @@ void Script::getText(bool testOnly, std::vector<std::string> &contents) {
     bool found = false;
     size_t ix = _indexNextStatement;
     while (ix < _lines.size()) {
-      auto line = _lines[ix++];
+      auto line = _lines.lineAsString(ix++);
       if (line == marker) {
         found = true;
         _indexNextStatement = ix;
@@ -1015,7 +1015,7 @@ void Script::leave(bool testOnly) {
     size_t index = _indexNextStatement;
     int nesting = count;
     while (index < _lines.size()) {
-      _parser.setInput(_lines[index].c_str(), index + 1, _name.c_str());
+      _parser.setInput(_lines.line(index), index + 1, _name.c_str());
       auto type = _parser.parse();
       if (type == TT_KEYWORD) {
         auto currentId = _parser.token()._keywordId;
@@ -1054,11 +1054,11 @@ void Script::load(bool testOnly) {
           formatCString("file %s does not exist", filename.c_str()), _parser);
     }
     buffer->clear();
-    buffer->readFromFile(filename.c_str(), true);
+    buffer->readFromFile(filename.c_str());
     buffer->setPosition(0, 0);
     if (_engine._trace != nullptr) {
       fprintf(_engine._trace, "  %s: %ld lines read\n", filename.c_str(),
-          buffer->lines().size());
+          buffer->countLines());
     }
   }
 }
@@ -1277,12 +1277,12 @@ void Script::log(bool testOnly) {
 
 int Script::oneStatement(bool testOnly) {
   int rc = 0;
-  const std::string &line = _lines[_indexNextStatement];
+  const char *line = _lines.line(_indexNextStatement);
   _indexNextStatement++;
-  _parser.setInput(line.c_str(), _indexNextStatement, _name.c_str());
+  _parser.setInput(line, _indexNextStatement, _name.c_str());
   if (!testOnly && _engine._trace != nullptr) {
     fprintf(_engine._trace, "%s-%03ld: %s\n", _name.c_str(),
-        _indexNextStatement, line.c_str());
+        _indexNextStatement, line);
   }
   _numericalContext = false;
   if (_parser.parseSpecial(&SearchParser::_regexAssignment, 1) == 1) {
@@ -1455,7 +1455,7 @@ bool Script::searchBuffer(LineBuffer &buffer, SearchExpression &searchExpr,
   if (!rc) {
     _engine._lastHit.clear();
   } else {
-    auto ptr = buffer.lines()[searchResult._position._lineIndex].c_str()
+    auto ptr = buffer.lineAt(searchResult._position._lineIndex)
         + searchResult._position._columnIndex;
     _engine._lastHit = std::string(ptr, searchResult._length);
   }
@@ -1529,14 +1529,14 @@ void Script::script(bool testOnly) {
     _engine.addScript(script);
     auto start = _indexNextStatement - 1;
     do {
-      script->lines().push_back(_lines[_indexNextStatement]);
+      script->lines().push_back(_lines.lineAsString(_indexNextStatement));
       if (++_indexNextStatement >= _lines.size()) {
         throw ParserError(
             formatCString(
                 "missing 'endscript' in script '%s' starting in line %d",
                 name.c_str(), start), _parser);
       }
-    } while (_lines[_indexNextStatement] != "endscript");
+    } while (strcmp(_lines.line(_indexNextStatement), "endscript") != 0);
     _indexNextStatement++;
     _singleEndData[start + 1] = _indexNextStatement;
   } else {
@@ -1612,7 +1612,7 @@ double Script::variableAsDouble(const std::string &name, bool quiet) {
     } else if (name == "$(__column0)") {
       rc = buffer->position(position)._columnIndex;
     } else if (name == "$(__lines)") {
-      rc = buffer->lines().size();
+      rc = buffer->countLines();
     } else if (name == "$(__position)") {
     } else if (name == "$(__mark)") {
     } else if (name == "$(__start)") {
@@ -1666,7 +1666,7 @@ std::string Script::variableAsString(const std::string &name, bool quiet) {
       } else if (key == "$(__column)") {
         rc = formatCString("%d", buffer->position(position)._columnIndex);
       } else if (key == "$(__lines)") {
-        rc = formatCString("%d", buffer->lines().size());
+        rc = formatCString("%d", buffer->countLines());
       } else if (key == "$(__position)") {
         buffer->position(position);
         rc = formatCString("%ld:%ld", position._lineIndex + 1,
@@ -100,7 +100,7 @@ void SearchEngine::loadScript(const char *scriptName, const char *filename) {
   if (_scripts.find(scriptName) != _scripts.end()) {
     throw InternalError(formatCString("script already loaded: %s", scriptName));
   }
-  script->readFromFile(filename, true);
+  script->readFromFile(filename);
   _scripts[scriptName] = script;
 }
 
@@ -193,6 +193,9 @@ int SearchEngine::testAndRun(const char *scriptName) {
   } catch (...) {
     _logger.say(LV_ERROR, "unknown exception");
   }
+  if (_trace != nullptr) {
+    fprintf(_trace, "= %s\n", RegexCache::instance()->statistics().c_str());
+  }
   return rc;
 }
 bool SearchEngine::variableExists(const char *name) {
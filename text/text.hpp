@@ -15,9 +15,13 @@
 #include "Base64.hpp"
 #include "StringList.hpp"
 #include "Matcher.hpp"
+#include "RegexPrefilter.hpp"
+#include "RegexEngine.hpp"
+#include "RegexCache.hpp"
 #include "LineReader.hpp"
 #include "LinesStream.hpp"
 #include "NodeJson.hpp"
+#include "LineArena.hpp"
 #include "LineList.hpp"
 #include "Parser.hpp"
 #include "ParserError.hpp"
@@ -248,6 +248,34 @@ int Argument::asNat(size_t index) const {
 }
 
 std::regex Argument::asRegExpr(size_t index) const {
+  std::string pattern;
+  std::string flags;
+  regExprParts(index, pattern, flags);
+  std::regex_constants::syntax_option_type flags2 =
+      std::regex_constants::ECMAScript;
+  if (!flags.empty()) {
+    if (strchr(flags.c_str(), 'i') != nullptr) {
+      flags2 |= std::regex_constants::icase;
+    }
+#ifdef MULTILINE_KNOWN
+    if (strchr(flags.c_str(), 'm') != nullptr) {
+      flags2 = std::regex::multiline
+    );
+  }
+#endif
+  }
+  std::regex rc(pattern, flags2);
+  return rc;
+}
+RegexEngine* Argument::asRegexEngine(size_t index) const {
+  std::string pattern;
+  std::string flags;
+  regExprParts(index, pattern, flags);
+  return RegexEngine::create(pattern.c_str(),
+      strchr(flags.c_str(), 'i') != nullptr);
+}
+void Argument::regExprParts(size_t index, std::string &pattern,
+    std::string &flags) const {
   DataType type = _parameter->dataType();
   if (type != DT_SIZE && type != DT_REGEXPR) {
     throw InternalError(
@@ -256,8 +284,6 @@ std::regex Argument::asRegExpr(size_t index) const {
   }
   const char *value = _values[index].c_str();
   char delimiter = value[0];
-  std::string pattern;
-  std::string flags;
   if (delimiter == '\0') {
     pattern = ".*";
   } else {
@@ -275,21 +301,6 @@ std::regex Argument::asRegExpr(size_t index) const {
       replaceString(pattern, ".", "\\B");
     }
   }
-  std::regex_constants::syntax_option_type flags2 =
-      std::regex_constants::ECMAScript;
-  if (!flags.empty()) {
-    if (strchr(flags.c_str(), 'i') != nullptr) {
-      flags2 |= std::regex_constants::icase;
-    }
-#ifdef MULTILINE_KNOWN
-    if (strchr(flags.c_str(), 'm') != nullptr) {
-      flags2 = std::regex::multiline
-    );
-  }
-#endif
-  }
-  std::regex rc(pattern, flags2);
-  return rc;
 }
 int64_t Argument::asSize(size_t index) const {
   checkIndex(index);
@@ -591,6 +602,18 @@ std::regex ArgumentParser::asRegExpr(const char *name, const char *defaultValue,
   return rc;
 }
 
+RegexEngine* ArgumentParser::asRegexEngine(const char *name,
+    const char *defaultValue, size_t index) const {
+  Argument *arg = findArgument(name);
+  RegexEngine *rc = nullptr;
+  if (arg != nullptr) {
+    rc = arg->asRegexEngine(index);
+  } else {
+    rc = RegexEngine::create(defaultValue == nullptr ? ".*" : defaultValue);
+  }
+  return rc;
+}
+
 int64_t ArgumentParser::asSize(const char *name, int64_t defaultValue,
     size_t index) const {
   Argument *arg = findArgument(name);
@@ -185,6 +185,7 @@ public:
   int
   asNat(size_t index = 0) const;
   std::regex asRegExpr(size_t index = 0) const;
+  RegexEngine* asRegexEngine(size_t index = 0) const;
   int64_t
   asSize(size_t index = 0) const;
   const std::string&
@@ -205,6 +206,8 @@ public:
 protected:
   void
   checkIndex(size_t index) const;
+  void
+  regExprParts(size_t index, std::string &pattern, std::string &flags) const;
 };
 void
 argumentReleaser(void *object);
@@ -318,6 +321,16 @@ public:
   std::regex
   asRegExpr(const char *name, const char *defaultValue = nullptr, size_t index =
       0) const;
+  /**
+   * Returns the current value of the program argument as search engine of a regular expression.
+   * @param name: the name of the argument.
+   * @param defaultValue: The pattern if the parameter is not in the program arguments.
+   * @param index: 0 or the index (when multiple values are allowed).
+   * @return The engine. Must be deleted by the caller.
+   */
+  RegexEngine*
+  asRegexEngine(const char *name, const char *defaultValue = nullptr,
+      size_t index = 0) const;
   /**
    * Returns the current value of the program argument as (file) size.
    * @param name: the name of the argument.
@@ -12,10 +12,17 @@ namespace cppknife {
 
 CommandHandler *CommandHandler::_lastInstance = nullptr;
 
-void addTraverserOptions(ArgumentParser &parser) {
-  parser.add("base", nullptr, DT_FILE_PATTERN,
-      "The start directory or a list of file patterns delimited by ',', first with path. Preceding '-' defines a NOT pattern",
-      ".", ".|/home/jonny/*.c,*.h,-*tmp*", true);
+/**
+ * Adds the options of a directory traversal.
+ * @param parser The options are added to that parser.
+ * @param withBase <em>false</em>: the start directory is defined by the caller.
+ */
+void addTraverserOptions(ArgumentParser &parser, bool withBase) {
+  if (withBase) {
+    parser.add("base", nullptr, DT_FILE_PATTERN,
+        "The start directory or a list of file patterns delimited by ',', first with path. Preceding '-' defines a NOT pattern",
+        ".", ".|/home/jonny/*.c,*.h,-*tmp*", true);
+  }
   parser.add("--files", "-f", DT_PATTERN,
       "Only files matching that patterns will be found", "*",
       ";*.cpp;*.hpp;-test*");
@@ -40,6 +47,21 @@ void addTraverserOptions(ArgumentParser &parser) {
   parser.add("--type", "-t", DT_STRING,
       "The file type: f(ile) d(irectory) l(ink) s(ocket) b(lock) p(ipe) c(har)",
       "", "f,d,l|d");
+  parser.add("--threads", "-j", DT_NAT,
+      "The count of threads scanning the directory tree or processing the files. 0: count of CPU cores",
+      "1", "1|8|0");
+  parser.add("--index", nullptr, DT_STRING,
+      "A file caching the directory tree: only directories with a changed modification time are read",
+      "", "/var/cache/fileknife/home.idx");
+  parser.add("--order", nullptr, DT_STRING,
+      "The traversal order: native (fastest) or the portable depth(-first) or breadth(-first)",
+      "native", "depth|breadth");
+  parser.add("--queue-memory", nullptr, DT_SIZE_INT,
+      "The maximal memory for the pending directories of the portable traversal. More is stored in a temporary file. Units: [kmgt]",
+      "16M", "100k|1G");
+  parser.add("--queue-depth", nullptr, DT_NAT,
+      "The count of asynchronous status requests (io_uring) in flight. 0: synchronous status requests",
+      "0", "64|256");
 }
 
 /**
@@ -115,14 +137,89 @@ void populateFilter(const ArgumentParser &parser, DirEntryFilter &filter) {
     filter._pathPatterns = new PatternList();
     filter._pathPatterns->set(stringValue, -1, true, ",");
   }
+  filter.compile();
+}
+/**
+ * Takes the traverser settings from the program arguments.
+ * @param parser Contains the program arguments.
+ * @param traverser: OUT: The traverser to configure.
+ */
+void populateTraverser(const ArgumentParser &parser, Traverser &traverser) {
+  traverser.setThreadCount(parser.asInt("threads", 1));
+  auto order = parser.asString("order", "native");
+  if (startsWith(order, -1, "depth")) {
+    traverser.setTraversalOrder(Traverser::TO_DEPTH_FIRST,
+        parser.asSize("queue-memory", 0));
+  } else if (startsWith(order, -1, "breadth")) {
+    traverser.setTraversalOrder(Traverser::TO_BREADTH_FIRST,
+        parser.asSize("queue-memory", 0));
+  } else if (strcmp(order, "native") != 0) {
+    throw ArgumentException(
+        formatCString("unknown order: %s correct: native|depth|breadth",
+            order));
+  }
+  auto queueDepth = parser.asInt("queue-depth", 0);
+  if (queueDepth > 0) {
+    traverser.setAsyncStatus(queueDepth);
+  }
+  auto indexFile = parser.asString("index", "");
+  if (indexFile[0] != '\0') {
+    traverser.setIndexFile(indexFile);
+  }
+}
+FileOutput::FileOutput(Logger *logger) :
+    _logger(logger), _messages() {
+}
+void FileOutput::say(LogLevel level, const std::string &message) {
+  if (_logger != nullptr) {
+    _logger->say(level, message);
+  } else {
+    _messages.emplace_back(level, message);
+  }
+}
+void FileOutput::writeTo(Logger &logger) {
+  for (auto &message : _messages) {
+    logger.say(message.first, message.second);
+  }
+  _messages.clear();
 }
+
+/**
+ * @brief A file processed by a worker.
+ */
+class CommandHandler::FileJob {
+public:
+  std::string _filename;
+  FileSize_t _size;
+  FileOutput _output;
+  /// Protected by <em>CommandHandler::_jobMutex</em>.
+  bool _done;
+  /// The result of <em>processFile()</em>.
+  bool _continue;
+public:
+  FileJob(const char *filename, FileSize_t size) :
+      _filename(filename), _size(size), _output(), _done(false), _continue(
+          true) {
+  }
+};
+
 CommandHandler::CommandHandler(ArgumentParser &argumentParser, Logger *logger) :
     _argumentParser(argumentParser), _logger(logger), _filter(), _level(0), _status(
         nullptr), _traverser(nullptr, &_filter, nullptr, _logger), _processedFiles(
-        0) {
+        0), _filePool(nullptr), _unordered(false), _jobs(), _stopped(false), _discardOutput(
+        false), _jobMutex(), _jobDone(), _startDirectory(currentDirectory()) {
   _lastInstance = this;
 }
 CommandHandler::~CommandHandler() {
+  if (_filePool != nullptr) {
+    _filePool->waitIdle();
+    delete _filePool;
+    _filePool = nullptr;
+  }
+  for (auto job : _jobs) {
+    delete job;
+  }
+  _jobs.clear();
 }
 bool CommandHandler::check() {
   return true;
@@ -132,11 +229,39 @@ void CommandHandler::finish() {
 }
 void CommandHandler::initialize() {
   populateFilter(_argumentParser, _filter);
+  populateTraverser(_argumentParser, _traverser);
+  if (supportsConcurrency()) {
+    int threads = _argumentParser.asInt("threads", 1);
+    if (threads == 0) {
+      threads = ThreadPool::defaultThreadCount();
+    }
+    if (threads > 1 && _filePool == nullptr) {
+      _filePool = new ThreadPool(threads);
+    }
+    if (_filePool != nullptr) {
+      // The threads process the files: the traversal itself stays serial
+      // to keep the order of the output deterministic.
+      _traverser.setThreadCount(1);
+    }
+    _unordered = _argumentParser.asBool("unordered", false);
+  }
 }
 
+std::string CommandHandler::absoluteName() const {
+  const char *fullName = _status->fullName();
+  std::string rc =
+      fullName[0] == '/' ?
+          std::string(fullName) :
+          joinPath(_startDirectory.c_str(), fullName);
+  return rc;
+}
 bool CommandHandler::isValid() {
   return true;
 }
+bool CommandHandler::oneFile() {
+  FileOutput output(_logger);
+  return processFile(absoluteName().c_str(), _status->fileSize(), output);
+}
 
 int CommandHandler::run(const char *nameSources) {
   int rc = 0;
@@ -166,12 +291,21 @@ void CommandHandler::traverse(const char *nameSources) {
       base = base2.c_str();
     }
     if (!isDirectory(base, &exists) && exists) {
-      FsEntryLinux status(
-          *dynamic_cast<FileAgentLinux*>(_traverser.fileAgent()));
+      // The output of the files found before comes first:
+      waitForFiles();
+      auto agent = dynamic_cast<FileAgentLinux*>(_traverser.fileAgent());
+      FileAgentLinux *singleAgent = nullptr;
+      if (agent == nullptr) {
+        // The traverser works with another agent, e.g. the ParallelFileAgent:
+        agent = singleAgent = new FileAgentLinux(nullptr, &_filter, nullptr,
+            _logger, _traverser);
+      }
+      FsEntryLinux status(*agent);
       _status = &status;
       _status->setCertainFile(base);
       bool stop = !oneFile();
       _status->finishCertainFile();
+      delete singleAgent;
       if (stop) {
         break;
       }
@@ -186,12 +320,87 @@ void CommandHandler::traverse(const char *nameSources) {
         std::string format;
         if (isValid()) {
           _processedFiles++;
-          if (!oneFile()) {
+          if (_filePool != nullptr) {
+            submitFile();
+            if (_stopped) {
+              break;
+            }
+          } else if (!oneFile()) {
             break;
           }
         }
       }
+      if (_stopped) {
+        break;
+      }
+    }
+  }
+  waitForFiles();
+}
+void CommandHandler::submitFile() {
+  auto job = new FileJob(absoluteName().c_str(), _status->fileSize());
+  {
+    std::lock_guard<std::mutex> guard(_jobMutex);
+    _jobs.push_back(job);
+  }
+  _filePool->submit([this, job]() {
+    if (!_stopped) {
+      job->_continue = processFile(job->_filename.c_str(), job->_size,
+          job->_output);
+      if (!job->_continue) {
+        _stopped = true;
+      }
+    }
+    {
+      std::lock_guard<std::mutex> guard(_jobMutex);
+      job->_done = true;
+    }
+    _jobDone.notify_all();
+  });
+  writeResults(false);
+  // The memory of the stored output is limited:
+  while (_jobs.size() >= MAX_PENDING_FILES) {
+    writeResults(true);
+  }
+}
+void CommandHandler::waitForFiles() {
+  if (_filePool != nullptr) {
+    _filePool->waitIdle();
+    writeResults(false);
+  }
+}
+/**
+ * Writes the output of the finished files.
+ * @param wait <em>true</em>: waits until at least one output is written.
+ */
+void CommandHandler::writeResults(bool wait) {
+  std::unique_lock<std::mutex> lock(_jobMutex);
+  while (true) {
+    bool written = false;
+    for (auto it = _jobs.begin(); it != _jobs.end();) {
+      FileJob *job = *it;
+      if (!job->_done) {
+        if (!_unordered) {
+          // Ordered output: the following files must wait.
+          break;
+        }
+        ++it;
+      } else {
+        if (!_discardOutput) {
+          job->_output.writeTo(*_logger);
+          // Files behind the stopping file would not have been processed:
+          _discardOutput = !job->_continue;
+        }
+        delete job;
+        it = _jobs.erase(it);
+        written = true;
+      }
+    }
+    if (!wait || written || _jobs.empty()) {
+      break;
     }
+    // Timed: std::condition_variable::wait() requires GLIBCXX_3.4.30.
+    _jobDone.wait_for(lock, std::chrono::milliseconds(100));
   }
 }
 }
@@ -14,13 +14,50 @@
 
 namespace cppknife {
 
+/**
+ * @brief The messages of one file.
+ *
+ * If the files are processed by workers the messages are stored and written later
+ * by the main thread, in traversal order.
+ */
+class FileOutput {
+protected:
+  /// <em>nullptr</em>: the messages are stored. Otherwise: the messages are written immediately.
+  Logger *_logger;
+  std::vector<std::pair<LogLevel, std::string>> _messages;
+public:
+  FileOutput(Logger *logger = nullptr);
+public:
+  /**
+   * Writes or stores a message.
+   * @param level The log level of the message.
+   * @param message The message to write.
+   */
+  void say(LogLevel level, const std::string &message);
+  /**
+   * Writes the stored messages and removes them.
+   * @param logger The target of the messages.
+   */
+  void writeTo(Logger &logger);
+};
+
 /**
  * @brief A base class for handlers implementing a sub command.
+ *
+ * If the handler supports concurrency (see <em>supportsConcurrency()</em>) and the option
+ * <em>--threads</em> is greater than 1 the files found by the traverser are processed
+ * by workers calling <em>processFile()</em>. The output of the files is written in traversal order,
+ * with the option <em>--unordered</em> as soon as it is available.
  */
 class CommandHandler {
 public:
   static CommandHandler *_lastInstance;
+  enum {
+    /// More files are not processed ahead of the oldest unfinished file.
+    MAX_PENDING_FILES = 1024
+  };
 protected:
+  class FileJob;
   ArgumentParser &_argumentParser;
   Logger *_logger;
   DirEntryFilter _filter;
@@ -28,6 +65,19 @@ protected:
   FsEntry *_status;
   Traverser _traverser;
   int _processedFiles;
+  /// <em>nullptr</em> or the workers processing the files.
+  ThreadPool *_filePool;
+  bool _unordered;
+  /// The submitted files in traversal order whose output is not written yet.
+  std::deque<FileJob*> _jobs;
+  /// Set by a worker if <em>processFile()</em> requests the end of the traversal.
+  std::atomic<bool> _stopped;
+  /// <em>true</em>: the output of the file requesting the stop has been written.
+  bool _discardOutput;
+  std::mutex _jobMutex;
+  std::condition_variable _jobDone;
+  /// The current directory at the start: the traverser may change the current directory.
+  std::string _startDirectory;
 public:
   CommandHandler(ArgumentParser &argumentParser, Logger *logger);
   virtual ~CommandHandler();
@@ -59,30 +109,56 @@ public:
   }
   /**
    * Does the things for one file.
+   * The default implementation calls <em>processFile()</em> for the current file.
+   * @return <em>false</em>: the traversal should be stopped.
    */
-  virtual bool oneFile() = 0;
+  virtual bool oneFile();
   /**
    * Returns the number of processed files.
    */
   inline int processedFiles() const {
     return _processedFiles;
   }
+  /**
+   * Processes one file. Must be thread safe if <em>supportsConcurrency()</em> returns <em>true</em>.
+   * @param filename The name of the file.
+   * @param size The size of the file.
+   * @param output The messages of the file must be written there.
+   * @return <em>false</em>: the traversal should be stopped.
+   */
+  virtual bool processFile(const char *filename, FileSize_t size,
+      FileOutput &output) = 0;
   /**
    * Runs the command: Initialization, traversion and finishing.
    * @param nameSources The variable name defining the source files/directories.
    * @return The exit code: 0: success
    */
   int run(const char *nameSources);
+  /**
+   * Returns whether <em>processFile()</em> may be called by multiple workers.
+   */
+  virtual bool supportsConcurrency() const {
+    return false;
+  }
   /**
    * Traverses the file tree and call the user defined method <em>oneFile</em> for all selected files.
    * @param nameSources The name (in argument parser) for the argument defining the files to handle.
    */
   virtual void traverse(const char *nameSources);
+protected:
+  /**
+   * Returns the name of the current file usable independently of the current directory.
+   */
+  std::string absoluteName() const;
+  void submitFile();
+  void waitForFiles();
+  void writeResults(bool wait);
 }
 ;
 
-void addTraverserOptions(ArgumentParser &parser);
+void addTraverserOptions(ArgumentParser &parser, bool withBase = true);
 void populateFilter(const ArgumentParser &parser, DirEntryFilter &filter);
+void populateTraverser(const ArgumentParser &parser, Traverser &traverser);
 }
 
 #endif /* TOOLS_TOOLSCOMMONS_HPP_ */
@@ -23,6 +23,7 @@ int du(ArgumentParser &parser, Logger &logger) {
   populateFilter(parser, filter);
   FsEntry *status;
   Traverser traverser(".", &filter, nullptr, &logger);
+  populateTraverser(parser, traverser);
   auto count = parser.countValuesOf("base");
   bool baseIsPattern = false;
   for (size_t ix = 0; ix < count; ix++) {
@@ -48,57 +49,162 @@ int du(ArgumentParser &parser, Logger &logger) {
   return 0;
 }
 
-class Extrema {
-public:
-  Extrema(const char *name, bool reverse, size_t maxCount) :
-      _name(name), _list(), _maxCount(maxCount), _reverse(reverse) {
-    _list.reserve(maxCount);
-  }
-public:
-  void addIfNeeded(const char *data) {
-    if (_list.size() >= _maxCount) {
-      _list.erase(_list.begin());
+/**
+ * Manages the "dedup" sub command: finds files with identical content.
+ * @param parser Contains the program argument info.
+ * @param logger Manages the output.
+ */
+int dedup(ArgumentParser &parser, Logger &logger) {
+  DirEntryFilter filter;
+  int level = 0;
+  populateFilter(parser, filter);
+  filter._types = FsEntry::TF_REGULAR;
+  FsEntry *status;
+  Traverser traverser(".", &filter, nullptr, &logger);
+  populateTraverser(parser, traverser);
+  // The threads hash the files, the traversal stays sequential:
+  int threads = parser.asInt("threads", 1);
+  traverser.setThreadCount(1);
+  traverser.setLazyStatus(STATX_TYPE | STATX_SIZE);
+  DuplicateFinder finder(&logger, threads);
+  // The traverser may change the current directory: relative names are not usable by the threads.
+  std::string startDirectory = currentDirectory();
+  auto count = parser.countValuesOf("base");
+  bool baseIsPattern = false;
+  for (size_t ix = 0; ix < count; ix++) {
+    if (baseIsPattern) {
+      delete filter._nodePatterns;
+      filter._nodePatterns = nullptr;
     }
-    _list.push_back(data);
-    sort(_list.begin(), _list.end());
-  }
-  bool isExtrema(const char *data) {
-    bool rc = true;
-    if (_list.size() >= _maxCount) {
-      rc =
-          _reverse ?
-              strcmp(data, _list.back().c_str()) < 0 :
-              strcmp(data, _list.front().c_str()) > 0;
-    }
-    return rc;
-  }
-  void show(Logger &logger, bool isDate) {
-    logger.say(LV_INFO, formatCString("=== %s", _name));
-    if (_reverse) {
-      std::reverse(_list.begin(), _list.end());
-    }
-    for (auto entry : _list) {
-      auto parts = splitCString(entry.c_str(), "\t");
-      int64_t value = atoll(parts[0].c_str());
-      if (isDate) {
-        FileTime_t time2;
-        setFiletime(time2, value, 0);
-        auto time3 = filetimeToString(time2);
-        logger.say(LV_INFO,
-            formatCString("%s %s", time3.c_str(), parts[1].c_str()).c_str());
+    auto base = parser.asString("base", ".", ix);
+    if (strchr(base, ',') == nullptr) {
+      traverser.changeBase(base);
+    } else {
+      traverser.changeBaseByPatterns(base, filter);
+      baseIsPattern = true;
+    }
+    while ((status = traverser.nextFile(level)) != nullptr) {
+      const char *fullName = status->fullName();
+      if (fullName[0] == '/') {
+        finder.add(fullName, status->fileSize());
       } else {
+        finder.add(joinPath(startDirectory.c_str(), fullName).c_str(),
+            status->fileSize());
+      }
+    }
+  }
+  char buffer[8192];
+  finder.find([&logger, &buffer](const DuplicateFinder::Group &group) {
+    logger.say(LV_INFO,
+        formatOnBuffer(buffer, sizeof buffer, "=== %d x %.6f MB",
+            static_cast<int>(group._files.size()), group._size / 1E6));
+    for (auto file : group._files) {
+      logger.say(LV_INFO, file);
+    }
+  });
+  logger.say(LV_SUMMARY,
+      formatOnBuffer(buffer, sizeof buffer,
+          "= %d group(s) %d duplicate(s) %.6f MB wasted %.6f MB hashed %.6f MB compared %d error(s)",
+          static_cast<int>(finder.groups()),
+          static_cast<int>(finder.duplicates()), finder.wastedBytes() / 1E6,
+          finder.hashedBytes() / 1E6, finder.comparedBytes() / 1E6,
+          static_cast<int>(finder.errors())));
+  std::string info;
+  info.reserve(1024);
+  appendString(info, "= ");
+  logger.say(LV_SUMMARY, traverser.statisticAsString(info, true));
+  return 0;
+}
+
+/**
+ * Manages the "sync" sub command: copies the changed files of a directory tree.
+ * @param parser Contains the program argument info.
+ * @param logger Manages the output.
+ */
+int sync(ArgumentParser &parser, Logger &logger) {
+  auto source = parser.asString("source");
+  auto target = parser.asString("target");
+  DirEntryFilter filter;
+  populateFilter(parser, filter);
+  FileSyncer syncer(&logger, parser.asInt("threads", 1),
+      parser.asBool("dry-run"));
+  int rc = syncer.sync(source, target, &filter) ? 0 : 1;
+  logger.say(LV_SUMMARY, "= " + syncer.statisticAsString());
+  return rc;
+}
+
+/**
+ * Manages the "watch" sub command: shows the changes of a directory tree.
+ * @param parser Contains the program argument info.
+ * @param logger Manages the output.
+ */
+int watch(ArgumentParser &parser, Logger &logger) {
+  auto base = parser.asString("base");
+  auto interval = parser.asInt("interval", 10);
+  auto count = parser.asInt("count", 0);
+  TreeWatcher watcher(&logger);
+  int rc = 0;
+  char buffer[512];
+  if (!watcher.start(base)) {
+    rc = 1;
+  } else {
+    DirTreeStatistic last = watcher.statistic();
+    logger.say(LV_SUMMARY,
+        formatOnBuffer(buffer, sizeof buffer,
+            "= start: files: %d dirs: %d MB: %.6f", last._files,
+            last._directories, last._sizes / 1E6));
+    for (int ix = 0; count == 0 || ix < count; ix++) {
+      double end = nowAsDouble() + interval;
+      double rest;
+      do {
+        rest = end - nowAsDouble();
+        watcher.poll(rest <= 0 ? 0 : static_cast<int>(rest * 1000));
+      } while (rest > 0);
+      auto &current = watcher.statistic();
+      if (current._files != last._files || current._sizes != last._sizes
+          || current._directories != last._directories) {
+        FileTime_t now;
+        setFiletime(now, time(nullptr), 0);
+        char timeBuffer[64];
         logger.say(LV_INFO,
-            formatCString("%13.6f MB %s", static_cast<double>(value / 1E6),
-                parts[1].c_str()).c_str());
+            formatOnBuffer(buffer, sizeof buffer,
+                "%s files: %d (%+d) dirs: %d (%+d) MB: %.6f (%+.6f)",
+                filetimeToString(now, timeBuffer, sizeof timeBuffer),
+                current._files, current._files - last._files,
+                current._directories, current._directories - last._directories,
+                current._sizes / 1E6, (current._sizes - last._sizes) / 1E6));
+        last = current;
       }
     }
   }
-protected:
-  const char *_name;
-  std::vector<std::string> _list;
-  size_t _maxCount;
-  bool _reverse;
-};
+  return rc;
+}
+
+/**
+ * Shows the records of one extremum.
+ * @param logger The logging manager.
+ * @param title The name of the extremum.
+ * @param extrema The collector.
+ * @param heap The heap with the records to show.
+ * @param isDate <em>true</em>: the key is a file time. Otherwise: the key is a file size.
+ */
+static void showExtremum(Logger &logger, const char *title,
+    const FileExtrema &extrema, const ExtremaHeap &heap, bool isDate) {
+  logger.say(LV_INFO, formatCString("=== %s", title));
+  for (auto &record : heap.sorted()) {
+    if (isDate) {
+      FileTime_t time2;
+      setFiletime(time2, record._key, 0);
+      auto time3 = filetimeToString(time2);
+      logger.say(LV_INFO,
+          formatCString("%s %s", time3.c_str(), extrema.path(record)).c_str());
+    } else {
+      logger.say(LV_INFO,
+          formatCString("%13.6f MB %s", static_cast<double>(record._key / 1E6),
+              extrema.path(record)).c_str());
+    }
+  }
+}
 
 void examples() {
   printf(
@@ -107,6 +213,11 @@ fileknife du /home --directories=-.git
 # Ignore all .git directories, show only *.cpp and *.hpp files without the test file:
 fileknife du --files=,*.cpp,*.hpp,-*test.?pp /home
 
+# Find the files with identical content in /srv/data and /home, hashing with 8 threads, ignoring files smaller than 1 MByte:
+fileknife dedup --threads=8 --size=+1M /srv/data /home
+# Find identical images:
+fileknife dedup /home/jonny/*.jpg,*.png --directories=,-.cache
+
 # Show the 20 youngest, newest, largest files from /etc.
 fileknife extrema /etc
 # Show the 5 youngest, newest directories and symbolic links from /var/spool.
@@ -118,9 +229,25 @@ fileknife list '/var/log/*.log,*.gz' --days=+30 --size=+5k
 fileknife list --files=,*.html,-index.html --max-depth=3 --minutes=+5 /srv/www
 # Show only the filename without attributes: larger than 1GByte, the *.deb and *.zip and *.gz files. 
 fileknife list --name-only --size=+1G /opt/downloads/*.deb,*.zip,*.gz
+# Store all entries of /home in the compact binary format for post processing:
+fileknife list --format=binary --output=/tmp/home.bin /home
 
 # Count the lines, words and characters of all source files without the generated files in build:
 fileknife wc /home/ws/cpp/*.cpp,*.hpp --directories=,-build
+# Show the disk usage of a large tree scanning the directories with 16 threads:
+fileknife du --threads=16 /srv/nfs
+# Show the disk usage of a large tree every hour: only the changed directories are read again:
+fileknife du --index=/var/cache/fileknife/archive.idx /srv/archive
+# Store the files with another owner/group than their directory as text and binary file, scanning with 8 threads:
+fileknife owner --threads=8 --binary=/var/audit/owners.bin /srv /var/audit/owners.txt
+
+# Copy the changed files of /home/jonny into /media/backup/jonny with 4 threads, ignoring the .cache directories:
+fileknife sync --threads=4 --directories=,-.cache /home/jonny /media/backup/jonny
+# Show the files that would be copied:
+fileknife sync --dry-run --log-level=4 /srv/www /srv/www.copy
+
+# Show the growth of /var/log every minute:
+fileknife watch --interval=60 /var/log
 )""");
 }
 /**
@@ -135,11 +262,14 @@ int extrema(ArgumentParser &parser, Logger &logger) {
   populateFilter(parser, filter);
   FsEntry *status;
   Traverser traverser(base, &filter, nullptr, &logger);
-  char message[8192];
+  populateTraverser(parser, traverser);
   auto count = parser.asInt("count");
-  Extrema largest("largest", false, count);
-  Extrema youngest("youngest", false, count);
-  Extrema oldest("oldest", true, count);
+  auto indexed = dynamic_cast<IndexedFileAgent*>(traverser.fileAgent());
+  if (indexed != nullptr) {
+    // Only the extrema candidates of the directories are needed:
+    indexed->setCandidatesOnly(count);
+  }
+  FileExtrema extrema(count);
   auto countPatterns = parser.countValuesOf("base");
   bool baseIsPattern = false;
   for (size_t ix = 0; ix < countPatterns; ix++) {
@@ -155,196 +285,59 @@ int extrema(ArgumentParser &parser, Logger &logger) {
       baseIsPattern = true;
     }
     while ((status = traverser.nextFile(level)) != nullptr) {
-      std::string format;
-      auto fileName = status->fullName();
-      formatOnBuffer(message, sizeof message, "%012lld\t%s",
-          status->modified()->tv_sec, fileName);
-      if (youngest.isExtrema(message)) {
-        youngest.addIfNeeded(message);
-      }
-      if (oldest.isExtrema(message)) {
-        oldest.addIfNeeded(message);
-      }
-      if (status->isRegular()) {
-        formatOnBuffer(message, sizeof message, "%012lld\t%s",
-            status->fileSize(), fileName);
-        if (largest.isExtrema(message)) {
-          largest.addIfNeeded(message);
-        }
-      }
+      extrema.add(*status);
     }
   }
-  largest.show(logger, false);
-  oldest.show(logger, true);
-  youngest.show(logger, true);
+  showExtremum(logger, "largest", extrema, extrema.largest(), false);
+  showExtremum(logger, "oldest", extrema, extrema.oldest(), true);
+  showExtremum(logger, "youngest", extrema, extrema.youngest(), true);
   std::string info;
   info.reserve(1024);
   appendString(info, "= ");
   logger.say(LV_SUMMARY, traverser.statisticAsString(info, true));
   return 0;
 }
-class OwnerInfo {
-private:
-  Logger &_logger;
-  FILE *_output;
-  int _countFiles;
-  int _countDirs;
-  int _countErrors;
-  std::set<int> _uids;
-  std::set<int> _gids;
-public:
-  OwnerInfo(Logger &logger, FILE *output);
-public:
-  inline int countDirs() const {
-    return _countDirs;
-  }
-  inline int countErrors() const {
-    return _countErrors;
-  }
-  inline int countFiles() const {
-    return _countFiles;
-  }
-  inline int countGids() const {
-    return _gids.size();
-  }
-  inline int countUids() const {
-    return _uids.size();
-  }
-  void finish();
-  void oneDir(const char *path, int uid, int gid);
-  inline void storeUid(int uid) {
-    _uids.insert(uid);
-  }
-  inline void storeGid(int gid) {
-    _gids.insert(gid);
-  }
-};
-OwnerInfo::OwnerInfo(Logger &logger, FILE *output) :
-    _logger(logger), _output(output), _countFiles(0), _countDirs(0), _countErrors(
-        9), _uids(), _gids() {
-}
-
-void OwnerInfo::finish() {
-  for (std::set<int>::iterator it = _uids.cbegin(); it != _uids.cend(); it++) {
-    struct passwd *info = getpwuid(*it);
-    const char *name = info == nullptr ? "?" : info->pw_name;
-    fprintf(_output, "u%d %s\n", *it, name);
-  }
-  for (std::set<int>::iterator it = _gids.cbegin(); it != _gids.cend(); it++) {
-    struct group *info = getgrgid(*it);
-    const char *name = info == nullptr ? "?" : info->gr_name;
-    fprintf(_output, "g%d %s\n", *it, name);
-  }
-  fclose(_output);
-  _output = nullptr;
-}
-void OwnerInfo::oneDir(const char *path, int uid, int gid) {
-  size_t length = strlen(path);
-  char fullName[8192];
-  storeUid(uid);
-  storeGid(gid);
-  if (length + 256 >= sizeof fullName) {
-    _logger.say(LV_DETAIL,
-        formatCString("path too long (%d): %s", length, path));
-  } else {
-    bool directoryIsWritten = false;
-    struct stat statInfo;
-    DIR *handle = opendir(path);
-    if (handle == nullptr) {
-      _logger.say(LV_DETAIL, formatCString("opendir() failed: %s", fullName));
-      ++_countErrors;
-    } else {
-      struct dirent *data = nullptr;
-      copyNCString(fullName, sizeof fullName, path, length);
-      char *start = fullName + length;
-      length++;
-      size_t restLength = sizeof fullName - length - 1;
-      *start++ = '/';
-      // detect files with other owner/group than the directory:
-      while ((data = readdir(handle)) != nullptr) {
-        if (data->d_name[0] == '.'
-            && (data->d_name[1] == 0
-                || (data->d_name[1] == '.') && (data->d_name[2] == 0))) {
-          continue;
-        }
-        copyNCString(start, restLength, data->d_name);
-        if (lstat(fullName, &statInfo) != 0) {
-          _logger.say(LV_DETAIL, formatCString("lstat failed: %s", fullName));
-          ++_countErrors;
-        } else {
-          if (data->d_type == DT_DIR) {
-            _countDirs++;
-          } else {
-            _countFiles++;
-          }
-          bool differentUid = statInfo.st_uid != uid;
-          bool differentGid = statInfo.st_gid != gid;
-          if (differentUid || differentGid) {
-            if (!directoryIsWritten) {
-              fprintf(_output, "=%d %d %s\n", uid, gid, path);
-              directoryIsWritten = true;
-            }
-            if (differentUid) {
-              storeUid(statInfo.st_uid);
-            }
-            if (differentGid) {
-              storeGid(statInfo.st_gid);
-            }
-            fprintf(_output, "%d %d %s\n", statInfo.st_uid, statInfo.st_gid,
-                data->d_name);
-          }
-        }
-      }
-      // detect the sub directories for recursive call:
-      rewinddir(handle);
-      while ((data = readdir(handle)) != nullptr) {
-        if (data->d_name[0] == '.'
-            && (data->d_name[1] == 0
-                || (data->d_name[1] == '.') && (data->d_name[2] == 0))) {
-          continue;
-        }
-        if (data->d_type == DT_DIR) {
-          copyNCString(start, restLength, data->d_name);
-          if (lstat(fullName, &statInfo) != 0) {
-            _logger.say(LV_DETAIL, formatCString("lstat failed: %s", fullName));
-            ++_countErrors;
-          } else {
-            oneDir(fullName, statInfo.st_uid, statInfo.st_gid);
-          }
-        }
-      }
-      closedir(handle);
-    }
-  }
-}
-
+/**
+ * Manages the "owner" sub command.
+ * @param parser Contains the program argument info.
+ * @param logger Manages the output.
+ */
 int owner(ArgumentParser &parser, Logger &logger) {
   auto base = parser.asString("directory");
   auto outputFile = parser.asString("target");
+  auto binaryFile = parser.asString("binary");
   struct stat statInfo;
-  int errors = 0;
-  int countFiles = 0;
-  int countDirs = 0;
-  lstat(base, &statInfo);
-  if (!S_ISDIR(statInfo.st_mode)) {
+  if (lstat(base, &statInfo) != 0 || !S_ISDIR(statInfo.st_mode)) {
     logger.say(LV_ERROR, formatCString("not a directory: %s\n", base));
   } else {
-    int level = 0;
     FILE *output = fopen(outputFile, "w");
+    FILE *binaryOutput =
+        binaryFile[0] == '\0' ? nullptr : fopen(binaryFile, "wb");
     if (output == nullptr) {
       logger.say(LV_ERROR,
           formatCString("cannot open (for writing): %s (%d)", outputFile,
           errno));
+    } else if (binaryFile[0] != '\0' && binaryOutput == nullptr) {
+      logger.say(LV_ERROR,
+          formatCString("cannot open (for writing): %s (%d)", binaryFile,
+          errno));
     } else {
-      fprintf(output, "=%d %d %s\n", statInfo.st_uid, statInfo.st_gid, base);
-      OwnerInfo info(logger, output);
-      info.oneDir(base, statInfo.st_uid, statInfo.st_gid);
-      info.finish();
+      OwnerScanner scanner(&logger, output, binaryOutput,
+          parser.asInt("threads", 1));
+      scanner.scan(base);
+      scanner.finish();
       logger.say(LV_SUMMARY,
           formatCString(
-              "%d files in %d directories with %d errors %d uids %d gids",
-              info.countFiles(), info.countDirs(), info.countErrors(),
-              info.countUids(), info.countGids()));
+              "%ld files in %ld directories with %ld errors %d uids %d gids",
+              scanner.countFiles(), scanner.countDirs(), scanner.countErrors(),
+              static_cast<int>(scanner.countUids()),
+              static_cast<int>(scanner.countGids())));
+    }
+    if (output != nullptr) {
+      fclose(output);
+    }
+    if (binaryOutput != nullptr) {
+      fclose(binaryOutput);
     }
   }
   return 0;
@@ -422,6 +415,57 @@ const char* wcOutput(const char *format, char *buffer, size_t bufferSize,
   *endOfBuffer = '\0';
   return buffer;
 }
+/**
+ * The result of counting one file in the "wc" sub command.
+ */
+class WcResult {
+public:
+  std::string _fullName;
+  /// The name for opening the file: absolute in the multithreaded mode.
+  std::string _accessName;
+  WordCounter _counter;
+  bool _valid;
+  std::atomic<bool> _done;
+public:
+  WcResult(const char *fullName, const char *accessName) :
+      _fullName(fullName), _accessName(accessName), _counter(), _valid(
+          false), _done(false) {
+  }
+};
+/**
+ * Counts a large file in parallel: the chunks of the file are counted by the pool.
+ * @param pool The workers counting the chunks.
+ * @param result IN/OUT: the file to count and the result.
+ * @param fileSize The size of the file.
+ * @param logger The logger.
+ * @return <em>false</em>: the file cannot be split (e.g. compressed): it must be counted sequentially.
+ */
+static bool countChunked(ThreadPool &pool, WcResult &result, size_t fileSize,
+    Logger &logger) {
+  // Binary data is detected by the counter: '\0' in the whole file.
+  ChunkedFile file(result._accessName.c_str(), &logger, false);
+  bool rc = file.split(ChunkedFile::chunkSizeFor(fileSize, pool.countThreads()));
+  if (rc) {
+    std::vector<WordCounter> counters(file.chunks().size());
+    result._counter.reset();
+    result._valid = file.process(pool,
+        [&counters](FileChunk &chunk, LineAgent &agent) {
+          auto &counter = counters[chunk._index];
+          const char *block;
+          size_t length = 0;
+          // The counter does not need lines: the mapped blocks are counted directly.
+          while (!counter._hasBinaryData
+              && (block = agent.nextBlock(length)) != nullptr) {
+            counter.count(block, length);
+          }
+          counter.finish();
+        }, [&counters, &result](FileChunk &chunk) {
+          result._counter.add(counters[chunk._index]);
+          return !result._counter._hasBinaryData;
+        });
+  }
+  return rc;
+}
 /**
  * Manages the "wc" (Word Count) sub command.
  * @param parser Contains the program argument info.
@@ -434,11 +478,7 @@ int wc(ArgumentParser &parser, Logger &logger) {
   filter._types = FsEntry::TC_TEXT;
   FsEntry *status;
   char buffer[8192];
-  LineList lines(8128);
-  LineAgent lineAgent(&logger);
-  size_t length = 0;
-  const char *line;
-  const char *wordSeparators = " \t";
+  const size_t readBufferSize = 256 * 1024;
   size_t bytesTotal = 0;
   size_t wordsTotal = 0;
   size_t linesTotal = 0;
@@ -458,9 +498,43 @@ int wc(ArgumentParser &parser, Logger &logger) {
       format = "%l %w %b %f";
     }
   }
-  bool countWords = strstr(format, "%w") != nullptr;
-
   Traverser traverser(".", &filter, nullptr, &logger);
+  populateTraverser(parser, traverser);
+  // The threads count the files, the traversal stays sequential: the output order is deterministic.
+  int threads = parser.asInt("threads", 1);
+  if (threads == 0) {
+    threads = ThreadPool::defaultThreadCount();
+  }
+  traverser.setThreadCount(1);
+  ThreadPool *pool = threads > 1 ? new ThreadPool(threads) : nullptr;
+  std::string startDirectory = currentDirectory();
+  std::vector<std::string> readBuffers(threads > 1 ? threads : 1);
+  for (auto &readBuffer : readBuffers) {
+    readBuffer.resize(readBufferSize);
+  }
+  // The results in traversal order. A deque: the addresses of the elements are stable.
+  std::deque<WcResult> results;
+  size_t nextOutput = 0;
+  auto output = [&](bool all) {
+    while (nextOutput < results.size()
+        && (all || results[nextOutput]._done.load(std::memory_order_acquire))) {
+      auto &result = results[nextOutput++];
+      if (result._valid) {
+        auto &counter = result._counter;
+        files++;
+        bytesTotal += counter._bytes;
+        wordsTotal += counter._words;
+        linesTotal += counter._lines;
+        if (counter._maxLength > maxLengthTotal) {
+          maxLengthTotal = counter._maxLength;
+        }
+        logger.say(LV_INFO,
+            wcOutput(format, buffer, sizeof buffer - 1, counter._lines,
+                counter._words, counter._bytes, counter._maxLength,
+                result._fullName.c_str()));
+      }
+    }
+  };
   auto count = parser.countValuesOf("base");
   bool baseIsPattern = false;
   for (size_t ix = 0; ix < count; ix++) {
@@ -476,47 +550,45 @@ int wc(ArgumentParser &parser, Logger &logger) {
       baseIsPattern = true;
     }
     while ((status = traverser.nextFile(level)) != nullptr) {
-      size_t bytes = 0;
-      size_t words = 0;
-      size_t lines = 0;
-      size_t maxLength = 0;
-      if (lineAgent.openFile(status->accessFullName())) {
-        bool abort = false;
-        while ((line = lineAgent.nextLine(length)) != nullptr) {
-          if (lineAgent.hasBinaryData()) {
-            abort = true;
-            break;
-          }
-          if (length > maxLength) {
-            maxLength = length;
-          }
-          lines++;
-          bytes += length + 1;
-          if (countWords) {
-            const char *ptr = line + strspn(line, wordSeparators);
-            size_t len = 0;
-            while ((len = strcspn(ptr, wordSeparators)) != 0) {
-              words++;
-              ptr += len;
-              ptr += strspn(ptr, wordSeparators);
-            }
-          }
+      if (pool == nullptr) {
+        results.emplace_back(status->fullName(), status->accessFullName());
+        WcResult *result = &results.back();
+        auto &readBuffer = readBuffers[0];
+        result->_valid = result->_counter.countFile(
+            result->_accessName.c_str(), &readBuffer[0], readBuffer.size());
+        output(true);
+      } else {
+        // The traverser may change the current directory: relative names are not usable by the threads.
+        const char *fullName = status->fullName();
+        if (fullName[0] == '/') {
+          results.emplace_back(fullName, fullName);
+        } else {
+          results.emplace_back(fullName,
+              joinPath(startDirectory.c_str(), fullName).c_str());
         }
-        if (!abort) {
-          files++;
-          bytesTotal += bytes;
-          wordsTotal += words;
-          linesTotal += lines;
-          if (maxLength > maxLengthTotal) {
-            maxLengthTotal = maxLength;
-          }
-          logger.say(LV_INFO,
-              wcOutput(format, buffer, sizeof buffer - 1, lines, words, bytes,
-                  maxLength, status->fullName()));
+        WcResult *result = &results.back();
+        // A large file is split and counted by all threads:
+        if (status->fileSize() >= 2 * ChunkedFile::MIN_CHUNK_SIZE
+            && countChunked(*pool, *result, status->fileSize(), logger)) {
+          result->_done.store(true, std::memory_order_release);
+          output(false);
+          continue;
         }
+        pool->submit([result, pool, &readBuffers] {
+          auto &readBuffer = readBuffers[pool->currentWorker()];
+          result->_valid = result->_counter.countFile(
+              result->_accessName.c_str(), &readBuffer[0], readBuffer.size());
+          result->_done.store(true, std::memory_order_release);
+        });
+        output(false);
       }
     }
   }
+  if (pool != nullptr) {
+    pool->waitIdle();
+    output(true);
+    delete pool;
+  }
   if (files > 0) {
     const char *titleSummary = "<summary>";
     logger.say(LV_INFO,
@@ -539,10 +611,45 @@ int list(ArgumentParser &parser, Logger &logger) {
   DirEntryFilter filter;
   int level = 0;
   populateFilter(parser, filter);
-  bool nameOnly = parser.asBool("nameOnly", false);
+  bool nameOnly = parser.asBool("name-only", false);
+  auto format = parser.asString("format", "text");
+  auto outputFile = parser.asString("output", "");
+  EntryWriter *writer = nullptr;
+  FILE *output = stdout;
+  if (strcmp(format, "text") != 0) {
+    bool binary = startsWith(format, -1, "binary");
+    if (!binary && !startsWith(format, -1, "ndjson")) {
+      throw ArgumentException(
+          formatCString("unknown format: %s correct: text|ndjson|binary",
+              format));
+    }
+    if (outputFile[0] != '\0'
+        && (output = fopen(outputFile, binary ? "wb" : "w")) == nullptr) {
+      logger.say(LV_ERROR,
+          formatCString("cannot open (for writing): %s (%d)", outputFile,
+          errno));
+      return 1;
+    }
+    if (binary) {
+      writer = new BinaryEntryWriter(output);
+    } else {
+      writer = new NdjsonEntryWriter(output);
+    }
+    nameOnly = false;
+  }
   FsEntry *status;
   Traverser traverser("", &filter, nullptr, &logger);
+  // The names are stored in arenas: no heap allocation per entry.
+  // No status info is needed for a name only output:
+  traverser.setLazyStatus(
+      nameOnly ? 0 :
+      writer == nullptr ?
+          STATX_TYPE | STATX_SIZE | STATX_MTIME :
+          STATX_TYPE | STATX_SIZE | STATX_MTIME | STATX_MODE | STATX_UID
+              | STATX_GID);
+  populateTraverser(parser, traverser);
   char buffer[8192];
+  char fileTime[32];
   auto count = parser.countValuesOf("base");
   bool baseIsPattern = false;
   for (size_t ix = 0; ix < count; ix++) {
@@ -559,36 +666,56 @@ int list(ArgumentParser &parser, Logger &logger) {
     }
     while ((status = traverser.nextFile(level)) != nullptr) {
       auto fileName = status->fullName();
-      if (nameOnly) {
+      if (writer != nullptr) {
+        writer->write(*status, level);
+      } else if (nameOnly) {
         logger.log(fileName);
       } else {
-        auto fileTime = status->filetimeAsString();
+        status->filetimeToBuffer(fileTime, sizeof fileTime);
         if (status->isDirectory()) {
           // 2022.10.22 12:44:49 2048.123456 MB /home/my.txt
           logger.log(
               formatOnBuffer(buffer, sizeof buffer, "d%s      directory %s",
-                  fileTime.c_str(), fileName));
+                  fileTime, fileName));
         } else if ((status->type() & (FsEntry::TF_LINK_DIR | FsEntry::TF_LINK))
             != 0) {
           logger.log(
               formatOnBuffer(buffer, sizeof buffer, "%c%s %11.6f MB %s -> %s",
-                  status->typeAsChar(), fileTime.c_str(),
-                  status->fileSize() / 1E6, fileName,
-                  status->linkReference().c_str()));
+                  status->typeAsChar(), fileTime, status->fileSize() / 1E6,
+                  fileName, status->linkTarget()));
         } else {
           logger.log(
               formatOnBuffer(buffer, sizeof buffer, "%c%s %11.6f MB %s",
-                  status->typeAsChar(), fileTime.c_str(),
-                  status->fileSize() / 1E6, fileName));
+                  status->typeAsChar(), fileTime, status->fileSize() / 1E6,
+                  fileName));
         }
       }
     }
   }
+  int rc = 0;
+  // The summary must not be mixed into the machine readable output:
+  auto summaryLevel = LV_SUMMARY;
+  if (writer != nullptr) {
+    writer->flush();
+    if (writer->error()) {
+      logger.say(LV_ERROR,
+          formatCString("cannot write the output (%d): %s", errno,
+              strerror(errno)));
+      rc = 1;
+    }
+    delete writer;
+    if (output != stdout) {
+      fclose(output);
+    } else {
+      summaryLevel = LV_DETAIL;
+    }
+  }
   std::string info;
   info.reserve(1024);
   appendString(info, "= ");
-  logger.say(LV_SUMMARY, traverser.statisticAsString(info, true));
-  return 0;
+  logger.say(summaryLevel, traverser.statisticAsString(info, true));
+  logger.say(LV_DETAIL, filter.program()->statisticAsString());
+  return rc;
 }
 
 int fileKnife(int argc, char **argv, Logger *loggerExtern) {
@@ -604,12 +731,19 @@ int fileKnife(int argc, char **argv, Logger *loggerExtern) {
       "5");
   parser.add("--verbose", "-v", DT_BOOL, "Show more information");
   parser.add("--examples", nullptr, DT_BOOL, "Show usage examples", "false");
-  parser.addMode("mode", "What should be done:", "du,extrema,list,owner,wc");
+  parser.addMode("mode", "What should be done:",
+      "dedup,du,extrema,list,owner,sync,watch,wc");
   ArgumentParser listParser("list", logger,
       "Lists specified files/directories");
   parser.addSubParser("mode", "list", listParser);
   listParser.add("--name-only", "-1", DT_BOOL,
       "Show only the filename, no other attributes");
+  listParser.add("--format", nullptr, DT_STRING,
+      "The output format: text, ndjson (one JSON object per line) or binary (fixed-width records)",
+      "text", "ndjson|binary");
+  listParser.add("--output", "-o", DT_STRING,
+      "The file for the ndjson or binary output. Default: stdout", "",
+      "/tmp/files.ndjson");
   addTraverserOptions(listParser);
   ArgumentParser extramaParser("extrema", logger,
       "Creates a statistic about the youngest/oldest/largest files");
@@ -624,7 +758,31 @@ int fileKnife(int argc, char **argv, Logger *loggerExtern) {
       "The generated file with the owner information.");
   ownerParser.add("--count", "-c", DT_NAT,
       "Maximal count of entries per extremum will be collected", "20", "5|100");
+  ownerParser.add("--binary", "-b", DT_STRING,
+      "An additional file with the owner information in the compact binary (delta encoded) format",
+      "", "/var/audit/owners.bin");
+  ownerParser.add("--threads", "-j", DT_NAT,
+      "The count of threads scanning the directory tree. 0: count of CPU cores",
+      "1", "1|8|0");
   parser.addSubParser("mode", "owner", ownerParser);
+  ArgumentParser syncParser("sync", logger,
+      "Copies the new and changed files of a directory tree into another directory");
+  syncParser.add("source", nullptr, DT_DIRECTORY, "The directory to copy.");
+  syncParser.add("target", nullptr, DT_STRING,
+      "The target directory. Will be created if needed.");
+  syncParser.add("--dry-run", "-n", DT_BOOL,
+      "Only show the files to copy (log level 4), nothing is copied");
+  addTraverserOptions(syncParser, false);
+  parser.addSubParser("mode", "sync", syncParser);
+  ArgumentParser watchParser("watch", logger,
+      "Scans a directory tree once, then shows the changes of files, directories and sizes");
+  watchParser.add("base", nullptr, DT_DIRECTORY, "The directory to watch.",
+      ".");
+  watchParser.add("--interval", "-i", DT_NAT,
+      "The count of seconds between two outputs", "10", "1|60");
+  watchParser.add("--count", "-c", DT_NAT,
+      "The count of outputs. 0: endless", "0", "0|24");
+  parser.addSubParser("mode", "watch", watchParser);
   addTraverserOptions(extramaParser);
   ArgumentParser wcParser("wc", logger, "Counts words, lines and characters");
   wcParser.add("--bytes", "-b", DT_BOOL, "Only count bytes", "F");
@@ -640,6 +798,10 @@ int fileKnife(int argc, char **argv, Logger *loggerExtern) {
           "<summary>", "=== summary");
   parser.addSubParser("mode", "wc", wcParser);
   addTraverserOptions(wcParser);
+  ArgumentParser dedupParser("dedup", logger,
+      "Finds files with identical content");
+  parser.addSubParser("mode", "dedup", dedupParser);
+  addTraverserOptions(dedupParser);
   ArgumentParser duParser("du", logger, "Counts files, directories, bytes");
   parser.addSubParser("mode", "du", duParser);
   addTraverserOptions(duParser);
@@ -654,12 +816,18 @@ int fileKnife(int argc, char **argv, Logger *loggerExtern) {
       examples();
     } else if (parser.isMode("mode", "list")) {
       rc = list(parser, *logger);
+    } else if (parser.isMode("mode", "dedup")) {
+      rc = dedup(parser, *logger);
     } else if (parser.isMode("mode", "du")) {
       rc = du(parser, *logger);
     } else if (parser.isMode("mode", "extrema")) {
       rc = extrema(parser, *logger);
     } else if (parser.isMode("mode", "owner")) {
       rc = owner(parser, *logger);
+    } else if (parser.isMode("mode", "sync")) {
+      rc = sync(parser, *logger);
+    } else if (parser.isMode("mode", "watch")) {
+      rc = watch(parser, *logger);
     } else if (parser.isMode("mode", "wc")) {
       rc = wc(parser, *logger);
     } else {
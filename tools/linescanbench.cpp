@@ -0,0 +1,123 @@
+/*
+ * linescanbench.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+// Micro benchmark of the line splitting: memchr() plus a binary test per line
+// against the LineScanner kernels. Also measures reading a gzip file with LineAgent.
+// Usage: linescanbench [<megabytes> [<rounds>]]
+#include "../os/os.hpp"
+#include <zlib.h>
+
+using namespace cppknife;
+
+/**
+ * The splitting before LineScanner: memchr() and a second pass for the binary test.
+ */
+static size_t splitOld(const char *data, size_t length, bool &binary) {
+  size_t rc = 0;
+  const char *end = data + length;
+  while (data < end) {
+    auto lineEnd = static_cast<const char*>(memchr(data, '\n', end - data));
+    if (lineEnd == nullptr) {
+      lineEnd = end;
+    }
+    for (auto ptr = reinterpret_cast<const unsigned char*>(data);
+        ptr < reinterpret_cast<const unsigned char*>(lineEnd); ptr++) {
+      if (*ptr < ' ' && (*ptr < '\t' || *ptr > '\r')) {
+        binary = true;
+        break;
+      }
+    }
+    data = lineEnd + 1;
+    rc++;
+  }
+  return rc;
+}
+static size_t splitLines(const LineScanner &scanner, const char *data,
+    size_t length, bool &binary) {
+  size_t rc = 0;
+  size_t offset = 0;
+  while (offset < length) {
+    offset += scanner.findLineEnd(data + offset, length - offset, binary) + 1;
+    rc++;
+  }
+  return rc;
+}
+static void report(const char *name, double start, size_t bytes,
+    size_t lines) {
+  double duration = nowAsDouble() - start;
+  printf("%-16s %8.3f sec %9.1f MB/s lines: %zu\n", name, duration,
+      bytes / 1E6 / duration, lines);
+}
+int main(int argc, char **argv) {
+  size_t megaBytes = argc > 1 ? atol(argv[1]) : 256;
+  int rounds = argc > 2 ? atoi(argv[2]) : 5;
+  // A text with line lengths between 0 and 160:
+  std::string text;
+  text.reserve(megaBytes * 1024 * 1024);
+  PortableRandom random;
+  while (text.size() + 200 < megaBytes * 1024 * 1024) {
+    text.append(random.nextInt(160), 'a' + random.nextInt(26));
+    text += '\n';
+  }
+  size_t bytes = text.size() * rounds;
+  bool binary = false;
+  size_t lines = 0;
+  double start = nowAsDouble();
+  for (int round = 0; round < rounds; round++) {
+    lines = splitOld(text.c_str(), text.size(), binary);
+  }
+  report("memchr+test", start, bytes, lines);
+  const char *names[] = { "", "scalar", "sse2", "avx2" };
+  std::vector<uint32_t> lineEnds;
+  lineEnds.reserve(text.size() / 40);
+  for (auto kernel : { LineScanner::K_SCALAR, LineScanner::K_SSE2,
+      LineScanner::K_AVX2 }) {
+    LineScanner scanner(kernel);
+    if (scanner.kernel() != kernel) {
+      continue;
+    }
+    start = nowAsDouble();
+    for (int round = 0; round < rounds; round++) {
+      lines = splitLines(scanner, text.c_str(), text.size(), binary);
+    }
+    report(formatCString("%s lines", names[kernel]).c_str(), start, bytes,
+        lines);
+    start = nowAsDouble();
+    for (int round = 0; round < rounds; round++) {
+      // Blocks of 64 KiByte like LineReader:
+      lines = 0;
+      for (size_t offset = 0; offset < text.size(); offset += 0x10000) {
+        scanner.indexBlock(text.c_str() + offset,
+            std::min(text.size() - offset, static_cast<size_t>(0x10000)),
+            lineEnds);
+        lines += lineEnds.size();
+      }
+    }
+    report(formatCString("%s index", names[kernel]).c_str(), start, bytes,
+        lines);
+  }
+  // Decompression: the throughput is measured in uncompressed bytes.
+  auto gzName = temporaryFile("linescanbench.txt.gz");
+  gzFile gzOutput = gzopen(gzName.c_str(), "wb");
+  gzwrite(gzOutput, text.data(), static_cast<unsigned>(text.size()));
+  gzclose(gzOutput);
+  auto logger = buildMemoryLogger();
+  start = nowAsDouble();
+  for (int round = 0; round < rounds; round++) {
+    LineAgent agent(logger);
+    agent.openFile(gzName.c_str());
+    size_t length;
+    lines = 0;
+    while (agent.nextLine(length) != nullptr) {
+      lines++;
+    }
+  }
+  report("gzip LineAgent", start, bytes, lines);
+  delete logger;
+  unlink(gzName.c_str());
+  return binary ? 1 : 0;
+}
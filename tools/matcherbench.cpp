@@ -0,0 +1,66 @@
+/*
+ * matcherbench.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+// Benchmark of PatternList::match(): the cost per name with a growing count of patterns.
+// With the KeywordAutomaton the cost should not grow with the count of patterns.
+// Usage: matcherbench [<names> [<loops>]]
+#include "../text/text.hpp"
+
+using namespace cppknife;
+
+/**
+ * Returns the minimal cost of some runs: less disturbed by other processes.
+ */
+static double nanosPerName(PatternList &patterns,
+    const std::vector<std::string> &names, int loops, size_t &hits) {
+  double rc = 1E99;
+  for (int run = 0; run < 3; run++) {
+    auto start = std::chrono::steady_clock::now();
+    for (int loop = 0; loop < loops; loop++) {
+      for (auto &name : names) {
+        hits += patterns.match(name) ? 1 : 0;
+      }
+    }
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    rc = std::min(rc, nanos / (double(loops) * names.size()));
+  }
+  return rc;
+}
+int main(int argc, char **argv) {
+  int countNames = argc > 1 ? atoi(argv[1]) : 2000;
+  int loops = argc > 2 ? atoi(argv[2]) : 20;
+  std::vector<std::string> names;
+  for (int ix = 0; ix < countNames; ix++) {
+    names.push_back(
+        formatCString("src/module%d/file_%d.ext%d", ix % 17, ix, ix % 300));
+  }
+  int counts[] = { 10, 50, 200, 1000 };
+  for (auto count : counts) {
+    std::string list;
+    for (int no = 0; no < count; no++) {
+      list += formatCString(",*.ext%d", no * 3);
+    }
+    PatternList patterns;
+    patterns.set(list.c_str(), -1, true);
+    size_t hits = 0;
+    double sequential = 1E99;
+    for (int run = 0; run < 3; run++) {
+      auto start = std::chrono::steady_clock::now();
+      for (auto &name : names) {
+        hits += patterns.matchSequential(name.c_str()) ? 1 : 0;
+      }
+      auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start).count();
+      sequential = std::min(sequential, nanos / double(names.size()));
+    }
+    double nanos = nanosPerName(patterns, names, loops, hits);
+    printf("patterns: %4d ns/name: %8.1f sequential: %8.1f hits: %zu\n",
+        count, nanos, sequential, hits);
+  }
+  return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * prefilterbench.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+// Benchmark of the line search with and without RegexPrefilter: generates a synthetic
+// log file and searches it with LineAgent::nextLine() and LineAgent::nextCandidateLine(),
+// buffered and memory mapped.
+// Usage: prefilterbench [<megabytes> [<rounds> [<pattern>]]]
+#include "../text/text.hpp"
+#include "../os/os.hpp"
+
+using namespace cppknife;
+
+/**
+ * Writes a log file: mostly INFO lines, one ERROR line in about 10000 lines.
+ */
+static void writeLog(const char *filename, size_t megaBytes) {
+  const char *levels[] = { "INFO ", "DEBUG", "WARN " };
+  const char *actions[] = { "request handled", "cache refreshed",
+      "session created", "connection reused" };
+  FILE *fp = fopen(filename, "w");
+  if (fp == nullptr) {
+    fprintf(stderr, "cannot write %s (%d): %s\n", filename, errno,
+        strerror(errno));
+    exit(2);
+  }
+  // nextInt(max) delivers 0..max:
+  PortableRandom random;
+  std::string block;
+  block.reserve(0x1000000 + 200);
+  size_t total = 0;
+  size_t size = megaBytes * 1024 * 1024;
+  for (size_t lineNo = 0; total < size; lineNo++) {
+    auto seconds = lineNo / 100;
+    if (random.nextInt(9999) == 0) {
+      block += formatCString(
+          "2026-10-17 %02d:%02d:%02d.%03d ERROR [worker-%d] upstream failed: timeout=%d ms\n",
+          int(seconds / 3600 % 24), int(seconds / 60 % 60), int(seconds % 60),
+          int(lineNo % 1000), random.nextInt(15), random.nextInt(1000, 9999));
+    } else {
+      block += formatCString(
+          "2026-10-17 %02d:%02d:%02d.%03d %s [worker-%d] %s id=%d took %d ms\n",
+          int(seconds / 3600 % 24), int(seconds / 60 % 60), int(seconds % 60),
+          int(lineNo % 1000), levels[random.nextInt(2)], random.nextInt(15),
+          actions[random.nextInt(3)], random.nextInt(999999),
+          random.nextInt(499));
+    }
+    if (block.size() >= 0x1000000) {
+      fwrite(block.data(), 1, block.size(), fp);
+      total += block.size();
+      block.clear();
+    }
+  }
+  fwrite(block.data(), 1, block.size(), fp);
+  fclose(fp);
+}
+static size_t search(const char *filename, const RegexEngine &engine,
+    const RegexPrefilter &prefilter, bool mapped, Logger *logger) {
+  size_t rc = 0;
+  LineAgent agent(logger);
+  agent.setMemoryMapped(mapped);
+  if (agent.openFile(filename)) {
+    const char *line;
+    size_t length;
+    while ((line = agent.nextCandidateLine(prefilter, length)) != nullptr) {
+      if (engine.search(line, length)) {
+        rc++;
+      }
+    }
+  }
+  return rc;
+}
+static void report(const char *name, double start, size_t bytes, size_t hits) {
+  double duration = nowAsDouble() - start;
+  printf("%-24s %8.3f sec %9.1f MB/s hits: %zu\n", name, duration,
+      bytes / 1E6 / duration, hits);
+}
+int main(int argc, char **argv) {
+  size_t megaBytes = argc > 1 ? atol(argv[1]) : 1024;
+  int rounds = argc > 2 ? atoi(argv[2]) : 1;
+  const char *pattern = argc > 3 ? argv[3] : "ERROR .*timeout=\\d{4,}";
+  auto filename = temporaryFile("prefilterbench.log");
+  double start = nowAsDouble();
+  writeLog(filename.c_str(), megaBytes);
+  struct stat info;
+  stat(filename.c_str(), &info);
+  size_t bytes = info.st_size * rounds;
+  report("generate", start, info.st_size, 0);
+  std::unique_ptr<RegexEngine> engine(RegexEngine::create(pattern));
+  RegexPrefilter prefilter;
+  prefilter.compile(pattern);
+  printf("pattern: %s engine: %s literals: %zu\n", pattern,
+      engine->type() == RE_DFA ? "dfa" : "std", prefilter.literals().size());
+  // An inactive prefilter: each line is searched by the engine.
+  RegexPrefilter noFilter;
+  auto logger = buildMemoryLogger();
+  size_t hits[2] = { 0, 0 };
+  for (int mapped = 0; mapped < 2; mapped++) {
+    for (int filtered = 0; filtered < 2; filtered++) {
+      start = nowAsDouble();
+      for (int round = 0; round < rounds; round++) {
+        hits[filtered] = search(filename.c_str(), *engine,
+            filtered ? prefilter : noFilter, mapped != 0, logger);
+      }
+      report(
+          formatCString("%s %s", mapped ? "mapped" : "buffered",
+              filtered ? "prefilter" : "no prefilter").c_str(), start, bytes,
+          hits[filtered]);
+    }
+    if (hits[0] != hits[1]) {
+      printf("+++ different hits: %zu / %zu\n", hits[0], hits[1]);
+    }
+  }
+  delete logger;
+  unlink(filename.c_str());
+  return hits[0] == hits[1] ? 0 : 1;
+}
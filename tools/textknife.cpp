@@ -31,6 +31,10 @@ textknife search --days=+3 -Smemory_limit /etc/php/*.ini,*.conf
 textknife search --list -SJonny --max-depth=3 /home
 # List only the filenames not containing "License" ignoring case:
 textknife search -v --list -P/license/i /home/ws/*.cpp
+# Search a large log file with 8 threads: the file is split into chunks searched in parallel:
+textknife search -j8 -SERROR /var/log/huge.log
+# Search a source tree with 8 threads: the files are searched in parallel, the hits are shown in traversal order:
+textknife search -j8 -P/TODO:/ /home/ws/*.cpp,*.hpp
 
 # Find the strings in all sourcefiles (*.cpp and *.hpp) in the directory /home/ws and subdirs:
 textknife strings /home/ws/*.cpp,*.hpp
@@ -144,9 +148,9 @@ public:
     bool rc = !_status->isDirectory();
     return rc;
   }
-  virtual bool oneFile() {
+  virtual bool processFile(const char *filename, FileSize_t size,
+      FileOutput &output) {
     bool rc = true;
-    auto filename = _status->fullName();
     LineList lines;
     lines.readFromFile(filename);
     bool hasChanged = false;
@@ -168,7 +172,8 @@ public:
 
 class CheckSumHandler: public CommandHandler {
 private:
-  uint32_t _totalCheckSum;
+  /// Combined by XOR: independent of the processing order.
+  std::atomic<uint32_t> _totalCheckSum;
 public:
   CheckSumHandler(ArgumentParser &argumentParser, Logger *logger) :
       CommandHandler(argumentParser, logger), _totalCheckSum(0) {
@@ -179,9 +184,9 @@ public:
     bool rc = !_status->isDirectory();
     return rc;
   }
-  virtual bool oneFile() {
+  virtual bool processFile(const char *filename, FileSize_t size,
+      FileOutput &output) {
     bool rc = true;
-    auto filename = _status->fullName();
     FILE *file = fopen(filename, "rb");
     if (file != nullptr) {
       uint8_t buffer[512 * 1024];
@@ -190,13 +195,16 @@ public:
       while ((length = fread(buffer, 1, sizeof buffer, file)) > 0) {
         crc32Update(buffer, length, checkSum, false);
       }
+      fclose(file);
       crc32Update(buffer, 0, checkSum, true);
       _totalCheckSum ^= checkSum;
-      _logger->say(LV_INFO,
-          formatCString("%08x %s", checkSum, filename));
+      output.say(LV_INFO, formatCString("%08x %s", checkSum, filename));
     }
     return rc;
   }
+  virtual bool supportsConcurrency() const {
+    return true;
+  }
   inline uint32_t totalCheckSum() const {
     return _totalCheckSum;
   }
@@ -218,11 +226,11 @@ public:
     return rc;
   }
 
-  virtual bool oneFile() {
+  virtual bool processFile(const char *filename, FileSize_t size,
+      FileOutput &output) {
     bool rc = true;
 #ifdef DOIT
     auto pattern = _argumentParser.asRegExpr("pattern");
-    auto filename = _status->accessFullName();
     FileLinesStream stream(filename, *_logger);
     std::string line;
     bool found = false;
@@ -238,18 +246,45 @@ public:
 }
 ;
 
+/**
+ * The hits of one chunk of a file searched in parallel.
+ */
+class SearchHits {
+public:
+  /// The line numbers relative to the chunk start.
+  std::vector<size_t> _lineNos;
+  /// The matching lines or (option --only-matching) the matching strings.
+  std::vector<std::string> _texts;
+  /// Option --list: <em>true</em>: the chunk contains a hit.
+  bool _found;
+public:
+  SearchHits() :
+      _lineNos(), _texts(), _found(false) {
+  }
+};
+
 class SearchCommandHandler: public CommandHandler {
 private:
-  std::regex _pattern;
+  /// The search engine of the pattern: a DFA if the pattern allows that.
+  RegexEngine *_engine;
   std::string _string;
   bool _onlyMatching;
   bool _listFiles;
   bool _invertMatch;
   size_t _maxCount;
+  size_t _readAhead;
+  /// <em>true</em>: the files are mapped into memory. Opt-in: truncating a mapped file kills the process (SIGBUS).
+  bool _memoryMapped;
+  int _threads;
+  /// <em>nullptr</em> or the workers searching the chunks of a large file.
+  ThreadPool *_pool;
+  /// Finds the lines containing a mandatory literal of the pattern.
+  RegexPrefilter _prefilter;
 public:
   SearchCommandHandler(ArgumentParser &argumentParser, Logger *logger) :
-      CommandHandler(argumentParser, logger), _pattern(), _string(), _onlyMatching(
-          false), _listFiles(false), _invertMatch(false), _maxCount(0) {
+      CommandHandler(argumentParser, logger), _engine(nullptr), _string(), _onlyMatching(
+          false), _listFiles(false), _invertMatch(false), _maxCount(0), _readAhead(
+          0), _memoryMapped(false), _threads(1), _pool(nullptr), _prefilter() {
     _onlyMatching = argumentParser.asBool("only-matching");
     _listFiles = argumentParser.asBool("list");
     _invertMatch = argumentParser.asBool("invert-match");
@@ -257,7 +292,13 @@ public:
       _onlyMatching = false;
     }
     _maxCount = argumentParser.asInt("max-count");
-    _pattern = _argumentParser.asRegExpr("pattern");
+    _readAhead = argumentParser.asInt("read-ahead");
+    _memoryMapped = argumentParser.asBool("memory-mapped", false);
+    _threads = argumentParser.asInt("threads", 1);
+    if (_threads == 0) {
+      _threads = ThreadPool::defaultThreadCount();
+    }
+    _engine = _argumentParser.asRegexEngine("pattern");
     _string = argumentParser.asString("string");
     auto pattern2 = argumentParser.asString("pattern");
     auto length2 = strlen(pattern2);
@@ -266,39 +307,100 @@ public:
         && strcspn(pattern2, "^$()[]{}.*+?\\") == length2) {
       _string = std::string(pattern2 + 1, length2 - 2);
     }
+    // Only the lines containing a mandatory literal are inspected by the regular expression:
+    auto patternEnd = length2 < 2 ? nullptr : strchr(pattern2 + 1, pattern2[0]);
+    if (!_string.empty()) {
+      _prefilter.setLiteral(_string);
+    } else if (patternEnd != nullptr) {
+      std::string flags(patternEnd + 1);
+      // The flag 'w' may change the pattern: see Argument::asRegExpr().
+      if (flags.find('w') == std::string::npos
+          || strchr(pattern2, '[') == nullptr) {
+        _prefilter.compile(
+            std::string(pattern2 + 1, patternEnd - pattern2 - 1).c_str(),
+            flags.find('i') != std::string::npos);
+      }
+    }
   }
   virtual ~SearchCommandHandler() {
+    delete _pool;
+    _pool = nullptr;
+    delete _engine;
+    _engine = nullptr;
   }
   virtual bool isValid() {
     bool rc = !_status->isDirectory();
     return rc;
   }
-
-  virtual bool oneFile() {
+  virtual bool supportsConcurrency() const {
+    return true;
+  }
+  /**
+   * Tests whether a line contains the searched string or pattern.
+   * Thread safe: used by the workers of a parallel search.
+   * @param line The line to inspect. Not terminated by '\0'.
+   * @param length The length of <em>line</em>.
+   * @param[out] match The hit of the regular expression.
+   * @return <em>true</em>: the line contains the string or pattern.
+   */
+  bool matches(const char *line, size_t length, std::cmatch &match) const {
+    bool rc;
+    if (!_string.empty()) {
+      rc = memmem(line, length, _string.c_str(), _string.size()) != nullptr;
+    } else if (_onlyMatching) {
+      // The hit itself is needed:
+      rc = _engine->search(line, length, match);
+    } else {
+      rc = _engine->search(line, length);
+    }
+    return rc;
+  }
+  /**
+   * Returns the next line which may contain a hit: the lines without a literal of the
+   * pattern are skipped.
+   * @param agent The line source.
+   * @param[out] length The length of the line.
+   * @return <em>nullptr</em>: no more lines. Otherwise: the line.
+   */
+  const char* nextLine(LineAgent &agent, size_t &length) const {
+    return
+        _invertMatch ?
+            agent.nextLine(length) :
+            agent.nextCandidateLine(_prefilter, length);
+  }
+  virtual bool processFile(const char *filename, FileSize_t size,
+      FileOutput &output) {
     bool rc = true;
-    auto filename = _status->fullName();
+    // A large file is split into chunks searched in parallel.
+    // The chunks are memory mapped: only with --memory-mapped.
+    // Not inside a worker processing files: the other workers are busy too.
+    if (_threads > 1 && (_filePool == nullptr || _filePool->currentWorker() < 0)
+        && _memoryMapped && _readAhead == 0
+        && size >= 2 * ChunkedFile::MIN_CHUNK_SIZE
+        && searchChunked(filename, size, output)) {
+      return rc;
+    }
     LineAgent file(_logger);
+    // The lines are views into the mapping: not terminated by '\0'.
+    file.setMemoryMapped(_memoryMapped && _readAhead == 0);
+    file.setReadAhead(_readAhead);
 
     size_t count = 0;
     if (file.openFile(filename, true, true)) {
-      const char *simpleString = _string.empty() ? nullptr : _string.c_str();
       const char *line = nullptr;
       bool found = false;
       std::cmatch match;
       int lineNo = 0;
       size_t length = 0;
-      while ((line = file.nextLine(length)) != nullptr) {
+      while ((line = nextLine(file, length)) != nullptr) {
         if (file.hasBinaryData()) {
           break;
         }
-        lineNo++;
-        found =
-            simpleString != nullptr ?
-                strstr(line, simpleString) != nullptr :
-                std::regex_search(line, match, _pattern);
+        lineNo = file.currentLineNo();
+        found = matches(line, length, match);
         if (_listFiles) {
           if (!_invertMatch && found) {
-            _logger->say(LV_INFO, filename);
+            output.say(LV_INFO, filename);
           }
           if (found) {
             count++;
@@ -306,27 +408,112 @@ public:
           }
         } else if ((_invertMatch && !found) || (!_invertMatch && found)) {
           count++;
-          if (_listFiles) {
-            if (found) {
-              _logger->say(LV_INFO, filename);
-              break;
-            }
-          } else if (_onlyMatching) {
-            auto hit = simpleString == nullptr ? match.str(0) : simpleString;
-            _logger->say(LV_INFO, hit);
+          if (_onlyMatching) {
+            output.say(LV_INFO, _string.empty() ? match.str(0) : _string);
           } else {
-            _logger->say(LV_INFO,
-                formatCString("%s-%d: %s", filename, lineNo, line));
+            output.say(LV_INFO,
+                formatCString("%s-%d: %.*s", filename, lineNo,
+                    static_cast<int>(length), line));
           }
           if (_maxCount > 0 && count >= _maxCount) {
-            _logger->say(LV_FINE,
+            output.say(LV_FINE,
                 formatCString("= %s: max-count reached: %d", filename, count));
             break;
           }
         }
       }
       if (_invertMatch && count == 0) {
-        _logger->say(LV_INFO, filename);
+        output.say(LV_INFO, filename);
+      }
+    }
+    return rc;
+  }
+  /**
+   * Searches a large file in parallel: the chunks are searched by the workers,
+   * the hits are written in file order.
+   * @param filename The name of the file.
+   * @param size The size of the file.
+   * @param output The hits must be written there.
+   * @return <em>false</em>: the file cannot be split (e.g. compressed): it must be searched sequentially.
+   */
+  bool searchChunked(const char *filename, FileSize_t size,
+      FileOutput &output) {
+    ChunkedFile file(filename, _logger);
+    bool rc = file.split(ChunkedFile::chunkSizeFor(size, _threads));
+    if (rc) {
+      if (_pool == nullptr) {
+        _pool = new ThreadPool(_threads);
+      }
+      std::vector<SearchHits> hits(file.chunks().size());
+      size_t count = 0;
+      bool binaryFile = false;
+      file.process(*_pool, [this, &hits](FileChunk &chunk, LineAgent &agent) {
+        auto &chunkHits = hits[chunk._index];
+        const char *line;
+        size_t length = 0;
+        std::cmatch match;
+        while ((line = nextLine(agent, length)) != nullptr
+            && !agent.hasBinaryData()) {
+          bool found = matches(line, length, match);
+          if (_listFiles) {
+            if (found) {
+              chunkHits._found = true;
+              break;
+            }
+          } else if (found != _invertMatch) {
+            chunkHits._lineNos.push_back(agent.currentLineNo());
+            if (_onlyMatching) {
+              chunkHits._texts.push_back(
+                  _string.empty() ? match.str(0) : _string);
+            } else {
+              chunkHits._texts.emplace_back(line, length);
+            }
+            // The chunk cannot contribute more:
+            if (_maxCount > 0 && chunkHits._lineNos.size() >= _maxCount) {
+              break;
+            }
+          }
+        }
+      }, [&](FileChunk &chunk) {
+        bool again = !chunk._hasBinaryData;
+        auto &chunkHits = hits[chunk._index];
+        if (chunk._index == 0 && chunk._hasBinaryData && chunk._lineCount == 0) {
+          // Binary data at the file start: the file is ignored.
+          binaryFile = true;
+        } else if (_listFiles) {
+          if (chunkHits._found) {
+            count++;
+            if (!_invertMatch) {
+              output.say(LV_INFO, filename);
+            }
+            again = false;
+          }
+        } else {
+          for (size_t ix = 0; ix < chunkHits._lineNos.size(); ix++) {
+            count++;
+            if (_onlyMatching) {
+              output.say(LV_INFO, chunkHits._texts[ix]);
+            } else {
+              output.say(LV_INFO,
+                  formatCString("%s-%d: %s", filename,
+                      static_cast<int>(chunk._firstLineNo + chunkHits._lineNos[ix] - 1),
+                      chunkHits._texts[ix].c_str()));
+            }
+            if (_maxCount > 0 && count >= _maxCount) {
+              output.say(LV_FINE,
+                  formatCString("= %s: max-count reached: %d", filename, count));
+              again = false;
+              break;
+            }
+          }
+        }
+        // The hits are written: free the memory.
+        SearchHits empty;
+        std::swap(chunkHits, empty);
+        return again;
+      });
+      if (_invertMatch && count == 0 && !binaryFile) {
+        output.say(LV_INFO, filename);
       }
     }
     return rc;
@@ -336,9 +523,11 @@ public:
 class StringsCommandHandler: public CommandHandler {
 private:
   std::map<std::string, int> _strings;
+  /// Protects <em>_strings</em>.
+  std::mutex _mutex;
 public:
   StringsCommandHandler(ArgumentParser &argumentParser, Logger *logger) :
-      CommandHandler(argumentParser, logger), _strings() {
+      CommandHandler(argumentParser, logger), _strings(), _mutex() {
   }
   virtual ~StringsCommandHandler() {
   }
@@ -347,16 +536,22 @@ public:
     return rc;
   }
 
-  virtual bool oneFile() {
+  virtual bool processFile(const char *filename, FileSize_t size,
+      FileOutput &output) {
     bool rc = true;
-    auto filename = _status->accessFullName();
     const int MAX = 0xffff;
     char buffer[MAX + 1];
     buffer[MAX] = '\0';
     FILE *input = fopen(filename, "r");
+    if (input == nullptr) {
+      output.say(LV_ERROR, formatCString("cannot open %s", filename));
+      return rc;
+    }
     const char *ptr = nullptr;
     const char *start = nullptr;
     char cc = 0;
+    // Collected without lock, merged at the end:
+    std::map<std::string, int> strings;
     while (fgets(buffer, sizeof buffer, input) != nullptr) {
       char delimiter = '\0';
       ptr = buffer;
@@ -373,18 +568,22 @@ public:
           delimiter = cc;
         } else if (start != nullptr && cc == delimiter) {
           std::string contents(start, ptr - start);
-          if (_strings.find(contents) != _strings.end()) {
-            _strings[contents]++;
-          } else {
-            _strings[contents] = 1;
-          }
+          strings[contents]++;
           start = nullptr;
           delimiter = '\0';
         }
       }
     }
+    fclose(input);
+    std::lock_guard<std::mutex> guard(_mutex);
+    for (auto &item : strings) {
+      _strings[item.first] += item.second;
+    }
     return rc;
   }
+  virtual bool supportsConcurrency() const {
+    return true;
+  }
   void write(const char *filename, Logger &logger) {
     FILE *output = nullptr;
     if (strcmp(filename, "-") == 0) {
@@ -513,6 +712,9 @@ int textKnife(int argc, char **argv, Logger *loggerExtern) {
   checkSumParser.add("source", nullptr, DT_FILE_PATTERN,
       "A directory with or without a list of file patterns.", ".", nullptr,
       true);
+  checkSumParser.add("--unordered", nullptr, DT_BOOL,
+      "With --threads: the checksums are shown in the order of calculation, not in traversal order",
+      "false");
   addTraverserOptions(checkSumParser);
 #ifdef REPLACE
     ArgumentParser replaceParser("replace", logger,
@@ -540,6 +742,15 @@ int textKnife(int argc, char **argv, Logger *loggerExtern) {
       "Show the lines NOT matching the patterns", "false");
   searchParser.add("--max-count", "-m", DT_NAT,
       "Stops file processing after that count of matching lines", "false");
+  searchParser.add("--read-ahead", "-r", DT_NAT,
+      "0: no read-ahead. Otherwise: the files are read with that count of blocks read in advance by a background thread",
+      "0");
+  searchParser.add("--memory-mapped", nullptr, DT_BOOL,
+      "Without --read-ahead: the files are mapped into memory, with --threads large files are searched in parallel. Faster, but the files must not be truncated while searching (e.g. by log rotation)",
+      "false");
+  searchParser.add("--unordered", nullptr, DT_BOOL,
+      "With --threads: the hits of a file are shown when the file is searched, not in traversal order",
+      "false");
   searchParser.add("source", nullptr, DT_FILE_PATTERN,
       "A directory with or without a list of file patterns.", ".", nullptr,
       true);
@@ -49,3 +49,19 @@ TEST(ByteStorageTest, basics) {
     ASSERT_TRUE(storage.check().empty());
   }
 }
+TEST(ByteStorageTest, reset) {
+  ByteStorage storage(100);
+  char *first = storage.allocate(60);
+  storage.allocate(60);
+  size_t buffers = 0, used = 0, vasted = 0;
+  storage.statistics(buffers, used, vasted);
+  ASSERT_EQ(2, buffers);
+  storage.reset();
+  // The memory is reused:
+  ASSERT_EQ(first, storage.allocate(60));
+  storage.allocate(60);
+  storage.statistics(buffers, used, vasted);
+  ASSERT_EQ(2, buffers);
+  ASSERT_EQ(126, used);
+  ASSERT_TRUE(storage.check().empty());
+}
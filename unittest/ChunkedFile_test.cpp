@@ -0,0 +1,138 @@
+/*
+ * ChunkedFile_test.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+using namespace cppknife;
+
+static bool onlyFewTests() {
+  return false;
+}
+#define FEW_TESTS() if (onlyFewTests()) return
+
+static std::string createText(int lines) {
+  std::string rc;
+  for (int ix = 1; ix <= lines; ix++) {
+    rc += formatCString("line %d: %s\n", ix,
+        std::string(ix % 100, 'a' + ix % 26).c_str());
+  }
+  return rc;
+}
+TEST(ChunkedFileTest, split) {
+  FEW_TESTS();
+  auto text = createText(5000);
+  // A last line without '\n':
+  text += "last";
+  auto filename = temporaryFile("chunked.txt", "unittest");
+  writeText(filename.c_str(), text.c_str(), text.size());
+  auto logger = buildMemoryLogger();
+  ChunkedFile file(filename.c_str(), logger);
+  ASSERT_TRUE(file.split(10000));
+  auto &chunks = file.chunks();
+  ASSERT_TRUE(chunks.size() > 10);
+  size_t start = 0;
+  for (auto &chunk : chunks) {
+    ASSERT_EQ(start, chunk._start);
+    ASSERT_TRUE(chunk._end > chunk._start);
+    // Complete lines only:
+    if (chunk._end < text.size()) {
+      ASSERT_EQ('\n', text[chunk._end - 1]);
+    }
+    start = chunk._end;
+  }
+  ASSERT_EQ(text.size(), start);
+  ASSERT_EQ(text.size(), file.fileSize());
+  // Larger than the file: one chunk
+  ASSERT_TRUE(file.split(text.size() * 2));
+  ASSERT_EQ(1U, file.chunks().size());
+  delete logger;
+  unlink(filename.c_str());
+}
+TEST(ChunkedFileTest, process) {
+  FEW_TESTS();
+  auto text = createText(20000);
+  auto filename = temporaryFile("chunked2.txt", "unittest");
+  writeText(filename.c_str(), text.c_str(), text.size());
+  auto logger = buildMemoryLogger();
+  ChunkedFile file(filename.c_str(), logger);
+  ASSERT_TRUE(file.split(4096));
+  ThreadPool pool(4);
+  // The numbers of the lines containing "7:", relative to the chunk:
+  std::vector<std::vector<size_t>> hits(file.chunks().size());
+  std::vector<size_t> found;
+  size_t merged = 0;
+  ASSERT_TRUE(file.process(pool, [&hits](FileChunk &chunk, LineAgent &agent) {
+    size_t length = 0;
+    const char *line;
+    while ((line = agent.nextLine(length)) != nullptr) {
+      if (memmem(line, length, "7:", 2) != nullptr) {
+        hits[chunk._index].push_back(agent.currentLineNo());
+      }
+      // Only a part of the lines is fetched: the rest is counted by ChunkedFile.
+      if (chunk._index % 3 == 0 && agent.currentLineNo() > 10) {
+        break;
+      }
+    }
+  }, [&](FileChunk &chunk) {
+    EXPECT_EQ(merged++, chunk._index);
+    for (auto lineNo : hits[chunk._index]) {
+      found.push_back(chunk._firstLineNo + lineNo - 1);
+    }
+    return true;
+  }));
+  ASSERT_EQ(file.chunks().size(), merged);
+  ASSERT_TRUE(found.size() > 100);
+  // The line with the number N contains "line N:"
+  for (auto lineNo : found) {
+    ASSERT_EQ(7U, lineNo % 10);
+  }
+  size_t lines = 0;
+  for (auto &chunk : file.chunks()) {
+    lines += chunk._lineCount;
+  }
+  ASSERT_EQ(20000U, lines);
+  delete logger;
+  unlink(filename.c_str());
+}
+TEST(ChunkedFileTest, stopAndBinary) {
+  FEW_TESTS();
+  auto text = createText(20000);
+  auto filename = temporaryFile("chunked3.txt", "unittest");
+  writeText(filename.c_str(), text.c_str(), text.size());
+  auto logger = buildMemoryLogger();
+  ChunkedFile file(filename.c_str(), logger);
+  ASSERT_TRUE(file.split(4096));
+  ThreadPool pool(3);
+  size_t merged = 0;
+  // The merge stops after 3 chunks:
+  ASSERT_FALSE(file.process(pool, [](FileChunk &chunk, LineAgent &agent) {
+  }, [&merged](FileChunk &chunk) {
+    return ++merged < 3;
+  }, 2));
+  ASSERT_EQ(3U, merged);
+  // Binary data in the first block:
+  text[100] = '\0';
+  writeText(filename.c_str(), text.c_str(), text.size());
+  ASSERT_TRUE(file.split(4096));
+  bool binary = false;
+  ASSERT_FALSE(file.process(pool, [](FileChunk &chunk, LineAgent &agent) {
+  }, [&binary](FileChunk &chunk) {
+    binary = chunk._hasBinaryData;
+    return !binary;
+  }));
+  ASSERT_TRUE(binary);
+  delete logger;
+  unlink(filename.c_str());
+}
+TEST(ChunkedFileTest, chunkSizeFor) {
+  FEW_TESTS();
+  ASSERT_EQ(static_cast<size_t>(ChunkedFile::MIN_CHUNK_SIZE),
+      ChunkedFile::chunkSizeFor(1000, 4));
+  ASSERT_EQ(static_cast<size_t>(ChunkedFile::DEFAULT_CHUNK_SIZE),
+      ChunkedFile::chunkSizeFor(30000000000LL, 4));
+  ASSERT_EQ(50000000U, ChunkedFile::chunkSizeFor(800000000, 4));
+}
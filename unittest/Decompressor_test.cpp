@@ -0,0 +1,132 @@
+/*
+ * Decompressor_test.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+#include <zlib.h>
+using namespace cppknife;
+
+static bool onlyFewTests() {
+  return false;
+}
+#define FEW_TESTS() if (onlyFewTests()) return
+
+static std::string createText(int lines) {
+  std::string rc;
+  for (int ix = 0; ix < lines; ix++) {
+    rc += formatCString("line %d: %s\n", ix,
+        std::string(ix % 100, 'a' + ix % 26).c_str());
+  }
+  return rc;
+}
+/**
+ * Writes a gzip file. With <em>members</em> &gt; 1 the text is written as concatenated gzip members.
+ */
+static std::string writeGzip(const char *node, const std::string &text,
+    int members = 1) {
+  auto rc = temporaryFile(node, "unittest");
+  unlink(rc.c_str());
+  size_t partSize = text.size() / members + 1;
+  for (size_t offset = 0; offset < text.size(); offset += partSize) {
+    // Mode "a": a new member is appended.
+    gzFile file = gzopen(rc.c_str(), "ab");
+    gzwrite(file, text.data() + offset,
+        static_cast<unsigned>(std::min(partSize, text.size() - offset)));
+    gzclose(file);
+  }
+  return rc;
+}
+TEST(DecompressorTest, compressionOf) {
+  FEW_TESTS();
+  auto gzName = writeGzip("decompressor.txt.gz", "abc\n");
+  auto plainName = temporaryFile("decompressor.txt", "unittest");
+  writeText(plainName.c_str(), "abc\n");
+  auto zstdName = temporaryFile("decompressor.txt.zst", "unittest");
+  writeBinary(zstdName.c_str(), "\x28\xb5\x2f\xfd\0\0", 6);
+  int handle = open(gzName.c_str(), O_RDONLY);
+  ASSERT_EQ(CT_GZIP, compressionOf(handle));
+  // The file position is unchanged:
+  ASSERT_EQ(0, lseek(handle, 0, SEEK_CUR));
+  close(handle);
+  handle = open(plainName.c_str(), O_RDONLY);
+  ASSERT_EQ(CT_NONE, compressionOf(handle));
+  close(handle);
+  handle = open(zstdName.c_str(), O_RDONLY);
+  ASSERT_EQ(CT_ZSTD, compressionOf(handle));
+  close(handle);
+  ASSERT_STREQ("gzip", compressionName(CT_GZIP));
+}
+TEST(DecompressorTest, lineAgent) {
+  FEW_TESTS();
+  auto text = createText(10000);
+  auto name = writeGzip("decompressor.txt.gz", text, 3);
+  auto logger = buildMemoryLogger(100, LV_DEBUG);
+  LineAgent agent(logger);
+  // A compressed file is never mapped:
+  agent.setMemoryMapped(true);
+  ASSERT_TRUE(agent.openFile(name.c_str()));
+  ASSERT_FALSE(agent.isMapped());
+  size_t length;
+  for (int ix = 0; ix < 10000; ix++) {
+    auto line = agent.nextLine(length);
+    ASSERT_TRUE(line != nullptr);
+    ASSERT_EQ(
+        formatCString("line %d: %s", ix,
+            std::string(ix % 100, 'a' + ix % 26).c_str()),
+        std::string(line, length));
+  }
+  ASSERT_EQ(nullptr, agent.nextLine(length));
+  ASSERT_FALSE(agent.hasBinaryData());
+  delete logger;
+}
+TEST(DecompressorTest, lineReader) {
+  FEW_TESTS();
+  auto text = createText(1000);
+  auto name = writeGzip("decompressor.txt.gz", text);
+  auto logger = buildMemoryLogger(100, LV_DEBUG);
+  LineReader reader(name.c_str(), *logger, true, 100);
+  for (int ix = 0; ix < 1000; ix++) {
+    ASSERT_FALSE(reader.endOfFile());
+    ASSERT_EQ(
+        formatCString("line %d: %s", ix,
+            std::string(ix % 100, 'a' + ix % 26).c_str()), reader.nextLine());
+  }
+  ASSERT_TRUE(reader.endOfFile());
+  reader.reset();
+  ASSERT_EQ("line 0: ", reader.nextLine());
+  delete logger;
+}
+TEST(DecompressorTest, wordCounter) {
+  FEW_TESTS();
+  auto text = createText(1000);
+  auto name = writeGzip("decompressor.txt.gz", text, 2);
+  WordCounter counter;
+  char buffer[4096];
+  ASSERT_TRUE(counter.countFile(name.c_str(), buffer, sizeof buffer));
+  ASSERT_EQ(1000U, counter._lines);
+  ASSERT_EQ(text.size(), counter._bytes);
+}
+TEST(DecompressorTest, truncated) {
+  FEW_TESTS();
+  auto text = createText(1000);
+  auto name = writeGzip("decompressor.txt.gz", text);
+  struct stat status;
+  ASSERT_EQ(0, stat(name.c_str(), &status));
+  ASSERT_EQ(0, truncate(name.c_str(), status.st_size / 2));
+  WordCounter counter;
+  char buffer[4096];
+  ASSERT_FALSE(counter.countFile(name.c_str(), buffer, sizeof buffer));
+  auto logger = buildMemoryLogger(100, LV_DEBUG);
+  LineAgent agent(logger);
+  ASSERT_TRUE(agent.openFile(name.c_str()));
+  size_t length;
+  while (agent.nextLine(length) != nullptr) {
+  }
+  auto messages = dynamic_cast<MemoryAppender*>(logger->findAppender("memory"))->linesAsString();
+  ASSERT_NE(std::string::npos, messages.find("corrupted or truncated"));
+  delete logger;
+}
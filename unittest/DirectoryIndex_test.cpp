@@ -0,0 +1,230 @@
+/*
+ * DirectoryIndex_test.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+#include <set>
+using namespace cppknife;
+
+static bool onlyFewTests() {
+  return false;
+}
+#define FEW_TESTS() if (onlyFewTests()) return
+
+static const char *indexFile = "/tmp/unittest/dirindex.idx";
+
+static std::string createIndexTree() {
+  auto rc = buildFileTree(
+      R"""(/tmp/unittest/dirindex/file1.txt;332
+/tmp/unittest/dirindex/file2.dat;80
+/tmp/unittest/dirindex/dir1/file3.txt;85
+/tmp/unittest/dirindex/dir1/dir2/file4.txt;90
+/tmp/unittest/dirindex/dir4/file6.txt;110
+)""");
+  // An old modification time: a new file changes it for sure.
+  struct timespec times[2];
+  times[0].tv_sec = times[1].tv_sec = 1600000000;
+  times[0].tv_nsec = times[1].tv_nsec = 0;
+  utimensat(AT_FDCWD, (rc + "dir1").c_str(), times, 0);
+  unlink((rc + "dir1/file5.txt").c_str());
+  unlink(indexFile);
+  return rc;
+}
+static std::set<std::string> collect(Traverser &traverser) {
+  std::set<std::string> rc;
+  int level = 0;
+  FsEntry *entry;
+  while ((entry = traverser.nextFile(level)) != nullptr) {
+    rc.insert(entry->fullName());
+  }
+  return rc;
+}
+TEST(DirectoryIndexTest, record) {
+  FEW_TESTS();
+  std::vector<IndexEntry> entries;
+  std::string nodes;
+  const char *names[] = { "a.txt", "b", "c.dat" };
+  int64_t sizes[] = { 100, 4096, 300 };
+  uint32_t modes[] = { S_IFREG | 0644, S_IFDIR | 0755, S_IFREG | 0600 };
+  for (size_t ix = 0; ix < 3; ix++) {
+    IndexEntry entry;
+    memset(&entry, 0, sizeof entry);
+    entry._size = sizes[ix];
+    entry._mtimeSeconds = 1000 + ix;
+    entry._mode = modes[ix];
+    entry._nodeOffset = nodes.size();
+    entries.push_back(entry);
+    nodes.append(names[ix], strlen(names[ix]) + 1);
+  }
+  FileTime_t modified;
+  setFiletime(modified, 12345, 678);
+  std::string record;
+  DirectoryIndex::buildRecord(record, "/tmp/x", modified, entries, nodes, 1);
+  ASSERT_EQ(0U, record.size() % 8);
+  DirectoryIndex::RecordView view(record.data());
+  ASSERT_EQ(12345, view._record->_mtimeSeconds);
+  ASSERT_EQ(678, view._record->_mtimeNanoseconds);
+  ASSERT_EQ(2U, view._record->_files);
+  ASSERT_EQ(400, view._record->_sizes);
+  ASSERT_STREQ("/tmp/x", view.path());
+  ASSERT_STREQ("c.dat", view.node(view.entries()[2]));
+  // largest: c.dat youngest: c.dat oldest: a.txt
+  ASSERT_EQ(2U, view._record->_candidates);
+  ASSERT_EQ(0U, view.candidates()[0]);
+  ASSERT_EQ(2U, view.candidates()[1]);
+}
+TEST(DirectoryIndexTest, saveLoad) {
+  FEW_TESTS();
+  auto logger = buildMemoryLogger();
+  createIndexTree();
+  std::vector<IndexEntry> entries;
+  FileTime_t modified;
+  setFiletime(modified, 4711, 0);
+  {
+    DirectoryIndex index(indexFile, logger);
+    ASSERT_FALSE(index.load());
+    const char *paths[] = { "/b", "/a", "/c/d" };
+    for (auto path : paths) {
+      std::string record;
+      DirectoryIndex::buildRecord(record, path, modified, entries, "", 5);
+      index.put(path, record);
+    }
+    ASSERT_TRUE(index.save());
+    ASSERT_TRUE(index.find("/a") != nullptr);
+    ASSERT_TRUE(index.find("/c/d") != nullptr);
+    ASSERT_TRUE(index.find("/c") == nullptr);
+  }
+  DirectoryIndex index(indexFile, logger);
+  ASSERT_TRUE(index.load());
+  ASSERT_STREQ("/b", DirectoryIndex::RecordView(index.find("/b")).path());
+  // All records below /c are obsolete:
+  index.finishTree("/c");
+  ASSERT_TRUE(index.save());
+  ASSERT_TRUE(index.find("/c/d") == nullptr);
+  ASSERT_TRUE(index.find("/a") != nullptr);
+  delete logger;
+}
+TEST(DirectoryIndexTest, loadCorrupted) {
+  FEW_TESTS();
+  auto logger = buildMemoryLogger();
+  createIndexTree();
+  std::vector<IndexEntry> entries(2);
+  memset(entries.data(), 0, entries.size() * sizeof(IndexEntry));
+  entries[0]._mode = entries[1]._mode = S_IFREG | 0644;
+  entries[1]._nodeOffset = 2;
+  FileTime_t modified;
+  setFiletime(modified, 4711, 0);
+  {
+    DirectoryIndex index(indexFile, logger);
+    std::string record;
+    DirectoryIndex::buildRecord(record, "/a", modified, entries,
+        std::string("x\0y\0", 4), 1);
+    index.put("/a", record);
+    ASSERT_TRUE(index.save());
+  }
+  auto contents = readAsString(indexFile);
+  // The header is followed by the only record:
+  size_t offset = 24;
+  std::function<void(IndexRecord &record)> corruptions[] = { [](
+      IndexRecord &record) {
+    record._entries = 0x10000000;
+  }, [](IndexRecord &record) {
+    record._candidates = 100;
+  }, [](IndexRecord &record) {
+    record._pathLength = 0x7fffffff;
+  }, [](IndexRecord &record) {
+    // The '\0' of the path is the 'x' of the first node:
+    record._pathLength++;
+  }, [](IndexRecord &record) {
+    reinterpret_cast<IndexEntry*>(&record + 1)[1]._nodeOffset = 0x1000;
+  }, [](IndexRecord &record) {
+    reinterpret_cast<uint32_t*>(reinterpret_cast<IndexEntry*>(&record + 1) + 2)[0] =
+        2;
+  } };
+  for (auto &corrupt : corruptions) {
+    std::string data(contents);
+    corrupt(*reinterpret_cast<IndexRecord*>(&data[offset]));
+    writeText(indexFile, data.c_str(), data.size());
+    DirectoryIndex index(indexFile, logger);
+    ASSERT_FALSE(index.load());
+    ASSERT_TRUE(index.find("/a") == nullptr);
+  }
+  writeText(indexFile, contents.c_str(), contents.size());
+  DirectoryIndex index(indexFile, logger);
+  ASSERT_TRUE(index.load());
+  DirectoryIndex::RecordView view(index.find("/a"));
+  ASSERT_STREQ("y", view.node(view.entries()[1]));
+  delete logger;
+}
+TEST(DirectoryIndexTest, incremental) {
+  FEW_TESTS();
+  auto logger = buildMemoryLogger();
+  auto base = createIndexTree();
+  DirEntryFilter filter;
+  std::set<std::string> expected;
+  int files = 0;
+  int64_t sizes = 0;
+  {
+    Traverser traverser(base.c_str(), &filter, nullptr, logger);
+    expected = collect(traverser);
+    files = traverser.files();
+    sizes = traverser.sizes();
+  }
+  {
+    Traverser traverser(base.c_str(), &filter, nullptr, logger);
+    traverser.setIndexFile(indexFile);
+    auto agent = dynamic_cast<IndexedFileAgent*>(traverser.fileAgent());
+    ASSERT_EQ(expected, collect(traverser));
+    ASSERT_EQ(4U, agent->scannedDirectories());
+    ASSERT_EQ(0U, agent->cachedDirectories());
+    ASSERT_EQ(files, traverser.files());
+    ASSERT_EQ(sizes, traverser.sizes());
+  }
+  {
+    Traverser traverser(base.c_str(), &filter, nullptr, logger);
+    traverser.setIndexFile(indexFile);
+    auto agent = dynamic_cast<IndexedFileAgent*>(traverser.fileAgent());
+    ASSERT_EQ(expected, collect(traverser));
+    ASSERT_EQ(0U, agent->scannedDirectories());
+    ASSERT_EQ(4U, agent->cachedDirectories());
+    ASSERT_EQ(files, traverser.files());
+    ASSERT_EQ(sizes, traverser.sizes());
+  }
+  writeText((base + "dir1/file5.txt").c_str(), "12345");
+  {
+    Traverser traverser(base.c_str(), &filter, nullptr, logger);
+    traverser.setIndexFile(indexFile);
+    auto agent = dynamic_cast<IndexedFileAgent*>(traverser.fileAgent());
+    auto found = collect(traverser);
+    ASSERT_EQ(expected.size() + 1, found.size());
+    ASSERT_TRUE(found.find(base + "dir1/file5.txt") != found.end());
+    // Only dir1 has been changed:
+    ASSERT_EQ(1U, agent->scannedDirectories());
+    ASSERT_EQ(3U, agent->cachedDirectories());
+    ASSERT_EQ(sizes + 5, traverser.sizes());
+  }
+  delete logger;
+}
+TEST(DirectoryIndexTest, candidatesOnly) {
+  FEW_TESTS();
+  auto logger = buildMemoryLogger();
+  auto base = createIndexTree();
+  DirEntryFilter filter;
+  Traverser traverser(base.c_str(), &filter, nullptr, logger);
+  traverser.setIndexFile(indexFile);
+  auto agent = dynamic_cast<IndexedFileAgent*>(traverser.fileAgent());
+  agent->setCandidatesOnly(1);
+  auto found = collect(traverser);
+  // Each directory delivers the largest, youngest and oldest file and its subdirectories:
+  ASSERT_TRUE(found.find(base + "file1.txt") != found.end());
+  ASSERT_TRUE(found.find(base + "dir1") != found.end());
+  ASSERT_TRUE(found.find(base + "dir1/dir2/file4.txt") != found.end());
+  // The statistic contains all files:
+  ASSERT_EQ(5, traverser.files());
+  ASSERT_EQ(697, traverser.sizes());
+  delete logger;
+}
@@ -0,0 +1,64 @@
+/*
+ * DirectoryQueue_test.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+using namespace cppknife;
+
+static bool onlyFewTests() {
+  return false;
+}
+#define FEW_TESTS() if (onlyFewTests()) return
+
+/**
+ * Pushes and pops interleaved and returns the popped paths.
+ */
+static std::vector<std::string> runQueue(DirectoryQueue &queue) {
+  std::vector<std::string> rc;
+  char path[64];
+  std::string popped;
+  int level;
+  for (int round = 0; round < 20; round++) {
+    for (int ix = 0; ix < 50; ix++) {
+      snprintf(path, sizeof path, "/data/dir%02d/sub%03d", round, ix);
+      queue.push(path, round);
+    }
+    for (int ix = 0; ix < 30 && queue.pop(popped, level); ix++) {
+      rc.push_back(popped);
+    }
+  }
+  while (queue.pop(popped, level)) {
+    rc.push_back(popped);
+  }
+  return rc;
+}
+TEST(DirectoryQueueTest, depthFirstSpill) {
+  FEW_TESTS();
+  DirectoryQueue reference(true, 0);
+  DirectoryQueue queue(true, 500);
+  auto expected = runQueue(reference);
+  auto found = runQueue(queue);
+  ASSERT_EQ(0U, reference.spilledBlocks());
+  ASSERT_LT(0U, queue.spilledBlocks());
+  ASSERT_EQ(1000U, found.size());
+  ASSERT_TRUE(expected == found);
+  ASSERT_TRUE(queue.empty());
+  ASSERT_EQ(0U, queue.memoryUsage());
+}
+TEST(DirectoryQueueTest, breadthFirstSpill) {
+  FEW_TESTS();
+  DirectoryQueue reference(false, 0);
+  DirectoryQueue queue(false, 500);
+  auto expected = runQueue(reference);
+  auto found = runQueue(queue);
+  ASSERT_LT(0U, queue.spilledBlocks());
+  ASSERT_EQ(1000U, found.size());
+  ASSERT_STREQ("/data/dir00/sub000", found[0].c_str());
+  ASSERT_STREQ("/data/dir19/sub049", found[999].c_str());
+  ASSERT_TRUE(expected == found);
+  ASSERT_TRUE(queue.empty());
+}
@@ -0,0 +1,125 @@
+/*
+ * DuplicateFinder_test.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+using namespace cppknife;
+
+static bool onlyFewTests() {
+  return false;
+}
+#define FEW_TESTS() if (onlyFewTests()) return
+
+/**
+ * Creates the test files:
+ * small1/small2/small3: identical, small4: same size, other content
+ * large1/large2: identical (larger than 2 * PARTIAL_SIZE)
+ * large3: same size, start and end as large1, differs in the middle
+ */
+static std::string createDedupTree() {
+  std::string base = temporaryFile("dedup", "unittest");
+  ensureDirectory(base.c_str());
+  ensureDirectory((base + "/dir1").c_str());
+  std::string small(1000, 'x');
+  writeText((base + "/small1.txt").c_str(), small.c_str());
+  writeText((base + "/dir1/small2.txt").c_str(), small.c_str());
+  writeText((base + "/dir1/small3.txt").c_str(), small.c_str());
+  small[500] = 'y';
+  writeText((base + "/small4.txt").c_str(), small.c_str());
+  writeText((base + "/single.txt").c_str(), "unique");
+  std::string large(3 * DuplicateFinder::PARTIAL_SIZE + 1, 'a');
+  for (size_t ix = 0; ix < large.size(); ix += 7) {
+    large[ix] = static_cast<char>('a' + ix % 26);
+  }
+  writeBinary((base + "/large1.dat").c_str(), large.c_str(), large.size());
+  writeBinary((base + "/dir1/large2.dat").c_str(), large.c_str(),
+      large.size());
+  large[large.size() / 2] = '!';
+  writeBinary((base + "/large3.dat").c_str(), large.c_str(), large.size());
+  return base;
+}
+/**
+ * Simulates hash collisions: all files have the same hash.
+ */
+class CollidingFinder: public DuplicateFinder {
+public:
+  CollidingFinder(Logger *logger, int threads) :
+      DuplicateFinder(logger, threads) {
+  }
+protected:
+  virtual bool hashFile(Candidate &candidate, bool partial) {
+    bool rc = DuplicateFinder::hashFile(candidate, partial);
+    candidate._hash = 4711;
+    return rc;
+  }
+};
+static void findDuplicates(int threads, bool colliding = false) {
+  auto logger = buildMemoryLogger();
+  auto base = createDedupTree();
+  DirEntryFilter filter;
+  filter._types = FsEntry::TF_REGULAR;
+  Traverser traverser(base.c_str(), &filter, nullptr, logger);
+  std::unique_ptr<DuplicateFinder> finder2(
+      colliding ?
+          new CollidingFinder(logger, threads) :
+          new DuplicateFinder(logger, threads));
+  DuplicateFinder &finder = *finder2;
+  int level;
+  FsEntry *entry;
+  while ((entry = traverser.nextFile(level)) != nullptr) {
+    finder.add(entry->fullName(), entry->fileSize());
+  }
+  // The groups ordered by size, the largest first:
+  std::map<FileSize_t, std::vector<std::string>, std::greater<FileSize_t>> bySize;
+  finder.find([&bySize](const DuplicateFinder::Group &group) {
+    auto &files = bySize[group._size];
+    for (auto file : group._files) {
+      files.push_back(file);
+    }
+  });
+  std::vector<std::vector<std::string>> groups;
+  for (auto &item : bySize) {
+    groups.push_back(item.second);
+  }
+  ASSERT_EQ(2U, groups.size());
+  ASSERT_EQ(2U, finder.groups());
+  ASSERT_EQ(3U, finder.duplicates());
+  ASSERT_EQ(0U, finder.errors());
+  // The names are sorted:
+  ASSERT_EQ(2U, groups[0].size());
+  ASSERT_STREQ((base + "/dir1/large2.dat").c_str(), groups[0][0].c_str());
+  ASSERT_STREQ((base + "/large1.dat").c_str(), groups[0][1].c_str());
+  ASSERT_EQ(3U, groups[1].size());
+  ASSERT_STREQ((base + "/small1.txt").c_str(), groups[1][2].c_str());
+  ASSERT_EQ(3 * DuplicateFinder::PARTIAL_SIZE + 1 + 2 * 1000,
+      finder.wastedBytes());
+  ASSERT_LT(0U, finder.comparedBytes());
+  delete logger;
+}
+TEST(DuplicateFinderTest, singleThread) {
+  FEW_TESTS();
+  findDuplicates(1);
+}
+TEST(DuplicateFinderTest, threads) {
+  FEW_TESTS();
+  findDuplicates(4);
+}
+TEST(DuplicateFinderTest, hashCollision) {
+  FEW_TESTS();
+  // small4 and large3 are separated by the comparison only:
+  findDuplicates(1, true);
+  findDuplicates(4, true);
+}
+TEST(DuplicateFinderTest, hashBlock) {
+  FEW_TESTS();
+  std::string data(100, 'x');
+  auto hash = DuplicateFinder::hashBlock(data.c_str(), data.size(), 0);
+  ASSERT_EQ(hash, DuplicateFinder::hashBlock(data.c_str(), data.size(), 0));
+  ASSERT_NE(hash, DuplicateFinder::hashBlock(data.c_str(), data.size(), 1));
+  data[99] = 'y';
+  ASSERT_NE(hash, DuplicateFinder::hashBlock(data.c_str(), data.size(), 0));
+}
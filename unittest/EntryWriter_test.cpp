@@ -0,0 +1,117 @@
+/*
+ * EntryWriter_test.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+using namespace cppknife;
+
+static bool onlyFewTests() {
+  return false;
+}
+#define FEW_TESTS() if (onlyFewTests()) return
+
+static std::string createWriterTree() {
+  auto rc = buildFileTree(
+      R"""(/tmp/unittest/writer/file1.txt;332
+/tmp/unittest/writer/dir1/file2.txt;85
+/tmp/unittest/writer/dir1/a"b.txt;27
+)""");
+  return rc;
+}
+/**
+ * Writes all entries of a tree with a given writer.
+ */
+static size_t writeTree(const std::string &base, EntryWriter &writer) {
+  auto logger = buildMemoryLogger();
+  DirEntryFilter filter;
+  Traverser traverser(base.c_str(), &filter, nullptr, logger);
+  int level;
+  FsEntry *entry;
+  while ((entry = traverser.nextFile(level)) != nullptr) {
+    writer.write(*entry, level);
+  }
+  writer.flush();
+  delete logger;
+  return writer.entries();
+}
+TEST(EntryWriterTest, ndjson) {
+  FEW_TESTS();
+  auto base = createWriterTree();
+  auto name = temporaryFile("list.ndjson", "unittest");
+  FILE *output = fopen(name.c_str(), "w");
+  ASSERT_TRUE(output != nullptr);
+  {
+    NdjsonEntryWriter writer(output);
+    ASSERT_EQ(4U, writeTree(base, writer));
+    ASSERT_FALSE(writer.error());
+  }
+  fclose(output);
+  auto contents = readAsString(name.c_str());
+  auto lines = splitCString(contents.c_str(), "\n");
+  // The last line is empty:
+  ASSERT_EQ(5U, lines.size());
+  ASSERT_NE(std::string::npos,
+      contents.find(
+          "{\"path\":\"" + base + "file1.txt\",\"type\":\"f\",\"size\":332,"));
+  ASSERT_NE(std::string::npos,
+      contents.find(
+          "{\"path\":\"" + base + "dir1\",\"type\":\"d\",\"size\":0,"));
+  ASSERT_NE(std::string::npos, contents.find("dir1/a\\\"b.txt\""));
+  ASSERT_NE(std::string::npos,
+      contents.find(formatCString(",\"uid\":%d,", getuid())));
+}
+TEST(EntryWriterTest, binary) {
+  FEW_TESTS();
+  auto base = createWriterTree();
+  auto name = temporaryFile("list.bin", "unittest");
+  FILE *output = fopen(name.c_str(), "wb");
+  ASSERT_TRUE(output != nullptr);
+  {
+    // A tiny chunk size: one block per record.
+    BinaryEntryWriter writer(output, 10);
+    ASSERT_EQ(4U, writeTree(base, writer));
+  }
+  fclose(output);
+  struct stat status;
+  ASSERT_EQ(0, stat(name.c_str(), &status));
+  // Magic, 4 blocks with header and one record, the names:
+  ASSERT_EQ(
+      8 + 4 * (8 + sizeof(BinaryEntryWriter::Record)) + 4 * base.size() + 9
+          + 4 + 14 + 12, static_cast<size_t>(status.st_size));
+  FILE *input = fopen(name.c_str(), "rb");
+  BinaryEntryReader reader(input);
+  BinaryEntryWriter::Record record;
+  std::string path;
+  std::map<std::string, BinaryEntryWriter::Record> found;
+  while (reader.next(record, path)) {
+    found[path] = record;
+  }
+  fclose(input);
+  ASSERT_FALSE(reader.error());
+  ASSERT_EQ(4U, found.size());
+  auto &file1 = found[base + "file1.txt"];
+  ASSERT_EQ(332, file1._size);
+  ASSERT_EQ(0, file1._level);
+  ASSERT_TRUE(S_ISREG(file1._mode));
+  ASSERT_EQ(getuid(), file1._uid);
+  auto &file2 = found[base + "dir1/file2.txt"];
+  ASSERT_EQ(85, file2._size);
+  ASSERT_EQ(1, file2._level);
+  ASSERT_TRUE(S_ISDIR(found[base + "dir1"]._mode));
+}
+TEST(EntryWriterTest, binaryWrongFormat) {
+  FEW_TESTS();
+  auto name = temporaryFile("list.wrong", "unittest");
+  writeText(name.c_str(), "{\"path\":\"x\"}\n");
+  FILE *input = fopen(name.c_str(), "rb");
+  BinaryEntryReader reader(input);
+  BinaryEntryWriter::Record record;
+  std::string path;
+  ASSERT_FALSE(reader.next(record, path));
+  ASSERT_TRUE(reader.error());
+  fclose(input);
+}
@@ -0,0 +1,84 @@
+/*
+ * FileExtrema_test.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+using namespace cppknife;
+
+static bool onlyFewTests() {
+  return false;
+}
+#define FEW_TESTS() if (onlyFewTests()) return
+
+TEST(FileExtremaTest, basic) {
+  FEW_TESTS();
+  FileExtrema extrema(3);
+  char path[64];
+  for (int ix = 0; ix < 1000; ix++) {
+    // sizes and times in a "random" order:
+    int value = (ix * 7919) % 1000;
+    snprintf(path, sizeof path, "/data/file%04d", value);
+    extrema.add(path, 1000000 + value, value * 10);
+  }
+  auto largest = extrema.largest().sorted();
+  ASSERT_EQ(3U, largest.size());
+  ASSERT_EQ(9970, largest[0]._key);
+  ASSERT_EQ(9990, largest[2]._key);
+  ASSERT_STREQ("/data/file0999", extrema.path(largest[2]));
+  auto oldest = extrema.oldest().sorted();
+  ASSERT_EQ(1000002, oldest[0]._key);
+  ASSERT_EQ(1000000, oldest[2]._key);
+  ASSERT_STREQ("/data/file0000", extrema.path(oldest[2]));
+  auto youngest = extrema.youngest().sorted();
+  ASSERT_EQ(1000999, youngest[2]._key);
+}
+TEST(FileExtremaTest, noSize) {
+  FEW_TESTS();
+  FileExtrema extrema(2);
+  extrema.add("/dir1", 100, -1);
+  extrema.add("/file1", 200, 33);
+  ASSERT_EQ(1U, extrema.largest().count());
+  ASSERT_EQ(2U, extrema.oldest().count());
+  ASSERT_STREQ("/dir1", extrema.path(extrema.oldest().sorted()[1]));
+}
+TEST(FileExtremaTest, merge) {
+  FEW_TESTS();
+  FileExtrema extrema1(5);
+  FileExtrema extrema2(5);
+  FileExtrema all(5);
+  char path[64];
+  for (int ix = 0; ix < 200; ix++) {
+    int value = (ix * 37) % 200;
+    snprintf(path, sizeof path, "/x/%d", value);
+    (ix % 2 == 0 ? extrema1 : extrema2).add(path, value, 2 * value);
+    all.add(path, value, 2 * value);
+  }
+  extrema1.merge(extrema2);
+  auto expected = all.largest().sorted();
+  auto found = extrema1.largest().sorted();
+  ASSERT_EQ(expected.size(), found.size());
+  for (size_t ix = 0; ix < expected.size(); ix++) {
+    ASSERT_EQ(expected[ix]._key, found[ix]._key);
+    ASSERT_STREQ(all.path(expected[ix]), extrema1.path(found[ix]));
+  }
+  ASSERT_EQ(0, extrema1.oldest().sorted()[4]._key);
+  ASSERT_EQ(199, extrema1.youngest().sorted()[4]._key);
+}
+TEST(FileExtremaTest, compaction) {
+  FEW_TESTS();
+  FileExtrema extrema(2);
+  std::string path(200, 'x');
+  // ascending sizes: each file is a new extremum, the pool must be compacted.
+  for (int ix = 0; ix < 20000; ix++) {
+    path.replace(0, 10, formatCString("%010d", ix));
+    extrema.add(path.c_str(), 5, ix);
+  }
+  auto largest = extrema.largest().sorted();
+  ASSERT_EQ(19999, largest[1]._key);
+  ASSERT_TRUE(startsWith(extrema.path(largest[1]), -1, "0000019999xxx"));
+  ASSERT_TRUE(startsWith(extrema.path(largest[0]), -1, "0000019998xxx"));
+}
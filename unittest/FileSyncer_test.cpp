@@ -0,0 +1,113 @@
+/*
+ * FileSyncer_test.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+using namespace cppknife;
+
+static bool onlyFewTests() {
+  return false;
+}
+#define FEW_TESTS() if (onlyFewTests()) return
+
+static const char *syncFiles[] = { "file1.txt", "file2.txt", "dir1/file3.txt",
+    "dir1/dir2/file4.txt", "link1", nullptr };
+
+static void syncTree(int threads) {
+  auto logger = buildMemoryLogger(100, LV_DETAIL);
+  auto source = temporaryFile("syncsource", "unittest");
+  auto target = temporaryFile(threads == 1 ? "synctarget1" : "synctarget4",
+      "unittest");
+  ensureDirectory((source + "/dir1/dir2").c_str());
+  ensureDirectory((source + "/empty").c_str());
+  writeText((source + "/file1.txt").c_str(), "Hello");
+  std::string large(300 * 1000, 'x');
+  writeText((source + "/file2.txt").c_str(), large.c_str());
+  writeText((source + "/dir1/file3.txt").c_str(), "file3");
+  writeText((source + "/dir1/dir2/file4.txt").c_str(), "file4");
+  unlink((source + "/link1").c_str());
+  symlink("file1.txt", (source + "/link1").c_str());
+  for (int ix = 0; syncFiles[ix] != nullptr; ix++) {
+    unlink((target + "/" + syncFiles[ix]).c_str());
+  }
+  {
+    FileSyncer syncer(logger, threads);
+    ASSERT_TRUE(syncer.sync(source.c_str(), target.c_str()));
+    ASSERT_EQ(5, syncer.copied());
+    ASSERT_EQ(0, syncer.unchanged());
+    ASSERT_EQ(300 * 1000 + 5 + 5 + 5, syncer.bytes());
+    ASSERT_EQ(0, syncer.methodCount(CM_NONE));
+  }
+  ASSERT_STREQ(large.c_str(),
+      readAsString((target + "/file2.txt").c_str()).c_str());
+  ASSERT_STREQ("file4",
+      readAsString((target + "/dir1/dir2/file4.txt").c_str()).c_str());
+  ASSERT_TRUE(isSymbolicLink((target + "/link1").c_str()));
+  ASSERT_TRUE(isDirectory((target + "/empty").c_str()));
+  struct stat status1, status2;
+  stat((source + "/file2.txt").c_str(), &status1);
+  stat((target + "/file2.txt").c_str(), &status2);
+  ASSERT_EQ(status1.st_mtim.tv_sec, status2.st_mtim.tv_sec);
+  {
+    // Nothing changed:
+    FileSyncer syncer(logger, threads);
+    ASSERT_TRUE(syncer.sync(source.c_str(), target.c_str()));
+    ASSERT_EQ(0, syncer.copied());
+    ASSERT_EQ(5, syncer.unchanged());
+  }
+  writeText((source + "/dir1/file3.txt").c_str(), "file3 changed");
+  {
+    FileSyncer syncer(logger, threads);
+    ASSERT_TRUE(syncer.sync(source.c_str(), target.c_str()));
+    ASSERT_EQ(1, syncer.copied());
+    ASSERT_EQ(4, syncer.unchanged());
+    ASSERT_TRUE(
+        strstr(syncer.statisticAsString().c_str(), "1 file(s) copied")
+            != nullptr);
+  }
+  ASSERT_STREQ("file3 changed",
+      readAsString((target + "/dir1/file3.txt").c_str()).c_str());
+  delete logger;
+}
+TEST(FileSyncerTest, sync) {
+  FEW_TESTS();
+  syncTree(1);
+}
+TEST(FileSyncerTest, syncThreads) {
+  FEW_TESTS();
+  syncTree(4);
+}
+TEST(FileSyncerTest, dryRun) {
+  FEW_TESTS();
+  auto logger = buildMemoryLogger();
+  auto source = temporaryFile("syncdry", "unittest");
+  auto target = temporaryFile("syncdrytarget", "unittest", false);
+  ensureDirectory(source.c_str());
+  writeText((source + "/file1.txt").c_str(), "Hello");
+  FileSyncer syncer(logger, 2, true);
+  ASSERT_TRUE(syncer.sync(source.c_str(), target.c_str()));
+  ASSERT_EQ(1, syncer.copied());
+  ASSERT_FALSE(fileExists((target + "/file1.txt").c_str()));
+  delete logger;
+}
+TEST(FileSyncerTest, copyFileContent) {
+  FEW_TESTS();
+  auto source = temporaryFile("copycontent.src", "unittest");
+  auto target = temporaryFile("copycontent.trg", "unittest");
+  std::string content(100 * 1000 + 3, 'z');
+  writeText(source.c_str(), content.c_str());
+  int sourceHandle = open(source.c_str(), O_RDONLY);
+  int targetHandle = open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  std::string message;
+  auto method = copyFileContent(sourceHandle, targetHandle, content.size(),
+      &message);
+  close(sourceHandle);
+  close(targetHandle);
+  ASSERT_NE(CM_NONE, method);
+  ASSERT_STREQ(content.c_str(), readAsString(target.c_str()).c_str());
+  ASSERT_STREQ("read/write", copyMethodName(CM_READ_WRITE));
+}
@@ -55,6 +55,13 @@ TEST(FileToolTest, makeDirectory) {
   if (osInfo()._osType == LINUX) {
     ASSERT_TRUE(makeDirectory("/tmp/unittest/dir1/dir2", true) >= 0);
     ASSERT_EQ(makeDirectory("/tmp/unittest"), 0);
+    rmdir("/tmp/unittest/mkdir1/mkdir2/mkdir3");
+    rmdir("/tmp/unittest/mkdir1/mkdir2");
+    makeDirectory("/tmp/unittest/mkdir1");
+    ASSERT_EQ(2, makeDirectory("/tmp/unittest/mkdir1/mkdir2/mkdir3", true));
+    ASSERT_TRUE(isDirectory("/tmp/unittest/mkdir1/mkdir2/mkdir3"));
+    rmdir("/tmp/unittest/mkdir1/mkdir2/mkdir3");
+    ASSERT_EQ(1, makeDirectory("/tmp/unittest/mkdir1/mkdir2/mkdir3"));
   } else {
     throw InternalError("missing FileTool::fileExists test");
   }
@@ -100,6 +107,17 @@ TEST(FileToolTest, filetimeToString) {
   auto t2 = filetimeToString(t1);
   ASSERT_STREQ(t2.c_str(), "1978.03.11 02:49:00");
 }
+TEST(FileToolTest, filetimeToStringBuffer) {
+  FEW_TESTS;
+  FileTime_t t1;
+  t1.tv_sec = 258428940;
+  t1.tv_nsec = 123100100;
+  char buffer[32];
+  ASSERT_STREQ(filetimeToString(t1).c_str(),
+      filetimeToString(t1, buffer, sizeof buffer));
+  // Too small: an empty string
+  ASSERT_STREQ("", filetimeToString(t1, buffer, 10));
+}
 
 TEST(FileToolTest, textToFile) {
   FEW_TESTS;
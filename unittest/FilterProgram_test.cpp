@@ -0,0 +1,96 @@
+/*
+ * FilterProgram_test.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+using namespace cppknife;
+
+static bool onlyFewTests() {
+  return false;
+}
+#define FEW_TESTS() if (onlyFewTests()) return
+
+static std::string createFilterTree() {
+  auto rc = buildFileTree(
+      R"""(/tmp/unittest/filterprogram/file1.txt;25
+/tmp/unittest/filterprogram/file2.txt;200
+/tmp/unittest/filterprogram/small.c;20
+/tmp/unittest/filterprogram/dir1/big.c;300
+/tmp/unittest/filterprogram/dir1/file3.txt;30
+/tmp/unittest/filterprogram/dir1/file4.txt;40
+)""");
+  return rc;
+}
+TEST(FilterProgramTest, order) {
+  FEW_TESTS();
+  DirEntryFilter filter;
+  filter._nodePatterns = new PatternList();
+  filter._nodePatterns->set("*.c", -1, true, ",");
+  filter._minSize = 100;
+  filter._types = FsEntry::TF_REGULAR;
+  filter.compile();
+  auto program = filter.program();
+  ASSERT_STREQ("name type size", program->orderAsString().c_str());
+  // A changed condition forces a new compilation:
+  filter._minSize = 0;
+  auto program2 = filter.program();
+  ASSERT_TRUE(program != program2);
+  ASSERT_STREQ("name type", program2->orderAsString().c_str());
+  delete filter._nodePatterns;
+  filter._nodePatterns = nullptr;
+}
+TEST(FilterProgramTest, statsAvoided) {
+  FEW_TESTS();
+  auto logger = buildMemoryLogger();
+  auto base = createFilterTree();
+  DirEntryFilter filter;
+  filter._nodePatterns = new PatternList();
+  filter._nodePatterns->set("*.c", -1, true, ",");
+  filter._minSize = 100;
+  filter.compile();
+  Traverser traverser(base.c_str(), &filter, nullptr, logger);
+  int level;
+  FsEntry *entry;
+  std::vector<std::string> found;
+  while ((entry = traverser.nextFile(level)) != nullptr) {
+    found.push_back(entry->node());
+  }
+  ASSERT_EQ(1, found.size());
+  ASSERT_STREQ("big.c", found[0].c_str());
+  auto program = filter.program();
+  // The *.txt files and the directories are rejected by name:
+  ASSERT_LE(5, program->statsAvoided());
+  ASSERT_EQ(2, program->evaluated(FilterProgram::P_SIZE));
+  ASSERT_EQ(1, program->rejected(FilterProgram::P_SIZE));
+  ASSERT_TRUE(
+      strstr(program->statisticAsString().c_str(), "stats avoided") != nullptr);
+  delete filter._nodePatterns;
+  filter._nodePatterns = nullptr;
+  delete logger;
+}
+TEST(FilterProgramTest, reorder) {
+  FEW_TESTS();
+  auto logger = buildMemoryLogger();
+  auto base = createFilterTree();
+  DirEntryFilter filter;
+  // The name pattern accepts all entries, the type rejects all files:
+  filter._nodePatterns = new PatternList();
+  filter._nodePatterns->set("*", -1, true, ",");
+  filter._types = FsEntry::TF_SUBDIR;
+  filter.compile();
+  Traverser traverser(base.c_str(), &filter, nullptr, logger);
+  int level;
+  while (traverser.nextFile(level) != nullptr) {
+  }
+  auto program = filter.program();
+  ASSERT_STREQ("name type", program->orderAsString().c_str());
+  program->reorder();
+  ASSERT_STREQ("type name", program->orderAsString().c_str());
+  delete filter._nodePatterns;
+  filter._nodePatterns = nullptr;
+  delete logger;
+}
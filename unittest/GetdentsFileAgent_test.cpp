@@ -0,0 +1,157 @@
+/*
+ * GetdentsFileAgent_test.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+using namespace cppknife;
+
+static bool onlyFewTests() {
+  return false;
+}
+#define FEW_TESTS() if (onlyFewTests()) return
+
+static std::string createGetdentsTree() {
+  auto rc =
+      buildFileTree(
+          R"""(/tmp/unittest/getdents/file1.txt;332
+/tmp/unittest/getdents/file2.dat;80
+/tmp/unittest/getdents/dir1/file3.txt;85
+/tmp/unittest/getdents/dir1/dir2/file4.txt;90
+/tmp/unittest/getdents/dir4/file6.txt;110
+/tmp/unittest/getdents/dir4/.git/file7.txt;120
+)""");
+  return rc;
+}
+static std::vector<std::string> collect(Traverser &traverser) {
+  std::vector<std::string> rc;
+  int level = 0;
+  FsEntry *entry;
+  while ((entry = traverser.nextFile(level)) != nullptr) {
+    rc.push_back(entry->fullName());
+  }
+  return rc;
+}
+TEST(GetdentsFileAgentTest, sameAsFts) {
+  FEW_TESTS();
+  auto logger = buildMemoryLogger();
+  auto base = createGetdentsTree();
+  DirEntryFilter filter;
+  Traverser traverser(base.c_str(), &filter, nullptr, logger);
+  auto expected = collect(traverser);
+  std::sort(expected.begin(), expected.end());
+  DirEntryFilter filter2;
+  Traverser traverser2(base.c_str(), &filter2, nullptr, logger);
+  traverser2.setLazyStatus(STATX_SIZE);
+  auto agent = dynamic_cast<GetdentsFileAgent*>(traverser2.fileAgent());
+  ASSERT_TRUE(agent != nullptr);
+  auto found = collect(traverser2);
+  std::sort(found.begin(), found.end());
+  ASSERT_EQ(expected, found);
+  ASSERT_EQ(traverser.files(), traverser2.files());
+  ASSERT_EQ(traverser.directories(), traverser2.directories());
+  ASSERT_EQ(817, traverser2.sizes());
+  delete logger;
+}
+TEST(GetdentsFileAgentTest, directoryAfterContent) {
+  FEW_TESTS();
+  auto logger = buildMemoryLogger();
+  auto base = createGetdentsTree();
+  DirEntryFilter filter;
+  Traverser traverser(base.c_str(), &filter, nullptr, logger);
+  traverser.setLazyStatus(0);
+  auto found = collect(traverser);
+  auto posDir = std::find(found.begin(), found.end(), base + "dir1/dir2");
+  auto posFile = std::find(found.begin(), found.end(),
+      base + "dir1/dir2/file4.txt");
+  ASSERT_TRUE(posDir != found.end());
+  ASSERT_TRUE(posFile < posDir);
+  ASSERT_TRUE(
+      std::find(found.begin(), found.end(), base) == found.end()
+          && std::find(found.begin(), found.end(), base.substr(0, base.size() - 1))
+              == found.end());
+  delete logger;
+}
+TEST(GetdentsFileAgentTest, nameOnlyWithoutStatus) {
+  FEW_TESTS();
+  auto logger = buildMemoryLogger();
+  auto base = createGetdentsTree();
+  DirEntryFilter filter;
+  filter._nodePatterns = new PatternList();
+  filter._nodePatterns->set("*.txt", -1, true, ",");
+  filter._pathPatterns = new PatternList();
+  filter._pathPatterns->set("*,-.git", -1, true, ",");
+  Traverser traverser(base.c_str(), &filter, nullptr, logger);
+  traverser.setLazyStatus(0);
+  auto agent = dynamic_cast<GetdentsFileAgent*>(traverser.fileAgent());
+  auto found = collect(traverser);
+  ASSERT_EQ(4U, found.size());
+  ASSERT_EQ(4, traverser.files());
+  ASSERT_EQ(0, traverser.sizes());
+  ASSERT_EQ(1, traverser._ignoredDirectories);
+  // d_type is supported by the file system of /tmp: no statx() is needed.
+  ASSERT_EQ(0U, agent->statusCalls());
+  delete filter._nodePatterns;
+  delete filter._pathPatterns;
+  delete logger;
+}
+TEST(GetdentsFileAgentTest, sizeFilter) {
+  FEW_TESTS();
+  auto logger = buildMemoryLogger();
+  auto base = createGetdentsTree();
+  DirEntryFilter filter;
+  filter._minSize = 100;
+  filter._types = FsEntry::TF_REGULAR;
+  Traverser traverser(base.c_str(), &filter, nullptr, logger);
+  traverser.setLazyStatus(0);
+  auto agent = dynamic_cast<GetdentsFileAgent*>(traverser.fileAgent());
+  ASSERT_EQ(static_cast<unsigned>(STATX_SIZE), agent->statusMask());
+  auto found = collect(traverser);
+  ASSERT_EQ(3U, found.size());
+  ASSERT_EQ(562, traverser.sizes());
+  // Only the regular files are stat-ed:
+  ASSERT_EQ(6U, agent->statusCalls());
+  delete logger;
+}
+TEST(GetdentsFileAgentTest, arenaNames) {
+  FEW_TESTS();
+  auto logger = buildMemoryLogger();
+  auto base = createGetdentsTree();
+  auto link = base + "dir1/link1";
+  unlink(link.c_str());
+  ASSERT_EQ(0, symlink("../file1.txt", link.c_str()));
+  DirEntryFilter filter;
+  Traverser traverser(base.c_str(), &filter, nullptr, logger);
+  traverser.setLazyStatus(STATX_TYPE | STATX_MTIME);
+  int level = 0;
+  FsEntry *entry;
+  int links = 0;
+  char fileTime[32];
+  while ((entry = traverser.nextFile(level)) != nullptr) {
+    ASSERT_EQ(strlen(entry->fullName()), entry->fullNameLength());
+    ASSERT_TRUE(endsWith(entry->fullName(), -1, entry->node()));
+    ASSERT_STREQ(entry->filetimeAsString().c_str(),
+        entry->filetimeToBuffer(fileTime, sizeof fileTime));
+    if (entry->isLink()) {
+      links++;
+      ASSERT_STREQ(link.c_str(), entry->fullName());
+      ASSERT_STREQ("../file1.txt", entry->linkTarget());
+      ASSERT_STREQ("../file1.txt", entry->linkReference().c_str());
+    } else {
+      ASSERT_STREQ("", entry->linkTarget());
+    }
+  }
+  ASSERT_EQ(1, links);
+  // The arenas are recycled: a second run gives the same names.
+  traverser.changeBase(base.c_str());
+  auto found = collect(traverser);
+  ASSERT_TRUE(std::find(found.begin(), found.end(), link) != found.end());
+  ASSERT_TRUE(
+      std::find(found.begin(), found.end(), base + "dir1/dir2/file4.txt")
+          != found.end());
+  unlink(link.c_str());
+  delete logger;
+}
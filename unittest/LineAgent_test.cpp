@@ -100,3 +100,264 @@ TEST(LineAgentTest, binaryData) {
   delete logger;
 }
 
+TEST(LineAgentTest, mappedBasics) {
+  FEW_TESTS;
+  auto theOsInfo(osInfo());
+  auto fn = theOsInfo._tempDirectorySeparator + "lineagent.test.txt";
+  writeText(fn.c_str(), "1\nabc\nABCDEFGH\nlast");
+  auto logger = buildMemoryLogger(100, LV_DEBUG);
+  LineAgent agent(logger);
+  agent.setMemoryMapped(true);
+  ASSERT_TRUE(agent.openFile(fn.c_str(), false, true));
+  ASSERT_TRUE(agent.isMapped());
+  size_t length = 0;
+  auto line = agent.nextLine(length);
+  ASSERT_EQ("1", std::string(line, length));
+  line = agent.nextLine(length);
+  ASSERT_EQ("abc", std::string(line, length));
+  ASSERT_EQ(2U, agent.offsetCurrentLine());
+  line = agent.nextLine(length);
+  ASSERT_EQ("ABCDEFGH", std::string(line, length));
+  ASSERT_EQ(3U, agent.currentLineNo());
+  size_t size = 0;
+  auto previous = agent.previousLine(1, size);
+  ASSERT_EQ("abc", std::string(previous, size));
+  previous = agent.previousLine(2, size);
+  ASSERT_EQ("1", std::string(previous, size));
+  ASSERT_EQ(nullptr, agent.previousLine(3, size));
+  ASSERT_FALSE(agent.eof());
+  line = agent.nextLine(length);
+  ASSERT_EQ("last", std::string(line, length));
+  ASSERT_TRUE(agent.eof());
+  ASSERT_EQ(nullptr, agent.nextLine(length));
+  ASSERT_FALSE(agent.hasBinaryData());
+  delete logger;
+}
+TEST(LineAgentTest, mappedSmallWindow) {
+  FEW_TESTS;
+  auto theOsInfo(osInfo());
+  auto fn = theOsInfo._tempDirectorySeparator + "lineagent.test.txt";
+  std::string contents;
+  for (int ix = 0; ix < 5000; ix++) {
+    contents += formatCString("line %d\n", ix);
+  }
+  // A line longer than the window:
+  std::string longLine(10000, 'x');
+  contents += longLine + "\nend\n";
+  writeText(fn.c_str(), contents.c_str());
+  auto logger = buildMemoryLogger(100, LV_DEBUG);
+  LineAgent agent(logger);
+  // One page: many lines cross the window end.
+  agent.setMemoryMapped(true, 4096);
+  ASSERT_TRUE(agent.openFile(fn.c_str()));
+  ASSERT_TRUE(agent.isMapped());
+  size_t length = 0;
+  size_t offset = 0;
+  for (int ix = 0; ix < 5000; ix++) {
+    auto expected = formatCString("line %d", ix);
+    auto line = agent.nextLine(length);
+    ASSERT_TRUE(line != nullptr);
+    ASSERT_EQ(expected, std::string(line, length));
+    ASSERT_EQ(offset, agent.offsetCurrentLine());
+    offset += length + 1;
+  }
+  auto line = agent.nextLine(length);
+  ASSERT_EQ(longLine, std::string(line, length));
+  line = agent.nextLine(length);
+  ASSERT_EQ("end", std::string(line, length));
+  ASSERT_EQ(nullptr, agent.nextLine(length));
+  ASSERT_EQ(5002U, agent.currentLineNo());
+  delete logger;
+}
+TEST(LineAgentTest, openRange) {
+  FEW_TESTS;
+  auto theOsInfo(osInfo());
+  auto fn = theOsInfo._tempDirectorySeparator + "lineagent.test.txt";
+  std::string contents;
+  for (int ix = 0; ix < 5000; ix++) {
+    contents += formatCString("line %d\n", ix);
+  }
+  writeText(fn.c_str(), contents.c_str());
+  auto logger = buildMemoryLogger(100, LV_DEBUG);
+  LineAgent agent(logger);
+  // The range: lines 1000..1999
+  size_t start = contents.find("line 1000\n");
+  size_t end = contents.find("line 2000\n");
+  agent.setMemoryMapped(true, 4096);
+  ASSERT_TRUE(agent.openRange(fn.c_str(), start, end));
+  size_t length = 0;
+  for (int ix = 1000; ix < 2000; ix++) {
+    auto line = agent.nextLine(length);
+    ASSERT_TRUE(line != nullptr);
+    ASSERT_EQ(formatCString("line %d", ix), std::string(line, length));
+  }
+  ASSERT_EQ(nullptr, agent.nextLine(length));
+  ASSERT_EQ(1000U, agent.currentLineNo());
+  // The same range as blocks:
+  ASSERT_TRUE(agent.openRange(fn.c_str(), start, end));
+  std::string blocks;
+  const char *block;
+  while ((block = agent.nextBlock(length)) != nullptr) {
+    blocks.append(block, length);
+  }
+  ASSERT_EQ(contents.substr(start, end - start), blocks);
+  // An empty range:
+  ASSERT_TRUE(agent.openRange(fn.c_str(), end, end));
+  ASSERT_EQ(nullptr, agent.nextLine(length));
+  delete logger;
+}
+TEST(LineAgentTest, mappedBinaryData) {
+  FEW_TESTS;
+  auto theOsInfo(osInfo());
+  auto fn = theOsInfo._tempDirectorySeparator + "lineagent.test.txt";
+  char data[] = { 'a', 'b', 'c', '\n', '1', '2', '\n', 1, 2 };
+  writeBinary(fn.c_str(), data, sizeof data);
+  auto logger = buildMemoryLogger(100, LV_DEBUG);
+  LineAgent agent(logger);
+  agent.setMemoryMapped(true);
+  ASSERT_TRUE(agent.openFile(fn.c_str()));
+  size_t length;
+  agent.nextLine(length);
+  agent.nextLine(length);
+  ASSERT_FALSE(agent.hasBinaryData());
+  auto line = agent.nextLine(length);
+  ASSERT_EQ("\001\002", std::string(line, length));
+  ASSERT_TRUE(agent.hasBinaryData());
+  data[1] = '\0';
+  writeBinary(fn.c_str(), data, sizeof data);
+  ASSERT_FALSE(agent.openFile(fn.c_str(), true));
+  ASSERT_TRUE(agent.hasBinaryData());
+  delete logger;
+}
+TEST(LineAgentTest, nextCandidateLine) {
+  FEW_TESTS;
+  auto theOsInfo(osInfo());
+  auto fn = theOsInfo._tempDirectorySeparator + "lineagent.test.txt";
+  std::string contents;
+  std::vector<size_t> expected;
+  for (int ix = 1; ix <= 5000; ix++) {
+    if (ix % 97 == 0 || ix == 1 || ix == 2222) {
+      expected.push_back(ix);
+      contents += formatCString("line %d: a hit\n", ix);
+    } else if (ix == 3000) {
+      // Longer than the window, the literal near the end:
+      contents += std::string(10000, 'x') + " hi" + "t\n";
+      expected.push_back(ix);
+    } else if (ix == 4000) {
+      contents += std::string(10000, 'y') + "\n";
+    } else {
+      contents += formatCString("line %d: nothing\n", ix);
+    }
+  }
+  // The last line without '\n':
+  contents += "last line";
+  writeText(fn.c_str(), contents.c_str());
+  auto logger = buildMemoryLogger(100, LV_DEBUG);
+  RegexPrefilter prefilter;
+  prefilter.setLiteral("hit");
+  for (int mapped = 0; mapped < 2; mapped++) {
+    LineAgent agent(logger);
+    agent.setMemoryMapped(mapped != 0, 4096);
+    ASSERT_TRUE(agent.openFile(fn.c_str()));
+    size_t length = 0;
+    const char *line;
+    std::vector<size_t> found;
+    while ((line = agent.nextCandidateLine(prefilter, length)) != nullptr) {
+      ASSERT_TRUE(memmem(line, length, "hit", 3) != nullptr);
+      found.push_back(agent.currentLineNo());
+    }
+    ASSERT_EQ(expected, found);
+    if (mapped) {
+      // All lines behind the last candidate are counted too:
+      ASSERT_EQ(5001U, agent.currentLineNo());
+    }
+  }
+  // Binary data in the skipped lines: the line containing it is returned.
+  contents[contents.find("line 100: nothing") + 4] = '\x01';
+  writeText(fn.c_str(), contents.c_str());
+  LineAgent agent(logger);
+  agent.setMemoryMapped(true, 4096);
+  ASSERT_TRUE(agent.openFile(fn.c_str()));
+  size_t length = 0;
+  ASSERT_TRUE(agent.nextCandidateLine(prefilter, length) != nullptr);
+  ASSERT_TRUE(agent.nextCandidateLine(prefilter, length) != nullptr);
+  ASSERT_FALSE(agent.hasBinaryData());
+  ASSERT_TRUE(agent.nextCandidateLine(prefilter, length) != nullptr);
+  ASSERT_TRUE(agent.hasBinaryData());
+  ASSERT_EQ(100U, agent.currentLineNo());
+  delete logger;
+}
+TEST(LineAgentTest, readAhead) {
+  FEW_TESTS;
+  auto theOsInfo(osInfo());
+  auto fn = theOsInfo._tempDirectorySeparator + "lineagent.test.txt";
+  std::string contents;
+  for (int ix = 0; ix < 20000; ix++) {
+    contents += formatCString("line %d: %s\n", ix,
+        std::string(ix % 300, 'a' + ix % 26).c_str());
+  }
+  writeText(fn.c_str(), contents.c_str());
+  auto logger = buildMemoryLogger(100, LV_DEBUG);
+  for (size_t chunks = 0; chunks <= 8; chunks = chunks == 0 ? 1 : 2 * chunks) {
+    LineAgent agent(logger);
+    agent.setReadAhead(chunks);
+    // Many buffer switches:
+    agent.setBufferSize(chunks == 8 ? 512 : 0x10000);
+    ASSERT_TRUE(agent.openFile(fn.c_str()));
+    ASSERT_FALSE(agent.isMapped());
+    size_t length = 0;
+    size_t offset = 0;
+    for (int ix = 0; ix < 20000; ix++) {
+      auto expected = formatCString("line %d: %s", ix,
+          std::string(ix % 300, 'a' + ix % 26).c_str());
+      auto line = agent.nextLine(length);
+      ASSERT_TRUE(line != nullptr);
+      ASSERT_STREQ(expected.c_str(), line);
+      ASSERT_EQ(offset, agent.offsetCurrentLine());
+      offset += length + 1;
+    }
+    ASSERT_EQ(nullptr, agent.nextLine(length));
+    ASSERT_TRUE(agent.eof());
+  }
+  // Stopping the read thread before the end of file:
+  LineAgent agent(logger);
+  agent.setReadAhead(2);
+  agent.setBufferSize(0x1000);
+  ASSERT_TRUE(agent.openFile(fn.c_str()));
+  size_t length = 0;
+  ASSERT_STREQ("line 0: ", agent.nextLine(length));
+  ASSERT_TRUE(agent.openFile(fn.c_str()));
+  ASSERT_STREQ("line 0: ", agent.nextLine(length));
+  delete logger;
+}
+TEST(LineAgentTest, truncatedWhileReading) {
+  FEW_TESTS;
+  auto theOsInfo(osInfo());
+  auto fn = theOsInfo._tempDirectorySeparator + "lineagent.test.txt";
+  std::string contents;
+  for (int ix = 0; ix < 20000; ix++) {
+    contents += formatCString("line %d: %s\n", ix,
+        std::string(ix % 100, 'a' + ix % 26).c_str());
+  }
+  auto logger = buildMemoryLogger(100, LV_DEBUG);
+  for (size_t chunks = 0; chunks <= 2; chunks += 2) {
+    writeText(fn.c_str(), contents.c_str());
+    LineAgent agent(logger);
+    agent.setReadAhead(chunks);
+    agent.setBufferSize(0x1000);
+    ASSERT_TRUE(agent.openFile(fn.c_str()));
+    size_t length = 0;
+    ASSERT_STREQ("line 0: ", agent.nextLine(length));
+    // E.g. log rotation with "copytruncate": the file shrinks while it is read.
+    ASSERT_EQ(0, truncate(fn.c_str(), 0x8000));
+    const char *line;
+    size_t lines = 1;
+    while ((line = agent.nextLine(length)) != nullptr) {
+      ASSERT_EQ(0, strncmp("line ", line, 5)) << lines;
+      lines++;
+    }
+    ASSERT_TRUE(agent.eof());
+    ASSERT_GT(20000U, lines);
+  }
+  delete logger;
+}
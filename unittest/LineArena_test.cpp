@@ -0,0 +1,125 @@
+/*
+ * LineArena_test.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+#include "../text/text.hpp"
+
+using namespace cppknife;
+
+static bool fewTests() {
+  return false;
+}
+#define FEW_TESTS if (fewTests()) return
+
+static std::string writeLines(const char *node, const char *text) {
+  auto rc = temporaryFile(node, "unittest");
+  writeText(rc.c_str(), text);
+  return rc;
+}
+TEST(LineArenaTest, basics) {
+  FEW_TESTS;
+  auto logger = buildMemoryLogger();
+  auto fn = writeLines("arena1.txt", "abc\n\n123\nlast");
+  LineArena arena;
+  ASSERT_TRUE(arena.readFromFile(fn.c_str(), *logger));
+  ASSERT_FALSE(arena.isVectorMode());
+  ASSERT_EQ(4U, arena.size());
+  ASSERT_STREQ("abc", arena.line(0));
+  ASSERT_EQ(0U, arena.lineLength(1));
+  ASSERT_STREQ("123", arena.line(2));
+  ASSERT_STREQ("last", arena.line(3));
+  ASSERT_EQ("as", arena.substr(3, 1, 2));
+  // Copy on write:
+  arena.modifiable(0) += "def";
+  ASSERT_STREQ("abcdef", arena.line(0));
+  ASSERT_EQ(6U, arena.lineLength(0));
+  arena.insert(1, "inserted");
+  arena.erase(2, 3);
+  ASSERT_EQ(4U, arena.size());
+  ASSERT_STREQ("inserted", arena.line(1));
+  ASSERT_STREQ("123", arena.line(2));
+  // A copy is independent:
+  LineArena arena2(arena);
+  arena2.modifiable(1) = "changed";
+  ASSERT_STREQ("inserted", arena.line(1));
+  ASSERT_STREQ("changed", arena2.line(1));
+  // The vector adapter:
+  auto &strings = arena.strings();
+  ASSERT_TRUE(arena.isVectorMode());
+  ASSERT_EQ(4U, strings.size());
+  ASSERT_EQ("abcdef", strings[0]);
+  strings.push_back("vector");
+  ASSERT_EQ(5U, arena.size());
+  ASSERT_STREQ("vector", arena.line(4));
+  // Reading ends the vector mode:
+  ASSERT_TRUE(arena.readFromFile(fn.c_str(), *logger));
+  ASSERT_FALSE(arena.isVectorMode());
+  ASSERT_EQ(4U, arena.size());
+  delete logger;
+  unlink(fn.c_str());
+}
+TEST(LineArenaTest, binaryData) {
+  FEW_TESTS;
+  auto logger = buildMemoryLogger();
+  auto fn = temporaryFile("arena2.txt", "unittest");
+  std::string text(10000, 'x');
+  text[10] = text[20] = '\n';
+  text[5000] = '\x01';
+  writeText(fn.c_str(), text.c_str(), text.size());
+  LineArena arena;
+  // Only the lines in front of the binary data:
+  ASSERT_FALSE(arena.readFromFile(fn.c_str(), *logger));
+  ASSERT_EQ(2U, arena.size());
+  text[100] = '\0';
+  writeText(fn.c_str(), text.c_str(), text.size());
+  ASSERT_FALSE(arena.readFromFile(fn.c_str(), *logger));
+  ASSERT_EQ(0U, arena.size());
+  delete logger;
+  unlink(fn.c_str());
+}
+TEST(LineArenaTest, lineListArenaEqualsVector) {
+  FEW_TESTS;
+  auto logger = buildMemoryLogger();
+  std::string text;
+  for (int ix = 0; ix < 200; ix++) {
+    text += formatCString("line %d: value=%d\n", ix, ix * 7);
+  }
+  auto fn = writeLines("arena3.txt", text.c_str());
+  // The same operations in the arena mode and in the vector mode:
+  LineList arena(10, logger);
+  LineList vector(10, logger);
+  arena.readFromFile(fn.c_str());
+  vector.readFromFile(fn.c_str());
+  vector.lines();
+  std::regex backReference("!(\\d)");
+  for (auto list : { &arena, &vector }) {
+    list->deleteRange(BufferPosition(3, 5), BufferPosition(10, 2));
+    list->insert(BufferPosition(20, 4), "first\nsecond\nthird");
+    list->insert(BufferPosition(50, 0), "alone");
+    SearchExpression expression("value=(\\d+)", true);
+    ASSERT_TRUE(
+        list->replace(expression, "v=!1", -1, nullptr, nullptr, nullptr,
+            &backReference) > 100);
+    list->adapt("^line 100:", "line 100: adapted");
+    SearchResult result;
+    list->setPosition(0, 0);
+    ASSERT_TRUE(list->search(SearchExpression("v=14\\b", true), result, true));
+    ASSERT_EQ("v=14", list->lastHit());
+  }
+  ASSERT_FALSE(arena.constLines().empty());
+  ASSERT_EQ(-1, arena.indexOfFirstDifference(vector));
+  ASSERT_EQ(arena.countLines(), vector.countLines());
+  auto fn2 = temporaryFile("arena4.txt", "unittest");
+  arena.writeToFile(fn2.c_str(), true);
+  LineList reread(10, logger);
+  reread.readFromFile(fn2.c_str());
+  ASSERT_EQ(-1, reread.indexOfFirstDifference(vector));
+  delete logger;
+  unlink(fn.c_str());
+  unlink(fn2.c_str());
+}
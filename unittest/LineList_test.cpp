@@ -27,7 +27,7 @@ TEST(LineListTest, basics) {
   list1.writeToFile(fn.c_str());
   ASSERT_TRUE(fileExists(fn.c_str()));
   LineList list2(10, logger);
-  list2.readFromFile(fn.c_str(), true);
+  list2.readFromFile(fn.c_str());
   ASSERT_EQ(-1, list2.indexOfFirstDifference(list1));
   list2.lines()[1] += "!";
   ASSERT_EQ(1, list2.indexOfFirstDifference(list1));
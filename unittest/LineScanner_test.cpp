@@ -0,0 +1,94 @@
+/*
+ * LineScanner_test.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+using namespace cppknife;
+
+static bool onlyFewTests() {
+  return false;
+}
+#define FEW_TESTS() if (onlyFewTests()) return
+
+static const LineScanner::Kernel allKernels[] = { LineScanner::K_SCALAR,
+    LineScanner::K_SSE2, LineScanner::K_AVX2 };
+
+TEST(LineScannerTest, findLineEnd) {
+  FEW_TESTS();
+  // Longer than 2 AVX2 blocks:
+  std::string text(70, 'a');
+  text[40] = '\n';
+  text[66] = '\n';
+  for (auto kernel : allKernels) {
+    LineScanner scanner(kernel);
+    bool binary = false;
+    ASSERT_EQ(40U, scanner.findLineEnd(text.c_str(), text.size(), binary));
+    ASSERT_FALSE(binary);
+    ASSERT_EQ(25U, scanner.findLineEnd(text.c_str() + 41, text.size() - 41, binary));
+    ASSERT_EQ(3U, scanner.findLineEnd(text.c_str() + 67, 3, binary));
+    ASSERT_FALSE(binary);
+  }
+}
+TEST(LineScannerTest, binary) {
+  FEW_TESTS();
+  std::string text(70, 'x');
+  text[20] = '\t';
+  text[21] = '\r';
+  text[22] = '\f';
+  text[40] = '\n';
+  for (auto kernel : allKernels) {
+    text[50] = '\0';
+    LineScanner scanner(kernel);
+    bool binary = false;
+    // The '\0' behind the line end is not reported:
+    ASSERT_EQ(40U, scanner.findLineEnd(text.c_str(), text.size(), binary));
+    ASSERT_FALSE(binary);
+    ASSERT_EQ(29U, scanner.findLineEnd(text.c_str() + 41, text.size() - 41, binary));
+    ASSERT_TRUE(binary);
+    binary = false;
+    text[50] = '\033';
+    scanner.findLineEnd(text.c_str() + 41, text.size() - 41, binary);
+    ASSERT_TRUE(binary);
+    text[50] = 'x';
+    // Bytes >= 0x80 are not binary:
+    text[51] = '\xe4';
+    std::vector<uint32_t> lineEnds;
+    ASSERT_FALSE(scanner.indexBlock(text.c_str(), text.size(), lineEnds));
+    text[51] = 'x';
+  }
+}
+TEST(LineScannerTest, indexBlock) {
+  FEW_TESTS();
+  std::string text;
+  std::vector<uint32_t> expected;
+  for (int ix = 0; ix < 1000; ix++) {
+    text.append(ix % 37, 'a' + ix % 26);
+    expected.push_back(static_cast<uint32_t>(text.size()));
+    text += '\n';
+  }
+  text += "rest";
+  for (auto kernel : allKernels) {
+    LineScanner scanner(kernel);
+    std::vector<uint32_t> lineEnds;
+    ASSERT_FALSE(scanner.indexBlock(text.c_str(), text.size(), lineEnds));
+    ASSERT_EQ(expected, lineEnds);
+    // All offsets of the block:
+    for (size_t offset = 0; offset < 64; offset++) {
+      bool binary = false;
+      auto end = scanner.findLineEnd(text.c_str() + offset,
+          text.size() - offset, binary);
+      ASSERT_EQ('\n', text[offset + end]);
+    }
+  }
+}
+TEST(LineScannerTest, kernel) {
+  FEW_TESTS();
+  LineScanner scanner;
+  ASSERT_EQ(LineScanner::bestKernel(), scanner.kernel());
+  LineScanner scalar(LineScanner::K_SCALAR);
+  ASSERT_EQ(LineScanner::K_SCALAR, scalar.kernel());
+}
@@ -107,3 +107,52 @@ TEST(MatcherTest, filterMatches) {
   auto list2 = SimpleMatcher::filterMatches("*a*", list);
   ASSERT_STREQ("Adam,Bea", joinVector(list2, ",").c_str());
 }
+TEST(MatcherTest, keywordAutomaton) {
+  FEW_TESTS;
+  KeywordAutomaton automaton;
+  automaton.add("he", 2, 1);
+  automaton.add("she", 3, 2);
+  automaton.add("hers", 4, 3);
+  automaton.add(".CPP", 4, 4);
+  automaton.compile(true);
+  std::string hits;
+  automaton.scan("Ushers.cpp", 10, [&hits](int id, size_t end) {
+    hits += formatCString("%d:%d ", id, (int) end);
+    return true;
+  });
+  ASSERT_EQ("2:4 1:4 3:6 4:10 ", hits);
+  hits.clear();
+  // Stop after the first hit:
+  ASSERT_FALSE(automaton.scan("ushers", 6, [&hits](int id, size_t) {
+    hits += formatCString("%d ", id);
+    return false;
+  }));
+  ASSERT_EQ("2 ", hits);
+  automaton.compile(false);
+  hits.clear();
+  automaton.scan("A.cpp B.CPP", 11, [&hits](int id, size_t end) {
+    hits += formatCString("%d:%d ", id, (int) end);
+    return true;
+  });
+  ASSERT_EQ("4:11 ", hits);
+}
+TEST(MatcherTest, patternListAutomatonEqualsSequential) {
+  FEW_TESTS;
+  const char *lists[] = { ",*.c,*.h,*.cpp,*.hpp,Makefile,*.txt",
+      ",-*.o,-*.a,-*tmp*,-*~",
+      ",*.c,-test*,*.h,-*_old.*,*.cpp",
+      ",*,-*.bak,-*.o,-core",
+      ",a*b*c,*x*y*,q*,*.java,*.JS" };
+  const char *names[] = { "a.c", "x.H", "main.cpp", "test.cpp", "lib.a",
+      "Makefile", "Makefile.am", "a_old.c", "tmp", "xtmpy", "abc", "axbyc",
+      "q", "Q.java", "x.js", "core", "file~", "readme.txt", "", "x.o.bak" };
+  for (auto list : lists) {
+    for (int ignoreCase = 0; ignoreCase < 2; ignoreCase++) {
+      PatternList patterns;
+      patterns.set(list, -1, ignoreCase != 0);
+      for (auto name : names) {
+        ASSERT_EQ(patterns.matchSequential(name), patterns.match(name))<< list << " " << name;
+      }
+    }
+  }
+}
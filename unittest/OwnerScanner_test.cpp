@@ -0,0 +1,103 @@
+/*
+ * OwnerScanner_test.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+using namespace cppknife;
+
+static bool onlyFewTests() {
+  return false;
+}
+#define FEW_TESTS() if (onlyFewTests()) return
+
+static std::string createOwnerTree() {
+  auto rc = buildFileTree(
+      R"""(/tmp/unittest/owner/file1.txt;25
+/tmp/unittest/owner/dir1/file2.txt;20
+/tmp/unittest/owner/dir1/file3.txt;30
+/tmp/unittest/owner/dir1/dir2/file4.txt;40
+/tmp/unittest/owner/dir3/file5.txt;50
+)""");
+  if (geteuid() == 0) {
+    chown((rc + "dir1/file3.txt").c_str(), 4711, 4712);
+    chown((rc + "dir1/dir2").c_str(), 4711, -1);
+  }
+  return rc;
+}
+static std::vector<std::string> sortedLines(const std::string &text) {
+  auto rc = splitCString(text.c_str(), "\n");
+  std::sort(rc.begin(), rc.end());
+  return rc;
+}
+static void scanTree(const std::string &base, int threads, std::string &text,
+    const char *binaryFile, Logger *logger) {
+  auto textFile = temporaryFile("owner.txt", "unittest");
+  FILE *output = fopen(textFile.c_str(), "w");
+  FILE *binaryOutput = binaryFile == nullptr ? nullptr : fopen(binaryFile, "wb");
+  OwnerScanner scanner(logger, output, binaryOutput, threads);
+  ASSERT_TRUE(scanner.scan(base.c_str()));
+  scanner.finish();
+  ASSERT_EQ(5, scanner.countFiles());
+  ASSERT_EQ(3, scanner.countDirs());
+  ASSERT_EQ(0, scanner.countErrors());
+  fclose(output);
+  if (binaryOutput != nullptr) {
+    fclose(binaryOutput);
+  }
+  text = readAsString(textFile.c_str(), logger);
+}
+TEST(OwnerScannerTest, text) {
+  FEW_TESTS();
+  auto logger = buildMemoryLogger();
+  auto base = createOwnerTree();
+  std::string text;
+  scanTree(base, 1, text, nullptr, logger);
+  ASSERT_TRUE(strstr(text.c_str(), " /tmp/unittest/owner/\n") != nullptr);
+  if (geteuid() == 0) {
+    ASSERT_TRUE(strstr(text.c_str(), "\n=0 0 /tmp/unittest/owner/dir1\n") != nullptr);
+    ASSERT_TRUE(strstr(text.c_str(), "\n4711 4712 file3.txt\n") != nullptr);
+    ASSERT_TRUE(strstr(text.c_str(), "\n4711 0 dir2\n") != nullptr);
+    // The files of dir2 have another owner than dir2:
+    ASSERT_TRUE(strstr(text.c_str(), "\n=4711 0 /tmp/unittest/owner/dir1/dir2\n0 0 file4.txt\n") != nullptr);
+    ASSERT_TRUE(strstr(text.c_str(), "dir3") == nullptr);
+    ASSERT_TRUE(strstr(text.c_str(), "\nu4711 ") != nullptr);
+    ASSERT_TRUE(strstr(text.c_str(), "\ng4712 ") != nullptr);
+  }
+  delete logger;
+}
+TEST(OwnerScannerTest, binary) {
+  FEW_TESTS();
+  auto logger = buildMemoryLogger();
+  auto base = createOwnerTree();
+  auto binaryFile = temporaryFile("owner.bin", "unittest");
+  std::string text;
+  scanTree(base, 1, text, binaryFile.c_str(), logger);
+  std::string decoded;
+  ASSERT_TRUE(OwnerScanner::binaryToText(binaryFile.c_str(), decoded, logger));
+  ASSERT_EQ(text, decoded);
+  // The binary format is more compact:
+  ASSERT_TRUE(readAsString(binaryFile.c_str(), logger).size() < text.size());
+  writeText(binaryFile.c_str(), "CKOWNER1D\x05");
+  ASSERT_FALSE(OwnerScanner::binaryToText(binaryFile.c_str(), decoded, logger));
+  delete logger;
+}
+TEST(OwnerScannerTest, parallel) {
+  FEW_TESTS();
+  auto logger = buildMemoryLogger();
+  auto base = createOwnerTree();
+  std::string expected;
+  scanTree(base, 1, expected, nullptr, logger);
+  auto binaryFile = temporaryFile("owner.bin", "unittest");
+  std::string text;
+  scanTree(base, 4, text, binaryFile.c_str(), logger);
+  // The order of the directory blocks may differ:
+  ASSERT_EQ(sortedLines(expected), sortedLines(text));
+  std::string decoded;
+  ASSERT_TRUE(OwnerScanner::binaryToText(binaryFile.c_str(), decoded, logger));
+  ASSERT_EQ(text, decoded);
+  delete logger;
+}
@@ -0,0 +1,98 @@
+/*
+ * ParallelFileAgent_test.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+#include <set>
+using namespace cppknife;
+
+static bool onlyFewTests() {
+  return false;
+}
+#define FEW_TESTS() if (onlyFewTests()) return
+
+static std::string createParallelTree() {
+  auto rc =
+      buildFileTree(
+          R"""(/tmp/unittest/parallel/file1.txt;332
+/tmp/unittest/parallel/file2.dat;80
+/tmp/unittest/parallel/dir1/file3.txt;85
+/tmp/unittest/parallel/dir1/dir2/file4.txt;90
+/tmp/unittest/parallel/dir1/dir2/dir3/file5.txt;100
+/tmp/unittest/parallel/dir4/file6.txt;110
+/tmp/unittest/parallel/dir4/.git/file7.txt;120
+)""");
+  return rc;
+}
+static std::set<std::string> collect(Traverser &traverser) {
+  std::set<std::string> rc;
+  int level = 0;
+  FsEntry *entry;
+  while ((entry = traverser.nextFile(level)) != nullptr) {
+    rc.insert(entry->fullName());
+  }
+  return rc;
+}
+TEST(ParallelFileAgentTest, sameAsFts) {
+  FEW_TESTS();
+  auto logger = buildMemoryLogger();
+  auto base = createParallelTree();
+  DirEntryFilter filter;
+  Traverser traverser(base.c_str(), &filter, nullptr, logger);
+  auto expected = collect(traverser);
+  int files = traverser.files();
+  int64_t sizes = traverser.sizes();
+  DirEntryFilter filter2;
+  Traverser traverser2(base.c_str(), &filter2, nullptr, logger);
+  traverser2.setThreadCount(4);
+  ASSERT_EQ(4, traverser2.threadCount());
+  ASSERT_TRUE(traverser2.fileAgent()->isPrefiltered());
+  auto found = collect(traverser2);
+  ASSERT_EQ(expected, found);
+  ASSERT_EQ(files, traverser2.files());
+  ASSERT_EQ(sizes, traverser2.sizes());
+  ASSERT_EQ(917, traverser2.sizes());
+  delete logger;
+}
+TEST(ParallelFileAgentTest, filter) {
+  FEW_TESTS();
+  auto logger = buildMemoryLogger();
+  auto base = createParallelTree();
+  DirEntryFilter filter;
+  filter._nodePatterns = new PatternList();
+  filter._nodePatterns->set("*.txt", -1, true, ",");
+  filter._pathPatterns = new PatternList();
+  filter._pathPatterns->set("*,-.git", -1, true, ",");
+  filter._types = FsEntry::TF_REGULAR;
+  Traverser traverser(base.c_str(), &filter, nullptr, logger);
+  traverser.setThreadCount(3);
+  auto found = collect(traverser);
+  ASSERT_EQ(5U, found.size());
+  ASSERT_TRUE(found.find(base + "file1.txt") != found.end());
+  ASSERT_TRUE(found.find(base + "dir1/dir2/dir3/file5.txt") != found.end());
+  ASSERT_TRUE(found.find(base + "dir4/.git/file7.txt") == found.end());
+  ASSERT_EQ(5, traverser.files());
+  ASSERT_EQ(1, traverser._ignoredDirectories);
+  delete filter._nodePatterns;
+  delete filter._pathPatterns;
+  delete logger;
+}
+TEST(ParallelFileAgentTest, changeBase) {
+  FEW_TESTS();
+  auto logger = buildMemoryLogger();
+  auto base = createParallelTree();
+  DirEntryFilter filter;
+  Traverser traverser(base.c_str(), &filter, nullptr, logger);
+  traverser.setThreadCount(2);
+  int level = 0;
+  // Stop the traversal after the first entry:
+  ASSERT_TRUE(traverser.nextFile(level) != nullptr);
+  traverser.changeBase((base + "dir1").c_str());
+  auto found = collect(traverser);
+  ASSERT_EQ(5U, found.size());
+  delete logger;
+}
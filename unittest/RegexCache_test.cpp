@@ -0,0 +1,67 @@
+/*
+ * RegexCache_test.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+#include "../text/text.hpp"
+
+using namespace cppknife;
+
+static bool fewTests() {
+  return false;
+}
+#define FEW_TESTS if (fewTests()) return
+
+TEST(RegexCacheTest, basics) {
+  FEW_TESTS;
+  RegexCache cache(2);
+  auto regex1 = cache.get("a+b");
+  ASSERT_TRUE(std::regex_search("xaab", *regex1));
+  ASSERT_EQ(regex1.get(), cache.get("a+b").get());
+  ASSERT_EQ(1U, cache.countHits());
+  ASSERT_EQ(1U, cache.countMisses());
+  // The flags are part of the key:
+  auto regex2 = cache.get("a+b", std::regex::ECMAScript | std::regex::icase);
+  ASSERT_NE(regex1.get(), regex2.get());
+  ASSERT_TRUE(std::regex_search("AB", *regex2));
+  ASSERT_EQ(2U, cache.size());
+  // "a+b" is the most recently used: the icase entry is removed.
+  cache.get("a+b");
+  cache.get("c");
+  ASSERT_EQ(2U, cache.size());
+  ASSERT_EQ(regex1.get(), cache.get("a+b").get());
+  cache.get("a+b", std::regex::ECMAScript | std::regex::icase);
+  ASSERT_EQ("regex cache: 3 hit(s) 4 miss(es) 2 pattern(s)", cache.statistics());
+  // A removed entry stays valid:
+  ASSERT_TRUE(std::regex_search("aB", *regex2));
+  ASSERT_THROW(cache.get("(a"), std::regex_error);
+  auto engine = cache.getEngine("a+b", true);
+  ASSERT_TRUE(engine->search("xAB", 3));
+  ASSERT_EQ(engine.get(), cache.getEngine("a+b", true).get());
+  ASSERT_NE(engine.get(), cache.getEngine("a+b").get());
+  ASSERT_THROW(cache.getEngine("(a"), std::regex_error);
+  cache.setCapacity(0);
+  ASSERT_EQ(0U, cache.size());
+  cache.get("a");
+  ASSERT_EQ(0U, cache.size());
+  cache.clear();
+  ASSERT_EQ(0U, cache.countHits() + cache.countMisses());
+}
+TEST(RegexCacheTest, searchExpression) {
+  FEW_TESTS;
+  auto cache = RegexCache::instance();
+  auto hits = cache->countHits();
+  SearchExpression expression1("id=\\d+", true);
+  SearchExpression expression2;
+  expression2.set("id=\\d+", true, "");
+  ASSERT_EQ(expression1.engine(), expression2.engine());
+  ASSERT_EQ(expression1.regExpr(), expression2.regExpr());
+  ASSERT_LT(hits, cache->countHits());
+  expression2.set("id=\\d+", true, "i");
+  ASSERT_NE(expression1.regExpr(), expression2.regExpr());
+  ASSERT_TRUE(expression2.search("ID=3"));
+}
@@ -0,0 +1,167 @@
+/*
+ * RegexEngine_test.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+#include "../text/text.hpp"
+#include "../tools/ArgumentParser.hpp"
+
+using namespace cppknife;
+
+static bool fewTests() {
+  return false;
+}
+#define FEW_TESTS if (fewTests()) return
+
+static std::vector<std::string> randomTexts(size_t count, const char *alphabet,
+    size_t alphabetLength, unsigned seed = 4711) {
+  std::vector<std::string> rc;
+  for (size_t ix = 0; ix < count; ix++) {
+    std::string text;
+    size_t length = ix % 13;
+    for (size_t ix2 = 0; ix2 < length; ix2++) {
+      seed = seed * 1103515245 + 12345;
+      text += alphabet[(seed >> 16) % alphabetLength];
+    }
+    rc.push_back(text);
+  }
+  return rc;
+}
+
+TEST(RegexEngineTest, create) {
+  FEW_TESTS;
+  auto type = [](const char *pattern) {
+    std::unique_ptr<RegexEngine> engine(RegexEngine::create(pattern));
+    return engine->type();
+  };
+  ASSERT_EQ(RE_DFA, type("a+b"));
+  ASSERT_EQ(RE_DFA, type("^(?:id|no)=\\d{1,4}[^,]*$"));
+  ASSERT_EQ(RE_DFA, type("[\\w.-]+@x\\.com|\\x41\\u0042"));
+  // Back references, assertions and POSIX classes: std::regex.
+  ASSERT_EQ(RE_STD, type("(a)\\1"));
+  ASSERT_EQ(RE_STD, type("\\bword\\b"));
+  ASSERT_EQ(RE_STD, type("a(?=b)"));
+  ASSERT_EQ(RE_STD, type("[[:alpha:]]+"));
+  std::unique_ptr<RegexEngine> engine(RegexEngine::create("a+", true, false));
+  ASSERT_EQ(RE_STD, engine->type());
+  ASSERT_TRUE(engine->ignoreCase());
+  ASSERT_EQ("a+", engine->pattern());
+  ASSERT_THROW(RegexEngine::create("(a"), std::regex_error);
+  ASSERT_THROW(RegexEngine::create("a{2,1}"), std::regex_error);
+}
+TEST(RegexEngineTest, search) {
+  FEW_TESTS;
+  DfaRegexEngine engine("^ERROR.*\\d+ ms$");
+  ASSERT_TRUE(engine.isValid());
+  const char *text = "ERROR: took 123 ms";
+  ASSERT_TRUE(engine.search(text, strlen(text)));
+  // Not terminated by '\0': the text ends before " ms".
+  ASSERT_FALSE(engine.search(text, strlen(text) - 3));
+  text = " ERROR: took 123 ms";
+  ASSERT_FALSE(engine.search(text, strlen(text)));
+  DfaRegexEngine engine2("x*");
+  ASSERT_TRUE(engine2.search("", 0));
+  DfaRegexEngine engine3("[^a-c]", true);
+  ASSERT_FALSE(engine3.search("aBc", 3));
+  ASSERT_TRUE(engine3.search("aBcD", 4));
+  std::cmatch match;
+  DfaRegexEngine engine4("id=(\\d+)");
+  text = "name=x id=42 y";
+  ASSERT_TRUE(engine4.search(text, strlen(text), match));
+  ASSERT_EQ("42", match.str(1));
+  ASSERT_FALSE(engine4.search(text, 10, match));
+}
+TEST(RegexEngineTest, sameHitsAsStdRegex) {
+  FEW_TESTS;
+  const char *patterns[] = { "ab", "a|b", "a.b", "^a", "b$", "^$", "^a*$",
+      "a+b+", "(ab|ba)+x", "a?b?c", "[a-c]+[^ab]", "\\d\\D", "\\w+\\W",
+      "\\s\\S*", "A{2}", "a{1,3}b", "(?:a|B){2,}c", "x{0,2}y", "[\\d.]-",
+      "\\.|\\-", "(a|)b", "a*?b", "[\\n\\r]", "\\x41\\u0062", "\\t|\\0",
+      "(^a|b$)", "((a|b)c|\\.)+$", "a\\b" };
+  const char alphabet[] = "aAbBcC1_ .-x\t\n\r\0";
+  auto texts = randomTexts(3000, alphabet, sizeof alphabet);
+  texts.push_back("");
+  for (auto pattern : patterns) {
+    for (int ignoreCase = 0; ignoreCase < 2; ignoreCase++) {
+      std::regex regex(pattern,
+          ignoreCase ?
+              std::regex_constants::ECMAScript | std::regex_constants::icase :
+              std::regex_constants::ECMAScript);
+      std::unique_ptr<RegexEngine> engine(
+          RegexEngine::create(pattern, ignoreCase != 0));
+      for (auto &text : texts) {
+        ASSERT_EQ(std::regex_search(text, regex),
+            engine->search(text.c_str(), text.size()))<< pattern << " icase: " << ignoreCase << " text: " << text;
+      }
+    }
+  }
+}
+TEST(RegexEngineTest, tooManyStates) {
+  FEW_TESTS;
+  // The DFA needs 2**13 states: the remaining texts are searched by std::regex.
+  const char *pattern = "a[ab]{12}$";
+  DfaRegexEngine engine(pattern);
+  ASSERT_TRUE(engine.isValid());
+  std::regex regex(pattern);
+  auto texts = randomTexts(3000, "ab", 2);
+  for (auto &text : randomTexts(500, "ab", 2, 1234)) {
+    texts.push_back(text + text + text);
+  }
+  for (auto &text : texts) {
+    ASSERT_EQ(std::regex_search(text, regex),
+        engine.search(text.c_str(), text.size()))<< text;
+  }
+  ASSERT_LE(engine.countStates(), size_t(DfaRegexEngine::MAX_STATES));
+}
+TEST(RegexEngineTest, threads) {
+  FEW_TESTS;
+  const char *pattern = "(\\d+|x)[a-c]{2}\\.$";
+  std::regex regex(pattern);
+  DfaRegexEngine engine(pattern);
+  auto texts = randomTexts(20000, "12xabc.-", 8);
+  std::vector<int> errors(4, 0);
+  std::vector<std::thread> threads;
+  for (int ix = 0; ix < 4; ix++) {
+    // The states are built concurrently:
+    threads.emplace_back([&, ix]() {
+      for (size_t ix2 = ix; ix2 < texts.size(); ix2 += 2) {
+        auto &text = texts[ix2];
+        if (std::regex_search(text, regex)
+            != engine.search(text.c_str(), text.size())) {
+          errors[ix]++;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(0, errors[0] + errors[1] + errors[2] + errors[3]);
+}
+TEST(RegexEngineTest, argument) {
+  FEW_TESTS;
+  Parameter param("--search", "-s", DT_REGEXPR, "Help");
+  std::string value("!abc|123!i");
+  Argument argument(&param, value);
+  argument.validate();
+  std::unique_ptr<RegexEngine> engine(argument.asRegexEngine(0));
+  ASSERT_EQ(RE_DFA, engine->type());
+  ASSERT_TRUE(engine->ignoreCase());
+  ASSERT_TRUE(engine->search("xABC", 4));
+  ASSERT_FALSE(engine->search("12", 2));
+}
+TEST(RegexEngineTest, searchExpression) {
+  FEW_TESTS;
+  SearchExpression expression("^id=(\\d+)$", true, "i");
+  ASSERT_EQ(RE_DFA, expression.engine()->type());
+  ASSERT_TRUE(expression.search("ID=12"));
+  ASSERT_FALSE(expression.search("ID=12 "));
+  ASSERT_EQ(&expression.engine()->regex(), expression.regExpr());
+  std::cmatch match;
+  ASSERT_TRUE(expression.engine()->search("id=42", 5, match));
+  ASSERT_EQ("42", match.str(1));
+}
@@ -0,0 +1,106 @@
+/*
+ * RegexPrefilter_test.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+#include "../text/text.hpp"
+
+using namespace cppknife;
+
+static bool fewTests() {
+  return false;
+}
+#define FEW_TESTS if (fewTests()) return
+
+TEST(RegexPrefilterTest, requiredLiteral) {
+  FEW_TESTS;
+  auto literal = [](const char *pattern) {
+    return RegexPrefilter::requiredLiteral(pattern, strlen(pattern));
+  };
+  ASSERT_EQ("ERROR", literal("ERROR"));
+  ASSERT_EQ("timeout", literal("^ERR.*timeout\\s+\\d+$"));
+  ASSERT_EQ("192.168.", literal("\\b192\\.168\\.\\d+"));
+  // Optional and repeated atoms:
+  ASSERT_EQ("abc", literal("abcd?e"));
+  ASSERT_EQ("xyzz", literal("a?xyzz+q"));
+  ASSERT_EQ("value", literal("name{0,3}value"));
+  ASSERT_EQ("names", literal("names{2}va"));
+  // Classes, groups and escapes:
+  ASSERT_EQ("]", literal("[a\\]b]]+\\d"));
+  ASSERT_EQ("end", literal("(a|b)+end"));
+  ASSERT_EQ("\ttab", literal("\\ttab\\w"));
+  ASSERT_EQ("", literal("\\d+[a-z]*"));
+  ASSERT_EQ("", literal(".*"));
+  ASSERT_EQ("", literal(""));
+}
+TEST(RegexPrefilterTest, splitAlternatives) {
+  FEW_TESTS;
+  ASSERT_EQ("a(b|c)+d [|] \\|", joinVector(RegexPrefilter::splitAlternatives("a(b|c)+d|[|]|\\|"), " "));
+  ASSERT_EQ("", joinVector(RegexPrefilter::splitAlternatives(""), " "));
+  ASSERT_EQ("a ", joinVector(RegexPrefilter::splitAlternatives("a|"), " "));
+}
+TEST(RegexPrefilterTest, find) {
+  FEW_TESTS;
+  RegexPrefilter prefilter;
+  ASSERT_TRUE(prefilter.compile("ERROR.*timeout"));
+  ASSERT_EQ(1U, prefilter.literals().size());
+  ASSERT_EQ("timeout", prefilter.literals()[0]);
+  const char *text = "a timeout\nERROR: timeout";
+  ASSERT_EQ(text + 2, prefilter.find(text, strlen(text)));
+  ASSERT_FALSE(prefilter.mayMatch(text, 8));
+  // Alternatives: the first literal in the text:
+  ASSERT_TRUE(prefilter.compile("warning: \\d+|(fatal|error)? failure"));
+  ASSERT_EQ("warning: , failure", joinVector(prefilter.literals(), ","));
+  text = "a failure, warning: 3";
+  ASSERT_EQ(text + 1, prefilter.find(text, strlen(text)));
+  // Ignore case:
+  ASSERT_TRUE(prefilter.compile("error", true));
+  text = "An ERROR";
+  ASSERT_EQ(text + 3, prefilter.find(text, strlen(text)));
+  // An alternative without literal: no prefilter.
+  ASSERT_FALSE(prefilter.compile("error|\\d+"));
+  ASSERT_FALSE(prefilter.isActive());
+  ASSERT_TRUE(prefilter.mayMatch("x", 1));
+  prefilter.setLiteral("abc");
+  ASSERT_TRUE(prefilter.isActive());
+  ASSERT_FALSE(prefilter.mayMatch("ABC", 3));
+}
+TEST(RegexPrefilterTest, sameHitsAsRegex) {
+  FEW_TESTS;
+  const char *patterns[] = { "ERROR.*timeout", "id=\\d+ (ok|failed)",
+      "^x+y", "user (alice|bob)\\b", "\\[warn\\]|fatal", "[Tt]ime:? \\d+",
+      "a.b.c" };
+  std::vector<std::string> lines;
+  const char *words[] = { "ERROR", "timeout", "id=", "17", " ok", " failed",
+      "x", "y", "user ", "alice", "bob", "[warn]", "fatal", "Time", "time: ",
+      "3", "a", "b", "c", "-" };
+  unsigned seed = 4711;
+  for (int ix = 0; ix < 3000; ix++) {
+    std::string line;
+    int count = 1 + ix % 7;
+    for (int word = 0; word < count; word++) {
+      seed = seed * 1103515245 + 12345;
+      line += words[(seed >> 16) % 20];
+    }
+    lines.push_back(line);
+  }
+  for (auto pattern : patterns) {
+    for (int ignoreCase = 0; ignoreCase < 2; ignoreCase++) {
+      std::regex regex(pattern,
+          ignoreCase ?
+              std::regex_constants::ECMAScript | std::regex_constants::icase :
+              std::regex_constants::ECMAScript);
+      RegexPrefilter prefilter;
+      prefilter.compile(pattern, ignoreCase != 0);
+      for (auto &line : lines) {
+        if (std::regex_search(line, regex)) {
+          ASSERT_TRUE(prefilter.mayMatch(line.c_str(), line.size()))<< pattern << ": " << line;
+        }
+      }
+    }
+  }
+}
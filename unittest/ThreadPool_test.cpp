@@ -0,0 +1,52 @@
+/*
+ * ThreadPool_test.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+using namespace cppknife;
+
+static bool onlyFewTests() {
+  return false;
+}
+#define FEW_TESTS() if (onlyFewTests()) return
+
+TEST(ThreadPoolTest, basic) {
+  FEW_TESTS();
+  ThreadPool pool(4);
+  ASSERT_EQ(4, pool.countThreads());
+  std::atomic<int> sum(0);
+  for (int ix = 1; ix <= 1000; ix++) {
+    pool.submit([&sum, ix]() {
+      sum += ix;
+    });
+  }
+  pool.waitIdle();
+  ASSERT_EQ(500500, sum);
+}
+static void recursiveTask(ThreadPool &pool, std::atomic<int> &count,
+    int depth) {
+  ++count;
+  if (depth > 0) {
+    for (int ix = 0; ix < 3; ix++) {
+      pool.submit([&pool, &count, depth]() {
+        recursiveTask(pool, count, depth - 1);
+      });
+    }
+  }
+}
+TEST(ThreadPoolTest, submitFromWorker) {
+  FEW_TESTS();
+  ThreadPool pool(3);
+  std::atomic<int> count(0);
+  pool.submit([&pool, &count]() {
+    recursiveTask(pool, count, 6);
+  });
+  pool.waitIdle();
+  // 1 + 3 + 9 + ... + 3**6
+  ASSERT_EQ(1093, count);
+  ASSERT_EQ(-1, pool.currentWorker());
+}
@@ -83,4 +83,62 @@ TEST(TraverserTest, labor) {
     fts_close(fts);
   }
 }
-
+static std::vector<std::string> traverseOrdered(const std::string &base,
+    Traverser::TraversalOrder order, std::vector<int> *levels = nullptr) {
+  auto logger = buildMemoryLogger();
+  DirEntryFilter filter;
+  Traverser traverser(base.c_str(), &filter, nullptr, logger);
+  // A tiny budget forces the spill file:
+  traverser.setTraversalOrder(order, 100);
+  std::vector<std::string> rc;
+  int level;
+  FsEntry *entry;
+  while ((entry = traverser.nextFile(level)) != nullptr) {
+    rc.push_back(entry->fullName());
+    if (levels != nullptr) {
+      levels->push_back(level);
+    }
+  }
+  delete logger;
+  return rc;
+}
+TEST(TraverserTest, depthFirst) {
+  FEW_TESTS();
+  // The base ends with a separator:
+  auto base = createTree();
+  auto found = traverseOrdered(base, Traverser::TO_DEPTH_FIRST);
+  ASSERT_EQ(6U, found.size());
+  auto dir1 = std::find(found.begin(), found.end(), base + "dir1");
+  auto dir2 = std::find(found.begin(), found.end(), base + "dir1/dir2");
+  auto file3 = std::find(found.begin(), found.end(),
+      base + "dir1/dir2/file3.txt");
+  // A directory is returned before its content:
+  ASSERT_TRUE(dir1 < dir2);
+  ASSERT_TRUE(dir2 < file3);
+}
+TEST(TraverserTest, breadthFirst) {
+  FEW_TESTS();
+  auto base = createTree();
+  std::vector<int> levels;
+  auto found = traverseOrdered(base, Traverser::TO_BREADTH_FIRST, &levels);
+  ASSERT_EQ(6U, found.size());
+  for (size_t ix = 1; ix < levels.size(); ix++) {
+    ASSERT_LE(levels[ix - 1], levels[ix]);
+  }
+  ASSERT_STREQ((base + "dir1/dir2/file3.txt").c_str(), found[5].c_str());
+  ASSERT_EQ(2, levels[5]);
+}
+TEST(TraverserTest, deepTree) {
+  FEW_TESTS();
+  // Deeper than the former limit of 256 levels:
+  std::string base = temporaryFile("deeptree", "unittest");
+  std::string path = base;
+  for (int ix = 0; ix < 300; ix++) {
+    path += "/d";
+  }
+  ensureDirectory(path.c_str());
+  writeText((path + "/deep.txt").c_str(), "deep");
+  auto found = traverseOrdered(base, Traverser::TO_DEPTH_FIRST);
+  ASSERT_EQ(301U, found.size());
+  ASSERT_STREQ((path + "/deep.txt").c_str(), found[300].c_str());
+}
@@ -0,0 +1,105 @@
+/*
+ * TreeWatcher_test.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+using namespace cppknife;
+
+static bool onlyFewTests() {
+  return false;
+}
+#define FEW_TESTS() if (onlyFewTests()) return
+
+static std::string createWatchedTree() {
+  std::string base = temporaryFile("watcher", "unittest");
+  const char *files[] = { "/dir1/dir2/new.txt", "/dir1/new.txt", "/file1.txt",
+      "/dir1/file2.txt", nullptr };
+  for (int ix = 0; files[ix] != nullptr; ix++) {
+    unlink((base + files[ix]).c_str());
+  }
+  rmdir((base + "/dir1/dir2").c_str());
+  ensureDirectory((base + "/dir1").c_str());
+  writeText((base + "/file1.txt").c_str(), "12345");
+  writeText((base + "/dir1/file2.txt").c_str(), "1234567890");
+  return base;
+}
+/**
+ * Processes the events until the watcher has seen the expected count of files.
+ */
+static void waitForFiles(TreeWatcher &watcher, int files) {
+  for (int ix = 0; ix < 50 && watcher.statistic()._files != files; ix++) {
+    watcher.poll(20);
+  }
+  // The remaining events of the batch:
+  while (watcher.poll(20) > 0) {
+  }
+}
+TEST(TreeWatcherTest, basic) {
+  FEW_TESTS();
+  auto logger = buildMemoryLogger();
+  auto base = createWatchedTree();
+  TreeWatcher watcher(logger, 5);
+  ASSERT_TRUE(watcher.start(base.c_str()));
+  ASSERT_EQ(2, watcher.statistic()._files);
+  ASSERT_EQ(2, watcher.statistic()._directories);
+  ASSERT_EQ(15, watcher.statistic()._sizes);
+  ASSERT_EQ(10, watcher.directorySize((base + "/dir1").c_str()));
+  // A new file:
+  writeText((base + "/dir1/new.txt").c_str(), "abc");
+  waitForFiles(watcher, 3);
+  ASSERT_EQ(18, watcher.statistic()._sizes);
+  ASSERT_EQ(13, watcher.directorySize((base + "/dir1").c_str()));
+  ASSERT_EQ(18, watcher.directorySize(base.c_str()));
+  // A changed file:
+  writeText((base + "/file1.txt").c_str(), "1234567");
+  for (int ix = 0; ix < 50 && watcher.statistic()._sizes != 20; ix++) {
+    watcher.poll(20);
+  }
+  ASSERT_EQ(20, watcher.statistic()._sizes);
+  auto largest = watcher.extrema().largest().sorted();
+  ASSERT_EQ(3U, largest.size());
+  ASSERT_EQ(10, largest[2]._key);
+  ASSERT_EQ(7, largest[1]._key);
+  // A removed file:
+  unlink((base + "/file1.txt").c_str());
+  waitForFiles(watcher, 2);
+  ASSERT_EQ(13, watcher.statistic()._sizes);
+  ASSERT_EQ(2U, watcher.extrema().largest().count());
+  ASSERT_LE(3U, watcher.changes());
+  delete logger;
+}
+TEST(TreeWatcherTest, directories) {
+  FEW_TESTS();
+  auto logger = buildMemoryLogger();
+  auto base = createWatchedTree();
+  TreeWatcher watcher(logger);
+  ASSERT_TRUE(watcher.start(base.c_str()));
+  ensureDirectory((base + "/dir1/dir2").c_str());
+  writeText((base + "/dir1/dir2/new.txt").c_str(), "abcd");
+  waitForFiles(watcher, 3);
+  ASSERT_EQ(3, watcher.statistic()._directories);
+  ASSERT_EQ(4, watcher.directorySize((base + "/dir1/dir2").c_str()));
+  ASSERT_EQ(14, watcher.directorySize((base + "/dir1").c_str()));
+  // A moved directory: the old name is forgotten, the new name is scanned.
+  auto moved = temporaryFile("watcher.moved", "unittest");
+  unlink((moved + "/dir1/dir2/new.txt").c_str());
+  unlink((moved + "/dir1/file2.txt").c_str());
+  rmdir((moved + "/dir1/dir2").c_str());
+  rmdir((moved + "/dir1").c_str());
+  ensureDirectory(moved.c_str());
+  rename((base + "/dir1").c_str(), (moved + "/dir1").c_str());
+  waitForFiles(watcher, 1);
+  ASSERT_EQ(1, watcher.statistic()._directories);
+  ASSERT_EQ(5, watcher.statistic()._sizes);
+  ASSERT_EQ(-1, watcher.directorySize((base + "/dir1").c_str()));
+  rename((moved + "/dir1").c_str(), (base + "/dir1").c_str());
+  waitForFiles(watcher, 3);
+  ASSERT_EQ(3, watcher.statistic()._directories);
+  ASSERT_EQ(19, watcher.statistic()._sizes);
+  ASSERT_EQ(4, watcher.directorySize((base + "/dir1/dir2").c_str()));
+  delete logger;
+}
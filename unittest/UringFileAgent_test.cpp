@@ -0,0 +1,124 @@
+/*
+ * UringFileAgent_test.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+using namespace cppknife;
+
+static bool onlyFewTests() {
+  return false;
+}
+#define FEW_TESTS() if (onlyFewTests()) return
+
+static std::string createUringTree() {
+  auto rc = buildFileTree(
+      R"""(/tmp/unittest/uring/file1.txt;332
+/tmp/unittest/uring/file3.txt;80
+/tmp/unittest/uring/dir1/file4.txt;85
+/tmp/unittest/uring/dir1/dir2/file3.txt;90
+)""");
+  return rc;
+}
+static std::set<std::string> traverseAsync(const std::string &base,
+    unsigned queueDepth, DirEntryFilter &filter, DirTreeStatistic *statistic =
+        nullptr) {
+  auto logger = buildMemoryLogger();
+  Traverser traverser(base.c_str(), &filter, nullptr, logger);
+  traverser.setAsyncStatus(queueDepth);
+  std::set<std::string> rc;
+  int level;
+  FsEntry *entry;
+  while ((entry = traverser.nextFile(level)) != nullptr) {
+    rc.insert(formatCString("%s:%d:%c", entry->fullName(), level,
+        entry->typeAsChar()));
+  }
+  if (statistic != nullptr) {
+    *statistic = traverser;
+  }
+  delete logger;
+  return rc;
+}
+TEST(UringFileAgentTest, ring) {
+  FEW_TESTS();
+  auto base = createUringTree();
+  if (!IoUring::isAvailable()) {
+    return;
+  }
+  IoUring ring(4);
+  ASSERT_TRUE(ring.valid());
+  auto name1 = base + "file1.txt";
+  auto name2 = base + "dir1";
+  struct statx status1, status2;
+  ASSERT_TRUE(
+      ring.prepareStatus(AT_FDCWD, name1.c_str(), AT_SYMLINK_NOFOLLOW,
+          STATX_BASIC_STATS, &status1, 1));
+  ASSERT_TRUE(
+      ring.prepareStatus(AT_FDCWD, name2.c_str(), AT_SYMLINK_NOFOLLOW,
+          STATX_BASIC_STATS, &status2, 2));
+  ASSERT_TRUE(ring.submit(2));
+  uint64_t userData;
+  int result;
+  int found = 0;
+  while (ring.nextCompletion(userData, result)) {
+    ASSERT_EQ(0, result);
+    found |= static_cast<int>(userData);
+  }
+  ASSERT_EQ(3, found);
+  ASSERT_EQ(332U, status1.stx_size);
+  ASSERT_TRUE(S_ISDIR(status2.stx_mode));
+}
+TEST(UringFileAgentTest, traverse) {
+  FEW_TESTS();
+  auto base = createUringTree();
+  DirEntryFilter filter;
+  DirTreeStatistic statistic;
+  auto found = traverseAsync(base, 4, filter, &statistic);
+  // Completion order: the result is compared as set.
+  std::set<std::string> expected = { base + "file1.txt:0: ", base
+      + "file3.txt:0: ", base + "dir1:0:d", base + "dir1/file4.txt:1: ", base
+      + "dir1/dir2:1:d", base + "dir1/dir2/file3.txt:2: " };
+  ASSERT_EQ(expected, found);
+  ASSERT_EQ(4, statistic._files);
+  ASSERT_EQ(332 + 80 + 85 + 90, statistic._sizes);
+  ASSERT_EQ(3, statistic._directories);
+}
+TEST(UringFileAgentTest, smallQueue) {
+  FEW_TESTS();
+  auto base = temporaryFile("uring.many", "unittest");
+  ensureDirectory(base.c_str());
+  for (int ix = 0; ix < 100; ix++) {
+    writeText(formatCString("%s/file%03d.txt", base.c_str(), ix).c_str(), "x");
+  }
+  DirEntryFilter filter;
+  DirTreeStatistic statistic;
+  // More entries than requests in flight:
+  auto found = traverseAsync(base, 1, filter, &statistic);
+  ASSERT_EQ(100U, found.size());
+  ASSERT_EQ(100, statistic._files);
+  ASSERT_EQ(100, statistic._sizes);
+  ASSERT_EQ(1U, found.count(base + "/file099.txt:0: "));
+}
+TEST(UringFileAgentTest, maxDepth) {
+  FEW_TESTS();
+  auto base = createUringTree();
+  DirEntryFilter filter;
+  filter._maxDepth = 0;
+  filter._types = FsEntry::TF_REGULAR;
+  auto found = traverseAsync(base, 8, filter);
+  ASSERT_EQ(2U, found.size());
+  ASSERT_EQ(1U, found.count(base + "file1.txt:0: "));
+}
+TEST(UringFileAgentTest, certainFile) {
+  FEW_TESTS();
+  auto base = createUringTree();
+  UringFsEntry entry;
+  ASSERT_TRUE(entry.setCertainFile((base + "file3.txt").c_str()));
+  ASSERT_STREQ("file3.txt", entry.node());
+  ASSERT_EQ(80, entry.fileSize());
+  ASSERT_TRUE(entry.isRegular());
+  ASSERT_FALSE(entry.setCertainFile((base + "not.found").c_str()));
+}
@@ -0,0 +1,88 @@
+/*
+ * WordCounter_test.cpp
+ *
+ *  Created on: 16.10.2026
+ *      Author: seacocmd
+ *     License: CC0 1.0 Universal
+ */
+
+#include "google_test.hpp"
+using namespace cppknife;
+
+static bool onlyFewTests() {
+  return false;
+}
+#define FEW_TESTS() if (onlyFewTests()) return
+
+static void countInBlocks(WordCounter &counter, const std::string &text,
+    size_t blockSize) {
+  counter.reset();
+  for (size_t offset = 0; offset < text.size(); offset += blockSize) {
+    counter.count(text.data() + offset,
+        std::min(blockSize, text.size() - offset));
+  }
+  counter.finish();
+}
+TEST(WordCounterTest, basic) {
+  FEW_TESTS();
+  WordCounter counter(WordCounter::K_SCALAR);
+  countInBlocks(counter,
+      "adam: 1234   admin\njoe: 1235 user blocked\n\n  last line", 1000);
+  ASSERT_EQ(4U, counter._lines);
+  ASSERT_EQ(9U, counter._words);
+  ASSERT_EQ(54U, counter._bytes);
+  ASSERT_EQ(22U, counter._maxLength);
+  ASSERT_FALSE(counter._hasBinaryData);
+  countInBlocks(counter, std::string("abc\0def\n", 8), 1000);
+  ASSERT_TRUE(counter._hasBinaryData);
+}
+TEST(WordCounterTest, kernelsAreEqual) {
+  FEW_TESTS();
+  std::string text;
+  // Pseudo random text with long and short lines, words and separators:
+  const char *chars = "ab  \t\nxyz\n\n  word ";
+  unsigned int seed = 4711;
+  for (size_t ix = 0; ix < 100000; ix++) {
+    seed = seed * 1103515245 + 12345;
+    size_t index = (seed >> 16) % strlen(chars);
+    if ((seed >> 8) % 1000 == 0) {
+      // a long line:
+      text.append(300, 'x');
+    }
+    text += chars[index];
+  }
+  WordCounter reference(WordCounter::K_SCALAR);
+  countInBlocks(reference, text, text.size());
+  WordCounter::Kernel kernels[] = { WordCounter::K_SSE2, WordCounter::K_AVX2,
+      WordCounter::K_AUTO };
+  size_t blockSizes[] = { 1, 7, 16, 31, 32, 33, 4096, text.size() };
+  for (auto kernel : kernels) {
+    WordCounter counter(kernel);
+    for (auto blockSize : blockSizes) {
+      countInBlocks(counter, text, blockSize);
+      ASSERT_EQ(reference._lines, counter._lines);
+      ASSERT_EQ(reference._words, counter._words);
+      ASSERT_EQ(reference._bytes, counter._bytes);
+      ASSERT_EQ(reference._maxLength, counter._maxLength);
+      ASSERT_FALSE(counter._hasBinaryData);
+    }
+  }
+  text[50000] = '\0';
+  WordCounter counter(WordCounter::K_AUTO);
+  countInBlocks(counter, text, 4096);
+  ASSERT_TRUE(counter._hasBinaryData);
+}
+TEST(WordCounterTest, countFile) {
+  FEW_TESTS();
+  auto filename = temporaryFile("wordcounter.txt", "unittest");
+  writeText(filename.c_str(), "one two\nthree\n");
+  WordCounter counter;
+  char buffer[5];
+  ASSERT_TRUE(counter.countFile(filename.c_str(), buffer, sizeof buffer));
+  ASSERT_EQ(2U, counter._lines);
+  ASSERT_EQ(3U, counter._words);
+  ASSERT_EQ(14U, counter._bytes);
+  ASSERT_EQ(7U, counter._maxLength);
+  ASSERT_FALSE(counter.countFile("/tmp/unittest/not-existing.txt", buffer,
+      sizeof buffer));
+}
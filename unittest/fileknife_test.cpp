@@ -92,6 +92,22 @@ TEST(FileKnifeTest, list) {
           "0.001024 MB /tmp/unittest/dir1/dir2/dir3/file3.dat"));
   delete logger;
 }
+TEST(FileKnifeTest, listNdjson) {
+  FEW_TESTS();
+  auto base = initTree();
+  auto outputFile = temporaryFile("list.ndjson", "unittest");
+  const char *argv[] = { "list", "--format=ndjson", "-o", outputFile.c_str(),
+      base.c_str() };
+  auto logger = buildMemoryLogger(100, LV_SUMMARY);
+  ASSERT_EQ(0,
+      fileKnife(sizeof argv / sizeof argv[0], const_cast<char**>(argv), logger));
+  auto contents = readAsString(outputFile.c_str());
+  ASSERT_EQ(6U, splitCString(contents.c_str(), "\n").size() - 1);
+  ASSERT_NE(std::string::npos,
+      contents.find(
+          "{\"path\":\"/tmp/unittest/dir1/file1.txt\",\"type\":\"f\",\"size\":80,"));
+  delete logger;
+}
 TEST(FileKnifeTest, listSize) {
   FEW_TESTS();
   auto base = initTree();
@@ -154,7 +170,8 @@ TEST(FileKnifeTest, listDirectoriesMinutes) {
   fileKnife(sizeof argv / sizeof argv[0], const_cast<char**>(argv), logger);
   auto appender = dynamic_cast<MemoryAppender*>(logger->findAppender("memory"));
   auto lines = appender->lines();
-  ASSERT_EQ(8, appender->count());
+  // 4 files, 3 directories, the summary and the filter statistic:
+  ASSERT_EQ(9, appender->count());
   ASSERT_TRUE(
       matchInAnyLine(appender, "0.000449 MB /tmp/unittest/dir1/file0.dat"));
   ASSERT_TRUE(
@@ -177,6 +194,57 @@ TEST(FileKnifeTest, extrema) {
   delete logger;
 }
 
+TEST(FileKnifeTest, dedup) {
+  FEW_TESTS();
+  auto base = initTree();
+  auto copy = base + "/dir2/copy1.txt";
+  copyFile((base + "/file1.txt").c_str(), copy.c_str());
+  const char *argv[] = { "dedup", "--threads=2", base.c_str() };
+  auto logger = buildMemoryLogger(100, LV_FINE);
+  fileKnife(sizeof argv / sizeof argv[0], const_cast<char**>(argv), logger);
+  auto appender = dynamic_cast<MemoryAppender*>(logger->findAppender("memory"));
+  ASSERT_TRUE(matchInAnyLine(appender, "=== 2 x 0.000080 MB"));
+  ASSERT_TRUE(matchInAnyLine(appender, "/tmp/unittest/dir1/dir2/copy1.txt"));
+  ASSERT_TRUE(matchInAnyLine(appender, "= 1 group(s) 1 duplicate(s)"));
+  unlink(copy.c_str());
+  delete logger;
+}
+
+TEST(FileKnifeTest, sync) {
+  FEW_TESTS();
+  auto base = initTree();
+  auto target = temporaryFile("synctarget", "unittest", false);
+  const char *argv[] = { "sync", "--dry-run", base.c_str(), target.c_str() };
+  auto logger = buildMemoryLogger(100, LV_FINE);
+  fileKnife(sizeof argv / sizeof argv[0], const_cast<char**>(argv), logger);
+  auto appender = dynamic_cast<MemoryAppender*>(logger->findAppender("memory"));
+  ASSERT_TRUE(matchInAnyLine(appender, "/synctarget/file1.txt"));
+  ASSERT_TRUE(matchInAnyLine(appender, "file(s) copied"));
+  ASSERT_TRUE(matchInAnyLine(appender, " 0 error(s)"));
+  ASSERT_FALSE(isDirectory(target.c_str()));
+  delete logger;
+  // The filter options of the traversal:
+  const char *argv2[] = { "sync", "--dry-run", "--size=+1G", base.c_str(),
+      target.c_str() };
+  logger = buildMemoryLogger(100, LV_FINE);
+  fileKnife(sizeof argv2 / sizeof argv2[0], const_cast<char**>(argv2), logger);
+  appender = dynamic_cast<MemoryAppender*>(logger->findAppender("memory"));
+  ASSERT_FALSE(matchInAnyLine(appender, "/synctarget/file1.txt"));
+  ASSERT_TRUE(matchInAnyLine(appender, "= 0 file(s) copied"));
+  delete logger;
+}
+
+TEST(FileKnifeTest, watch) {
+  FEW_TESTS();
+  auto base = initTree();
+  const char *argv[] = { "watch", "--count=1", "--interval=0", base.c_str() };
+  auto logger = buildMemoryLogger(100, LV_FINE);
+  fileKnife(sizeof argv / sizeof argv[0], const_cast<char**>(argv), logger);
+  auto appender = dynamic_cast<MemoryAppender*>(logger->findAppender("memory"));
+  ASSERT_TRUE(matchInAnyLine(appender, "= start: files: "));
+  delete logger;
+}
+
 TEST(FileKnifeTest, wc) {
   FEW_TESTS();
   auto base = initTreeWc();
@@ -215,6 +283,33 @@ TEST(FileKnifeTest, wc) {
       startsWith(lines[0].c_str(), -1, (std::string("20 ") + base).c_str()));
   delete logger;
 }
+TEST(FileKnifeTest, wcLargeFileThreads) {
+  std::string base = temporaryFile("wc.large", "unittest");
+  ensureDirectory(base.c_str());
+  auto file = joinPath(base.c_str(), "large.txt");
+  // Larger than 2 chunks: the file is counted in parallel.
+  std::string text;
+  for (int ix = 1; text.size() < 3 * ChunkedFile::MIN_CHUNK_SIZE; ix++) {
+    text += formatCString("line %d:%s\n", ix,
+        std::string(ix % 90, ix % 7 == 0 ? ' ' : 'x').c_str());
+  }
+  writeText(file.c_str(), text.c_str(), text.size());
+  std::string results[2];
+  for (int parallel = 0; parallel < 2; parallel++) {
+    const char *argv[] = { "wc", parallel ? "--threads=4" : "--threads=1",
+        base.c_str() };
+    auto logger = buildMemoryLogger(100, LV_FINE);
+    fileKnife(sizeof argv / sizeof argv[0], const_cast<char**>(argv), logger);
+    auto appender = dynamic_cast<MemoryAppender*>(logger->findAppender(
+        "memory"));
+    results[parallel] = appender->lines()[0];
+    delete logger;
+  }
+  ASSERT_TRUE(startsWith(results[0].c_str(), -1, "55880 111760 3145794"));
+  ASSERT_EQ(results[0], results[1]);
+  unlink(file.c_str());
+  rmdir(base.c_str());
+}
 TEST(FileKnifeTest, listTypeNameOnlyMaxDepth) {
   FEW_TESTS();
   auto base = initTreeWc();
@@ -139,6 +139,30 @@ TEST(TextKnifeTest, strings) {
 )""");
   delete logger;
 }
+TEST(TextKnifeTest, stringsRelativeBase) {
+  std::string base = "/tmp/unittest/stringsTree";
+  ensureDirectory((base + "/sub/sub2").c_str());
+  writeText((base + "/a.txt").c_str(), "'a'\n");
+  writeText((base + "/sub/b.txt").c_str(), "\"b\"\n");
+  writeText((base + "/sub/sub2/c.txt").c_str(), "'c' 'a'\n");
+  auto output = temporaryFile("strings.relative.txt", "unittest", true);
+  // The traverser changes the current directory: the relative names must work anyway.
+  auto current = currentDirectory();
+  ASSERT_EQ(0, chdir("/tmp/unittest"));
+  for (auto threads : { "--threads=1", "--threads=4" }) {
+    unlink(output.c_str());
+    const char *argv[] = { "strings", threads, "-o", output.c_str(),
+        "stringsTree" };
+    auto logger = buildMemoryLogger(100, LV_FINE);
+    textKnife(sizeof argv / sizeof argv[0], const_cast<char**>(argv), logger);
+    auto appender = dynamic_cast<MemoryAppender*>(logger->findAppender(
+        "memory"));
+    ASSERT_FALSE(matchInAnyLine(appender, "cannot open"));
+    ASSERT_STREQ("\"b\"\n'a'\n'c'\n", readAsString(output.c_str()).c_str());
+    delete logger;
+  }
+  ASSERT_EQ(0, chdir(current.c_str()));
+}
 TEST(TextKnifeTest, search) {
   FEW_TESTS();
   auto theOsInfo = osInfo();
@@ -214,6 +238,106 @@ Suzy Q)""";
   delete logger;
 }
 
+TEST(TextKnifeTest, searchParallel) {
+  auto input = temporaryFile("searchBig.txt", "unittest", true);
+  // Larger than 2 chunks: the file is searched in parallel.
+  std::string text;
+  for (int ix = 1; text.size() < 3 * ChunkedFile::MIN_CHUNK_SIZE; ix++) {
+    text += formatCString("line %d: %s\n", ix,
+        std::string(ix % 80, 'a' + ix % 26).c_str());
+  }
+  writeText(input.c_str(), text.c_str(), text.size());
+  const char *variants[][2] = { { "-S99:", "" },
+      { "-P/^line [0-9]*12:/", "--max-count=300" }, { "-Sline 7777:", "-l" } };
+  for (auto variant : variants) {
+    std::vector<std::string> results[2];
+    for (int parallel = 0; parallel < 2; parallel++) {
+      // The chunks are memory mapped: the serial search is buffered.
+      const char *argv[] = { "search", variant[0],
+          parallel ? "--threads=4" : "--threads=1",
+          parallel ? "--memory-mapped" : "--read-ahead=0", input.c_str(),
+          variant[1] };
+      auto logger = buildMemoryLogger(100000, LV_FINE);
+      textKnife(variant[1][0] == '\0' ? 5 : 6, const_cast<char**>(argv),
+          logger);
+      auto appender = dynamic_cast<MemoryAppender*>(logger->findAppender(
+          "memory"));
+      for (auto &line : appender->lines()) {
+        // The runtime differs:
+        if (!startsWith(line.c_str(), -1, "= runtime")) {
+          results[parallel].push_back(line);
+        }
+      }
+      delete logger;
+    }
+    ASSERT_TRUE(results[0].size() > 0);
+    ASSERT_EQ(results[0], results[1]);
+  }
+  unlink(input.c_str());
+}
+TEST(TextKnifeTest, searchFilesConcurrently) {
+  std::string base = "/tmp/unittest/concurrent";
+  for (int dir = 0; dir < 4; dir++) {
+    for (int file = 0; file < 50; file++) {
+      std::string text;
+      for (int line = 0; line < file % 7 + 1; line++) {
+        text += formatCString("dir %d file %d line %d: hit\nmiss\n", dir, file,
+            line);
+      }
+      auto name = formatCString("%s/dir%d/file%02d.txt", base.c_str(), dir,
+          file);
+      ensureDirectory(name.substr(0, name.rfind('/')).c_str());
+      writeText(name.c_str(), text.c_str());
+    }
+  }
+  auto run = [](std::vector<const char*> argv) {
+    std::vector<std::string> rc;
+    auto logger = buildMemoryLogger(100000, LV_FINE);
+    textKnife(argv.size(), const_cast<char**>(argv.data()), logger);
+    auto appender = dynamic_cast<MemoryAppender*>(logger->findAppender(
+        "memory"));
+    for (auto &line : appender->lines()) {
+      // The runtime differs:
+      if (!startsWith(line.c_str(), -1, "= runtime")) {
+        rc.push_back(line);
+      }
+    }
+    delete logger;
+    return rc;
+  };
+  auto serial = run( { "search", "-Shit", "--threads=1", base.c_str() });
+  auto ordered = run( { "search", "-Shit", "--threads=4", base.c_str() });
+  auto unordered = run( { "search", "-Shit", "--threads=4", "--unordered",
+      base.c_str() });
+  // Per directory: 7 * (1 + 2 + ... + 7) + 1 hits.
+  ASSERT_EQ(4U * 197, serial.size());
+  // The traversal stays serial: the output is the same as with one thread.
+  ASSERT_EQ(serial, ordered);
+  auto mapped = run( { "search", "-Shit", "--memory-mapped", base.c_str() });
+  ASSERT_EQ(serial, mapped);
+  // Without order: the same hits, the lines of a file are contiguous.
+  auto sorted = [](std::vector<std::string> lines) {
+    std::sort(lines.begin(), lines.end());
+    return lines;
+  };
+  ASSERT_EQ(sorted(serial), sorted(unordered));
+  std::set<std::string> finished;
+  std::string current;
+  for (auto &line : unordered) {
+    auto name = line.substr(0, line.find('-'));
+    if (name != current) {
+      ASSERT_TRUE(finished.find(name) == finished.end()) << name;
+      finished.insert(current);
+      current = name;
+    }
+  }
+  auto list = run( { "search", "-Shit", "--threads=4", "--list", base.c_str() });
+  ASSERT_EQ(200U, list.size());
+  auto checkSum1 = run( { "checksum", "--threads=1", base.c_str() });
+  auto checkSum4 = run( { "checksum", "--threads=4", base.c_str() });
+  ASSERT_EQ(201U, checkSum4.size());
+  ASSERT_EQ(checkSum1.back(), checkSum4.back());
+}
 TEST(TextKnifeTest, checkSum) {
   //FEW_TESTS();
   auto theOsInfo = osInfo();